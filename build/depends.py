@@ -571,7 +571,8 @@ class SoundTouch(Dependence):
 
 class RubberBand(Dependence):
     def sources(self, build):
-        sources = ['src/engine/bufferscalers/enginebufferscalerubberband.cpp', ]
+        sources = ['src/engine/bufferscalers/enginebufferscalerubberband.cpp',
+                   'src/engine/bufferscalers/rubberbandrenderahead.cpp', ]
         return sources
 
     def configure(self, build, conf, env=None):
@@ -798,6 +799,7 @@ class MixxxCore(Feature):
                    "src/effects/effectparameterslot.cpp",
                    "src/effects/effectbuttonparameterslot.cpp",
                    "src/effects/effectsmanager.cpp",
+                   "src/effects/effectstatepool.cpp",
                    "src/effects/effectchainmanager.cpp",
                    "src/effects/effectsbackend.cpp",
 
@@ -834,6 +836,7 @@ class MixxxCore(Feature):
 
                    "src/engine/engineworker.cpp",
                    "src/engine/engineworkerscheduler.cpp",
+                   "src/engine/enginejobpool.cpp",
                    "src/engine/enginebuffer.cpp",
                    "src/engine/bufferscalers/enginebufferscale.cpp",
                    "src/engine/bufferscalers/enginebufferscalelinear.cpp",
@@ -861,7 +864,7 @@ class MixxxCore(Feature):
                    "src/engine/sidechain/networkoutputstreamworker.cpp",
                    "src/engine/sidechain/networkinputstreamworker.cpp",
                    "src/engine/enginexfader.cpp",
-                   "src/engine/channelmixer_autogen.cpp",
+                   "src/engine/channelmixer.cpp",
                    "src/engine/positionscratchcontroller.cpp",
                    "src/engine/controls/bpmcontrol.cpp",
                    "src/engine/controls/clockcontrol.cpp",
@@ -884,6 +887,7 @@ class MixxxCore(Feature):
                    "src/analyzer/analyzerbeats.cpp",
                    "src/analyzer/analyzerkey.cpp",
                    "src/analyzer/analyzerebur128.cpp",
+                   "src/analyzer/analyzerfingerprint.cpp",
                    "src/analyzer/analyzersilence.cpp",
                    "src/analyzer/plugins/analyzersoundtouchbeats.cpp",
                    "src/analyzer/plugins/analyzerqueenmarybeats.cpp",
@@ -932,6 +936,7 @@ class MixxxCore(Feature):
                    "src/sources/soundsourceproxy.cpp",
 
                    "src/widget/controlwidgetconnection.cpp",
+                   "src/widget/controlwidgetupdatequeue.cpp",
                    "src/widget/wbasewidget.cpp",
                    "src/widget/wwidget.cpp",
                    "src/widget/wwidgetgroup.cpp",
@@ -961,6 +966,7 @@ class MixxxCore(Feature):
                    "src/widget/wsearchlineedit.cpp",
                    "src/widget/wpixmapstore.cpp",
                    "src/widget/paintable.cpp",
+                   "src/widget/svgrastercache.cpp",
                    "src/widget/wimagestore.cpp",
                    "src/widget/hexspinbox.cpp",
                    "src/widget/wtrackproperty.cpp",
@@ -1010,6 +1016,7 @@ class MixxxCore(Feature):
                    "src/library/trackcollectionmanager.cpp",
                    "src/library/externaltrackcollection.cpp",
                    "src/library/basesqltablemodel.cpp",
+                   "src/library/asyncselectthread.cpp",
                    "src/library/basetrackcache.cpp",
                    "src/library/columncache.cpp",
                    "src/library/librarytablemodel.cpp",
@@ -1033,7 +1040,9 @@ class MixxxCore(Feature):
                    "src/library/analysisfeature.cpp",
                    "src/library/autodj/autodjfeature.cpp",
                    "src/library/autodj/autodjprocessor.cpp",
+                   "src/library/autodj/autodjtracksampler.cpp",
                    "src/library/dao/directorydao.cpp",
+                   "src/library/dao/fingerprintdao.cpp",
                    "src/library/mixxxlibraryfeature.cpp",
                    "src/library/baseplaylistfeature.cpp",
                    "src/library/playlistfeature.cpp",
@@ -1060,6 +1069,7 @@ class MixxxCore(Feature):
                    "src/library/recording/dlgrecording.cpp",
                    "src/recording/recordingmanager.cpp",
                    "src/engine/sidechain/enginerecord.cpp",
+                   "src/engine/sidechain/bufferedfilewriter.cpp",
 
                    # External Library Features
                    "src/library/baseexternallibraryfeature.cpp",
@@ -1179,6 +1189,7 @@ class MixxxCore(Feature):
                    "src/skin/skinloader.cpp",
                    "src/skin/legacyskinparser.cpp",
                    "src/skin/colorschemeparser.cpp",
+                   "src/skin/deferredwidgetbuilder.cpp",
                    "src/skin/tooltips.cpp",
                    "src/skin/skincontext.cpp",
                    "src/skin/svgparser.cpp",
@@ -1192,6 +1203,7 @@ class MixxxCore(Feature):
                    "src/track/beats.cpp",
                    "src/track/bpm.cpp",
                    "src/track/cue.cpp",
+                   "src/track/fingerprint.cpp",
                    "src/track/keyfactory.cpp",
                    "src/track/keys.cpp",
                    "src/track/keyutils.cpp",
@@ -1237,12 +1249,16 @@ class MixxxCore(Feature):
                    "src/encoder/encodervorbissettings.cpp",
                    "src/encoder/encoderwave.cpp",
                    "src/encoder/encoderwavesettings.cpp",
+                   "src/encoder/sharedencoder.cpp",
                    'src/encoder/encoderopussettings.cpp',
 
                    "src/util/sleepableqthread.cpp",
+                   "src/util/wakesemaphore.cpp",
                    "src/util/statsmanager.cpp",
                    "src/util/stat.cpp",
                    "src/util/statmodel.cpp",
+                   "src/util/callbacktrace.cpp",
+                   "src/util/callbacktracemodel.cpp",
                    "src/util/dnd.cpp",
                    "src/util/duration.cpp",
                    "src/util/time.cpp",
@@ -1255,6 +1271,7 @@ class MixxxCore(Feature):
                    "src/util/valuetransformer.cpp",
                    "src/util/sandbox.cpp",
                    "src/util/file.cpp",
+                   "src/util/filecopier.cpp",
                    "src/util/mac.cpp",
                    "src/util/task.cpp",
                    "src/util/experiment.cpp",
@@ -1275,6 +1292,8 @@ class MixxxCore(Feature):
                    "src/util/db/sqlstringformatter.cpp",
                    "src/util/db/sqltransaction.cpp",
                    "src/util/sample.cpp",
+                   "src/util/samplekernels.cpp",
+                   "src/util/cpufeatures.cpp",
                    "src/util/samplebuffer.cpp",
                    "src/util/readaheadsamplebuffer.cpp",
                    "src/util/rotary.cpp",
@@ -11,8 +11,9 @@ namespace {
 const double kReplayGain2ReferenceLUFS = -18;
 } // anonymous namespace
 
-AnalyzerEbur128::AnalyzerEbur128(UserSettingsPointer pConfig)
+AnalyzerEbur128::AnalyzerEbur128(UserSettingsPointer pConfig, bool enforceAnalysis)
         : m_rgSettings(pConfig),
+          m_enforceAnalysis(enforceAnalysis),
           m_pState(nullptr) {
 }
 
@@ -23,7 +24,10 @@ AnalyzerEbur128::~AnalyzerEbur128() {
 bool AnalyzerEbur128::initialize(TrackPointer tio,
         int sampleRate,
         int totalSamples) {
-    if (m_rgSettings.isAnalyzerDisabled(2, tio) || totalSamples == 0) {
+    const bool analyzerDisabled = m_enforceAnalysis
+            ? m_rgSettings.isTrackAnalyzed(tio)
+            : m_rgSettings.isAnalyzerDisabled(2, tio);
+    if (analyzerDisabled || totalSamples == 0) {
         qDebug() << "Skipping AnalyzerEbur128";
         return false;
     }
@@ -8,7 +8,9 @@
 
 class AnalyzerEbur128 : public Analyzer {
   public:
-    AnalyzerEbur128(UserSettingsPointer pConfig);
+    // The analysis can be enforced even if the ReplayGain 2.0 analyzer
+    // is disabled in the preferences
+    AnalyzerEbur128(UserSettingsPointer pConfig, bool enforceAnalysis = false);
     virtual ~AnalyzerEbur128();
 
     static bool isEnabled(const ReplayGainSettings& rgSettings) {
@@ -22,6 +24,7 @@ class AnalyzerEbur128 : public Analyzer {
 
   private:
     ReplayGainSettings m_rgSettings;
+    const bool m_enforceAnalysis;
     ebur128_state* m_pState;
 };
 
@@ -0,0 +1,123 @@
+#include "analyzer/analyzerfingerprint.h"
+
+#include <algorithm>
+
+#include "analyzer/constants.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+mixxx::Logger kLogger("AnalyzerFingerprint");
+
+// The pointer type of raw fingerprints depends on the Chromaprint version,
+// see also ChromaPrinter
+#if (CHROMAPRINT_VERSION_MINOR > 3) || (CHROMAPRINT_VERSION_MAJOR > 1)
+typedef uint32_t* uint32_p;
+#else
+typedef void* uint32_p;
+#endif
+
+// AcoustID only matches the first two minutes of a track. Duplicates are
+// detected as reliably from this range as from the whole track.
+constexpr SINT kFingerprintSeconds = 120;
+
+const ConfigKey kEnableFingerprintingKey("[Library]", "EnableFingerprinting");
+
+} // anonymous namespace
+
+// static
+bool AnalyzerFingerprint::isEnabled(const UserSettingsPointer& pConfig) {
+    return pConfig->getValue(kEnableFingerprintingKey, false);
+}
+
+AnalyzerFingerprint::AnalyzerFingerprint(const QSqlDatabase& dbConnection)
+        : m_pChromaprintContext(nullptr),
+          m_samples(mixxx::kAnalysisSamplesPerChunk),
+          m_remainingSamples(0) {
+    m_fingerprintDao.initialize(dbConnection);
+}
+
+AnalyzerFingerprint::~AnalyzerFingerprint() {
+    cleanup();
+}
+
+bool AnalyzerFingerprint::initialize(TrackPointer pTrack, int sampleRate, int totalSamples) {
+    if (totalSamples == 0 || m_fingerprintDao.hasFingerprint(pTrack->getId())) {
+        return false;
+    }
+
+    DEBUG_ASSERT(!m_pChromaprintContext);
+    m_pChromaprintContext = chromaprint_new(CHROMAPRINT_ALGORITHM_DEFAULT);
+    if (!chromaprint_start(m_pChromaprintContext, sampleRate, mixxx::kAnalysisChannels)) {
+        kLogger.warning() << "Failed to start fingerprinting" << pTrack->getLocation();
+        // cleanup() is only invoked after a successful initialization
+        cleanup();
+        return false;
+    }
+    m_remainingSamples = kFingerprintSeconds * sampleRate * mixxx::kAnalysisChannels;
+    m_pTrack = std::move(pTrack);
+    return true;
+}
+
+bool AnalyzerFingerprint::processSamples(const CSAMPLE* pIn, const int iLen) {
+    const SINT numSamples = math_min<SINT>(iLen, m_remainingSamples);
+    VERIFY_OR_DEBUG_ASSERT(numSamples <= static_cast<SINT>(m_samples.size())) {
+        return false;
+    }
+    SampleUtil::convertFloat32ToS16(m_samples.data(), pIn, numSamples);
+    m_remainingSamples -= numSamples;
+    if (chromaprint_feed(
+                m_pChromaprintContext,
+                m_samples.data(),
+                static_cast<int>(numSamples)) != 1) {
+        return false;
+    }
+    if (m_remainingSamples > 0) {
+        return true;
+    }
+    // The fingerprint is complete. Store it right away and become
+    // inactive, because storeResults() is not invoked for inactive
+    // analyzers. The analyzer thread stops decoding early when all
+    // analyzers are inactive.
+    storeFingerprint();
+    return false;
+}
+
+void AnalyzerFingerprint::storeResults(TrackPointer pTrack) {
+    // Only reached for tracks that are shorter than the fingerprint range
+    DEBUG_ASSERT(pTrack == m_pTrack);
+    Q_UNUSED(pTrack);
+    storeFingerprint();
+}
+
+void AnalyzerFingerprint::storeFingerprint() {
+    if (!chromaprint_finish(m_pChromaprintContext)) {
+        kLogger.warning() << "Failed to fingerprint" << m_pTrack->getLocation();
+        return;
+    }
+    uint32_p pRawFingerprint = nullptr;
+    int size = 0;
+    if (!chromaprint_get_raw_fingerprint(m_pChromaprintContext, &pRawFingerprint, &size)) {
+        kLogger.warning() << "Failed to fingerprint" << m_pTrack->getLocation();
+        return;
+    }
+    const uint32_t* pValues = static_cast<const uint32_t*>(pRawFingerprint);
+    QVector<quint32> values(size);
+    std::copy(pValues, pValues + size, values.begin());
+    chromaprint_dealloc(pRawFingerprint);
+
+    if (!m_fingerprintDao.saveFingerprint(
+                m_pTrack->getId(), mixxx::Fingerprint(std::move(values)))) {
+        kLogger.warning() << "Failed to store the fingerprint of" << m_pTrack->getLocation();
+    }
+}
+
+void AnalyzerFingerprint::cleanup() {
+    if (m_pChromaprintContext) {
+        chromaprint_free(m_pChromaprintContext);
+        m_pChromaprintContext = nullptr;
+    }
+    m_pTrack.reset();
+}
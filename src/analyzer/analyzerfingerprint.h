@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chromaprint.h>
+
+#include <QSqlDatabase>
+
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "library/dao/fingerprintdao.h"
+#include "preferences/usersettings.h"
+
+// Calculates the acoustic fingerprint of the beginning of a track from the
+// audio that is decoded for the analysis anyway and stores it together with
+// its duplicate detection keys.
+class AnalyzerFingerprint : public Analyzer {
+  public:
+    // Fingerprinting is disabled by default, because it costs analysis
+    // time that most users will never benefit from
+    static bool isEnabled(const UserSettingsPointer& pConfig);
+
+    explicit AnalyzerFingerprint(const QSqlDatabase& dbConnection);
+    ~AnalyzerFingerprint() override;
+
+    bool initialize(TrackPointer pTrack, int sampleRate, int totalSamples) override;
+    bool processSamples(const CSAMPLE* pIn, const int iLen) override;
+    void storeResults(TrackPointer pTrack) override;
+    void cleanup() override;
+
+  private:
+    void storeFingerprint();
+
+    FingerprintDAO m_fingerprintDao;
+    ChromaprintContext* m_pChromaprintContext;
+    // Chromaprint expects 16-bit integer samples
+    std::vector<SAMPLE> m_samples;
+    SINT m_remainingSamples;
+    TrackPointer m_pTrack;
+};
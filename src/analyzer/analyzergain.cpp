@@ -7,8 +7,9 @@
 #include "util/sample.h"
 #include "util/timer.h"
 
-AnalyzerGain::AnalyzerGain(UserSettingsPointer pConfig)
+AnalyzerGain::AnalyzerGain(UserSettingsPointer pConfig, bool enforceAnalysis)
         : m_rgSettings(pConfig),
+          m_enforceAnalysis(enforceAnalysis),
           m_pLeftTempBuffer(NULL),
           m_pRightTempBuffer(NULL),
           m_iBufferSize(0) {
@@ -22,7 +23,10 @@ AnalyzerGain::~AnalyzerGain() {
 }
 
 bool AnalyzerGain::initialize(TrackPointer tio, int sampleRate, int totalSamples) {
-    if (m_rgSettings.isAnalyzerDisabled(1, tio) || totalSamples == 0) {
+    const bool analyzerDisabled = m_enforceAnalysis
+            ? m_rgSettings.isTrackAnalyzed(tio)
+            : m_rgSettings.isAnalyzerDisabled(1, tio);
+    if (analyzerDisabled || totalSamples == 0) {
         qDebug() << "Skipping AnalyzerGain";
         return false;
     }
@@ -42,6 +46,7 @@ bool AnalyzerGain::processSamples(const CSAMPLE *pIn, const int iLen) {
         delete[] m_pRightTempBuffer;
         m_pLeftTempBuffer = new CSAMPLE[halfLength];
         m_pRightTempBuffer = new CSAMPLE[halfLength];
+        m_iBufferSize = halfLength;
     }
     SampleUtil::deinterleaveBuffer(m_pLeftTempBuffer, m_pRightTempBuffer, pIn, halfLength);
     SampleUtil::applyGain(m_pLeftTempBuffer, 32767, halfLength);
@@ -15,7 +15,9 @@ class ReplayGain;
 
 class AnalyzerGain : public Analyzer {
   public:
-    AnalyzerGain(UserSettingsPointer pConfig);
+    // The analysis can be enforced even if the ReplayGain 1.0 analyzer
+    // is disabled in the preferences
+    AnalyzerGain(UserSettingsPointer pConfig, bool enforceAnalysis = false);
     virtual ~AnalyzerGain();
 
     static bool isEnabled(const ReplayGainSettings& rgSettings) {
@@ -29,6 +31,7 @@ class AnalyzerGain : public Analyzer {
 
   private:
     ReplayGainSettings m_rgSettings;
+    const bool m_enforceAnalysis;
     CSAMPLE* m_pLeftTempBuffer;
     CSAMPLE* m_pRightTempBuffer;
     ReplayGain* m_pReplayGain;
@@ -4,6 +4,7 @@
 
 #include "analyzer/analyzerbeats.h"
 #include "analyzer/analyzerebur128.h"
+#include "analyzer/analyzerfingerprint.h"
 #include "analyzer/analyzergain.h"
 #include "analyzer/analyzerkey.h"
 #include "analyzer/analyzersilence.h"
@@ -95,7 +96,16 @@ void AnalyzerThread::doRun() {
     // before returning from this function.
     mixxx::DbConnectionPooler dbConnectionPooler;
 
-    if (m_modeFlags & AnalyzerModeFlags::WithWaveform) {
+    if (m_modeFlags & AnalyzerModeFlags::LoudnessOnly) {
+        // Skip all other analyzers. The analysis is enforced even if the
+        // ReplayGain analyzer is disabled in the preferences.
+        if (ReplayGainSettings(m_pConfig).getReplayGainAnalyzerVersion() == 1) {
+            m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerGain>(m_pConfig, true)));
+        } else {
+            m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerEbur128>(m_pConfig, true)));
+        }
+    } else {
+        // Waveforms and fingerprints are stored in the database
         dbConnectionPooler = mixxx::DbConnectionPooler(m_dbConnectionPool); // move assignment
         if (!dbConnectionPooler.isPooling()) {
             kLogger.warning()
@@ -103,20 +113,26 @@ void AnalyzerThread::doRun() {
             return;
         }
         QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_dbConnectionPool);
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerWaveform>(m_pConfig, dbConnection)));
-    }
-    if (AnalyzerGain::isEnabled(ReplayGainSettings(m_pConfig))) {
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerGain>(m_pConfig)));
-    }
-    if (AnalyzerEbur128::isEnabled(ReplayGainSettings(m_pConfig))) {
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerEbur128>(m_pConfig)));
+        if (m_modeFlags & AnalyzerModeFlags::WithWaveform) {
+            m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerWaveform>(m_pConfig, dbConnection)));
+        }
+        if (AnalyzerFingerprint::isEnabled(m_pConfig)) {
+            m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerFingerprint>(dbConnection)));
+        }
+        // Only one of the ReplayGain analyzers is enabled at a time
+        if (AnalyzerGain::isEnabled(ReplayGainSettings(m_pConfig))) {
+            m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerGain>(m_pConfig)));
+        }
+        if (AnalyzerEbur128::isEnabled(ReplayGainSettings(m_pConfig))) {
+            m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerEbur128>(m_pConfig)));
+        }
+        // BPM detection might be disabled in the config, but can be overridden
+        // and enabled by explicitly setting the mode flag.
+        const bool enforceBpmDetection = (m_modeFlags & AnalyzerModeFlags::WithBeats) != 0;
+        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerBeats>(m_pConfig, enforceBpmDetection)));
+        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerKey>(m_pConfig)));
+        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerSilence>(m_pConfig)));
     }
-    // BPM detection might be disabled in the config, but can be overridden
-    // and enabled by explicitly setting the mode flag.
-    const bool enforceBpmDetection = (m_modeFlags & AnalyzerModeFlags::WithBeats) != 0;
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerBeats>(m_pConfig, enforceBpmDetection)));
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerKey>(m_pConfig)));
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerSilence>(m_pConfig)));
     DEBUG_ASSERT(!m_analyzers.empty());
     kLogger.debug() << "Activated" << m_analyzers.size() << "analyzers";
 
@@ -295,10 +311,19 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
 
         // 2nd: step: Analyze chunk of decoded audio data
         if (!readableSampleFrames.frameIndexRange().empty()) {
+            bool anyAnalyzerActive = false;
             for (auto&& analyzer : m_analyzers) {
                 analyzer.processSamples(
                         readableSampleFrames.readableData(),
                         readableSampleFrames.readableLength());
+                anyAnalyzerActive |= analyzer.isActive();
+            }
+            if (!anyAnalyzerActive) {
+                // All analyzers failed, so decoding the rest of the
+                // track would be wasted
+                kLogger.warning()
+                        << "Aborting analysis after all analyzers failed";
+                break;
             }
         }
 
@@ -20,6 +20,10 @@ enum AnalyzerModeFlags {
     WithBeats = 0x01,
     WithWaveform = 0x02,
     All = WithBeats | WithWaveform,
+    // Only analyze the ReplayGain with the version selected in the
+    // preferences, e.g. for normalizing the loudness of the whole
+    // library. Takes precedence over all other flags.
+    LoudnessOnly = 0x04,
 };
 
 enum class AnalyzerThreadState {
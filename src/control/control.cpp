@@ -55,12 +55,12 @@ void ControlDoublePrivate::initialize(double defaultValue) {
     m_defaultValue.setValue(defaultValue);
     m_value.setValue(value);
 
-    //qDebug() << "Creating:" << m_trackKey << "at" << &m_value << sizeof(m_value);
+    //qDebug() << "Creating:" << m_key << "at" << &m_value << sizeof(m_value);
 
     if (m_bTrack) {
         // TODO(rryan): Make configurable.
-        m_trackKey = "control " + m_key.group + "," + m_key.item;
-        Stat::track(m_trackKey, static_cast<Stat::StatType>(m_trackType),
+        m_trackTag = StatTag("control " + m_key.group + "," + m_key.item);
+        Stat::track(m_trackTag, static_cast<Stat::StatType>(m_trackType),
                     static_cast<Stat::ComputeFlags>(m_trackFlags),
                     m_value.getValue());
     }
@@ -198,7 +198,7 @@ void ControlDoublePrivate::setInner(double value, QObject* pSender) {
     emit(valueChanged(value, pSender));
 
     if (m_bTrack) {
-        Stat::track(m_trackKey, static_cast<Stat::StatType>(m_trackType),
+        Stat::track(m_trackTag, static_cast<Stat::StatType>(m_trackType),
                     static_cast<Stat::ComputeFlags>(m_trackFlags), value);
     }
 }
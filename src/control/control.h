@@ -10,6 +10,7 @@
 #include "control/controlvalue.h"
 #include "preferences/usersettings.h"
 #include "util/mutex.h"
+#include "util/stat.h"
 
 class ControlObject;
 
@@ -155,7 +156,7 @@ class ControlDoublePrivate : public QObject {
 
     // Whether to track value changes with the stats framework.
     bool m_bTrack;
-    QString m_trackKey;
+    StatTag m_trackTag;
     int m_trackType;
     int m_trackFlags;
     bool m_confirmRequired;
@@ -91,6 +91,27 @@ class ControlProxy : public QObject {
         return true;
     }
 
+    // Calls func(value) directly from the thread that changed the control,
+    // unless the change originated from this proxy. No signal of this proxy
+    // is involved, so func must be thread-safe and must not capture objects
+    // that might be deleted while a change is delivered. The connection is
+    // removed when pContext is destroyed.
+    template <typename Func>
+    QMetaObject::Connection connectValueChangedUnqueued(QObject* pContext, Func func) {
+        if (!m_pControl) {
+            return QMetaObject::Connection();
+        }
+        const QObject* pSelf = this;
+        return connect(m_pControl.data(), &ControlDoublePrivate::valueChanged,
+                pContext,
+                [pSelf, func](double value, QObject* pSender) {
+                    if (pSender != pSelf) {
+                        func(value);
+                    }
+                },
+                Qt::DirectConnection);
+    }
+
     // Called from update();
     virtual void emitValueChanged() {
         emit(valueChanged(get()));
@@ -3,6 +3,7 @@
 #include <QDateTime>
 
 #include "control/control.h"
+#include "util/callbacktrace.h"
 #include "util/cmdlineargs.h"
 #include "util/statsmanager.h"
 #include "util/logging.h"
@@ -53,6 +54,14 @@ DlgDeveloperTools::DlgDeveloperTools(QWidget* pParent,
     m_statProxyModel.setSourceModel(&m_statModel);
     statsTable->setModel(&m_statProxyModel);
 
+    m_callbackTraceProxyModel.setSourceModel(&m_callbackTraceModel);
+    callbackTraceTable->setModel(&m_callbackTraceProxyModel);
+    callbackTraceTable->sortByColumn(CallbackTraceModel::CALLBACK_TRACE_COLUMN_MAX,
+                                     Qt::DescendingOrder);
+    if (!CallbackTrace::isEnabled()) {
+        toolTabWidget->removeTab(toolTabWidget->indexOf(callbackTraceTab));
+    }
+
     QString logFileName = QDir(pConfig->getSettingsPath()).filePath("mixxx.log");
     m_logFile.setFileName(logFileName);
     if (!m_logFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
@@ -123,6 +132,8 @@ void DlgDeveloperTools::timerEvent(QTimerEvent* pEvent) {
         if (pManager) {
             pManager->updateStats();
         }
+    } else if (toolTabWidget->currentWidget() == callbackTraceTab) {
+        m_callbackTraceModel.refresh();
     }
 }
 
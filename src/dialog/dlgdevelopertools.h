@@ -10,6 +10,7 @@
 #include "control/controlobject.h"
 #include "dialog/ui_dlgdevelopertoolsdlg.h"
 #include "preferences/usersettings.h"
+#include "util/callbacktracemodel.h"
 #include "util/statmodel.h"
 
 class DlgDeveloperTools : public QDialog, public Ui::DlgDeveloperTools {
@@ -33,6 +34,9 @@ class DlgDeveloperTools : public QDialog, public Ui::DlgDeveloperTools {
     StatModel m_statModel;
     QSortFilterProxyModel m_statProxyModel;
 
+    CallbackTraceModel m_callbackTraceModel;
+    QSortFilterProxyModel m_callbackTraceProxyModel;
+
     QFile m_logFile;
     QTextCursor m_logCursor;
 };
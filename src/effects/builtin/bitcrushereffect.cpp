@@ -2,6 +2,42 @@
 
 #include "util/sample.h"
 
+namespace {
+
+struct CrushParameters {
+    CSAMPLE downsample;
+    CSAMPLE bitDepth;
+    CSAMPLE scale;
+    CSAMPLE gainCorrection;
+};
+
+CrushParameters crushParameters(EngineEffectParameter* pDownsampleParameter,
+        EngineEffectParameter* pBitDepthParameter) {
+    CrushParameters parameters;
+    parameters.downsample = pDownsampleParameter ?
+            pDownsampleParameter->value() : 0.0;
+    parameters.bitDepth = pBitDepthParameter ?
+            pBitDepthParameter->value() : 16;
+    // divided by two because we use float math which includes the sing bit anyway
+    parameters.scale = pow(2.0f, parameters.bitDepth) / 2;
+    // Gain correction is required, because MSB (values above 0.5) is usually
+    // rarely used, to achieve equal loudness and maximum dynamic
+    parameters.gainCorrection = (17 - parameters.bitDepth) / 8;
+    return parameters;
+}
+
+inline CSAMPLE crush(CSAMPLE sample, const CrushParameters& parameters) {
+    if (parameters.bitDepth < 16) {
+        return floorf(SampleUtil::clampSample(sample * parameters.gainCorrection) *
+                parameters.scale + 0.5f) / parameters.scale / parameters.gainCorrection;
+    }
+    // Mixxx float has 24 bit depth, Audio CDs are 16 bit
+    // here we do not change the depth
+    return sample;
+}
+
+} // anonymous namespace
+
 // static
 QString BitCrusherEffect::getId() {
     return "org.mixxx.effects.bitcrusher";
@@ -76,38 +112,49 @@ void BitCrusherEffect::processChannel(const ChannelHandle& handle,
     Q_UNUSED(groupFeatures);
     Q_UNUSED(enableState); // no need to ramp, it is just a bitcrusher ;-)
 
-    const CSAMPLE downsample = m_pDownsampleParameter ?
-            m_pDownsampleParameter->value() : 0.0;
-
-    CSAMPLE bit_depth = m_pBitDepthParameter ?
-            m_pBitDepthParameter->value() : 16;
-
-    // divided by two because we use float math which includes the sing bit anyway
-    const CSAMPLE scale = pow(2.0f, bit_depth) / 2;
-    // Gain correction is required, because MSB (values above 0.5) is usually
-    // rarely used, to achieve equal loudness and maximum dynamic
-    const CSAMPLE gainCorrection = (17 - bit_depth) / 8;
+    const CrushParameters parameters = crushParameters(
+            m_pDownsampleParameter, m_pBitDepthParameter);
 
     for (unsigned int i = 0;
             i < bufferParameters.samplesPerBuffer();
             i += bufferParameters.channelCount()) {
-        pState->accumulator += downsample;
+        pState->accumulator += parameters.downsample;
 
         if (pState->accumulator >= 1.0) {
             pState->accumulator -= 1.0;
-            if (bit_depth < 16) {
-
-                pState->hold_l = floorf(SampleUtil::clampSample(pInput[i] * gainCorrection) * scale + 0.5f) / scale / gainCorrection;
-                pState->hold_r = floorf(SampleUtil::clampSample(pInput[i+1] * gainCorrection) * scale + 0.5f) / scale / gainCorrection;
-            } else {
-                // Mixxx float has 24 bit depth, Audio CDs are 16 bit
-                // here we do not change the depth
-                pState->hold_l = pInput[i];
-                pState->hold_r = pInput[i+1];
-            }
+            pState->hold_l = crush(pInput[i], parameters);
+            pState->hold_r = crush(pInput[i+1], parameters);
         }
 
         pOutput[i] = pState->hold_l;
         pOutput[i+1] = pState->hold_r;
     }
 }
+
+void BitCrusherEffect::processChannelPlanar(const ChannelHandle& handle,
+                                            BitCrusherGroupState* pState,
+                                            const CSAMPLE* const* pInputs,
+                                            CSAMPLE* const* pOutputs,
+                                            const mixxx::EngineParameters& bufferParameters,
+                                            const EffectEnableState enableState,
+                                            const GroupFeatureState& groupFeatures) {
+    Q_UNUSED(handle);
+    Q_UNUSED(groupFeatures);
+    Q_UNUSED(enableState);
+
+    const CrushParameters parameters = crushParameters(
+            m_pDownsampleParameter, m_pBitDepthParameter);
+
+    for (SINT i = 0; i < bufferParameters.framesPerBuffer(); ++i) {
+        pState->accumulator += parameters.downsample;
+
+        if (pState->accumulator >= 1.0) {
+            pState->accumulator -= 1.0;
+            pState->hold_l = crush(pInputs[0][i], parameters);
+            pState->hold_r = crush(pInputs[1][i], parameters);
+        }
+
+        pOutputs[0][i] = pState->hold_l;
+        pOutputs[1][i] = pState->hold_r;
+    }
+}
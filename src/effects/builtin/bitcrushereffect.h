@@ -39,6 +39,17 @@ class BitCrusherEffect : public EffectProcessorImpl<BitCrusherGroupState> {
                         const EffectEnableState enableState,
                         const GroupFeatureState& groupFeatureState);
 
+    bool supportsPlanarBuffers() const override {
+        return true;
+    }
+    void processChannelPlanar(const ChannelHandle& handle,
+                              BitCrusherGroupState* pState,
+                              const CSAMPLE* const* pInputs,
+                              CSAMPLE* const* pOutputs,
+                              const mixxx::EngineParameters& bufferParameters,
+                              const EffectEnableState enableState,
+                              const GroupFeatureState& groupFeatureState) override;
+
   private:
     QString debugString() const {
         return getId();
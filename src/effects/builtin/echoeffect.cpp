@@ -7,6 +7,8 @@
 #include "util/rampingvalue.h"
 
 constexpr int EchoGroupState::kMaxDelaySeconds;
+constexpr int EchoGroupState::kMaxSampleRate;
+constexpr int EchoGroupState::kMaxDelaySamples;
 
 namespace {
 
@@ -171,14 +173,14 @@ void EchoEffect::processChannel(const ChannelHandle& handle, EchoGroupState* pGr
     }
 
     int delay_samples = delay_frames * bufferParameters.channelCount();
-    VERIFY_OR_DEBUG_ASSERT(delay_samples <= gs.delay_buf.size()) {
-        delay_samples = gs.delay_buf.size();
+    VERIFY_OR_DEBUG_ASSERT(delay_samples <= gs.delay_buf.length()) {
+        delay_samples = gs.delay_buf.length();
     }
 
     int prev_read_position = gs.write_position;
-    decrementRing(&prev_read_position, gs.prev_delay_samples, gs.delay_buf.size());
+    decrementRing(&prev_read_position, gs.prev_delay_samples, gs.delay_buf.length());
     int read_position = gs.write_position;
-    decrementRing(&read_position, delay_samples, gs.delay_buf.size());
+    decrementRing(&read_position, delay_samples, gs.delay_buf.length());
 
     RampingValue<CSAMPLE_GAIN> send(send_current, gs.prev_send,
                                     bufferParameters.framesPerBuffer());
@@ -204,10 +206,10 @@ void EchoEffect::processChannel(const ChannelHandle& handle, EchoGroupState* pGr
             bufferedSampleLeft += gs.delay_buf[prev_read_position] * (1 - frac);
             bufferedSampleRight += gs.delay_buf[prev_read_position + 1] * (1 - frac);
             incrementRing(&prev_read_position, bufferParameters.channelCount(),
-                    gs.delay_buf.size());
+                    gs.delay_buf.length());
         }
         incrementRing(&read_position, bufferParameters.channelCount(),
-                gs.delay_buf.size());
+                gs.delay_buf.length());
 
         // Actual delays distort and saturate, so clamp the buffer here.
         gs.delay_buf[gs.write_position] = SampleUtil::clampSample(
@@ -236,7 +238,7 @@ void EchoEffect::processChannel(const ChannelHandle& handle, EchoGroupState* pGr
         }
 
         incrementRing(&gs.write_position, bufferParameters.channelCount(),
-                gs.delay_buf.size());
+                gs.delay_buf.length());
 
         ++gs.ping_pong;
         if (gs.ping_pong >= delay_samples) {
@@ -249,7 +251,7 @@ void EchoEffect::processChannel(const ChannelHandle& handle, EchoGroupState* pGr
     // of being handled by EngineEffect::process).
     if (enableState == EffectEnableState::Disabling) {
         SampleUtil::applyRampingGain(pOutput, 1.0, 0.0, bufferParameters.samplesPerBuffer());
-        gs.delay_buf.clear();
+        SampleUtil::clear(gs.delay_buf.data(), gs.delay_buf.length());
         gs.prev_send = 0;
     } else {
         gs.prev_send = send_current;
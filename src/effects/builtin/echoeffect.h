@@ -17,6 +17,10 @@ class EchoGroupState : public EffectState {
     // 3 seconds max. This supports the full range of 2 beats for tempos down to
     // 40 BPM.
     static constexpr int kMaxDelaySeconds = 3;
+    // EngineEffect creates all states for this sample rate
+    static constexpr int kMaxSampleRate = 96000;
+    static constexpr int kMaxDelaySamples =
+            kMaxDelaySeconds * kMaxSampleRate * mixxx::kEngineChannelCount;
 
     EchoGroupState(const mixxx::EngineParameters bufferParameters)
            : EffectState(bufferParameters) {
@@ -25,12 +29,16 @@ class EchoGroupState : public EffectState {
     }
 
     void audioParametersChanged(const mixxx::EngineParameters bufferParameters) {
-        delay_buf = mixxx::SampleBuffer(kMaxDelaySeconds
-                * bufferParameters.sampleRate() * bufferParameters.channelCount());
+        SINT delaySamples = kMaxDelaySeconds
+                * bufferParameters.sampleRate() * bufferParameters.channelCount();
+        VERIFY_OR_DEBUG_ASSERT(delaySamples <= kMaxDelaySamples) {
+            delaySamples = kMaxDelaySamples;
+        }
+        delay_buf = mixxx::SampleBuffer::WritableSlice(delay_samples, delaySamples);
     };
 
     void clear() {
-        delay_buf.clear();
+        SampleUtil::clear(delay_buf.data(), delay_buf.length());
         prev_send = 0.0f;
         prev_feedback= 0.0f;
         prev_delay_samples = 0;
@@ -38,7 +46,11 @@ class EchoGroupState : public EffectState {
         ping_pong = 0;
     };
 
-    mixxx::SampleBuffer delay_buf;
+    // The delay line is part of the state instead of being allocated
+    // separately, so it is recycled by the EffectStatePool along with the
+    // state and deleting the state never frees memory.
+    CSAMPLE delay_samples[kMaxDelaySamples];
+    mixxx::SampleBuffer::WritableSlice delay_buf;
     CSAMPLE_GAIN prev_send;
     CSAMPLE_GAIN prev_feedback;
     int prev_delay_samples;
@@ -14,6 +14,9 @@
 #include "engine/effects/message.h"
 #include "engine/channelhandle.h"
 #include "effects/effectsmanager.h"
+#include "effects/effectstatepool.h"
+#include "util/counter.h"
+#include "util/sample.h"
 
 class EngineEffect;
 
@@ -38,6 +41,10 @@ class EngineEffect;
 // EffectStates are only allocated for input signals that are enabled at that
 // time. This allows for scaling up to an arbitrary number of input signals
 // without wasting a lot of memory.
+//
+// The memory of EffectStates is recycled by the EffectStatePool of their
+// EffectProcessorImpl, so that disabling and enabling a chain for an input
+// channel does not allocate it again.
 class EffectState {
   public:
     EffectState(const mixxx::EngineParameters& bufferParameters) {
@@ -45,6 +52,23 @@ class EffectState {
         Q_UNUSED(bufferParameters);
     };
     virtual ~EffectState() {};
+
+    // States that are not created from a pool, e.g. by LV2EffectProcessor,
+    // are allocated from the heap. Deleting a state never allocates or
+    // locks, regardless of where it has been allocated.
+    static void* operator new(std::size_t size) {
+        return EffectStatePool::allocateUnpooled(size);
+    }
+    static void* operator new(std::size_t size, EffectStatePool* pPool) {
+        return pPool->allocate(size);
+    }
+    static void operator delete(void* pState) {
+        EffectStatePool::deallocate(pState);
+    }
+    // Only called if a constructor throws
+    static void operator delete(void* pState, EffectStatePool* /*pPool*/) {
+        EffectStatePool::deallocate(pState);
+    }
 };
 
 // EffectProcessor is an abstract base class for interfacing with the main
@@ -82,6 +106,39 @@ class EffectProcessor {
                          const mixxx::EngineParameters& bufferParameters,
                          const EffectEnableState enableState,
                          const GroupFeatureState& groupFeatures) = 0;
+
+    // Returns true if process() may be called for different input channels
+    // from different threads at the same time. Processors that share
+    // buffers between channels must return false.
+    virtual bool canProcessChannelsConcurrently() const {
+        return true;
+    }
+
+    // Returns true if the processor implements processPlanar(). Consecutive
+    // effects of a chain that support planar buffers pass them on without
+    // interleaving them in between.
+    virtual bool supportsPlanarBuffers() const {
+        return false;
+    }
+
+    // Like process(), but pInputs and pOutputs point to a separate buffer
+    // for each channel with bufferParameters.framesPerBuffer() samples.
+    virtual void processPlanar(const ChannelHandle& inputHandle,
+                               const ChannelHandle& outputHandle,
+                               const CSAMPLE* const* pInputs,
+                               CSAMPLE* const* pOutputs,
+                               const mixxx::EngineParameters& bufferParameters,
+                               const EffectEnableState enableState,
+                               const GroupFeatureState& groupFeatures) {
+        Q_UNUSED(inputHandle);
+        Q_UNUSED(outputHandle);
+        Q_UNUSED(pInputs);
+        Q_UNUSED(pOutputs);
+        Q_UNUSED(bufferParameters);
+        Q_UNUSED(enableState);
+        Q_UNUSED(groupFeatures);
+        DEBUG_ASSERT(!"processPlanar() is not supported");
+    }
 };
 
 // EffectProcessorImpl manages a separate EffectState for every routing of
@@ -92,7 +149,11 @@ template <typename EffectSpecificState>
 class EffectProcessorImpl : public EffectProcessor {
   public:
     EffectProcessorImpl()
-      : m_pEffectsManager(nullptr) {
+      : m_pEffectsManager(nullptr),
+        m_statePool(sizeof(EffectSpecificState)),
+        m_missingStateTag("EffectProcessor missing EffectState") {
+        static_assert(alignof(EffectSpecificState) <= alignof(std::max_align_t),
+                "EffectStatePool does not support over-aligned states");
     }
     // Subclasses should not implement their own destructor. All state should
     // be stored in the EffectState subclass, not the EffectProcessorImpl subclass.
@@ -137,6 +198,25 @@ class EffectProcessorImpl : public EffectProcessor {
                                 const EffectEnableState enableState,
                                 const GroupFeatureState& groupFeatures) = 0;
 
+    // Subclasses that return true from supportsPlanarBuffers() implement
+    // this planar variant of processChannel().
+    virtual void processChannelPlanar(const ChannelHandle& handle,
+                                      EffectSpecificState* channelState,
+                                      const CSAMPLE* const* pInputs,
+                                      CSAMPLE* const* pOutputs,
+                                      const mixxx::EngineParameters& bufferParameters,
+                                      const EffectEnableState enableState,
+                                      const GroupFeatureState& groupFeatures) {
+        Q_UNUSED(handle);
+        Q_UNUSED(channelState);
+        Q_UNUSED(pInputs);
+        Q_UNUSED(pOutputs);
+        Q_UNUSED(bufferParameters);
+        Q_UNUSED(enableState);
+        Q_UNUSED(groupFeatures);
+        DEBUG_ASSERT(!"processChannelPlanar() is not implemented");
+    }
+
     void process(const ChannelHandle& inputHandle, const ChannelHandle& outputHandle,
                          const CSAMPLE* pInput, CSAMPLE* pOutput,
                          const mixxx::EngineParameters& bufferParameters,
@@ -151,16 +231,51 @@ class EffectProcessorImpl : public EffectProcessor {
                            << "EffectState should have been preallocated in the"
                               "main thread.";
             }
-            pState = createSpecificState(bufferParameters);
-            m_channelStateMatrix[inputHandle][outputHandle] = pState;
+            // Creating the state here would allocate memory in the
+            // engine thread, so pass the signal through unprocessed.
+            countMissingState();
+            if (pOutput != pInput) {
+                SampleUtil::copy(pOutput, pInput,
+                        bufferParameters.samplesPerBuffer());
+            }
+            return;
         }
         processChannel(inputHandle, pState, pInput, pOutput, bufferParameters,
                        enableState, groupFeatures);
     }
 
+    void processPlanar(const ChannelHandle& inputHandle,
+                       const ChannelHandle& outputHandle,
+                       const CSAMPLE* const* pInputs,
+                       CSAMPLE* const* pOutputs,
+                       const mixxx::EngineParameters& bufferParameters,
+                       const EffectEnableState enableState,
+                       const GroupFeatureState& groupFeatures) final {
+        EffectSpecificState* pState = m_channelStateMatrix[inputHandle][outputHandle];
+        VERIFY_OR_DEBUG_ASSERT(pState != nullptr) {
+            // See process()
+            countMissingState();
+            for (int i = 0; i < bufferParameters.channelCount(); ++i) {
+                if (pOutputs[i] != pInputs[i]) {
+                    SampleUtil::copy(pOutputs[i], pInputs[i],
+                            bufferParameters.framesPerBuffer());
+                }
+            }
+            return;
+        }
+        processChannelPlanar(inputHandle, pState, pInputs, pOutputs,
+                bufferParameters, enableState, groupFeatures);
+    }
+
     void initialize(const QSet<ChannelHandleAndGroup>& activeInputChannels,
             EffectsManager* pEffectsManager,
             const mixxx::EngineParameters& bufferParameters) final {
+        // Allocate the memory for the states of all active input channels
+        // and one more at once. The chain is usually enabled for another
+        // input channel later.
+        const int numOutputChannels =
+                pEffectsManager->registeredOutputChannels().size();
+        m_statePool.reserve((activeInputChannels.size() + 1) * numOutputChannels);
         for (const ChannelHandleAndGroup& inputChannel : activeInputChannels) {
             if (kEffectDebugOutput) {
                 qDebug() << this << "EffectProcessorImpl::initialize allocating "
@@ -263,9 +378,15 @@ class EffectProcessorImpl : public EffectProcessor {
     };
 
   private:
+    // Counts the buffers that have been passed through unprocessed,
+    // because the state has not been created in advance
+    void countMissingState() const {
+        Counter(m_missingStateTag).increment();
+    }
 
     EffectSpecificState* createSpecificState(const mixxx::EngineParameters& bufferParameters) {
-        EffectSpecificState* pState = new EffectSpecificState(bufferParameters);
+        EffectSpecificState* pState =
+                new (&m_statePool) EffectSpecificState(bufferParameters);
         if (kEffectDebugOutput) {
             qDebug() << this << "EffectProcessorImpl creating EffectState" << pState;
         }
@@ -273,7 +394,11 @@ class EffectProcessorImpl : public EffectProcessor {
     };
 
     EffectsManager* m_pEffectsManager;
+    // Must outlive the states, which are deleted by the destructor
+    EffectStatePool m_statePool;
     ChannelHandleMap<ChannelHandleMap<EffectSpecificState*>> m_channelStateMatrix;
+    // Interned by the constructor instead of in the audio callback
+    const StatTag m_missingStateTag;
 };
 
 #endif /* EFFECTPROCESSOR_H */
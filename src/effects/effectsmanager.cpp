@@ -36,6 +36,13 @@ EffectsManager::EffectsManager(QObject* pParent, UserSettingsPointer pConfig,
 
     m_pRequestPipe.reset(requestPipes.first);
     m_pEngineEffectsManager = new EngineEffectsManager(requestPipes.second);
+    if (pConfig) {
+        // Process the post-fader effects of independent channels on
+        // additional threads. Off by default.
+        m_pEngineEffectsManager->setParallelProcessingWorkers(
+                pConfig->getValue(
+                        ConfigKey("[Effects]", "ParallelProcessingWorkers"), 0));
+    }
 
     m_pNumEffectsAvailable = new ControlObject(ConfigKey("[Master]", "num_effectsavailable"));
     m_pNumEffectsAvailable->setReadOnly();
@@ -0,0 +1,120 @@
+#include "effects/effectstatepool.h"
+
+#include <cstdlib>
+#include <new>
+
+#include "util/assert.h"
+#include "util/counter.h"
+#include "util/math.h"
+
+namespace {
+
+// Slabs hold at least this many states, which covers the master and
+// headphone outputs of a few input channels.
+constexpr int kMinStatesPerSlab = 4;
+
+constexpr std::size_t roundUpToAlignment(std::size_t size) {
+    return (size + alignof(std::max_align_t) - 1) /
+            alignof(std::max_align_t) * alignof(std::max_align_t);
+}
+
+} // anonymous namespace
+
+EffectStatePool::EffectStatePool(std::size_t stateSize)
+        : m_stateSize(stateSize),
+          m_slotStride(sizeof(Slot) + roundUpToAlignment(stateSize)),
+          m_capacity(0),
+          m_freeSlots(nullptr),
+          m_numFreeSlots(0) {
+}
+
+EffectStatePool::~EffectStatePool() {
+    for (void* pSlab : m_slabs) {
+        std::free(pSlab);
+    }
+}
+
+void EffectStatePool::reserve(int numStates) {
+    const int missingStates = numStates - m_numFreeSlots.load();
+    if (missingStates > 0) {
+        addSlab(missingStates);
+    }
+}
+
+void* EffectStatePool::allocate(std::size_t size) {
+    VERIFY_OR_DEBUG_ASSERT(size <= m_stateSize) {
+        return allocateUnpooled(size);
+    }
+    Slot* pSlot = popFreeSlot();
+    if (!pSlot) {
+        addSlab(kMinStatesPerSlab);
+        pSlot = popFreeSlot();
+        DEBUG_ASSERT(pSlot);
+    }
+    return stateOf(pSlot);
+}
+
+// static
+void* EffectStatePool::allocateUnpooled(std::size_t size) {
+    Slot* pSlot = static_cast<Slot*>(std::malloc(sizeof(Slot) + size));
+    if (!pSlot) {
+        throw std::bad_alloc();
+    }
+    pSlot->pPool = nullptr;
+    pSlot->pNextFree = nullptr;
+    return stateOf(pSlot);
+}
+
+// static
+void EffectStatePool::deallocate(void* pState) {
+    if (!pState) {
+        return;
+    }
+    Slot* pSlot = slotOf(pState);
+    if (pSlot->pPool) {
+        pSlot->pPool->pushFreeSlot(pSlot);
+    } else {
+        std::free(pSlot);
+    }
+}
+
+void EffectStatePool::addSlab(int numStates) {
+    numStates = math_max(numStates, kMinStatesPerSlab);
+    char* pSlab = static_cast<char*>(std::malloc(numStates * m_slotStride));
+    if (!pSlab) {
+        throw std::bad_alloc();
+    }
+    m_slabs.push_back(pSlab);
+    m_capacity += numStates;
+    for (int i = 0; i < numStates; ++i) {
+        Slot* pSlot = reinterpret_cast<Slot*>(pSlab + i * m_slotStride);
+        pSlot->pPool = this;
+        pushFreeSlot(pSlot);
+    }
+    static const StatTag tag("EffectStatePool states allocated");
+    Counter(tag).increment(numStates);
+}
+
+void EffectStatePool::pushFreeSlot(Slot* pSlot) {
+    Slot* pTop = m_freeSlots.load(std::memory_order_relaxed);
+    do {
+        pSlot->pNextFree = pTop;
+    } while (!m_freeSlots.compare_exchange_weak(
+            pTop, pSlot, std::memory_order_release, std::memory_order_relaxed));
+    m_numFreeSlots.fetch_add(1);
+}
+
+// Only safe if this is the only thread that pops. Otherwise another thread
+// could pop pTop and its successor and push pTop again after pTop->pNextFree
+// has been read. The compare-exchange would then succeed and put the
+// popped successor back on top (ABA problem). Concurrent pushes are safe.
+EffectStatePool::Slot* EffectStatePool::popFreeSlot() {
+    Slot* pTop = m_freeSlots.load(std::memory_order_acquire);
+    while (pTop && !m_freeSlots.compare_exchange_weak(
+            pTop, pTop->pNextFree, std::memory_order_acquire)) {
+    }
+    if (pTop) {
+        m_numFreeSlots.fetch_sub(1);
+    }
+    return pTop;
+}
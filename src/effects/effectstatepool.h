@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// EffectStatePool provides the memory for the EffectStates of one
+// EffectProcessorImpl. Memory is allocated in slabs of several states on
+// the main thread and recycled when the states are deleted, e.g. when an
+// effect chain is disabled for an input channel. Enabling it again reuses
+// the memory instead of allocating it from the heap.
+//
+// allocate() and reserve() must only be called from the main thread.
+// The free list is a lock-free (Treiber) stack that is only correct with a
+// single popping thread. Deleting a state pushes its memory onto the stack
+// without locking or allocating, so states may also be deleted by the
+// engine thread.
+class EffectStatePool final {
+  public:
+    explicit EffectStatePool(std::size_t stateSize);
+    // All states must have been deleted before.
+    ~EffectStatePool();
+
+    // Makes sure that numStates states can be allocated without growing
+    // the pool.
+    void reserve(int numStates);
+
+    // Returns memory for one state of at most stateSize bytes. Grows the
+    // pool if no memory is available.
+    void* allocate(std::size_t size);
+
+    // The number of states that the slabs of the pool can hold
+    int capacity() const {
+        return m_capacity;
+    }
+    // The number of states that can be allocated without growing the pool
+    int numFreeStates() const {
+        return m_numFreeSlots.load();
+    }
+
+    // Allocates memory for a state that does not belong to a pool.
+    static void* allocateUnpooled(std::size_t size);
+
+    // Returns the memory from allocate() or allocateUnpooled().
+    static void deallocate(void* pState);
+
+  private:
+    // Precedes the memory of each state
+    struct alignas(std::max_align_t) Slot {
+        EffectStatePool* pPool;
+        Slot* pNextFree;
+    };
+
+    static Slot* slotOf(void* pState) {
+        return static_cast<Slot*>(pState) - 1;
+    }
+    static void* stateOf(Slot* pSlot) {
+        return pSlot + 1;
+    }
+
+    void addSlab(int numStates);
+    void pushFreeSlot(Slot* pSlot);
+    Slot* popFreeSlot();
+
+    const std::size_t m_stateSize;
+    const std::size_t m_slotStride;
+
+    // Only accessed by the main thread
+    std::vector<void*> m_slabs;
+    int m_capacity;
+
+    // Lock-free stack of free slots. Slots are pushed by any thread but
+    // only popped by the main thread, which avoids the ABA problem. See
+    // popFreeSlot().
+    std::atomic<Slot*> m_freeSlots;
+    std::atomic<int> m_numFreeSlots;
+};
@@ -1,24 +1,147 @@
 #include "effects/lv2/lv2backend.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+
 #include "effects/lv2/lv2manifest.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/performancetimer.h"
+#include "util/timer.h"
 
-LV2Backend::LV2Backend(QObject* pParent)
-        : EffectsBackend(pParent, EffectBackendType::LV2) {
-    m_pWorld = lilv_world_new();
-    initializeProperties();
-    lilv_world_load_all(m_pWorld);
-    enumeratePlugins();
+namespace {
+
+const mixxx::Logger kLogger("LV2Backend");
+
+// Increment when the format of the index or of LV2Manifest::toJson() changes
+constexpr int kPluginIndexVersion = 1;
+
+const QString kPluginIndexFileName = QStringLiteral("lv2_plugins.json");
+
+// The directories that lilv searches for bundles if LV2_PATH is not set
+QStringList defaultSearchDirectories() {
+#if defined(__WINDOWS__)
+    return {
+            QDir(QString::fromLocal8Bit(qgetenv("APPDATA"))).filePath("LV2"),
+            QDir(QString::fromLocal8Bit(qgetenv("COMMONPROGRAMFILES"))).filePath("LV2"),
+    };
+#elif defined(__APPLE__)
+    return {
+            QDir::home().filePath(".lv2"),
+            QDir::home().filePath("Library/Audio/Plug-Ins/LV2"),
+            "/usr/local/lib/lv2",
+            "/usr/lib/lv2",
+            "/Library/Audio/Plug-Ins/LV2",
+    };
+#else
+    return {
+            QDir::home().filePath(".lv2"),
+            "/usr/lib/lv2",
+            "/usr/local/lib/lv2",
+    };
+#endif
+}
+
+QStringList searchDirectories(const QString& lv2Path) {
+    if (lv2Path.isEmpty()) {
+        return defaultSearchDirectories();
+    }
+    QStringList directories;
+    for (QString directory : lv2Path.split(QDir::listSeparator(), QString::SkipEmptyParts)) {
+        if (directory.startsWith('~')) {
+            directory.replace(0, 1, QDir::homePath());
+        }
+        directories.append(directory);
+    }
+    return directories;
+}
+
+// Bundles are described by their Turtle files. A bundle directory changes
+// when files are added or removed, the Turtle files when they are edited.
+qint64 lastModified(const QString& path, bool includeTurtleFiles) {
+    const QFileInfo fileInfo(path);
+    if (!fileInfo.exists()) {
+        return -1;
+    }
+    qint64 timestamp = fileInfo.lastModified().toMSecsSinceEpoch();
+    if (includeTurtleFiles) {
+        const QFileInfoList turtleFiles = QDir(path).entryInfoList(
+                QStringList() << "*.ttl", QDir::Files);
+        for (const auto& turtleFile : turtleFiles) {
+            timestamp = math_max(timestamp,
+                    turtleFile.lastModified().toMSecsSinceEpoch());
+        }
+    }
+    return timestamp;
+}
+
+QJsonObject timestamps(const QStringList& paths, bool includeTurtleFiles) {
+    QJsonObject json;
+    for (const auto& path : paths) {
+        json[path] = lastModified(path, includeTurtleFiles);
+    }
+    return json;
+}
+
+bool timestampsUnchanged(const QJsonObject& json, bool includeTurtleFiles) {
+    for (auto it = json.constBegin(); it != json.constEnd(); ++it) {
+        if (lastModified(it.key(), includeTurtleFiles) !=
+                static_cast<qint64>(it.value().toDouble())) {
+            kLogger.debug() << it.key() << "has been modified";
+            return false;
+        }
+    }
+    return true;
+}
+
+QString currentLV2Path() {
+    return QString::fromLocal8Bit(qgetenv("LV2_PATH"));
+}
+
+} // anonymous namespace
+
+LV2Backend::LV2Backend(QObject* pParent, UserSettingsPointer pConfig)
+        : EffectsBackend(pParent, EffectBackendType::LV2),
+          m_pluginIndexPath(QDir(pConfig->getSettingsPath()).filePath(
+                  kPluginIndexFileName)),
+          m_pWorld(nullptr) {
+    PerformanceTimer timer;
+    timer.start();
+    if (!loadPluginIndex()) {
+        loadWorld();
+        enumeratePlugins();
+        savePluginIndex();
+    }
+    kLogger.info()
+            << "Found" << m_registeredEffects.size() << "plugins in"
+            << timer.elapsed().debugMillisWithUnit();
 }
 
 LV2Backend::~LV2Backend() {
     foreach(LilvNode* node, m_properties) {
         lilv_node_free(node);
     }
-    lilv_world_free(m_pWorld);
+    if (m_pWorld) {
+        lilv_world_free(m_pWorld);
+    }
     foreach(LV2Manifest* lv2Manifest, m_registeredEffects) {
         delete lv2Manifest;
     }
 }
 
+void LV2Backend::loadWorld() {
+    if (m_pWorld) {
+        return;
+    }
+    ScopedTimer t("LV2Backend::loadWorld");
+    m_pWorld = lilv_world_new();
+    initializeProperties();
+    lilv_world_load_all(m_pWorld);
+}
+
 void LV2Backend::enumeratePlugins() {
     const LilvPlugins *plugs = lilv_world_get_all_plugins(m_pWorld);
     LILV_FOREACH(plugins, i, plugs) {
@@ -43,6 +166,88 @@ void LV2Backend::initializeProperties() {
     m_properties["enumeration_port"] = lilv_new_uri(m_pWorld, LV2_CORE__enumeration);
 }
 
+bool LV2Backend::loadPluginIndex() {
+    QFile file(m_pluginIndexPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QJsonObject index = QJsonDocument::fromJson(file.readAll()).object();
+    if (index["version"].toInt() != kPluginIndexVersion ||
+            index["lv2Path"].toString() != currentLV2Path()) {
+        return false;
+    }
+    // A changed search directory indicates added or removed bundles
+    if (!timestampsUnchanged(index["directories"].toObject(), false) ||
+            !timestampsUnchanged(index["bundles"].toObject(), true)) {
+        return false;
+    }
+
+    for (const auto& pluginValue : index["plugins"].toArray()) {
+        LV2Manifest* lv2Manifest = new LV2Manifest(pluginValue.toObject());
+        lv2Manifest->getEffectManifest()->setBackendType(m_type);
+        m_registeredEffects.insert(lv2Manifest->getEffectManifest()->id(),
+                                   lv2Manifest);
+    }
+    return true;
+}
+
+void LV2Backend::savePluginIndex() const {
+    QStringList bundles;
+    QStringList directories = searchDirectories(currentLV2Path());
+    const LilvPlugins *plugs = lilv_world_get_all_plugins(m_pWorld);
+    LILV_FOREACH(plugins, i, plugs) {
+        const LilvPlugin *plug = lilv_plugins_get(plugs, i);
+        char* pPath = lilv_file_uri_parse(
+                lilv_node_as_uri(lilv_plugin_get_bundle_uri(plug)), nullptr);
+        if (!pPath) {
+            continue;
+        }
+        const QFileInfo bundle(QString::fromLocal8Bit(pPath));
+        lilv_free(pPath);
+        bundles.append(bundle.absoluteFilePath());
+        // Also covers bundles in directories that lilv was configured with
+        directories.append(bundle.absolutePath());
+    }
+    bundles.removeDuplicates();
+    directories.removeDuplicates();
+
+    QJsonArray plugins;
+    foreach (LV2Manifest* lv2Manifest, m_registeredEffects) {
+        plugins.append(lv2Manifest->toJson());
+    }
+
+    QJsonObject index;
+    index["version"] = kPluginIndexVersion;
+    index["lv2Path"] = currentLV2Path();
+    index["directories"] = timestamps(directories, false);
+    index["bundles"] = timestamps(bundles, true);
+    index["plugins"] = plugins;
+
+    QFile file(m_pluginIndexPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning()
+                << "Failed to write plugin index"
+                << m_pluginIndexPath;
+        return;
+    }
+    file.write(QJsonDocument(index).toJson(QJsonDocument::Compact));
+}
+
+const LilvPlugin* LV2Backend::getPlugin(LV2Manifest* pLV2Manifest) {
+    if (pLV2Manifest->getPlugin()) {
+        return pLV2Manifest->getPlugin();
+    }
+    // The manifest was restored from the plugin index
+    loadWorld();
+    LilvNode* pUri = lilv_new_uri(m_pWorld,
+            pLV2Manifest->getEffectManifest()->id().toUtf8().constData());
+    const LilvPlugin* pPlugin = lilv_plugins_get_by_uri(
+            lilv_world_get_all_plugins(m_pWorld), pUri);
+    lilv_node_free(pUri);
+    pLV2Manifest->setPlugin(pPlugin);
+    return pPlugin;
+}
+
 const QList<QString> LV2Backend::getEffectIds() const {
     QList<QString> availableEffects;
     foreach (LV2Manifest* lv2Manifest, m_registeredEffects) {
@@ -89,6 +294,12 @@ EffectPointer LV2Backend::instantiateEffect(EffectsManager* pEffectsManager,
         return EffectPointer();
     }
     LV2Manifest* lv2manifest = m_registeredEffects[effectId];
+    const LilvPlugin* pPlugin = getPlugin(lv2manifest);
+    if (!pPlugin) {
+        // The bundle has been removed since the plugin index was checked
+        qWarning() << "WARNING: Effect" << effectId << "is not installed.";
+        return EffectPointer();
+    }
 
     return EffectPointer(
         new Effect(
@@ -96,7 +307,7 @@ EffectPointer LV2Backend::instantiateEffect(EffectsManager* pEffectsManager,
                 lv2manifest->getEffectManifest(),
                 EffectInstantiatorPointer(
                         new LV2EffectProcessorInstantiator(
-                                lv2manifest->getPlugin(),
+                                pPlugin,
                                 lv2manifest->getAudioPortIndices(),
                                 lv2manifest->getControlPortIndices()))));
 }
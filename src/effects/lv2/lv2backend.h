@@ -7,13 +7,16 @@
 #include "preferences/usersettings.h"
 #include <lilv-0/lilv/lilv.h>
 
+// The manifests of the installed plugins are stored in a plugin index in the
+// settings directory. As long as no LV2 bundle has been added, removed or
+// modified since, the manifests are restored from the index and the lilv
+// world is only loaded when an LV2 effect is instantiated.
 class LV2Backend : public EffectsBackend {
     Q_OBJECT
   public:
-    LV2Backend(QObject* pParent);
+    LV2Backend(QObject* pParent, UserSettingsPointer pConfig);
     virtual ~LV2Backend();
 
-    void enumeratePlugins();
     const QList<QString> getEffectIds() const;
     const QSet<QString> getDiscoveredPluginIds() const;
     EffectManifestPointer getManifest(const QString& effectId) const;
@@ -23,7 +26,16 @@ class LV2Backend : public EffectsBackend {
                                     const QString& effectId);
 
   private:
+    void loadWorld();
     void initializeProperties();
+    void enumeratePlugins();
+    const LilvPlugin* getPlugin(LV2Manifest* pLV2Manifest);
+
+    // Returns false if the index is missing or outdated
+    bool loadPluginIndex();
+    void savePluginIndex() const;
+
+    const QString m_pluginIndexPath;
     LilvWorld* m_pWorld;
     QHash<QString, LilvNode*> m_properties;
     QHash<QString, LV2Manifest*> m_registeredEffects;
@@ -89,15 +89,10 @@ void LV2EffectProcessor::initialize(
     DEBUG_ASSERT(m_pEffectsManager != nullptr);
 }
 
-void LV2EffectProcessor::process(const ChannelHandle& inputHandle,
+LV2EffectGroupState* LV2EffectProcessor::getGroupState(
+        const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
-        const CSAMPLE* pInput, CSAMPLE* pOutput,
-        const mixxx::EngineParameters& bufferParameters,
-        const EffectEnableState enableState,
-        const GroupFeatureState& groupFeatures) {
-    Q_UNUSED(groupFeatures);
-    Q_UNUSED(enableState);
-
+        const mixxx::EngineParameters& bufferParameters) {
     LV2EffectGroupState* pState = m_channelStateMatrix[inputHandle][outputHandle];
     VERIFY_OR_DEBUG_ASSERT(pState != nullptr) {
         if (kEffectDebugOutput) {
@@ -110,31 +105,64 @@ void LV2EffectProcessor::process(const ChannelHandle& inputHandle,
         pState = createGroupState(bufferParameters);
         m_channelStateMatrix[inputHandle][outputHandle] = pState;
     }
+    return pState;
+}
 
-    if (!pState) {
-        SampleUtil::copyWithGain(pOutput, pInput, 1.0, bufferParameters.samplesPerBuffer());
+void LV2EffectProcessor::process(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        const CSAMPLE* pInput, CSAMPLE* pOutput,
+        const mixxx::EngineParameters& bufferParameters,
+        const EffectEnableState enableState,
+        const GroupFeatureState& groupFeatures) {
+    SampleUtil::deinterleaveBuffer(m_inputL, m_inputR, pInput,
+            bufferParameters.framesPerBuffer());
+
+    const CSAMPLE* const pInputs[] = {m_inputL, m_inputR};
+    CSAMPLE* const pOutputs[] = {m_outputL, m_outputR};
+    processPlanar(inputHandle, outputHandle, pInputs, pOutputs,
+            bufferParameters, enableState, groupFeatures);
+
+    SampleUtil::interleaveBuffer(pOutput, m_outputL, m_outputR,
+            bufferParameters.framesPerBuffer());
+}
+
+void LV2EffectProcessor::processPlanar(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        const CSAMPLE* const* pInputs,
+        CSAMPLE* const* pOutputs,
+        const mixxx::EngineParameters& bufferParameters,
+        const EffectEnableState enableState,
+        const GroupFeatureState& groupFeatures) {
+    Q_UNUSED(groupFeatures);
+    Q_UNUSED(enableState);
+
+    LV2EffectGroupState* pState = getGroupState(
+            inputHandle, outputHandle, bufferParameters);
+    LilvInstance* handle = pState ? pState->lilvIinstance() : nullptr;
+    if (!handle) {
+        for (int i = 0; i < bufferParameters.channelCount(); ++i) {
+            SampleUtil::copy(pOutputs[i], pInputs[i],
+                    bufferParameters.framesPerBuffer());
+        }
         return;
-    } 
+    }
 
     for (int i = 0; i < m_parameters.size(); i++) {
         m_params[i] = m_parameters[i]->value();
     }
 
-    int j = 0;
-    for (unsigned int i = 0; i < bufferParameters.samplesPerBuffer(); i += 2) {
-        m_inputL[j] = pInput[i];
-        m_inputR[j] = pInput[i + 1];
-        j++;
-    }
-
-    lilv_instance_run(pState->lilvIinstance(), bufferParameters.framesPerBuffer());
+    // Connecting ports is real-time safe and allowed before every run.
+    // Plugins must not write to input ports.
+    // We assume the audio ports are in the following order:
+    // input_left, input_right, output_left, output_right
+    lilv_instance_connect_port(handle, m_audioPortIndices[0],
+            const_cast<CSAMPLE*>(pInputs[0]));
+    lilv_instance_connect_port(handle, m_audioPortIndices[1],
+            const_cast<CSAMPLE*>(pInputs[1]));
+    lilv_instance_connect_port(handle, m_audioPortIndices[2], pOutputs[0]);
+    lilv_instance_connect_port(handle, m_audioPortIndices[3], pOutputs[1]);
 
-    j = 0;
-    for (unsigned int i = 0; i < bufferParameters.samplesPerBuffer(); i += 2) {
-        pOutput[i] = m_outputL[j];
-        pOutput[i + 1] = m_outputR[j];
-        j++;
-    }
+    lilv_instance_run(handle, bufferParameters.framesPerBuffer());
 }
 
 LV2EffectGroupState* LV2EffectProcessor::createGroupState(const mixxx::EngineParameters& bufferParameters) {
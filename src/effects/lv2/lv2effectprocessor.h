@@ -52,8 +52,26 @@ class LV2EffectProcessor : public EffectProcessor {
             const mixxx::EngineParameters& bufferParameters,
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
+    // Connects the audio ports to the planar buffers of the chain
+    void processPlanar(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            const CSAMPLE* const* pInputs,
+            CSAMPLE* const* pOutputs,
+            const mixxx::EngineParameters& bufferParameters,
+            const EffectEnableState enableState,
+            const GroupFeatureState& groupFeatures) override;
+    bool supportsPlanarBuffers() const override {
+        return true;
+    }
+    // The port buffers are shared by all channels
+    bool canProcessChannelsConcurrently() const override {
+        return false;
+    }
   private:
     LV2EffectGroupState* createGroupState(const mixxx::EngineParameters& bufferParameters);
+    LV2EffectGroupState* getGroupState(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            const mixxx::EngineParameters& bufferParameters);
 
     QList<EngineEffectParameter*> m_parameters;
     float* m_inputL;
@@ -1,7 +1,36 @@
 #include "effects/lv2/lv2manifest.h"
+
+#include <QJsonArray>
+#include <limits>
+
 #include "effects/effectmanifestparameter.h"
 #include "util/math.h"
 
+namespace {
+
+QJsonArray intListToJson(const QList<int>& list) {
+    QJsonArray array;
+    for (int value : list) {
+        array.append(value);
+    }
+    return array;
+}
+
+QList<int> intListFromJson(const QJsonArray& array) {
+    QList<int> list;
+    for (const auto& value : array) {
+        list.append(value.toInt());
+    }
+    return list;
+}
+
+// JSON has no NaN, Qt writes it as null
+double doubleFromJson(const QJsonValue& value) {
+    return value.toDouble(std::numeric_limits<double>::quiet_NaN());
+}
+
+} // anonymous namespace
+
 LV2Manifest::LV2Manifest(const LilvPlugin* plug,
                          QHash<QString, LilvNode*>& properties)
         : m_pEffectManifest(new EffectManifest()),
@@ -155,6 +184,72 @@ LV2Manifest::LV2Manifest(const LilvPlugin* plug,
     lilv_nodes_free(features);
 }
 
+LV2Manifest::LV2Manifest(const QJsonObject& json)
+        : m_pLV2plugin(nullptr),
+          m_pEffectManifest(new EffectManifest()),
+          audioPortIndices(intListFromJson(json["audioPorts"].toArray())),
+          controlPortIndices(intListFromJson(json["controlPorts"].toArray())),
+          m_minimum(nullptr),
+          m_maximum(nullptr),
+          m_default(nullptr),
+          m_status(static_cast<Status>(json["status"].toInt(AVAILABLE))) {
+    m_pEffectManifest->setId(json["id"].toString());
+    m_pEffectManifest->setName(json["name"].toString());
+    m_pEffectManifest->setAuthor(json["author"].toString());
+
+    for (const auto& parameterValue : json["parameters"].toArray()) {
+        const QJsonObject parameterJson = parameterValue.toObject();
+        EffectManifestParameterPointer param = m_pEffectManifest->addParameter();
+        param->setName(parameterJson["name"].toString());
+        param->setId(parameterJson["id"].toString());
+        param->setSemanticHint(EffectManifestParameter::SemanticHint::UNKNOWN);
+        param->setUnitsHint(EffectManifestParameter::UnitsHint::UNKNOWN);
+        param->setControlHint(static_cast<EffectManifestParameter::ControlHint>(
+                parameterJson["controlHint"].toInt()));
+        param->setDefault(doubleFromJson(parameterJson["default"]));
+        param->setMinimum(doubleFromJson(parameterJson["minimum"]));
+        param->setMaximum(doubleFromJson(parameterJson["maximum"]));
+        for (const auto& stepValue : parameterJson["steps"].toArray()) {
+            const QJsonObject stepJson = stepValue.toObject();
+            param->appendStep(qMakePair(
+                    stepJson["label"].toString(),
+                    doubleFromJson(stepJson["value"])));
+        }
+    }
+}
+
+QJsonObject LV2Manifest::toJson() const {
+    QJsonArray parameters;
+    for (const auto& param : m_pEffectManifest->parameters()) {
+        QJsonArray steps;
+        for (const auto& step : param->getSteps()) {
+            QJsonObject stepJson;
+            stepJson["label"] = step.first;
+            stepJson["value"] = step.second;
+            steps.append(stepJson);
+        }
+        QJsonObject parameterJson;
+        parameterJson["name"] = param->name();
+        parameterJson["id"] = param->id();
+        parameterJson["controlHint"] = static_cast<int>(param->controlHint());
+        parameterJson["default"] = param->getDefault();
+        parameterJson["minimum"] = param->getMinimum();
+        parameterJson["maximum"] = param->getMaximum();
+        parameterJson["steps"] = steps;
+        parameters.append(parameterJson);
+    }
+
+    QJsonObject json;
+    json["id"] = m_pEffectManifest->id();
+    json["name"] = m_pEffectManifest->name();
+    json["author"] = m_pEffectManifest->author();
+    json["status"] = static_cast<int>(m_status);
+    json["audioPorts"] = intListToJson(audioPortIndices);
+    json["controlPorts"] = intListToJson(controlPortIndices);
+    json["parameters"] = parameters;
+    return json;
+}
+
 LV2Manifest::~LV2Manifest() {
     delete m_minimum;
     delete m_maximum;
@@ -177,6 +272,10 @@ const LilvPlugin* LV2Manifest::getPlugin() {
     return m_pLV2plugin;
 }
 
+void LV2Manifest::setPlugin(const LilvPlugin* pPlugin) {
+    m_pLV2plugin = pPlugin;
+}
+
 LV2Manifest::Status LV2Manifest::getStatus() {
     return m_status;
 }
@@ -1,6 +1,8 @@
 #ifndef LV2MANIFEST_H
 #define LV2MANIFEST_H
 
+#include <QJsonObject>
+
 #include "effects/effectmanifest.h"
 #include "effects/defs.h"
 #include <lilv-0/lilv/lilv.h>
@@ -14,11 +16,19 @@ class LV2Manifest {
     };
 
     LV2Manifest(const LilvPlugin* plug, QHash<QString, LilvNode*>& properties);
+    // Restores a manifest from the plugin index without loading the plugin.
+    // getPlugin() returns nullptr until the plugin is set.
+    explicit LV2Manifest(const QJsonObject& json);
     ~LV2Manifest();
+
+    // The entry of the plugin index
+    QJsonObject toJson() const;
+
     EffectManifestPointer getEffectManifest() const;
     QList<int> getAudioPortIndices();
     QList<int> getControlPortIndices();
     const LilvPlugin* getPlugin();
+    void setPlugin(const LilvPlugin* pPlugin);
     bool isValid();
     Status getStatus();
 
@@ -0,0 +1,306 @@
+#include "encoder/sharedencoder.h"
+
+#include <QMutexLocker>
+
+#include <algorithm>
+
+#include "util/logger.h"
+#include "util/math.h"
+
+namespace {
+
+const mixxx::Logger kLogger("SharedEncoder");
+
+QMutex s_registryMutex;
+QHash<QString, std::weak_ptr<SharedEncoder>> s_registry;
+
+// Broadcast encoders are fed interleaved stereo samples, see
+// EncoderMp3::encodeBuffer()
+constexpr int kChannels = 2;
+
+// The most recently encoded samples that are kept for finding the position
+// of clients that join the stream, about 0.2 s of audio.
+constexpr int kHistorySamples = 16384;
+
+// The number of samples that need to match to find the position of a client
+// in the history
+constexpr int kMatchSamples = 64;
+
+} // anonymous namespace
+
+// The Encoder handed out to each output. All work is delegated to the
+// SharedEncoder.
+class SharedEncoder::Client final : public Encoder {
+  public:
+    Client(std::shared_ptr<SharedEncoder> pShared, EncoderCallback* pSink)
+            : m_pShared(std::move(pShared)),
+              m_pSink(pSink) {
+        m_pShared->attach(this);
+    }
+
+    ~Client() override {
+        m_pShared->detach(this);
+    }
+
+    int initEncoder(int samplerate, QString errorMessage) override {
+        return m_pShared->initEncoder(samplerate, errorMessage);
+    }
+
+    void encodeBuffer(const CSAMPLE* samples, const int size) override {
+        m_pShared->encodeBuffer(this, samples, size);
+    }
+
+    void updateMetaData(const QString& artist, const QString& title,
+                        const QString& album) override {
+        // Shared streams do not carry in-band metadata. Outputs that need it,
+        // e.g. ShoutConnection, send it on their own.
+        Q_UNUSED(artist);
+        Q_UNUSED(title);
+        Q_UNUSED(album);
+    }
+
+    void flush() override {
+        // Flushing would terminate the stream for all other clients.
+    }
+
+    void setEncoderSettings(const EncoderSettings& settings) override {
+        // The settings are applied by the EncoderCreator and are part of the
+        // key.
+        Q_UNUSED(settings);
+    }
+
+  private:
+    friend class SharedEncoder;
+
+    const std::shared_ptr<SharedEncoder> m_pShared;
+    EncoderCallback* const m_pSink;
+    // The following members are guarded by the m_mutex of m_pShared.
+    // Set when the client has joined the stream.
+    bool m_bStreaming = false;
+    // Stream position of the next sample passed to encodeBuffer()
+    qint64 m_streamPosition = 0;
+    // Sequence number of the next packet that needs to be written
+    qint64 m_nextPacket = 0;
+};
+
+// static
+EncoderPointer SharedEncoder::createClient(const QString& key,
+        EncoderCallback* pSink,
+        const EncoderCreator& createEncoder) {
+    std::shared_ptr<SharedEncoder> pShared;
+    {
+        QMutexLocker locker(&s_registryMutex);
+        pShared = s_registry.value(key).lock();
+        if (!pShared) {
+            pShared = std::shared_ptr<SharedEncoder>(new SharedEncoder(key));
+            pShared->m_pEncoder = createEncoder(pShared.get());
+            if (!pShared->m_pEncoder) {
+                return EncoderPointer();
+            }
+            s_registry.insert(key, pShared);
+        } else {
+            kLogger.debug() << "Sharing encoder" << key;
+        }
+    }
+    return std::make_shared<Client>(std::move(pShared), pSink);
+}
+
+// static
+int SharedEncoder::clientCount(const QString& key) {
+    std::shared_ptr<SharedEncoder> pShared;
+    {
+        QMutexLocker locker(&s_registryMutex);
+        pShared = s_registry.value(key).lock();
+    }
+    if (!pShared) {
+        return 0;
+    }
+    QMutexLocker locker(&pShared->m_mutex);
+    return pShared->m_clients.size();
+}
+
+SharedEncoder::SharedEncoder(const QString& key)
+        : m_key(key),
+          m_bInitialized(false),
+          m_initResult(0),
+          m_encodedSamples(0),
+          m_firstPacket(0) {
+}
+
+SharedEncoder::~SharedEncoder() {
+    // Destroying the encoder may flush it. There are no clients anymore that
+    // could receive the packets, so they are discarded with m_packets.
+    m_pEncoder.reset();
+
+    QMutexLocker locker(&s_registryMutex);
+    auto it = s_registry.find(m_key);
+    // The key may already have been taken over by a new instance.
+    if (it != s_registry.end() && it.value().expired()) {
+        s_registry.erase(it);
+    }
+}
+
+void SharedEncoder::attach(Client* pClient) {
+    QMutexLocker locker(&m_mutex);
+    m_clients.append(pClient);
+}
+
+void SharedEncoder::detach(Client* pClient) {
+    QMutexLocker locker(&m_mutex);
+    m_clients.removeAll(pClient);
+    dropConsumedPackets();
+}
+
+int SharedEncoder::initEncoder(int samplerate, QString errorMessage) {
+    QMutexLocker locker(&m_mutex);
+    if (!m_bInitialized) {
+        m_initResult = m_pEncoder->initEncoder(samplerate, errorMessage);
+        m_bInitialized = true;
+    }
+    return m_initResult;
+}
+
+void SharedEncoder::encodeBuffer(Client* pClient,
+        const CSAMPLE* samples, const int size) {
+    QList<QByteArray> packets;
+    {
+        QMutexLocker locker(&m_mutex);
+        const qint64 nextPacket = m_firstPacket + m_packets.size();
+        if (pClient->m_bStreaming &&
+                nextPacket - pClient->m_nextPacket > kMaxPendingPackets) {
+            kLogger.debug() << m_key << "resynchronizing" << pClient;
+            pClient->m_bStreaming = false;
+        }
+        if (!pClient->m_bStreaming) {
+            joinStream(pClient, samples, size);
+        }
+
+        const qint64 endPosition = pClient->m_streamPosition + size;
+        if (endPosition > m_encodedSamples) {
+            // Skip the samples that another client has already encoded
+            const int encodedSize = static_cast<int>(math_max<qint64>(
+                    m_encodedSamples - pClient->m_streamPosition, 0));
+            m_recentBuffers.append(EncodedBuffer{m_encodedSamples, nextPacket});
+            if (m_bInitialized && m_initResult >= 0) {
+                // The packets are appended to m_packets in write().
+                m_pEncoder->encodeBuffer(samples + encodedSize, size - encodedSize);
+            }
+            m_encodedSamples = endPosition;
+            appendHistory(samples + encodedSize, size - encodedSize);
+        }
+        pClient->m_streamPosition = endPosition;
+
+        // QByteArray is implicitly shared, so this does not copy the data.
+        packets = m_packets.mid(static_cast<int>(pClient->m_nextPacket - m_firstPacket));
+        pClient->m_nextPacket = m_firstPacket + m_packets.size();
+        dropConsumedPackets();
+    }
+
+    // Write outside of the lock, the sink may block on the network.
+    for (const QByteArray& packet : packets) {
+        pClient->m_pSink->write(nullptr,
+                reinterpret_cast<const unsigned char*>(packet.constData()),
+                0, packet.size());
+    }
+}
+
+void SharedEncoder::joinStream(Client* pClient, const CSAMPLE* samples, int size) {
+    // The clients receive the same audio at about the same time. Another
+    // client may already have encoded the first samples of this client, so
+    // they are looked up in the newest encoded samples, newest match first.
+    // Otherwise this client is ahead and continues the stream.
+    const int historySize = static_cast<int>(m_history.size());
+    const int matchSize = math_min(size, kMatchSamples);
+    qint64 position = m_encodedSamples;
+    // Positions are frame aligned
+    const int minDistance = (matchSize + kChannels - 1) / kChannels * kChannels;
+    for (int distance = minDistance;
+            matchSize > 0 && distance <= historySize;
+            distance += kChannels) {
+        const CSAMPLE* pHistory = m_history.data() + historySize - distance;
+        if (std::equal(samples, samples + matchSize, pHistory)) {
+            position = m_encodedSamples - distance;
+            break;
+        }
+    }
+
+    // Start with the packets of the buffer that contains the position, which
+    // may contain a few samples before it.
+    qint64 nextPacket = m_firstPacket + m_packets.size();
+    if (position < m_encodedSamples) {
+        for (int i = m_recentBuffers.size() - 1; i >= 0; --i) {
+            if (m_recentBuffers[i].startPosition <= position) {
+                nextPacket = m_recentBuffers[i].firstPacket;
+                break;
+            }
+        }
+    }
+
+    pClient->m_bStreaming = true;
+    pClient->m_streamPosition = position;
+    pClient->m_nextPacket = nextPacket;
+}
+
+void SharedEncoder::appendHistory(const CSAMPLE* samples, int size) {
+    m_history.insert(m_history.end(), samples, samples + size);
+    if (m_history.size() > static_cast<size_t>(kHistorySamples)) {
+        m_history.erase(m_history.begin(),
+                m_history.end() - kHistorySamples);
+    }
+    // Keep the buffer that contains the oldest sample of the history
+    const qint64 historyStart =
+            m_encodedSamples - static_cast<qint64>(m_history.size());
+    while (m_recentBuffers.size() > 1 &&
+            m_recentBuffers[1].startPosition <= historyStart) {
+        m_recentBuffers.removeFirst();
+    }
+}
+
+void SharedEncoder::dropConsumedPackets() {
+    // Clients that have not joined the stream yet don't need any packets.
+    // Clients that fall too far behind are resynchronized and skip them.
+    // The packets of the history are kept for joining clients.
+    const qint64 nextPacket = m_firstPacket + m_packets.size();
+    qint64 firstNeededPacket = m_recentBuffers.isEmpty()
+            ? nextPacket : m_recentBuffers.first().firstPacket;
+    for (const Client* pClient : m_clients) {
+        if (pClient->m_bStreaming &&
+                nextPacket - pClient->m_nextPacket <= kMaxPendingPackets) {
+            firstNeededPacket = math_min(firstNeededPacket, pClient->m_nextPacket);
+        }
+    }
+    while (m_firstPacket < firstNeededPacket) {
+        m_packets.removeFirst();
+        ++m_firstPacket;
+    }
+}
+
+void SharedEncoder::write(const unsigned char* header, const unsigned char* body,
+                          int headerLen, int bodyLen) {
+    if (headerLen + bodyLen <= 0) {
+        return;
+    }
+    QByteArray packet;
+    packet.reserve(headerLen + bodyLen);
+    if (headerLen > 0) {
+        packet.append(reinterpret_cast<const char*>(header), headerLen);
+    }
+    if (bodyLen > 0) {
+        packet.append(reinterpret_cast<const char*>(body), bodyLen);
+    }
+    m_packets.append(packet);
+}
+
+int SharedEncoder::tell() {
+    // Shared streams are not seekable.
+    return -1;
+}
+
+void SharedEncoder::seek(int pos) {
+    Q_UNUSED(pos);
+    DEBUG_ASSERT(!"SharedEncoder does not support seeking");
+}
+
+int SharedEncoder::filelen() {
+    return 0;
+}
@@ -0,0 +1,110 @@
+#ifndef ENCODER_SHAREDENCODER_H
+#define ENCODER_SHAREDENCODER_H
+
+#include <functional>
+#include <vector>
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "util/memory.h"
+
+// SharedEncoder lets several outputs that encode the same audio with
+// identical settings share a single encoder instance. Every output gets a
+// lightweight client Encoder from createClient(). Clients created with the
+// same key are backed by one real encoder: the audio is encoded once and the
+// encoded packets are fanned out to the EncoderCallback of every client.
+//
+// Each client is expected to be driven from its own thread with the same
+// audio stream. There is no dedicated encoding client. Every client keeps
+// track of its position in the audio stream, and whichever client first
+// passes audio beyond the encoded position feeds it to the real encoder.
+// Audio that has already been encoded is skipped. So a client that stops
+// encoding, e.g. because its connection is down, neither stalls the other
+// clients nor causes audio to be encoded twice.
+//
+// When a client first encodes, its position is found by looking up its
+// audio among the most recently encoded samples. It starts with the packets
+// from there on. A client that falls kMaxPendingPackets behind, e.g. because
+// its connection stalls, joins the stream again instead of sending stale
+// packets.
+//
+// Only encodings whose output can be joined at any packet boundary may be
+// shared. MP3 streams qualify; Ogg streams do not, because every stream
+// needs its own headers. Encoders that seek in their output (e.g. the LAME
+// tag written at the end of a recording) must never be shared.
+class SharedEncoder final : public EncoderCallback {
+  public:
+    typedef std::function<EncoderPointer(EncoderCallback* pCallback)> EncoderCreator;
+
+    // Clients that have this many packets waiting, e.g. because their
+    // connection stalls, drop them and continue with the newest packet.
+    // 64 MP3 frames are about 1.5 s of audio.
+    static const int kMaxPendingPackets = 64;
+
+    // Returns an Encoder that writes the encoded audio to pSink. If a client
+    // for key already exists, the new client shares its encoder. Otherwise
+    // createEncoder is invoked to create the encoder. The key must capture
+    // everything that affects the encoded output, e.g. format, sample rate,
+    // bitrate and channel mode.
+    static EncoderPointer createClient(const QString& key,
+            EncoderCallback* pSink,
+            const EncoderCreator& createEncoder);
+
+    // Returns the number of clients that are currently sharing the encoder
+    // for key.
+    static int clientCount(const QString& key);
+
+    ~SharedEncoder() override;
+
+    // EncoderCallback, called by the real encoder with m_mutex held.
+    void write(const unsigned char* header, const unsigned char* body,
+               int headerLen, int bodyLen) override;
+    int tell() override;
+    void seek(int pos) override;
+    int filelen() override;
+
+  private:
+    class Client;
+
+    explicit SharedEncoder(const QString& key);
+
+    void attach(Client* pClient);
+    void detach(Client* pClient);
+    int initEncoder(int samplerate, QString errorMessage);
+    void encodeBuffer(Client* pClient, const CSAMPLE* samples, const int size);
+    void joinStream(Client* pClient, const CSAMPLE* samples, int size);
+    void appendHistory(const CSAMPLE* samples, int size);
+    void dropConsumedPackets();
+
+    // The input of one call of the real encoder
+    struct EncodedBuffer {
+        qint64 startPosition;
+        // Sequence number of the first packet written after it was encoded
+        qint64 firstPacket;
+    };
+
+    const QString m_key;
+    QMutex m_mutex;
+    EncoderPointer m_pEncoder;
+    bool m_bInitialized;
+    int m_initResult;
+    QList<Client*> m_clients;
+    // Stream position up to which the audio has been encoded, in samples
+    qint64 m_encodedSamples;
+    // The newest encoded samples, which end at m_encodedSamples
+    std::vector<CSAMPLE> m_history;
+    // The encoded buffers that overlap with m_history
+    QList<EncodedBuffer> m_recentBuffers;
+    // Encoded packets that have not been written by all clients yet.
+    // m_packets.first() has the sequence number m_firstPacket.
+    QList<QByteArray> m_packets;
+    qint64 m_firstPacket;
+};
+
+#endif // ENCODER_SHAREDENCODER_H
@@ -19,22 +19,89 @@ namespace {
 // This is the default increment from RubberBand 1.8.1.
 size_t kRubberBandBlockSize = 256;
 
+// Tempo and pitch must not change for this long before the audio is
+// rendered ahead.
+constexpr double kRenderAheadSteadySeconds = 1.0;
+
+// Distance between the read position and the start of the rendered audio.
+// The worker has this much time to render its first block.
+constexpr double kRenderAheadLeadSeconds = 0.5;
+
+// Rendered frames that overlap with the end of the real-time output
+constexpr SINT kOverlapFrames = 256;
+
+// Rendered frames that are faded into the real-time output after a fall back
+constexpr SINT kCrossfadeFrames = 256;
+
+// Interned up front instead of in the audio callback
+const StatTag kUnderflowTag("EngineBufferScaleRubberBand::getScaled underflow");
+const StatTag kRenderAheadUnderflowTag(
+        "EngineBufferScaleRubberBand::renderAhead underflow");
+
 }  // namespace
 
 EngineBufferScaleRubberBand::EngineBufferScaleRubberBand(
-        ReadAheadManager* pReadAheadManager)
+        ReadAheadManager* pReadAheadManager,
+        const QString& group)
         : m_pReadAheadManager(pReadAheadManager),
           m_buffer_back(SampleUtil::alloc(MAX_BUFFER_LEN)),
-          m_bBackwards(false) {
+          m_bBackwards(false),
+          m_dTimeRatio(1.0),
+          m_dPitchScale(1.0),
+          m_group(group),
+          m_renderAheadState(RenderAheadState::Off),
+          m_renderAheadGeneration(0),
+          m_renderAheadTimeRatio(0.0),
+          m_renderAheadPitchScale(0.0),
+          m_steadyFrames(0),
+          m_handoverFrame(0),
+          m_pBlock(nullptr),
+          m_blockOffset(0),
+          m_inputFramesDue(0.0),
+          m_drainFrames(0),
+          m_drainedFrames(0),
+          m_overlapFrames(0),
+          m_framesToDiscard(0),
+          m_crossfade_buffer(SampleUtil::alloc(
+                  kCrossfadeFrames * RubberBandRenderAhead::kChannels)),
+          m_crossfadeFrames(0),
+          m_crossfadeOffset(0) {
     m_retrieve_buffer[0] = SampleUtil::alloc(MAX_BUFFER_LEN);
     m_retrieve_buffer[1] = SampleUtil::alloc(MAX_BUFFER_LEN);
     initRubberBand();
 }
 
 EngineBufferScaleRubberBand::~EngineBufferScaleRubberBand() {
+    if (m_pRenderAhead) {
+        m_pRenderAhead->quitWait();
+    }
     SampleUtil::free(m_buffer_back);
     SampleUtil::free(m_retrieve_buffer[0]);
     SampleUtil::free(m_retrieve_buffer[1]);
+    SampleUtil::free(m_crossfade_buffer);
+}
+
+void EngineBufferScaleRubberBand::bindWorkers(
+        EngineWorkerScheduler* pWorkerScheduler) {
+    DEBUG_ASSERT(!m_pRenderAhead);
+    m_pRenderAhead = std::make_unique<RubberBandRenderAhead>(m_group);
+    m_pRenderAhead->setScheduler(pWorkerScheduler);
+    m_pRenderAhead->start(QThread::NormalPriority);
+}
+
+// WARNING: Called from the threads that load tracks
+void EngineBufferScaleRubberBand::newTrack(TrackPointer pTrack) {
+    if (!m_pRenderAhead) {
+        return;
+    }
+    m_pRenderAhead->newTrack(std::move(pTrack));
+}
+
+void EngineBufferScaleRubberBand::wakeWorkersIfNewTrack() {
+    if (!m_pRenderAhead) {
+        return;
+    }
+    m_pRenderAhead->wakeIfNewTrack();
 }
 
 void EngineBufferScaleRubberBand::initRubberBand() {
@@ -55,6 +122,7 @@ void EngineBufferScaleRubberBand::setScaleParameters(double base_rate,
                                                      double* pPitchRatio) {
     // Negative speed means we are going backwards. pitch does not affect
     // the playback direction.
+    const bool backwardsChanged = m_bBackwards != (*pTempoRatio < 0);
     m_bBackwards = *pTempoRatio < 0;
 
     // Due to a bug in RubberBand, setting the timeRatio to a large value can
@@ -109,20 +177,49 @@ void EngineBufferScaleRubberBand::setScaleParameters(double base_rate,
     m_dBaseRate = base_rate;
     m_dTempoRatio = speed_abs;
     m_dPitchRatio = *pPitchRatio;
+
+    // Rendering ahead only starts after the parameters have been steady
+    // for a while.
+    const double timeRatio =
+            timeRatioInverse > 0 ? 1.0 / timeRatioInverse : 0.0;
+    if (backwardsChanged ||
+            timeRatio != m_dTimeRatio ||
+            pitchScale != m_dPitchScale) {
+        m_steadyFrames = 0;
+    }
+    m_dTimeRatio = timeRatio;
+    m_dPitchScale = pitchScale;
 }
 
 void EngineBufferScaleRubberBand::setSampleRate(SINT iSampleRate) {
+    cancelRenderAhead();
     EngineBufferScale::setSampleRate(iSampleRate);
     initRubberBand();
 }
 
 void EngineBufferScaleRubberBand::clear() {
+    cancelRenderAhead();
+    m_framesToDiscard = 0;
+    m_crossfadeFrames = 0;
+    m_crossfadeOffset = 0;
     m_pRubberBand->reset();
 }
 
 SINT EngineBufferScaleRubberBand::retrieveAndDeinterleave(
         CSAMPLE* pBuffer,
         SINT frames) {
+    while (m_framesToDiscard > 0) {
+        const SINT frames_to_discard = math_min<SINT>(
+                math_min<SINT>(m_framesToDiscard, m_pRubberBand->available()),
+                MAX_BUFFER_LEN);
+        if (frames_to_discard <= 0) {
+            return 0;
+        }
+        m_pRubberBand->retrieve(
+                (float* const*)m_retrieve_buffer, frames_to_discard);
+        m_framesToDiscard -= frames_to_discard;
+    }
+
     SINT frames_available = m_pRubberBand->available();
     SINT frames_to_read = math_min(frames_available, frames);
     SINT received_frames = m_pRubberBand->retrieve(
@@ -155,10 +252,79 @@ double EngineBufferScaleRubberBand::scaleBuffer(
         return 0.0;
     }
 
+    switch (m_renderAheadState) {
+    case RenderAheadState::Off:
+        if (shouldStartRenderAhead()) {
+            requestRenderAhead();
+        }
+        break;
+    case RenderAheadState::Pending:
+        if (!renderAheadMatchesScaleParameters()) {
+            cancelRenderAhead();
+        }
+        break;
+    case RenderAheadState::Draining:
+        // Parameter changes are handled after draining
+        break;
+    case RenderAheadState::Active:
+        if (!renderAheadMatchesScaleParameters()) {
+            fallBackToRealTime(true);
+        }
+        break;
+    }
+
+    SINT total_received_frames = 0;
+    SINT remaining_frames = getAudioSignal().samples2frames(iOutputBufferSize);
+    CSAMPLE* read = pOutputBuffer;
+    while (remaining_frames > 0) {
+        const RenderAheadState state = m_renderAheadState;
+        SINT received_frames;
+        switch (state) {
+        case RenderAheadState::Draining:
+            received_frames = drainRealTimeStretcher(read, remaining_frames);
+            break;
+        case RenderAheadState::Active:
+            received_frames = playRenderedFrames(read, remaining_frames);
+            break;
+        default:
+            received_frames = stretchInRealTime(read, remaining_frames);
+            break;
+        }
+        remaining_frames -= received_frames;
+        total_received_frames += received_frames;
+        read += getAudioSignal().frames2samples(received_frames);
+        if (m_renderAheadState == state) {
+            // Only a state change leaves frames for the next pass
+            break;
+        }
+    }
+
+    if (remaining_frames > 0) {
+        SampleUtil::clear(read, getAudioSignal().frames2samples(remaining_frames));
+        Counter counter(kUnderflowTag);
+        counter.increment();
+    }
+
+    // framesRead is interpreted as the total number of virtual sample frames
+    // consumed to produce the scaled buffer. Due to this, we do not take into
+    // account directionality or starting point.
+    // NOTE(rryan): Why no m_dPitchAdjust here? Pitch does not change the time
+    // ratio. m_dSpeedAdjust is the ratio of unstretched time to stretched
+    // time. So, if we used total_received_frames in stretched time, then
+    // multiplying that by the ratio of unstretched time to stretched time
+    // will get us the unstretched sample frames read.
+    double framesRead = m_dBaseRate * m_dTempoRatio * total_received_frames;
+
+    return framesRead;
+}
+
+SINT EngineBufferScaleRubberBand::stretchInRealTime(
+        CSAMPLE* pOutputBuffer,
+        SINT frames) {
     SINT total_received_frames = 0;
     SINT total_read_frames = 0;
 
-    SINT remaining_frames = getAudioSignal().samples2frames(iOutputBufferSize);
+    SINT remaining_frames = frames;
     CSAMPLE* read = pOutputBuffer;
     bool last_read_failed = false;
     bool break_out_after_retrieve_and_reset_rubberband = false;
@@ -196,6 +362,27 @@ double EngineBufferScaleRubberBand::scaleBuffer(
         //qDebug() << "iLenFramesRequired" << iLenFramesRequired;
 
         if (remaining_frames > 0 && iLenFramesRequired > 0) {
+            if (m_renderAheadState == RenderAheadState::Pending) {
+                // Stop exactly at the input frame where the rendered audio
+                // takes over
+                const SINT framesToHandover = static_cast<SINT>(floor(
+                        m_handoverFrame -
+                        m_pReadAheadManager->getPlaypos() /
+                                RubberBandRenderAhead::kChannels));
+                if (framesToHandover <= 0) {
+                    if (framesToHandover == 0 && handOverToRenderAhead()) {
+                        break;
+                    }
+                    // The worker is late or a loop or jump skipped the
+                    // handover frame
+                    cancelRenderAhead();
+                } else {
+                    iLenFramesRequired = math_min<size_t>(
+                            iLenFramesRequired, framesToHandover);
+                }
+            }
+
+            const double playposBefore = m_pReadAheadManager->getPlaypos();
             SINT iAvailSamples = m_pReadAheadManager->getNextSamples(
                         // The value doesn't matter here. All that matters is we
                         // are going forward or backward.
@@ -203,6 +390,10 @@ double EngineBufferScaleRubberBand::scaleBuffer(
                         m_buffer_back,
                         getAudioSignal().frames2samples(iLenFramesRequired));
             SINT iAvailFrames = getAudioSignal().samples2frames(iAvailSamples);
+            if (m_renderAheadState == RenderAheadState::Pending &&
+                    m_pReadAheadManager->getPlaypos() != playposBefore + iAvailSamples) {
+                cancelRenderAhead();
+            }
 
             if (iAvailFrames > 0) {
                 last_read_failed = false;
@@ -221,21 +412,261 @@ double EngineBufferScaleRubberBand::scaleBuffer(
         }
     }
 
-    if (remaining_frames > 0) {
-        SampleUtil::clear(read, getAudioSignal().frames2samples(remaining_frames));
-        Counter counter("EngineBufferScaleRubberBand::getScaled underflow");
-        counter.increment();
+    m_steadyFrames += total_received_frames;
+
+    if (m_crossfadeOffset < m_crossfadeFrames) {
+        // Fade from the rendered audio that would have followed into the
+        // real-time output after a fall back. This may span callbacks.
+        const SINT crossfadeFrames = math_min(
+                m_crossfadeFrames - m_crossfadeOffset, total_received_frames);
+        const CSAMPLE_GAIN startGain =
+                static_cast<CSAMPLE_GAIN>(m_crossfadeOffset) / m_crossfadeFrames;
+        const CSAMPLE_GAIN endGain =
+                static_cast<CSAMPLE_GAIN>(m_crossfadeOffset + crossfadeFrames) /
+                m_crossfadeFrames;
+        SampleUtil::applyRampingGain(pOutputBuffer,
+                startGain,
+                endGain,
+                getAudioSignal().frames2samples(crossfadeFrames));
+        SampleUtil::addWithRampingGain(pOutputBuffer,
+                m_crossfade_buffer +
+                        getAudioSignal().frames2samples(m_crossfadeOffset),
+                1 - startGain,
+                1 - endGain,
+                getAudioSignal().frames2samples(crossfadeFrames));
+        m_crossfadeOffset += crossfadeFrames;
     }
 
-    // framesRead is interpreted as the total number of virtual sample frames
-    // consumed to produce the scaled buffer. Due to this, we do not take into
-    // account directionality or starting point.
-    // NOTE(rryan): Why no m_dPitchAdjust here? Pitch does not change the time
-    // ratio. m_dSpeedAdjust is the ratio of unstretched time to stretched
-    // time. So, if we used total_received_frames in stretched time, then
-    // multiplying that by the ratio of unstretched time to stretched time
-    // will get us the unstretched sample frames read.
-    double framesRead = m_dBaseRate * m_dTempoRatio * total_received_frames;
+    return total_received_frames;
+}
 
-    return framesRead;
+SINT EngineBufferScaleRubberBand::drainRealTimeStretcher(
+        CSAMPLE* pOutputBuffer,
+        SINT frames) {
+    const SINT framesToDrain = math_min(frames, m_drainFrames - m_drainedFrames);
+    const SINT received_frames = retrieveAndDeinterleave(
+            pOutputBuffer, framesToDrain);
+
+    // The real-time output ends at the handover frame and the rendered
+    // audio starts kOverlapFrames earlier. Crossfade the overlapping frames
+    // to hide that both have been stretched independently.
+    const SINT overlapStart = m_drainFrames - m_overlapFrames;
+    for (SINT i = math_max(m_drainedFrames, overlapStart);
+            i < m_drainedFrames + received_frames;
+            ++i) {
+        const CSAMPLE_GAIN gain = static_cast<CSAMPLE_GAIN>(i - overlapStart + 1) /
+                (m_overlapFrames + 1);
+        const CSAMPLE* pRendered = m_pBlock->pSamples +
+                getAudioSignal().frames2samples(
+                        kOverlapFrames - (m_drainFrames - i));
+        CSAMPLE* pFrame = pOutputBuffer +
+                getAudioSignal().frames2samples(i - m_drainedFrames);
+        pFrame[0] = pFrame[0] * (1 - gain) + pRendered[0] * gain;
+        pFrame[1] = pFrame[1] * (1 - gain) + pRendered[1] * gain;
+    }
+    m_drainedFrames += received_frames;
+
+    if (received_frames < framesToDrain || m_drainedFrames == m_drainFrames) {
+        m_pRubberBand->reset();
+        m_blockOffset = math_min(kOverlapFrames, m_pBlock->numFrames);
+        m_inputFramesDue = 0.0;
+        m_renderAheadState = RenderAheadState::Active;
+        if (!renderAheadMatchesScaleParameters()) {
+            // Changed while draining
+            fallBackToRealTime(true);
+        }
+    }
+    return received_frames;
+}
+
+SINT EngineBufferScaleRubberBand::playRenderedFrames(
+        CSAMPLE* pOutputBuffer,
+        SINT frames) {
+    SINT played_frames = 0;
+    while (played_frames < frames) {
+        if (m_blockOffset == m_pBlock->numFrames) {
+            const bool endOfTrack = m_pBlock->endOfTrack;
+            m_pRenderAhead->recycleBlock(m_pBlock);
+            m_pBlock = endOfTrack ? nullptr : takeCurrentBlock();
+            m_blockOffset = 0;
+            if (!m_pBlock) {
+                if (!endOfTrack) {
+                    Counter counter(kRenderAheadUnderflowTag);
+                    counter.increment();
+                }
+                fallBackToRealTime(false);
+                break;
+            }
+        }
+
+        const SINT frames_to_play = math_min(
+                frames - played_frames, m_pBlock->numFrames - m_blockOffset);
+        SINT valid_frames;
+        const bool continuous = consumeInputFrames(frames_to_play, &valid_frames);
+        SampleUtil::copy(
+                pOutputBuffer + getAudioSignal().frames2samples(played_frames),
+                m_pBlock->pSamples + getAudioSignal().frames2samples(m_blockOffset),
+                getAudioSignal().frames2samples(valid_frames));
+        played_frames += valid_frames;
+        m_blockOffset += valid_frames;
+        if (!continuous) {
+            // Continue with the input after the loop or jump in real-time
+            fallBackToRealTime(true);
+            break;
+        }
+    }
+    return played_frames;
+}
+
+bool EngineBufferScaleRubberBand::consumeInputFrames(
+        SINT renderedFrames,
+        SINT* pValidFrames) {
+    // The read-ahead manager must see the same reads as in real-time mode.
+    // It takes loops, keeps the read log for the play position and hints
+    // the reader.
+    const double rate = m_dBaseRate * m_dTempoRatio;
+    const SINT maxReadFrames = getAudioSignal().samples2frames(MAX_BUFFER_LEN);
+    m_inputFramesDue += renderedFrames * rate;
+    while (m_inputFramesDue >= 1.0) {
+        const SINT framesToRead = math_min(
+                static_cast<SINT>(m_inputFramesDue), maxReadFrames);
+        const double playposBefore = m_pReadAheadManager->getPlaypos();
+        const SINT samplesRead = m_pReadAheadManager->getNextSamples(
+                rate,
+                m_buffer_back,
+                getAudioSignal().frames2samples(framesToRead));
+        m_inputFramesDue -= getAudioSignal().samples2frames(samplesRead);
+        if (m_pReadAheadManager->getPlaypos() != playposBefore + samplesRead) {
+            // The rendered frames after the loop or jump belong to the
+            // input that has been skipped
+            const SINT invalidFrames = static_cast<SINT>(
+                    ceil(m_inputFramesDue / rate));
+            m_inputFramesDue = 0.0;
+            *pValidFrames = math_max<SINT>(0, renderedFrames - invalidFrames);
+            return false;
+        }
+        if (samplesRead == 0) {
+            break;
+        }
+    }
+    *pValidFrames = renderedFrames;
+    return true;
+}
+
+bool EngineBufferScaleRubberBand::shouldStartRenderAhead() const {
+    return m_pRenderAhead &&
+            !m_bBackwards &&
+            m_dTimeRatio > 0.0 &&
+            m_steadyFrames >= kRenderAheadSteadySeconds *
+                            getAudioSignal().sampleRate();
+}
+
+bool EngineBufferScaleRubberBand::renderAheadMatchesScaleParameters() const {
+    return !m_bBackwards &&
+            m_dTimeRatio == m_renderAheadTimeRatio &&
+            m_dPitchScale == m_renderAheadPitchScale;
+}
+
+void EngineBufferScaleRubberBand::requestRenderAhead() {
+    const double rate = m_dBaseRate * m_dTempoRatio;
+    const double readFrame = m_pReadAheadManager->getPlaypos() /
+            RubberBandRenderAhead::kChannels;
+    const SINT handoverFrame = static_cast<SINT>(ceil(readFrame +
+            kRenderAheadLeadSeconds * getAudioSignal().sampleRate() * rate));
+    const SINT startFrame = handoverFrame -
+            static_cast<SINT>(round(kOverlapFrames * rate));
+    if (startFrame < 0) {
+        m_steadyFrames = 0;
+        return;
+    }
+
+    ++m_renderAheadGeneration;
+    RubberBandRenderAhead::Request request;
+    request.generation = m_renderAheadGeneration;
+    request.startFrame = startFrame;
+    request.sampleRate = getAudioSignal().sampleRate();
+    request.timeRatio = m_dTimeRatio;
+    request.pitchScale = m_dPitchScale;
+    m_pRenderAhead->requestRender(request);
+
+    m_renderAheadTimeRatio = m_dTimeRatio;
+    m_renderAheadPitchScale = m_dPitchScale;
+    m_handoverFrame = handoverFrame;
+    m_renderAheadState = RenderAheadState::Pending;
+}
+
+bool EngineBufferScaleRubberBand::handOverToRenderAhead() {
+    RubberBandRenderAhead::Block* pBlock = takeCurrentBlock();
+    if (!pBlock) {
+        return false;
+    }
+    m_pBlock = pBlock;
+    m_blockOffset = 0;
+
+    // Flush the real-time stretcher. All of its remaining output is
+    // available afterwards.
+    deinterleaveAndProcess(m_buffer_back, 0, true);
+    m_drainFrames = math_max(0, m_pRubberBand->available());
+    m_drainedFrames = 0;
+    m_overlapFrames = m_pBlock->numFrames < kOverlapFrames
+            ? 0
+            : math_min(kOverlapFrames, m_drainFrames);
+    m_renderAheadState = RenderAheadState::Draining;
+    return true;
+}
+
+void EngineBufferScaleRubberBand::fallBackToRealTime(bool crossfade) {
+    m_crossfadeFrames = 0;
+    m_crossfadeOffset = 0;
+    if (crossfade && m_pBlock) {
+        m_crossfadeFrames = math_min(
+                kCrossfadeFrames, m_pBlock->numFrames - m_blockOffset);
+        SampleUtil::copy(m_crossfade_buffer,
+                m_pBlock->pSamples + getAudioSignal().frames2samples(m_blockOffset),
+                getAudioSignal().frames2samples(m_crossfadeFrames));
+    }
+    cancelRenderAhead();
+
+    // Discard the output that precedes the input after the reset to
+    // continue right at the play position
+    m_pRubberBand->reset();
+    m_framesToDiscard = m_pRubberBand->getLatency();
+}
+
+void EngineBufferScaleRubberBand::cancelRenderAhead() {
+    if (m_renderAheadState == RenderAheadState::Off) {
+        return;
+    }
+    if (m_renderAheadState == RenderAheadState::Draining) {
+        // The real-time stretcher has been flushed
+        m_pRubberBand->reset();
+    }
+    if (m_pBlock) {
+        m_pRenderAhead->recycleBlock(m_pBlock);
+        m_pBlock = nullptr;
+    }
+
+    // Blocks of the cancelled request are recycled by takeCurrentBlock()
+    ++m_renderAheadGeneration;
+    RubberBandRenderAhead::Request request;
+    request.generation = m_renderAheadGeneration;
+    request.startFrame = -1;
+    request.sampleRate = 0;
+    request.timeRatio = 0.0;
+    request.pitchScale = 0.0;
+    m_pRenderAhead->requestRender(request);
+
+    m_renderAheadState = RenderAheadState::Off;
+    m_steadyFrames = 0;
+}
+
+RubberBandRenderAhead::Block* EngineBufferScaleRubberBand::takeCurrentBlock() {
+    RubberBandRenderAhead::Block* pBlock;
+    while ((pBlock = m_pRenderAhead->takeBlock())) {
+        if (pBlock->generation == m_renderAheadGeneration) {
+            return pBlock;
+        }
+        m_pRenderAhead->recycleBlock(pBlock);
+    }
+    return nullptr;
 }
@@ -2,22 +2,41 @@
 #define ENGINEBUFFERSCALERUBBERBAND_H
 
 #include "engine/bufferscalers/enginebufferscale.h"
+#include "engine/bufferscalers/rubberbandrenderahead.h"
+#include "track/track.h"
 #include "util/memory.h"
 
 namespace RubberBand {
 class RubberBandStretcher;
 }  // namespace RubberBand
 
+class EngineWorkerScheduler;
 class ReadAheadManager;
 
 // Uses librubberband to scale audio.  This class is not thread safe.
+//
+// While tempo and pitch are steady the audio is rendered ahead on a worker
+// thread (see RubberBandRenderAhead) and the real-time stretcher is only
+// used after changes, seeks, loops and while scratching.
 class EngineBufferScaleRubberBand : public EngineBufferScale {
     Q_OBJECT
   public:
-    explicit EngineBufferScaleRubberBand(
-            ReadAheadManager* pReadAheadManager);
+    EngineBufferScaleRubberBand(
+            ReadAheadManager* pReadAheadManager,
+            const QString& group);
     ~EngineBufferScaleRubberBand() override;
 
+    // Creates and starts the render-ahead worker. Without workers all audio
+    // is stretched in real-time.
+    void bindWorkers(EngineWorkerScheduler* pWorkerScheduler);
+
+    // Called from the threads that load tracks
+    void newTrack(TrackPointer pTrack);
+    // Schedules the render-ahead worker after newTrack(). Must be called
+    // from the engine thread, because only the engine thread may schedule
+    // workers.
+    void wakeWorkersIfNewTrack();
+
     void setScaleParameters(double base_rate,
                             double* pTempoRatio,
                             double* pPitchRatio) override;
@@ -32,12 +51,42 @@ class EngineBufferScaleRubberBand : public EngineBufferScale {
     void clear() override;
 
   private:
+    enum class RenderAheadState {
+        // Stretching in real-time
+        Off,
+        // Stretching in real-time until the play position reaches the
+        // start of the requested render
+        Pending,
+        // Retrieving the remaining output of the flushed real-time stretcher
+        Draining,
+        // Playing the rendered blocks
+        Active,
+    };
+
     // Reset RubberBand library with new audio signal
     void initRubberBand();
 
     void deinterleaveAndProcess(const CSAMPLE* pBuffer, SINT frames, bool flush);
     SINT retrieveAndDeinterleave(CSAMPLE* pBuffer, SINT frames);
 
+    // Each of these fills the output buffer until it is full or the render
+    // ahead state changes and returns the number of frames written.
+    SINT stretchInRealTime(CSAMPLE* pOutputBuffer, SINT frames);
+    SINT drainRealTimeStretcher(CSAMPLE* pOutputBuffer, SINT frames);
+    SINT playRenderedFrames(CSAMPLE* pOutputBuffer, SINT frames);
+
+    bool shouldStartRenderAhead() const;
+    bool renderAheadMatchesScaleParameters() const;
+    void requestRenderAhead();
+    bool handOverToRenderAhead();
+    void fallBackToRealTime(bool crossfade);
+    void cancelRenderAhead();
+    RubberBandRenderAhead::Block* takeCurrentBlock();
+    // Reads the input frames that correspond to the played rendered frames.
+    // Returns false after a loop or jump, when only *pValidFrames of the
+    // rendered frames match the input.
+    bool consumeInputFrames(SINT renderedFrames, SINT* pValidFrames);
+
     // The read-ahead manager that we use to fetch samples
     ReadAheadManager* m_pReadAheadManager;
 
@@ -48,6 +97,33 @@ class EngineBufferScaleRubberBand : public EngineBufferScale {
 
     // Holds the playback direction
     bool m_bBackwards;
+
+    double m_dTimeRatio;
+    double m_dPitchScale;
+
+    const QString m_group;
+    // Only created if rendering ahead is enabled for the deck
+    std::unique_ptr<RubberBandRenderAhead> m_pRenderAhead;
+    RenderAheadState m_renderAheadState;
+    int m_renderAheadGeneration;
+    double m_renderAheadTimeRatio;
+    double m_renderAheadPitchScale;
+    // Frames stretched in real-time since the scale parameters changed
+    SINT m_steadyFrames;
+    // The input frame where the rendered audio takes over
+    SINT m_handoverFrame;
+    RubberBandRenderAhead::Block* m_pBlock;
+    SINT m_blockOffset;
+    // Fractional input frames that have been played but not read yet
+    double m_inputFramesDue;
+    SINT m_drainFrames;
+    SINT m_drainedFrames;
+    SINT m_overlapFrames;
+    // Output of the real-time stretcher that precedes the audio after a reset
+    SINT m_framesToDiscard;
+    CSAMPLE* m_crossfade_buffer;
+    SINT m_crossfadeFrames;
+    SINT m_crossfadeOffset;
 };
 
 
@@ -0,0 +1,291 @@
+#include "engine/bufferscalers/rubberbandrenderahead.h"
+
+#include <rubberband/RubberBandStretcher.h>
+
+#include <QMutexLocker>
+#include <QThread>
+
+#include "sources/audiosourcestereoproxy.h"
+#include "sources/soundsourceproxy.h"
+#include "util/compatibility.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+using RubberBand::RubberBandStretcher;
+
+namespace {
+
+mixxx::Logger kLogger("RubberBandRenderAhead");
+
+// Decoded frames that are passed to RubberBand at once
+constexpr SINT kReadFrames = 1024;
+
+// Enough for a stale request and a new one per callback until the worker
+// wakes up
+constexpr int kRequestFIFOSize = 16;
+
+} // anonymous namespace
+
+constexpr SINT RubberBandRenderAhead::kChannels;
+constexpr SINT RubberBandRenderAhead::kBlockFrames;
+constexpr int RubberBandRenderAhead::kMaxBlocks;
+
+RubberBandRenderAhead::RubberBandRenderAhead(const QString& group)
+        : m_group(group),
+          m_requestFIFO(kRequestFIFOSize),
+          m_renderedBlockFIFO(kMaxBlocks),
+          m_freeBlockFIFO(kMaxBlocks),
+          m_newTrackAvailable(false),
+          m_stretcherSampleRate(0),
+          m_rendering(false),
+          m_inputFinished(false),
+          m_readFrame(0),
+          m_readBuffer(kReadFrames * kChannels),
+          m_numAllocatedBlocks(0),
+          m_framesToDiscard(0),
+          m_newTrackNotification(0),
+          m_stop(0) {
+    m_request.generation = 0;
+    m_request.startFrame = -1;
+    for (auto& planarBuffer : m_planarBuffers) {
+        mixxx::SampleBuffer(math_max(kReadFrames, kBlockFrames)).swap(planarBuffer);
+    }
+}
+
+RubberBandRenderAhead::~RubberBandRenderAhead() {
+}
+
+// WARNING: Called from the threads that load tracks
+void RubberBandRenderAhead::newTrack(TrackPointer pTrack) {
+    {
+        QMutexLocker locker(&m_newTrackMutex);
+        m_pNewTrack = pTrack;
+        m_newTrackAvailable = true;
+    }
+    // The worker is scheduled by the engine thread, see wakeIfNewTrack()
+    m_newTrackNotification.storeRelease(1);
+}
+
+void RubberBandRenderAhead::wakeIfNewTrack() {
+    if (m_newTrackNotification.testAndSetAcquire(1, 0)) {
+        workReady();
+    }
+}
+
+void RubberBandRenderAhead::requestRender(const Request& request) {
+    if (m_requestFIFO.write(&request, 1) != 1) {
+        kLogger.warning() << m_group << "Dropped render request";
+    }
+    workReady();
+}
+
+RubberBandRenderAhead::Block* RubberBandRenderAhead::takeBlock() {
+    Block* pBlock = nullptr;
+    if (m_renderedBlockFIFO.read(&pBlock, 1) != 1) {
+        return nullptr;
+    }
+    return pBlock;
+}
+
+void RubberBandRenderAhead::recycleBlock(Block* pBlock) {
+    DEBUG_ASSERT(pBlock);
+    // There are never more blocks than slots in the FIFO
+    m_freeBlockFIFO.writeBlocking(&pBlock, 1);
+    workReady();
+}
+
+void RubberBandRenderAhead::run() {
+    QThread::currentThread()->setObjectName(
+            QString("RubberBandRenderAhead %1").arg(m_group));
+
+    while (!atomicLoadAcquire(m_stop)) {
+        bool newTrackAvailable;
+        TrackPointer pNewTrack;
+        {
+            QMutexLocker locker(&m_newTrackMutex);
+            newTrackAvailable = m_newTrackAvailable;
+            pNewTrack = std::move(m_pNewTrack);
+            m_newTrackAvailable = false;
+        }
+        if (newTrackAvailable) {
+            loadTrack(std::move(pNewTrack));
+        }
+
+        // Only the latest request is relevant, all others are stale
+        bool newRequest = false;
+        while (m_requestFIFO.read(&m_request, 1) == 1) {
+            newRequest = true;
+        }
+        if (newRequest) {
+            startRendering();
+        }
+
+        if (!m_rendering || !renderBlock()) {
+            m_semaRun.acquire();
+        }
+    }
+}
+
+void RubberBandRenderAhead::quitWait() {
+    m_stop = 1;
+    m_semaRun.release();
+    wait();
+}
+
+void RubberBandRenderAhead::loadTrack(TrackPointer pTrack) {
+    m_rendering = false;
+    // Close open file handles
+    m_pStereoProxy.reset();
+    m_pAudioSource.reset();
+    m_pTrack = std::move(pTrack);
+}
+
+bool RubberBandRenderAhead::openAudioSource() {
+    if (m_pAudioSource) {
+        return true;
+    }
+    if (!m_pTrack) {
+        return false;
+    }
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(kChannels);
+    m_pAudioSource = SoundSourceProxy(m_pTrack).openAudioSource(config);
+    if (!m_pAudioSource || m_pAudioSource->frameIndexRange().empty()) {
+        kLogger.warning()
+                << m_group
+                << "Failed to open file"
+                << m_pTrack->getLocation();
+        m_pAudioSource.reset();
+        // Don't retry with every request
+        m_pTrack.reset();
+        return false;
+    }
+    m_pStereoProxy = std::make_unique<mixxx::AudioSourceStereoProxy>(
+            m_pAudioSource, kReadFrames);
+    return true;
+}
+
+void RubberBandRenderAhead::startRendering() {
+    m_rendering = false;
+    if (m_request.startFrame < 0 || !openAudioSource()) {
+        return;
+    }
+
+    if (m_pStretcher && m_stretcherSampleRate == m_request.sampleRate) {
+        m_pStretcher->reset();
+    } else {
+        // The offline mode would require to study() the whole input up to
+        // the end of the track before processing. The real-time mode
+        // produces the same output as the stretcher in the audio callback,
+        // which is required for seamless handovers.
+        m_pStretcher = std::make_unique<RubberBandStretcher>(
+                m_request.sampleRate,
+                kChannels,
+                RubberBandStretcher::OptionProcessRealTime |
+                        RubberBandStretcher::OptionThreadingNever);
+        m_pStretcher->setMaxProcessSize(kReadFrames);
+        m_stretcherSampleRate = m_request.sampleRate;
+    }
+    m_pStretcher->setTimeRatio(m_request.timeRatio);
+    m_pStretcher->setPitchScale(m_request.pitchScale);
+    // The output of the real-time stretcher is delayed by its latency
+    m_framesToDiscard = m_pStretcher->getLatency();
+
+    // The engine counts frames from the first readable frame of the track
+    m_readFrame = m_pAudioSource->frameIndexMin() + m_request.startFrame;
+    m_inputFinished = false;
+    m_rendering = true;
+}
+
+RubberBandRenderAhead::Block* RubberBandRenderAhead::acquireBlock() {
+    Block* pBlock = nullptr;
+    if (m_freeBlockFIFO.read(&pBlock, 1) == 1) {
+        return pBlock;
+    }
+    if (m_numAllocatedBlocks == kMaxBlocks) {
+        return nullptr;
+    }
+    mixxx::SampleBuffer(kBlockFrames * kChannels).swap(
+            m_blockBuffers[m_numAllocatedBlocks]);
+    pBlock = &m_blocks[m_numAllocatedBlocks];
+    pBlock->pSamples = m_blockBuffers[m_numAllocatedBlocks].data();
+    ++m_numAllocatedBlocks;
+    return pBlock;
+}
+
+void RubberBandRenderAhead::processNextInput() {
+    const float* planarInput[kChannels] = {
+            m_planarBuffers[0].data(),
+            m_planarBuffers[1].data()};
+    const mixxx::IndexRange readableRange = m_pAudioSource->frameIndexRange();
+    const SINT numFrames = math_min(kReadFrames, readableRange.end() - m_readFrame);
+    if (numFrames <= 0) {
+        m_pStretcher->process(planarInput, 0, true);
+        m_inputFinished = true;
+        return;
+    }
+
+    // Frames that cannot be read are left silent
+    SampleUtil::clear(m_readBuffer.data(), numFrames * kChannels);
+    const mixxx::IndexRange frameRange = intersect(
+            mixxx::IndexRange::forward(m_readFrame, numFrames),
+            readableRange);
+    if (!frameRange.empty()) {
+        const SINT offset = frameRange.start() - m_readFrame;
+        m_pStereoProxy->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        frameRange,
+                        mixxx::SampleBuffer::WritableSlice(
+                                m_readBuffer.data(offset * kChannels),
+                                frameRange.length() * kChannels)));
+    }
+    m_readFrame += numFrames;
+    m_inputFinished = m_readFrame >= readableRange.end();
+
+    SampleUtil::deinterleaveBuffer(
+            m_planarBuffers[0].data(),
+            m_planarBuffers[1].data(),
+            m_readBuffer.data(),
+            numFrames);
+    m_pStretcher->process(planarInput, numFrames, m_inputFinished);
+}
+
+bool RubberBandRenderAhead::renderBlock() {
+    Block* pBlock = acquireBlock();
+    if (!pBlock) {
+        return false;
+    }
+
+    while (!m_inputFinished &&
+            m_pStretcher->available() < m_framesToDiscard + kBlockFrames) {
+        processNextInput();
+    }
+    float* planarOutput[kChannels] = {
+            m_planarBuffers[0].data(),
+            m_planarBuffers[1].data()};
+    while (m_framesToDiscard > 0 && m_pStretcher->available() > 0) {
+        const SINT framesToDiscard = math_min<SINT>(
+                math_min<SINT>(m_framesToDiscard, m_pStretcher->available()),
+                kBlockFrames);
+        m_pStretcher->retrieve(planarOutput, framesToDiscard);
+        m_framesToDiscard -= framesToDiscard;
+    }
+    const SINT numFrames = math_clamp<SINT>(
+            m_pStretcher->available(), 0, kBlockFrames);
+    m_pStretcher->retrieve(planarOutput, numFrames);
+    SampleUtil::interleaveBuffer(
+            pBlock->pSamples,
+            m_planarBuffers[0].data(),
+            m_planarBuffers[1].data(),
+            numFrames);
+
+    pBlock->generation = m_request.generation;
+    pBlock->numFrames = numFrames;
+    pBlock->endOfTrack = m_inputFinished && m_pStretcher->available() <= 0;
+    m_renderedBlockFIFO.writeBlocking(&pBlock, 1);
+    if (pBlock->endOfTrack) {
+        m_rendering = false;
+    }
+    return true;
+}
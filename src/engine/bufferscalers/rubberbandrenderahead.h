@@ -0,0 +1,120 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QString>
+
+#include "engine/engineworker.h"
+#include "sources/audiosource.h"
+#include "track/track.h"
+#include "util/fifo.h"
+#include "util/memory.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+namespace RubberBand {
+class RubberBandStretcher;
+} // namespace RubberBand
+
+namespace mixxx {
+class AudioSourceStereoProxy;
+} // namespace mixxx
+
+// Renders the time-stretched audio of a deck ahead of its play position, so
+// that RubberBand does not run in the audio callback while tempo and pitch
+// are steady. EngineBufferScaleRubberBand plays the rendered blocks as long
+// as tempo and pitch of the deck do not change.
+//
+// The worker decodes the track from its own audio source. Rendered blocks are
+// tagged with the generation of the request that produced them, so the
+// engine can recycle the stale blocks of a cancelled request.
+class RubberBandRenderAhead : public EngineWorker {
+    Q_OBJECT
+  public:
+    static constexpr SINT kChannels = 2;
+    // Stereo frames of stretched audio per block
+    static constexpr SINT kBlockFrames = 4096;
+    // The blocks are allocated when needed and limit how far the worker
+    // renders ahead of the engine.
+    static constexpr int kMaxBlocks = 16;
+
+    struct Block {
+        int generation;
+        SINT numFrames;
+        // The track ended within this block, no more blocks will follow
+        bool endOfTrack;
+        // Interleaved stereo samples
+        CSAMPLE* pSamples;
+    };
+
+    // POD with trivial ctor/dtor/copy for passing through FIFO
+    struct Request {
+        int generation;
+        // The first frame of the track to render, negative to stop rendering
+        SINT startFrame;
+        SINT sampleRate;
+        double timeRatio;
+        double pitchScale;
+    };
+
+    explicit RubberBandRenderAhead(const QString& group);
+    ~RubberBandRenderAhead() override;
+
+    // Replaces the track to render from. The current audio source is closed
+    // and the new one is opened with the first request. The worker is only
+    // woken up by the next call of wakeIfNewTrack().
+    void newTrack(TrackPointer pTrack);
+    // Only called from the engine thread
+    void wakeIfNewTrack();
+
+    // Only called from the engine thread
+    void requestRender(const Request& request);
+    // Returns nullptr if no block has been rendered yet
+    Block* takeBlock();
+    void recycleBlock(Block* pBlock);
+
+    void run() override;
+
+    void quitWait();
+
+  private:
+    void loadTrack(TrackPointer pTrack);
+    bool openAudioSource();
+    void startRendering();
+    Block* acquireBlock();
+    // Returns false if no block is free
+    bool renderBlock();
+    void processNextInput();
+
+    const QString m_group;
+
+    FIFO<Request> m_requestFIFO;
+    FIFO<Block*> m_renderedBlockFIFO;
+    FIFO<Block*> m_freeBlockFIFO;
+
+    QMutex m_newTrackMutex;
+    bool m_newTrackAvailable;
+    TrackPointer m_pNewTrack;
+
+    // Only accessed by the worker thread
+    TrackPointer m_pTrack;
+    mixxx::AudioSourcePointer m_pAudioSource;
+    std::unique_ptr<mixxx::AudioSourceStereoProxy> m_pStereoProxy;
+    std::unique_ptr<RubberBand::RubberBandStretcher> m_pStretcher;
+    SINT m_stretcherSampleRate;
+    Request m_request;
+    bool m_rendering;
+    bool m_inputFinished;
+    SINT m_readFrame;
+    mixxx::SampleBuffer m_readBuffer;
+    mixxx::SampleBuffer m_planarBuffers[kChannels];
+    Block m_blocks[kMaxBlocks];
+    mixxx::SampleBuffer m_blockBuffers[kMaxBlocks];
+    int m_numAllocatedBlocks;
+    // Initial output of the stretcher that precedes the requested frame
+    SINT m_framesToDiscard;
+
+    // Set by newTrack() until the engine thread has scheduled the worker
+    QAtomicInt m_newTrackNotification;
+    QAtomicInt m_stop;
+};
@@ -38,6 +38,22 @@ const SINT kDefaultHintFrames = 1024;
 // massive drop outs are expected to occur Mixxx should run reliably!
 const SINT kNumberOfCachedChunksInMemory = 80;
 
+// Additional chunks that are owned by the worker for decoding the start
+// and the cue points of a new track before it is reported as loaded.
+// The preloaded chunks are adopted by the cache and replaced by free
+// chunks afterwards.
+//
+//     16 chunks -> 1024 KB = 1 MB
+const SINT kNumberOfPreloadChunks = 16;
+
+const SINT kNumberOfChunks = kNumberOfCachedChunksInMemory + kNumberOfPreloadChunks;
+
+// Interned up front instead of in the audio callback
+const StatTag kCacheMissTag(
+        "CachingReader::read(): Failed to read chunk on cache miss");
+const StatTag kFirstReadCacheMissTag(
+        "CachingReader::read(): Cache miss after loading a track");
+
 } // anonymous namespace
 
 CachingReader::CachingReader(QString group,
@@ -56,17 +72,23 @@ CachingReader::CachingReader(QString group,
           // The capacity of the back channel must be equal to the number of
           // allocated chunks, because the worker use writeBlocking(). Otherwise
           // the worker could get stuck in a hot loop!!!
-          m_readerStatusUpdateFIFO(kNumberOfCachedChunksInMemory),
+          m_readerStatusUpdateFIFO(kNumberOfChunks),
+          m_preloadChunkFIFO(kNumberOfPreloadChunks),
           m_state(STATE_IDLE),
           m_mruCachingReaderChunk(nullptr),
           m_lruCachingReaderChunk(nullptr),
-          m_sampleBuffer(CachingReaderChunk::kSamples * kNumberOfCachedChunksInMemory),
-          m_worker(group, &m_chunkReadRequestFIFO, &m_readerStatusUpdateFIFO) {
-    m_allocatedCachingReaderChunks.reserve(kNumberOfCachedChunksInMemory);
+          m_sampleBuffer(CachingReaderChunk::kSamples * kNumberOfChunks),
+          m_numPreloadChunksToReplenish(kNumberOfPreloadChunks),
+          m_firstReadPending(false),
+          m_worker(group,
+                  &m_chunkReadRequestFIFO,
+                  &m_readerStatusUpdateFIFO,
+                  &m_preloadChunkFIFO) {
+    m_allocatedCachingReaderChunks.reserve(kNumberOfChunks);
     // Divide up the allocated raw memory buffer into total_chunks
     // chunks. Initialize each chunk to hold nothing and add it to the free
     // list.
-    for (SINT i = 0; i < kNumberOfCachedChunksInMemory; ++i) {
+    for (SINT i = 0; i < kNumberOfChunks; ++i) {
         CachingReaderChunkForOwner* c =
                 new CachingReaderChunkForOwner(
                         mixxx::SampleBuffer::WritableSlice(
@@ -76,6 +98,7 @@ CachingReader::CachingReader(QString group,
         m_chunks.push_back(c);
         m_freeChunks.push_back(c);
     }
+    replenishPreloadChunks();
 
     // Forward signals from worker
     connect(&m_worker, &CachingReaderWorker::trackLoading,
@@ -135,6 +158,29 @@ void CachingReader::freeAllChunks() {
     m_allocatedCachingReaderChunks.clear();
 }
 
+void CachingReader::replenishPreloadChunks() {
+    while (m_numPreloadChunksToReplenish > 0) {
+        if (m_freeChunks.isEmpty()) {
+            if (!m_lruCachingReaderChunk) {
+                // All chunks are pending, try again later
+                return;
+            }
+            freeChunk(m_lruCachingReaderChunk);
+        }
+        CachingReaderChunkReadRequest request;
+        request.giveToWorkerForPreload(m_freeChunks.takeFirst());
+        // The FIFO is large enough for all preload chunks
+        VERIFY_OR_DEBUG_ASSERT(m_preloadChunkFIFO.write(&request, 1) == 1) {
+            auto pChunk = static_cast<CachingReaderChunkForOwner*>(request.chunk);
+            pChunk->takeFromWorker();
+            pChunk->free();
+            m_freeChunks.push_front(pChunk);
+            return;
+        }
+        --m_numPreloadChunksToReplenish;
+    }
+}
+
 CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
     if (m_freeChunks.isEmpty()) {
         return nullptr;
@@ -223,7 +269,18 @@ void CachingReader::process() {
     ReaderStatusUpdate update;
     while (m_readerStatusUpdateFIFO.read(&update, 1) == 1) {
         auto pChunk = update.takeFromWorker();
-        if (pChunk) {
+        if (pChunk && update.status == CHUNK_PRELOADED) {
+            // Preloaded chunks have not been allocated by the cache and are
+            // adopted if they have not been requested in the meantime.
+            ++m_numPreloadChunksToReplenish;
+            if (atomicLoadAcquire(m_state) != STATE_TRACK_LOADED ||
+                    lookupChunk(pChunk->getIndex())) {
+                freeChunkFromList(pChunk);
+                continue;
+            }
+            m_allocatedCachingReaderChunks.insert(pChunk->getIndex(), pChunk);
+            freshenChunk(pChunk);
+        } else if (pChunk) {
             // Result of a read request (with a chunk)
             DEBUG_ASSERT(atomicLoadRelaxed(m_state) != STATE_IDLE);
             DEBUG_ASSERT(
@@ -260,17 +317,17 @@ void CachingReader::process() {
                 // chunks in the m_readerStatusUpdateFIFO have been discarded.
                 // or the cache has been already cleared.
                 // In case of two consecutive load events, we receive two consecutive
-                // TRACK_LOADED without a chunk in between, assert this here.
+                // TRACK_LOADED with only the preloaded chunks of the first track
+                // in between.
                 DEBUG_ASSERT(atomicLoadRelaxed(m_state) == STATE_TRACK_LOADING ||
-                        (atomicLoadRelaxed(m_state) == STATE_TRACK_LOADED &&
-                                !m_mruCachingReaderChunk && !m_lruCachingReaderChunk));
+                        atomicLoadRelaxed(m_state) == STATE_TRACK_LOADED);
                 // now purge also the recently used chunk list from the old track.
                 if (m_mruCachingReaderChunk || m_lruCachingReaderChunk) {
-                    DEBUG_ASSERT(atomicLoadRelaxed(m_state) == STATE_TRACK_LOADING);
                     freeAllChunks();
                 }
                 // Reset the readable frame index range
                 m_readableFrameIndexRange = update.readableFrameIndexRange();
+                m_firstReadPending = true;
                 m_state.storeRelease(STATE_TRACK_LOADED);
             } else {
                 DEBUG_ASSERT(update.status == TRACK_UNLOADED);
@@ -283,6 +340,7 @@ void CachingReader::process() {
             }
         }
     }
+    replenishPreloadChunks();
 }
 
 CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples, bool reverse, CSAMPLE* buffer) {
@@ -436,7 +494,10 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
                     // pending.
                     DEBUG_ASSERT(!pChunk ||
                             (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING));
-                    Counter("CachingReader::read(): Failed to read chunk on cache miss")++;
+                    Counter(kCacheMissTag)++;
+                    if (m_firstReadPending) {
+                        Counter(kFirstReadCacheMissTag)++;
+                    }
                     if (kLogger.traceEnabled()) {
                         kLogger.trace()
                                 << "Cache miss for chunk with index"
@@ -460,6 +521,7 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
                     break;
                 }
                 DEBUG_ASSERT(bufferedFrameIndexRange <= remainingFrameIndexRange);
+                m_firstReadPending = false;
                 if (remainingFrameIndexRange.start() < bufferedFrameIndexRange.start()) {
                     const auto paddingFrameIndexRange =
                             mixxx::IndexRange::between(
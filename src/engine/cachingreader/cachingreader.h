@@ -125,6 +125,7 @@ class CachingReader : public QObject {
     // reader thread.
     FIFO<CachingReaderChunkReadRequest> m_chunkReadRequestFIFO;
     FIFO<ReaderStatusUpdate> m_readerStatusUpdateFIFO;
+    FIFO<CachingReaderChunkReadRequest> m_preloadChunkFIFO;
 
     // Looks for the provided chunk number in the index of in-memory chunks and
     // returns it if it is present. If not, returns nullptr. If it is present then
@@ -145,6 +146,10 @@ class CachingReader : public QObject {
     // Returns all allocated chunks to the free list
     void freeAllChunks();
 
+    // Hands over free chunks to the worker for every chunk that has been
+    // adopted from its preload pool. Expires LRU chunks if necessary.
+    void replenishPreloadChunks();
+
     // Gets a chunk from the free list. Returns nullptr if none available.
     CachingReaderChunkForOwner* allocateChunk(SINT chunkIndex);
 
@@ -180,6 +185,13 @@ class CachingReader : public QObject {
     // The readable frame index range as reported by the worker.
     mixxx::IndexRange m_readableFrameIndexRange;
 
+    // The number of chunks that are missing in the worker's preload pool
+    int m_numPreloadChunksToReplenish;
+
+    // Set when a new track has been loaded until the first chunk has
+    // been read successfully for counting the cache misses on first play
+    bool m_firstReadPending;
+
     CachingReaderWorker m_worker;
 };
 
@@ -43,6 +43,14 @@ void CachingReaderChunk::init(SINT index) {
     m_bufferedSampleFrames.frameIndexRange() = mixxx::IndexRange();
 }
 
+void CachingReaderChunk::initForPreload(SINT index) {
+    DEBUG_ASSERT(index != kInvalidChunkIndex);
+    // The chunk might have been assigned to a different index by a
+    // preceding preload that failed
+    init(kInvalidChunkIndex);
+    init(index);
+}
+
 // Frame index range of this chunk for the given audio source.
 mixxx::IndexRange CachingReaderChunk::frameIndexRange(
         const mixxx::AudioSourcePointer& pAudioSource) const {
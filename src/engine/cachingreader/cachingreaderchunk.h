@@ -47,6 +47,12 @@ public:
         return m_index;
     }
 
+    // Chunks that have been handed over to the worker for preloading
+    // are not associated with an index until the worker decides which
+    // part of the track should be buffered. Must only be invoked by the
+    // worker!
+    void initForPreload(SINT index);
+
     // Frame index range of this chunk for the given audio source.
     mixxx::IndexRange frameIndexRange(
             const mixxx::AudioSourcePointer& pAudioSource) const;
@@ -114,6 +120,15 @@ public:
         DEBUG_ASSERT(m_state == READY);
         m_state = READ_PENDING;
     }
+    // A free chunk without an index is handed over to the worker that
+    // assigns the index when preloading a new track.
+    void giveToWorkerForPreload() {
+        // Must not be referenced in MRU/LRU list!
+        DEBUG_ASSERT(!m_pPrev);
+        DEBUG_ASSERT(!m_pNext);
+        DEBUG_ASSERT(m_state == FREE);
+        m_state = READ_PENDING;
+    }
     void takeFromWorker() {
         // Must not be referenced in MRU/LRU list!
         DEBUG_ASSERT(!m_pPrev);
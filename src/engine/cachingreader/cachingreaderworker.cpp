@@ -9,22 +9,93 @@
 #include "util/compatibility.h"
 #include "util/event.h"
 #include "util/logger.h"
+#include "util/math.h"
 
 
 namespace {
 
 mixxx::Logger kLogger("CachingReaderWorker");
 
+// The number of chunks that are preloaded at positions where playback
+// starts after loading. About 0.5 s at 48 kHz, until the regular hints
+// of the engine have caught up.
+constexpr SINT kPreloadChunksPerPlayPosition = 3;
+
+// Returns the indices of the chunks that should be read before a
+// new track is reported as loaded, ordered by priority: The main cue,
+// the start of the track and the intro where playback starts, followed
+// by the hotcues and loops a user might jump to right after loading.
+QVector<SINT> preloadChunkIndices(
+        const Track& track,
+        const mixxx::IndexRange& frameIndexRange,
+        int maxCount) {
+    QVector<SINT> playFrames;
+    QVector<SINT> jumpFrames;
+    const auto appendFrame = [&frameIndexRange](
+            QVector<SINT>* pFrames, double samplePosition) {
+        if (samplePosition == Cue::kNoPosition) {
+            return;
+        }
+        // Cue positions are measured in stereo samples and the engine
+        // starts playback in the preroll before the first frame
+        const SINT frame = math_max(
+                static_cast<SINT>(samplePosition) / CachingReaderChunk::kChannels,
+                frameIndexRange.start());
+        if (frame < frameIndexRange.end()) {
+            pFrames->append(frame);
+        }
+    };
+    appendFrame(&playFrames, track.getCuePoint().getPosition());
+    appendFrame(&playFrames, frameIndexRange.start() * CachingReaderChunk::kChannels);
+    for (const auto& pCue : track.getCuePoints()) {
+        switch (pCue->getType()) {
+        case Cue::Type::Intro:
+            appendFrame(&playFrames, pCue->getPosition());
+            break;
+        case Cue::Type::HotCue:
+        case Cue::Type::Loop:
+            appendFrame(&jumpFrames, pCue->getPosition());
+            break;
+        default:
+            break;
+        }
+    }
+
+    QVector<SINT> chunkIndices;
+    const auto appendChunks = [&chunkIndices, maxCount](SINT frame, SINT count) {
+        const SINT firstChunkIndex = CachingReaderChunk::indexForFrame(frame);
+        for (SINT chunkIndex = firstChunkIndex;
+                chunkIndex < firstChunkIndex + count &&
+                chunkIndices.size() < maxCount;
+                ++chunkIndex) {
+            if (!chunkIndices.contains(chunkIndex)) {
+                chunkIndices.append(chunkIndex);
+            }
+        }
+    };
+    for (const auto frame : playFrames) {
+        appendChunks(frame, kPreloadChunksPerPlayPosition);
+    }
+    for (const auto frame : jumpFrames) {
+        appendChunks(frame, 1);
+    }
+    return chunkIndices;
+}
+
 } // anonymous namespace
 
 CachingReaderWorker::CachingReaderWorker(
         QString group,
         FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
-        FIFO<ReaderStatusUpdate>* pReaderStatusFIFO)
+        FIFO<ReaderStatusUpdate>* pReaderStatusFIFO,
+        FIFO<CachingReaderChunkReadRequest>* pPreloadChunkFIFO)
         : m_group(group),
           m_tag(QString("CachingReaderWorker %1").arg(m_group)),
           m_pChunkReadRequestFIFO(pChunkReadRequestFIFO),
           m_pReaderStatusFIFO(pReaderStatusFIFO),
+          m_pPreloadChunkFIFO(pPreloadChunkFIFO),
+          m_loadToReadyTimer(StatTag(
+                  QString("CachingReaderWorker %1 load-to-ready").arg(m_group))),
           m_newTrackAvailable(false),
           m_stop(0) {
 }
@@ -113,7 +184,43 @@ void CachingReaderWorker::run() {
     }
 }
 
+void CachingReaderWorker::preloadChunks(
+        const TrackPointer& pTrack,
+        std::vector<ReaderStatusUpdate>* pUpdates) {
+    CachingReaderChunkReadRequest request;
+    while (m_pPreloadChunkFIFO->read(&request, 1) == 1) {
+        m_preloadChunks.push_back(request.chunk);
+    }
+
+    const QVector<SINT> chunkIndices = preloadChunkIndices(
+            *pTrack,
+            m_pAudioSource->frameIndexRange(),
+            static_cast<int>(m_preloadChunks.size()));
+    for (const auto chunkIndex : chunkIndices) {
+        DEBUG_ASSERT(!m_preloadChunks.empty());
+        request.chunk = m_preloadChunks.back();
+        request.chunk->initForPreload(chunkIndex);
+        ReaderStatusUpdate update = processReadRequest(request);
+        if (update.status != CHUNK_READ_SUCCESS) {
+            // Keep the chunk for the next preload
+            continue;
+        }
+        m_preloadChunks.pop_back();
+        update.status = CHUNK_PRELOADED;
+        pUpdates->push_back(update);
+    }
+    if (kLogger.debugEnabled()) {
+        kLogger.debug()
+                << m_group
+                << "Preloaded"
+                << pUpdates->size()
+                << "chunks";
+    }
+}
+
 void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
+    m_loadToReadyTimer.start();
+
     // Discard all pending read requests
     CachingReaderChunkReadRequest request;
     while (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
@@ -185,15 +292,29 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
         mixxx::SampleBuffer(tempReadBufferSize).swap(m_tempReadBuffer);
     }
 
-    const auto update =
+    // Decode the parts of the track that are played first before the
+    // track is reported as loaded. Otherwise starting playback or jumping
+    // to a hotcue immediately after loading would produce silence until
+    // the chunks requested by the engine have been read.
+    std::vector<ReaderStatusUpdate> preloadUpdates;
+    preloadChunks(pTrack, &preloadUpdates);
+
+    // The readable frame index range might have been shrunk while
+    // preloading. All preloaded chunks are written together with the
+    // new track to prevent that the engine requests them again.
+    std::vector<ReaderStatusUpdate> updates;
+    updates.reserve(preloadUpdates.size() + 1);
+    updates.push_back(
             ReaderStatusUpdate::trackLoaded(
-                    m_pAudioSource->frameIndexRange());
-    m_pReaderStatusFIFO->writeBlocking(&update, 1);
+                    m_pAudioSource->frameIndexRange()));
+    updates.insert(updates.end(), preloadUpdates.begin(), preloadUpdates.end());
+    m_pReaderStatusFIFO->writeBlocking(updates.data(), static_cast<int>(updates.size()));
 
     // Emit that the track is loaded.
     const SINT sampleCount =
             CachingReaderChunk::frames2samples(
                     m_pAudioSource->frameLength());
+    m_loadToReadyTimer.elapsed(true);
     emit trackLoaded(pTrack, m_pAudioSource->sampleRate(), sampleCount);
 }
 
@@ -7,11 +7,15 @@
 #include <QThread>
 #include <QString>
 
+#include <vector>
+
 #include "engine/cachingreader/cachingreaderchunk.h"
 #include "track/track.h"
 #include "engine/engineworker.h"
 #include "sources/audiosource.h"
 #include "util/fifo.h"
+#include "util/stat.h"
+#include "util/timer.h"
 
 
 // POD with trivial ctor/dtor/copy for passing through FIFO
@@ -23,6 +27,12 @@ typedef struct CachingReaderChunkReadRequest {
         chunk = chunkForOwner;
         chunkForOwner->giveToWorker();
     }
+
+    void giveToWorkerForPreload(CachingReaderChunkForOwner* chunkForOwner) {
+        DEBUG_ASSERT(chunkForOwner);
+        chunk = chunkForOwner;
+        chunkForOwner->giveToWorkerForPreload();
+    }
 } CachingReaderChunkReadRequest;
 
 enum ReaderStatus {
@@ -32,6 +42,7 @@ enum ReaderStatus {
     CHUNK_READ_EOF,
     CHUNK_READ_INVALID,
     CHUNK_READ_DISCARDED, // response without frame index range!
+    CHUNK_PRELOADED, // successfully read chunk from the preload pool
 };
 
 // POD with trivial ctor/dtor/copy for passing through FIFO
@@ -100,7 +111,8 @@ class CachingReaderWorker : public EngineWorker {
     // Construct a CachingReader with the given group.
     CachingReaderWorker(QString group,
             FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
-            FIFO<ReaderStatusUpdate>* pReaderStatusFIFO);
+            FIFO<ReaderStatusUpdate>* pReaderStatusFIFO,
+            FIFO<CachingReaderChunkReadRequest>* pPreloadChunkFIFO);
     ~CachingReaderWorker() override = default;
 
     // Request to load a new track. wake() must be called afterwards.
@@ -120,13 +132,23 @@ class CachingReaderWorker : public EngineWorker {
 
   private:
     QString m_group;
-    QString m_tag;
+    StatTag m_tag;
 
     // Thread-safe FIFOs for communication between the engine callback and
     // reader thread.
     FIFO<CachingReaderChunkReadRequest>* m_pChunkReadRequestFIFO;
     FIFO<ReaderStatusUpdate>* m_pReaderStatusFIFO;
 
+    // Free chunks that are handed over by the cache for preloading the
+    // parts of a new track that are most likely played first. Chunks are
+    // only returned after they have been read successfully.
+    FIFO<CachingReaderChunkReadRequest>* m_pPreloadChunkFIFO;
+    std::vector<CachingReaderChunk*> m_preloadChunks;
+
+    // Measures the time from receiving a new track until the track
+    // has been opened and preloaded
+    Timer m_loadToReadyTimer;
+
     // Queue of Tracks to load, and the corresponding lock. Must acquire the
     // lock to touch.
     QMutex m_newTrackMutex;
@@ -136,6 +158,13 @@ class CachingReaderWorker : public EngineWorker {
     // Internal method to load a track. Emits trackLoaded when finished.
     void loadTrack(const TrackPointer& pTrack);
 
+    // Reads the chunks around the start, the main cue, and the hotcues of
+    // a new track into the preload chunks and appends the resulting status
+    // updates.
+    void preloadChunks(
+            const TrackPointer& pTrack,
+            std::vector<ReaderStatusUpdate>* pUpdates);
+
     ReaderStatusUpdate processReadRequest(
             const CachingReaderChunkReadRequest& request);
 
@@ -0,0 +1,88 @@
+#include "engine/channelmixer.h"
+
+#include "util/sample.h"
+
+namespace {
+
+// Calculates the new gain of a channel and returns the gain of the previous
+// callback in pOldGain, so the effects manager can ramp between them
+CSAMPLE_GAIN updateGain(const EngineMaster::GainCalculator& gainCalculator,
+        EngineMaster::ChannelInfo* pChannelInfo,
+        EngineMaster::GainCache* pGainCache,
+        CSAMPLE_GAIN* pOldGain) {
+    *pOldGain = pGainCache->m_gain;
+    CSAMPLE_GAIN newGain;
+    if (pGainCache->m_fadeout) {
+        newGain = 0;
+        pGainCache->m_fadeout = false;
+    } else {
+        newGain = gainCalculator.getGain(pChannelInfo);
+    }
+    pGainCache->m_gain = newGain;
+    return newGain;
+}
+
+} // anonymous namespace
+
+// static
+void ChannelMixer::applyEffectsAndMixChannels(const EngineMaster::GainCalculator& gainCalculator,
+                                              QVarLengthArray<EngineMaster::ChannelInfo*, kPreallocatedChannels>* activeChannels,
+                                              QVarLengthArray<EngineMaster::GainCache, kPreallocatedChannels>* channelGainCache,
+                                              CSAMPLE* pOutput,
+                                              const ChannelHandle& outputHandle,
+                                              unsigned int iBufferSize,
+                                              unsigned int iSampleRate,
+                                              EngineEffectsManager* pEngineEffectsManager) {
+    // Signal flow overview:
+    // 1. Clear pOutput buffer
+    // 2. Calculate gains for each channel
+    // 3. Pass each channel's calculated gain and input buffer to pEngineEffectsManager, which then:
+    //     A) Copies each channel input buffer to a temporary buffer
+    //     B) Applies gain to the temporary buffer
+    //     C) Processes effects on the temporary buffer
+    //     D) Mixes the temporary buffer into pOutput
+    // The original channel input buffers are not modified.
+    SampleUtil::clear(pOutput, iBufferSize);
+    for (EngineMaster::ChannelInfo* pChannelInfo : *activeChannels) {
+        CSAMPLE_GAIN oldGain;
+        const CSAMPLE_GAIN newGain = updateGain(gainCalculator, pChannelInfo,
+                &(*channelGainCache)[pChannelInfo->m_index], &oldGain);
+        pEngineEffectsManager->processPostFaderAndMix(pChannelInfo->m_handle,
+                outputHandle, pChannelInfo->m_pBuffer, pOutput,
+                iBufferSize, iSampleRate, pChannelInfo->m_features,
+                oldGain, newGain);
+    }
+}
+
+// static
+void ChannelMixer::applyEffectsInPlaceAndMixChannels(const EngineMaster::GainCalculator& gainCalculator,
+                                                     QVarLengthArray<EngineMaster::ChannelInfo*, kPreallocatedChannels>* activeChannels,
+                                                     QVarLengthArray<EngineMaster::GainCache, kPreallocatedChannels>* channelGainCache,
+                                                     CSAMPLE* pOutput,
+                                                     const ChannelHandle& outputHandle,
+                                                     unsigned int iBufferSize,
+                                                     unsigned int iSampleRate,
+                                                     EngineEffectsManager* pEngineEffectsManager) {
+    // Signal flow overview:
+    // 1. Calculate gains for each channel
+    // 2. Pass each channel's calculated gain and input buffer to pEngineEffectsManager, which then:
+    //    A) Applies the calculated gain to the channel buffer, modifying the original input buffer
+    //    B) Applies effects to the buffer, modifying the original input buffer
+    // 3. Mix the channel buffers together to make pOutput, overwriting the pOutput buffer from the last engine callback
+    QVarLengthArray<const CSAMPLE*, kPreallocatedChannels> channelBuffers;
+    // The channels are independent, so their effects can be processed in parallel
+    pEngineEffectsManager->beginParallelBatch();
+    for (EngineMaster::ChannelInfo* pChannelInfo : *activeChannels) {
+        CSAMPLE_GAIN oldGain;
+        const CSAMPLE_GAIN newGain = updateGain(gainCalculator, pChannelInfo,
+                &(*channelGainCache)[pChannelInfo->m_index], &oldGain);
+        pEngineEffectsManager->processPostFaderInPlace(pChannelInfo->m_handle,
+                outputHandle, pChannelInfo->m_pBuffer,
+                iBufferSize, iSampleRate, pChannelInfo->m_features,
+                oldGain, newGain);
+        channelBuffers.append(pChannelInfo->m_pBuffer);
+    }
+    pEngineEffectsManager->finishParallelBatch();
+    SampleUtil::sumBuffers(pOutput, channelBuffers.constData(),
+            channelBuffers.size(), iBufferSize);
+}
@@ -4,6 +4,26 @@
 #include "util/defs.h"
 #include "util/sample.h"
 
+namespace {
+
+// The ramp of SampleUtil::copy2WithRampingGain() for the buffer of a single
+// channel. pDest may be an alias of pSrc1.
+void copy2WithRampingGainPlanar(CSAMPLE* pDest,
+        const CSAMPLE* pSrc0, CSAMPLE_GAIN gain0in, CSAMPLE_GAIN gain0out,
+        const CSAMPLE* pSrc1, CSAMPLE_GAIN gain1in, CSAMPLE_GAIN gain1out,
+        SINT numFrames) {
+    const CSAMPLE_GAIN gainDelta0 = (gain0out - gain0in) / numFrames;
+    const CSAMPLE_GAIN startGain0 = gain0in + gainDelta0;
+    const CSAMPLE_GAIN gainDelta1 = (gain1out - gain1in) / numFrames;
+    const CSAMPLE_GAIN startGain1 = gain1in + gainDelta1;
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest[i] = pSrc0[i] * (startGain0 + gainDelta0 * i) +
+                pSrc1[i] * (startGain1 + gainDelta1 * i);
+    }
+}
+
+} // anonymous namespace
+
 EngineEffect::EngineEffect(EffectManifestPointer pManifest,
                            const QSet<ChannelHandleAndGroup>& activeInputChannels,
                            EffectsManager* pEffectsManager,
@@ -136,13 +156,10 @@ bool EngineEffect::processEffectsRequest(EffectsRequest& message,
     return false;
 }
 
-bool EngineEffect::process(const ChannelHandle& inputHandle,
-                           const ChannelHandle& outputHandle,
-                           const CSAMPLE* pInput, CSAMPLE* pOutput,
-                           const unsigned int numSamples,
-                           const unsigned int sampleRate,
-                           const EffectEnableState chainEnableState,
-                           const GroupFeatureState& groupFeatures) {
+EffectEnableState EngineEffect::effectiveEnableState(
+        const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        const EffectEnableState chainEnableState) {
     // Compute the effective enable state from the combination of the effect's state
     // for the channel and the state passed from the EngineEffectChain.
 
@@ -185,6 +202,31 @@ bool EngineEffect::process(const ChannelHandle& inputHandle,
             }
         }
     }
+    return effectiveEffectEnableState;
+}
+
+void EngineEffect::completeEnableStateTransition(
+        const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) {
+    // Now that the EffectProcessor has been sent the intermediate enabling/disabling
+    // signal, set the channel state to fully enabled/disabled for the next engine callback.
+    EffectEnableState& effectOnChannelState = m_effectEnableStateForChannelMatrix[inputHandle][outputHandle];
+    if (effectOnChannelState == EffectEnableState::Disabling) {
+        effectOnChannelState = EffectEnableState::Disabled;
+    } else if (effectOnChannelState == EffectEnableState::Enabling) {
+        effectOnChannelState = EffectEnableState::Enabled;
+    }
+}
+
+bool EngineEffect::process(const ChannelHandle& inputHandle,
+                           const ChannelHandle& outputHandle,
+                           const CSAMPLE* pInput, CSAMPLE* pOutput,
+                           const unsigned int numSamples,
+                           const unsigned int sampleRate,
+                           const EffectEnableState chainEnableState,
+                           const GroupFeatureState& groupFeatures) {
+    const EffectEnableState effectiveEffectEnableState =
+            effectiveEnableState(inputHandle, outputHandle, chainEnableState);
 
     bool processingOccured = false;
 
@@ -220,14 +262,58 @@ bool EngineEffect::process(const ChannelHandle& inputHandle,
         }
     }
 
-    // Now that the EffectProcessor has been sent the intermediate enabling/disabling
-    // signal, set the channel state to fully enabled/disabled for the next engine callback.
-    EffectEnableState& effectOnChannelState = m_effectEnableStateForChannelMatrix[inputHandle][outputHandle];
-    if (effectOnChannelState == EffectEnableState::Disabling) {
-        effectOnChannelState = EffectEnableState::Disabled;
-    } else if (effectOnChannelState == EffectEnableState::Enabling) {
-        effectOnChannelState = EffectEnableState::Enabled;
+    completeEnableStateTransition(inputHandle, outputHandle);
+
+    return processingOccured;
+}
+
+bool EngineEffect::processPlanar(const ChannelHandle& inputHandle,
+                                 const ChannelHandle& outputHandle,
+                                 const CSAMPLE* const* pInputs,
+                                 CSAMPLE* const* pOutputs,
+                                 const unsigned int numFrames,
+                                 const unsigned int sampleRate,
+                                 const EffectEnableState chainEnableState,
+                                 const GroupFeatureState& groupFeatures) {
+    const EffectEnableState effectiveEffectEnableState =
+            effectiveEnableState(inputHandle, outputHandle, chainEnableState);
+
+    bool processingOccured = false;
+
+    if (effectiveEffectEnableState != EffectEnableState::Disabled) {
+        const mixxx::EngineParameters bufferParameters(
+              mixxx::AudioSignal::SampleRate(sampleRate),
+              numFrames);
+
+        m_pProcessor->processPlanar(inputHandle, outputHandle, pInputs, pOutputs,
+                                    bufferParameters,
+                                    effectiveEffectEnableState, groupFeatures);
+
+        processingOccured = true;
+
+        if (!m_effectRampsFromDry) {
+            // the effect does not fade, so we care for it, see process()
+            if (effectiveEffectEnableState == EffectEnableState::Disabling) {
+                for (int i = 0; i < mixxx::kEngineChannelCount; ++i) {
+                    DEBUG_ASSERT(pInputs[i] != pOutputs[i]);
+                    copy2WithRampingGainPlanar(pOutputs[i],
+                            pInputs[i], 0.0, 1.0,
+                            pOutputs[i], 1.0, 0.0,
+                            numFrames);
+                }
+            } else if (effectiveEffectEnableState == EffectEnableState::Enabling) {
+                for (int i = 0; i < mixxx::kEngineChannelCount; ++i) {
+                    DEBUG_ASSERT(pInputs[i] != pOutputs[i]);
+                    copy2WithRampingGainPlanar(pOutputs[i],
+                            pInputs[i], 1.0, 0.0,
+                            pOutputs[i], 0.0, 1.0,
+                            numFrames);
+                }
+            }
+        }
     }
 
+    completeEnableStateTransition(inputHandle, outputHandle);
+
     return processingOccured;
 }
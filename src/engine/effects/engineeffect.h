@@ -50,15 +50,48 @@ class EngineEffect : public EffectsRequestHandler {
                  const EffectEnableState chainEnableState,
                  const GroupFeatureState& groupFeatures);
 
+    // Only called if supportsPlanarBuffers() returns true
+    bool processPlanar(const ChannelHandle& inputHandle, const ChannelHandle& outputHandle,
+                       const CSAMPLE* const* pInputs, CSAMPLE* const* pOutputs,
+                       const unsigned int numFrames,
+                       const unsigned int sampleRate,
+                       const EffectEnableState chainEnableState,
+                       const GroupFeatureState& groupFeatures);
+
+    // Returns false if process() and processPlanar() leave the buffers
+    // untouched, because the effect is disabled for the channel.
+    bool willProcess(const ChannelHandle& inputHandle,
+                     const ChannelHandle& outputHandle,
+                     const EffectEnableState chainEnableState) {
+        return effectiveEnableState(inputHandle, outputHandle, chainEnableState) !=
+                EffectEnableState::Disabled;
+    }
+
     const EffectManifestPointer getManifest() const {
         return m_pManifest;
     }
 
+    bool canProcessChannelsConcurrently() const {
+        return m_pProcessor == nullptr ||
+                m_pProcessor->canProcessChannelsConcurrently();
+    }
+
+    bool supportsPlanarBuffers() const {
+        return m_pProcessor != nullptr &&
+                m_pProcessor->supportsPlanarBuffers();
+    }
+
   private:
     QString debugString() const {
         return QString("EngineEffect(%1)").arg(m_pManifest->name());
     }
 
+    EffectEnableState effectiveEnableState(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            const EffectEnableState chainEnableState);
+    void completeEnableStateTransition(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle);
+
     EffectManifestPointer m_pManifest;
     EffectProcessor* m_pProcessor;
     ChannelHandleMap<ChannelHandleMap<EffectEnableState>> m_effectEnableStateForChannelMatrix;
@@ -4,15 +4,27 @@
 #include "util/defs.h"
 #include "util/sample.h"
 
+EngineEffectScratchBuffers::EngineEffectScratchBuffers()
+        : buffer1(MAX_BUFFER_LEN),
+          buffer2(MAX_BUFFER_LEN),
+          planarBuffer1(MAX_BUFFER_LEN),
+          planarBuffer2(MAX_BUFFER_LEN) {
+    const SINT maxFrames = MAX_BUFFER_LEN / mixxx::kEngineChannelCount;
+    for (int i = 0; i < mixxx::kEngineChannelCount; ++i) {
+        planar1[i] = planarBuffer1.data(i * maxFrames);
+        planar2[i] = planarBuffer2.data(i * maxFrames);
+    }
+}
+
 EngineEffectChain::EngineEffectChain(const QString& id,
                                      const QSet<ChannelHandleAndGroup>& registeredInputChannels,
                                      const QSet<ChannelHandleAndGroup>& registeredOutputChannels)
         : m_id(id),
+          m_traceStage(CallbackTrace::registerStage(
+                  QString("Effect chain %1").arg(id))),
           m_enableState(EffectEnableState::Enabled),
           m_mixMode(EffectChainMixMode::DrySlashWet),
-          m_dMix(0),
-          m_buffer1(MAX_BUFFER_LEN),
-          m_buffer2(MAX_BUFFER_LEN) {
+          m_dMix(0) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
 
@@ -226,12 +238,34 @@ EngineEffectChain::ChannelStatus& EngineEffectChain::getChannelStatus(
     return status;
 }
 
+void EngineEffectChain::onCallbackStart() {
+    // This is not done after processing a channel, because all channels
+    // that are processed in a callback need to receive the same state.
+    if (m_enableState == EffectEnableState::Disabling) {
+        m_enableState = EffectEnableState::Disabled;
+    } else if (m_enableState == EffectEnableState::Enabling) {
+        m_enableState = EffectEnableState::Enabled;
+    }
+}
+
+bool EngineEffectChain::canProcessChannelsConcurrently() const {
+    for (EngineEffect* pEffect : m_effects) {
+        if (pEffect != nullptr && !pEffect->canProcessChannelsConcurrently()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool EngineEffectChain::process(const ChannelHandle& inputHandle,
                                 const ChannelHandle& outputHandle,
                                 CSAMPLE* pIn, CSAMPLE* pOut,
                                 const unsigned int numSamples,
                                 const unsigned int sampleRate,
-                                const GroupFeatureState& groupFeatures) {
+                                const GroupFeatureState& groupFeatures,
+                                EngineEffectScratchBuffers* pScratch) {
+    ScopedCallbackTraceStage traceStage(m_traceStage);
+
     // Compute the effective enable state from the channel input routing switch and
     // the chain's enable state. When either of these are turned on/off, send the
     // effects the intermediate enabling/disabling signal.
@@ -264,14 +298,66 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         CSAMPLE* pIntermediateInput = pIn;
         CSAMPLE* pIntermediateOutput;
         bool firstAddDryToWetEffectProcessed = false;
+        // Consecutive effects that support planar buffers pass them on.
+        // While the signal is in planar buffers pIntermediateInput is null.
+        CSAMPLE* const* pIntermediatePlanarInput = nullptr;
+        const SINT numFrames = numSamples / mixxx::kEngineChannelCount;
 
         for (EngineEffect* pEffect: m_effects) {
-            if (pEffect != nullptr) {
+            // Disabled effects don't touch the buffers, so they are passed to
+            // process() below to keep the signal interleaved
+            if (pEffect != nullptr && pEffect->supportsPlanarBuffers() &&
+                    (pIntermediatePlanarInput != nullptr ||
+                            pEffect->willProcess(inputHandle, outputHandle,
+                                    effectiveChainEnableState))) {
+                if (pIntermediatePlanarInput == nullptr) {
+                    SampleUtil::deinterleaveBuffer(
+                            pScratch->planar1[0], pScratch->planar1[1],
+                            pIntermediateInput, numFrames);
+                    pIntermediatePlanarInput = pScratch->planar1;
+                    pIntermediateInput = nullptr;
+                }
+                CSAMPLE* const* pIntermediatePlanarOutput =
+                        pIntermediatePlanarInput == pScratch->planar1 ?
+                        pScratch->planar2 : pScratch->planar1;
+
+                if (pEffect->processPlanar(inputHandle, outputHandle,
+                                           pIntermediatePlanarInput,
+                                           pIntermediatePlanarOutput,
+                                           numFrames, sampleRate,
+                                           effectiveChainEnableState, groupFeatures)) {
+                    if (pEffect->getManifest()->addDryToWet()) {
+                        // See the interleaved effects below
+                        bool skipAddingDry = !firstAddDryToWetEffectProcessed
+                                && m_mixMode == EffectChainMixMode::DryPlusWet;
+
+                        if (!skipAddingDry) {
+                            for (int i = 0; i < mixxx::kEngineChannelCount; ++i) {
+                                SampleUtil::add(pIntermediatePlanarOutput[i],
+                                        pIntermediatePlanarInput[i], numFrames);
+                            }
+                        }
+
+                        firstAddDryToWetEffectProcessed = true;
+                    }
+
+                    processingOccured = true;
+                    pIntermediatePlanarInput = pIntermediatePlanarOutput;
+                }
+            } else if (pEffect != nullptr) {
+                if (pIntermediatePlanarInput != nullptr) {
+                    SampleUtil::interleaveBuffer(pScratch->buffer1.data(),
+                            pIntermediatePlanarInput[0], pIntermediatePlanarInput[1],
+                            numFrames);
+                    pIntermediateInput = pScratch->buffer1.data();
+                    pIntermediatePlanarInput = nullptr;
+                }
+
                 // Select an unused intermediate buffer for the next output
-                if (pIntermediateInput == m_buffer1.data()) {
-                    pIntermediateOutput = m_buffer2.data();
+                if (pIntermediateInput == pScratch->buffer1.data()) {
+                    pIntermediateOutput = pScratch->buffer2.data();
                 } else {
-                    pIntermediateOutput = m_buffer1.data();
+                    pIntermediateOutput = pScratch->buffer1.data();
                 }
 
                 if (pEffect->process(inputHandle, outputHandle,
@@ -308,6 +394,14 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
             }
         }
 
+        if (processingOccured && pIntermediatePlanarInput != nullptr) {
+            // Only interleave at the end of the chain
+            SampleUtil::interleaveBuffer(pScratch->buffer1.data(),
+                    pIntermediatePlanarInput[0], pIntermediatePlanarInput[1],
+                    numFrames);
+            pIntermediateInput = pScratch->buffer1.data();
+        }
+
         if (processingOccured) {
             // pIntermediateInput is the output of the last processed effect. It would be the
             // intermediate input of the next effect if there was one.
@@ -342,11 +436,5 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         chainOnChannelEnableState = EffectEnableState::Enabled;
     }
 
-    if (m_enableState == EffectEnableState::Disabling) {
-        m_enableState = EffectEnableState::Disabled;
-    } else if (m_enableState == EffectEnableState::Enabling) {
-        m_enableState = EffectEnableState::Enabled;
-    }
-
     return processingOccured;
 }
@@ -5,17 +5,35 @@
 #include <QList>
 #include <QLinkedList>
 
+#include "util/callbacktrace.h"
 #include "util/class.h"
 #include "util/types.h"
 #include "util/samplebuffer.h"
 #include "util/memory.h"
 #include "engine/channelhandle.h"
+#include "engine/engine.h"
 #include "engine/effects/message.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "effects/effectchain.h"
 
 class EngineEffect;
 
+// Intermediate buffers for processing effect chains. Threads that process
+// chains concurrently need separate buffers.
+struct EngineEffectScratchBuffers {
+    EngineEffectScratchBuffers();
+
+    mixxx::SampleBuffer buffer1;
+    mixxx::SampleBuffer buffer2;
+
+    // The channels of planar1 and planar2 point into these buffers
+    mixxx::SampleBuffer planarBuffer1;
+    mixxx::SampleBuffer planarBuffer2;
+    // Planar buffers for effects that support them
+    CSAMPLE* planar1[mixxx::kEngineChannelCount];
+    CSAMPLE* planar2[mixxx::kEngineChannelCount];
+};
+
 class EngineEffectChain : public EffectsRequestHandler {
   public:
     EngineEffectChain(const QString& id,
@@ -27,12 +45,24 @@ class EngineEffectChain : public EffectsRequestHandler {
         EffectsRequest& message,
         EffectsResponsePipe* pResponsePipe);
 
+    // Called at the start of each engine callback, before any channel is
+    // processed. Completes the intermediate enabling/disabling state of the
+    // chain that all channels received in the previous callback.
+    void onCallbackStart();
+
+    // Chains may be processed for different input channels concurrently,
+    // each with its own scratch buffers.
     bool process(const ChannelHandle& inputHandle,
                  const ChannelHandle& outputHandle,
                  CSAMPLE* pIn, CSAMPLE* pOut,
                  const unsigned int numSamples,
                  const unsigned int sampleRate,
-                 const GroupFeatureState& groupFeatures);
+                 const GroupFeatureState& groupFeatures,
+                 EngineEffectScratchBuffers* pScratch);
+
+    // Returns false if any effect in the chain does not support processing
+    // different input channels concurrently.
+    bool canProcessChannelsConcurrently() const;
 
     const QString& id() const {
         return m_id;
@@ -69,12 +99,11 @@ class EngineEffectChain : public EffectsRequestHandler {
                                     const ChannelHandle& outputHandle);
 
     QString m_id;
+    const int m_traceStage;
     EffectEnableState m_enableState;
     EffectChainMixMode m_mixMode;
     CSAMPLE m_dMix;
     QList<EngineEffect*> m_effects;
-    mixxx::SampleBuffer m_buffer1;
-    mixxx::SampleBuffer m_buffer2;
     ChannelHandleMap<ChannelHandleMap<ChannelStatus>> m_chainStatusForChannelMatrix;
 
     DISALLOW_COPY_AND_ASSIGN(EngineEffectChain);
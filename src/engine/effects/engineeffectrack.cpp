@@ -49,7 +49,8 @@ bool EngineEffectRack::process(const ChannelHandle& inputHandle,
                                CSAMPLE* pIn, CSAMPLE* pOut,
                                const unsigned int numSamples,
                                const unsigned int sampleRate,
-                               const GroupFeatureState& groupFeatures) {
+                               const GroupFeatureState& groupFeatures,
+                               EngineEffectScratchBuffers* pScratch) {
     bool processingOccured = false;
     if (pIn == pOut) {
         // Effects are applied to the buffer in place
@@ -57,7 +58,8 @@ bool EngineEffectRack::process(const ChannelHandle& inputHandle,
             if (pChain != nullptr) {
                 if (pChain->process(inputHandle, outputHandle,
                                     pIn, pOut,
-                                    numSamples, sampleRate, groupFeatures)) {
+                                    numSamples, sampleRate, groupFeatures,
+                                    pScratch)) {
                     processingOccured = true;
                 }
             }
@@ -78,7 +80,8 @@ bool EngineEffectRack::process(const ChannelHandle& inputHandle,
 
                 if (pChain->process(inputHandle, outputHandle,
                                     pIntermediateInput, pIntermediateOutput,
-                                    numSamples, sampleRate, groupFeatures)) {
+                                    numSamples, sampleRate, groupFeatures,
+                                    pScratch)) {
                     processingOccured = true;
                     // Output of this chain becomes the input of the next chain.
                     pIntermediateInput = pIntermediateOutput;
@@ -94,6 +97,15 @@ bool EngineEffectRack::process(const ChannelHandle& inputHandle,
     return processingOccured;
 }
 
+bool EngineEffectRack::canProcessChannelsConcurrently() const {
+    for (EngineEffectChain* pChain : m_chains) {
+        if (pChain != nullptr && !pChain->canProcessChannelsConcurrently()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool EngineEffectRack::addEffectChain(EngineEffectChain* pChain, int iIndex) {
     if (iIndex < 0) {
         if (kEffectDebugOutput) {
@@ -9,6 +9,7 @@
 #include "util/samplebuffer.h"
 
 class EngineEffectChain;
+struct EngineEffectScratchBuffers;
 
 //TODO(Be): Remove this superfluous class.
 class EngineEffectRack : public EffectsRequestHandler {
@@ -20,12 +21,17 @@ class EngineEffectRack : public EffectsRequestHandler {
         EffectsRequest& message,
         EffectsResponsePipe* pResponsePipe);
 
+    // Only in-place processing may run for different input channels
+    // concurrently. Otherwise the intermediate buffers of the rack are used.
     bool process(const ChannelHandle& inputHandle,
                  const ChannelHandle& outputHandle,
                  CSAMPLE* pIn, CSAMPLE* pOut,
                  const unsigned int numSamples,
                  const unsigned int sampleRate,
-                 const GroupFeatureState& groupFeatures);
+                 const GroupFeatureState& groupFeatures,
+                 EngineEffectScratchBuffers* pScratch);
+
+    bool canProcessChannelsConcurrently() const;
 
     int number() const {
         return m_iRackNumber;
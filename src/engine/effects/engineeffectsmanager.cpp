@@ -3,23 +3,154 @@
 #include "engine/effects/engineeffectrack.h"
 #include "engine/effects/engineeffectchain.h"
 #include "engine/effects/engineeffect.h"
+#include "engine/enginejobpool.h"
 
+#include "util/callbacktrace.h"
 #include "util/defs.h"
 #include "util/sample.h"
 
+namespace {
+
+// The maximum number of channels in a parallel batch. Further channels
+// are processed immediately.
+const int kMaxBatchJobs = 64;
+
+} // anonymous namespace
+
+// Processes the post-fader effects of one input channel in place
+class EngineEffectsManager::ChannelJob final : public EngineJob {
+  public:
+    explicit ChannelJob(EngineEffectsManager* pManager)
+            : m_pManager(pManager),
+              m_pInOut(nullptr),
+              m_numSamples(0),
+              m_sampleRate(0),
+              m_oldGain(CSAMPLE_GAIN_ONE),
+              m_newGain(CSAMPLE_GAIN_ONE) {
+    }
+
+    void schedule(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            CSAMPLE* pInOut,
+            unsigned int numSamples,
+            unsigned int sampleRate,
+            const GroupFeatureState& groupFeatures,
+            CSAMPLE_GAIN oldGain,
+            CSAMPLE_GAIN newGain) {
+        m_inputHandle = inputHandle;
+        m_outputHandle = outputHandle;
+        m_pInOut = pInOut;
+        m_numSamples = numSamples;
+        m_sampleRate = sampleRate;
+        m_groupFeatures = groupFeatures;
+        m_oldGain = oldGain;
+        m_newGain = newGain;
+    }
+
+    void run(int threadIndex) override {
+        if (threadIndex > 0) {
+            CallbackTrace::setThreadStageTimes(
+                    m_pManager->m_workerStageTimes[threadIndex - 1].data());
+        }
+        m_pManager->processInner(SignalProcessingStage::Postfader,
+                m_inputHandle, m_outputHandle,
+                m_pInOut, m_pInOut,
+                m_numSamples, m_sampleRate, m_groupFeatures,
+                m_oldGain, m_newGain,
+                m_pManager->m_scratchBuffers[threadIndex].get());
+    }
+
+  private:
+    EngineEffectsManager* const m_pManager;
+    ChannelHandle m_inputHandle;
+    ChannelHandle m_outputHandle;
+    CSAMPLE* m_pInOut;
+    unsigned int m_numSamples;
+    unsigned int m_sampleRate;
+    GroupFeatureState m_groupFeatures;
+    CSAMPLE_GAIN m_oldGain;
+    CSAMPLE_GAIN m_newGain;
+};
+
 EngineEffectsManager::EngineEffectsManager(EffectsResponsePipe* pResponsePipe)
         : m_pResponsePipe(pResponsePipe),
           m_buffer1(MAX_BUFFER_LEN),
-          m_buffer2(MAX_BUFFER_LEN) {
+          m_buffer2(MAX_BUFFER_LEN),
+          m_bBatchStarted(false),
+          m_batchTraceStage(CallbackTrace::registerStage(
+                  "Parallel post-fader effects")) {
     // Try to prevent memory allocation.
     m_chains.reserve(256);
     m_effects.reserve(256);
+    m_scratchBuffers.push_back(std::make_unique<EngineEffectScratchBuffers>());
 }
 
 EngineEffectsManager::~EngineEffectsManager() {
+    // Stop the workers before the buffers they use are freed
+    m_pJobPool.reset();
+}
+
+void EngineEffectsManager::setParallelProcessingWorkers(int numWorkers) {
+    // Stops the previous workers
+    m_pJobPool.reset();
+    m_scratchBuffers.resize(1);
+    m_workerStageTimes.clear();
+    m_channelJobs.clear();
+    m_scheduledJobs.clear();
+    if (numWorkers <= 0) {
+        return;
+    }
+    for (int i = 0; i < numWorkers; ++i) {
+        m_scratchBuffers.push_back(std::make_unique<EngineEffectScratchBuffers>());
+        m_workerStageTimes.emplace_back(CallbackTrace::kMaxStages, 0);
+    }
+    for (int i = 0; i < kMaxBatchJobs; ++i) {
+        m_channelJobs.push_back(std::make_unique<ChannelJob>(this));
+    }
+    m_scheduledJobs.reserve(kMaxBatchJobs);
+    m_pJobPool = std::make_unique<EngineJobPool>(numWorkers);
+}
+
+void EngineEffectsManager::beginParallelBatch() {
+    DEBUG_ASSERT(!m_bBatchStarted);
+    m_bBatchStarted = m_pJobPool &&
+            canProcessChannelsConcurrently(SignalProcessingStage::Postfader);
+}
+
+void EngineEffectsManager::finishParallelBatch() {
+    if (!m_bBatchStarted) {
+        return;
+    }
+    m_bBatchStarted = false;
+    {
+        ScopedCallbackTraceStage traceStage(m_batchTraceStage);
+        m_pJobPool->run(m_scheduledJobs.data(),
+                static_cast<int>(m_scheduledJobs.size()));
+    }
+    m_scheduledJobs.clear();
+    if (CallbackTrace::isEnabled()) {
+        // The time spent in each chain, summed over all threads
+        for (auto& stageTimes : m_workerStageTimes) {
+            CallbackTrace::addStageTimes(stageTimes.data());
+        }
+    }
+}
+
+bool EngineEffectsManager::canProcessChannelsConcurrently(
+        SignalProcessingStage stage) const {
+    for (EngineEffectRack* pRack : m_racksByStage.value(stage)) {
+        if (pRack != nullptr && !pRack->canProcessChannelsConcurrently()) {
+            return false;
+        }
+    }
+    return true;
 }
 
 void EngineEffectsManager::onCallbackStart() {
+    for (EngineEffectChain* pChain : m_chains) {
+        pChain->onCallbackStart();
+    }
+
     EffectsRequest* request = NULL;
     while (m_pResponsePipe->readMessage(&request)) {
         EffectsResponse response(*request);
@@ -133,7 +264,9 @@ void EngineEffectsManager::processPreFaderInPlace(const ChannelHandle& inputHand
     processInner(SignalProcessingStage::Prefader,
                  inputHandle, outputHandle,
                  pInOut, pInOut,
-                 numSamples, sampleRate, featureState);
+                 numSamples, sampleRate, featureState,
+                 CSAMPLE_GAIN_ONE, CSAMPLE_GAIN_ONE,
+                 m_scratchBuffers[0].get());
 }
 
 void EngineEffectsManager::processPostFaderInPlace(
@@ -145,11 +278,20 @@ void EngineEffectsManager::processPostFaderInPlace(
     const GroupFeatureState& groupFeatures,
     const CSAMPLE_GAIN oldGain,
     const CSAMPLE_GAIN newGain) {
+    if (m_bBatchStarted && m_scheduledJobs.size() < m_channelJobs.size()) {
+        ChannelJob* pJob = m_channelJobs[m_scheduledJobs.size()].get();
+        pJob->schedule(inputHandle, outputHandle, pInOut,
+                numSamples, sampleRate, groupFeatures,
+                oldGain, newGain);
+        m_scheduledJobs.push_back(pJob);
+        return;
+    }
     processInner(SignalProcessingStage::Postfader,
                  inputHandle, outputHandle,
                  pInOut, pInOut,
                  numSamples, sampleRate, groupFeatures,
-                 oldGain, newGain);
+                 oldGain, newGain,
+                 m_scratchBuffers[0].get());
 }
 
 void EngineEffectsManager::processPostFaderAndMix(
@@ -165,7 +307,8 @@ void EngineEffectsManager::processPostFaderAndMix(
                  inputHandle, outputHandle,
                  pIn, pOut,
                  numSamples, sampleRate, groupFeatures,
-                 oldGain, newGain);
+                 oldGain, newGain,
+                 m_scratchBuffers[0].get());
 }
 
 void EngineEffectsManager::processInner(
@@ -177,7 +320,8 @@ void EngineEffectsManager::processInner(
     const unsigned int sampleRate,
     const GroupFeatureState& groupFeatures,
     const CSAMPLE_GAIN oldGain,
-    const CSAMPLE_GAIN newGain) {
+    const CSAMPLE_GAIN newGain,
+    EngineEffectScratchBuffers* pScratch) {
 
     const QList<EngineEffectRack*>& racks = m_racksByStage.value(stage);
     if (pIn == pOut) {
@@ -188,7 +332,8 @@ void EngineEffectsManager::processInner(
             if (pRack != nullptr) {
                 pRack->process(inputHandle, outputHandle,
                                pIn, pIn,
-                               numSamples, sampleRate, groupFeatures);
+                               numSamples, sampleRate, groupFeatures,
+                               pScratch);
             }
         }
     } else {
@@ -221,7 +366,8 @@ void EngineEffectsManager::processInner(
 
                 if (pRack->process(inputHandle, outputHandle,
                                    pIntermediateInput, pIntermediateOutput,
-                                   numSamples, sampleRate, groupFeatures)) {
+                                   numSamples, sampleRate, groupFeatures,
+                                   pScratch)) {
                     // Output of this rack becomes the input of the next rack.
                     pIntermediateInput = pIntermediateOutput;
                 }
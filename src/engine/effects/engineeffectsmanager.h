@@ -1,6 +1,9 @@
 #ifndef ENGINEEFFECTSMANAGER_H
 #define ENGINEEFFECTSMANAGER_H
 
+#include <memory>
+#include <vector>
+
 #include <QScopedPointer>
 
 #include "util/samplebuffer.h"
@@ -13,6 +16,9 @@
 class EngineEffectRack;
 class EngineEffectChain;
 class EngineEffect;
+class EngineJob;
+class EngineJobPool;
+struct EngineEffectScratchBuffers;
 
 class EngineEffectsManager : public EffectsRequestHandler {
   public:
@@ -21,6 +27,22 @@ class EngineEffectsManager : public EffectsRequestHandler {
 
     void onCallbackStart();
 
+    // Processes the post-fader effects of the channels in a parallel batch
+    // on numWorkers threads in addition to the engine thread. With 0 workers
+    // all effects are processed on the engine thread. Must not be called
+    // while the engine is running.
+    void setParallelProcessingWorkers(int numWorkers);
+
+    // Between these calls processPostFaderInPlace() only schedules the
+    // processing of a channel. finishParallelBatch() processes all scheduled
+    // channels in parallel and returns when they are done. The buffers of the
+    // scheduled channels must not be accessed before, and every input
+    // channel may only be scheduled once per batch. Channels are processed
+    // immediately if there are no workers or an effect of the post-fader
+    // racks cannot process channels concurrently.
+    void beginParallelBatch();
+    void finishParallelBatch();
+
     // Take a buffer of numSamples samples of audio from a channel, provided as
     // pInput, and apply each EffectChain enabled for this channel to it,
     // putting the resulting output in pOutput. If pInput is equal to pOutput,
@@ -73,6 +95,10 @@ class EngineEffectsManager : public EffectsRequestHandler {
     bool addPostFaderEffectRack(EngineEffectRack* pRack);
     bool removePostFaderEffectRack(EngineEffectRack* pRack);
 
+    bool canProcessChannelsConcurrently(SignalProcessingStage stage) const;
+
+    // Must only be called concurrently for in-place processing of different
+    // input channels with different scratch buffers.
     void processInner(const SignalProcessingStage stage,
                       const ChannelHandle& inputHandle,
                       const ChannelHandle& outputHandle,
@@ -80,8 +106,11 @@ class EngineEffectsManager : public EffectsRequestHandler {
                       const unsigned int numSamples,
                       const unsigned int sampleRate,
                       const GroupFeatureState& groupFeatures,
-                      const CSAMPLE_GAIN oldGain = CSAMPLE_GAIN_ONE,
-                      const CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE);
+                      const CSAMPLE_GAIN oldGain,
+                      const CSAMPLE_GAIN newGain,
+                      EngineEffectScratchBuffers* pScratch);
+
+    class ChannelJob;
 
     QScopedPointer<EffectsResponsePipe> m_pResponsePipe;
     QHash<SignalProcessingStage, QList<EngineEffectRack*>> m_racksByStage;
@@ -90,6 +119,16 @@ class EngineEffectsManager : public EffectsRequestHandler {
 
     mixxx::SampleBuffer m_buffer1;
     mixxx::SampleBuffer m_buffer2;
+
+    std::unique_ptr<EngineJobPool> m_pJobPool;
+    // Indexed by the thread index of the job pool, the engine thread first
+    std::vector<std::unique_ptr<EngineEffectScratchBuffers>> m_scratchBuffers;
+    // CallbackTrace stage times of the workers, collected after each batch
+    std::vector<std::vector<qint64>> m_workerStageTimes;
+    std::vector<std::unique_ptr<ChannelJob>> m_channelJobs;
+    std::vector<EngineJob*> m_scheduledJobs;
+    bool m_bBatchStarted;
+    const int m_batchTraceStage;
 };
 
 
@@ -28,6 +28,7 @@
 #include "engine/readaheadmanager.h"
 #include "engine/sync/enginesync.h"
 #include "engine/sync/synccontrol.h"
+#include "mixer/playermanager.h"
 #include "track/beatfactory.h"
 #include "track/keyutils.h"
 #include "track/track.h"
@@ -50,6 +51,9 @@ const double kLinearScalerElipsis = 1.00058; // 2^(0.01/12): changes < 1 cent al
 
 const SINT kSamplesPerFrame = 2; // Engine buffer uses Stereo frames only
 
+// Interned up front instead of in the audio callback
+const StatTag kProcessTrackLockedTimerTag("EngineBuffer::process_pauselock");
+
 } // anonymous namespace
 
 EngineBuffer::EngineBuffer(const QString& group,
@@ -238,7 +242,7 @@ EngineBuffer::EngineBuffer(const QString& group,
     // Construct scaling objects
     m_pScaleLinear = new EngineBufferScaleLinear(m_pReadAheadManager);
     m_pScaleST = new EngineBufferScaleST(m_pReadAheadManager);
-    m_pScaleRB = new EngineBufferScaleRubberBand(m_pReadAheadManager);
+    m_pScaleRB = new EngineBufferScaleRubberBand(m_pReadAheadManager, group);
     if (m_pKeylockEngine->get() == SOUNDTOUCH) {
         m_pScaleKeylock = m_pScaleST;
     } else {
@@ -508,6 +512,7 @@ void EngineBuffer::slotTrackLoaded(TrackPointer pTrack,
     m_visualPlayPos->setInvalid();
     m_filepos_play = DBL_MIN; // for execute seeks to 0.0
     m_pCurrentTrack = pTrack;
+    m_pScaleRB->newTrack(pTrack);
     m_pTrackSamples->set(iTrackNumSamples);
     m_pTrackSampleRate->set(iTrackSampleRate);
     // Reset slip mode
@@ -562,6 +567,7 @@ void EngineBuffer::ejectTrack() {
 
     // Close open file handles by unloading the current track
     m_pReader->newTrack(TrackPointer());
+    m_pScaleRB->newTrack(TrackPointer());
 
     if (pTrack) {
         notifyTrackLoaded(TrackPointer(), pTrack);
@@ -706,7 +712,7 @@ void EngineBuffer::slotKeylockEngineChanged(double dIndex) {
 
 void EngineBuffer::processTrackLocked(
         CSAMPLE* pOutput, const int iBufferSize, int sample_rate) {
-    ScopedTimer t("EngineBuffer::process_pauselock");
+    ScopedTimer t(kProcessTrackLockedTimerTag);
 
     m_trackSampleRateOld = m_pTrackSampleRate->get();
     m_trackSamplesOld = m_pTrackSamples->get();
@@ -1010,6 +1016,7 @@ void EngineBuffer::process(CSAMPLE* pOutput, const int iBufferSize) {
         return;
     }
     m_pReader->process();
+    m_pScaleRB->wakeWorkersIfNewTrack();
     // Steps:
     // - Lookup new reader information
     // - Calculate current rate
@@ -1301,6 +1308,12 @@ void EngineBuffer::addControl(EngineControl* pControl) {
 
 void EngineBuffer::bindWorkers(EngineWorkerScheduler* pWorkerScheduler) {
     m_pReader->setScheduler(pWorkerScheduler);
+    // Rendering ahead costs a thread and a second decoder of the track per
+    // deck. It is only offered for the main decks.
+    if (PlayerManager::isDeckGroup(m_group) &&
+            m_pConfig->getValue(ConfigKey("[Master]", "keylock_render_ahead"), false)) {
+        m_pScaleRB->bindWorkers(pWorkerScheduler);
+    }
 }
 
 bool EngineBuffer::isTrackLoaded() {
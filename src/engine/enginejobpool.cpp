@@ -0,0 +1,157 @@
+#include "engine/enginejobpool.h"
+
+#include <QThread>
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/performancetimer.h"
+#include "util/wakesemaphore.h"
+
+namespace {
+
+// How long an idle worker keeps spinning after it has run a job before it
+// goes to sleep. The engine usually submits several batches per callback.
+const qint64 kSpinMicros = 200;
+
+constexpr quint64 kIndexMask = 0xFFFF;
+constexpr int kCountShift = 16;
+constexpr int kGenerationShift = 32;
+
+} // anonymous namespace
+
+constexpr int EngineJobPool::kMaxJobs;
+
+class EngineJobPool::Worker : public QThread {
+  public:
+    Worker(EngineJobPool* pPool, int threadIndex)
+            : m_pPool(pPool),
+              m_threadIndex(threadIndex),
+              m_sleeping(false) {
+        setObjectName(QString("EngineJobPool %1").arg(threadIndex));
+    }
+
+    // Wakes the worker if it is asleep
+    void wakeUp() {
+        if (m_sleeping.load() && m_sleeping.exchange(false)) {
+            m_semaWake.release();
+        }
+    }
+
+    // Wakes the worker to quit, whether it is asleep or not.
+    void wakeToQuit() {
+        m_semaWake.release();
+    }
+
+  protected:
+    void run() override {
+        PerformanceTimer idleTimer;
+        idleTimer.start();
+        while (!m_pPool->m_quit.load(std::memory_order_acquire)) {
+            if (m_pPool->runPendingJobs(m_threadIndex)) {
+                idleTimer.start();
+            } else if (idleTimer.elapsed().toIntegerMicros() < kSpinMicros) {
+                QThread::yieldCurrentThread();
+            } else {
+                waitForBatch();
+                idleTimer.start();
+            }
+        }
+    }
+
+  private:
+    void waitForBatch() {
+        // Pairs with the batch being published before wakeUp() checks the
+        // flag, so either we see the batch or the engine thread sees us
+        // sleeping.
+        m_sleeping.store(true);
+        if (m_pPool->hasPendingJobs()) {
+            if (m_sleeping.exchange(false)) {
+                return;
+            }
+            // The engine thread has cleared the flag and releases the
+            // semaphore
+        }
+        m_semaWake.acquire();
+    }
+
+    EngineJobPool* const m_pPool;
+    const int m_threadIndex;
+    std::atomic<bool> m_sleeping;
+    WakeSemaphore m_semaWake;
+};
+
+EngineJobPool::EngineJobPool(int numWorkers)
+        : m_claim(0),
+          m_remainingJobs(0),
+          m_ppJobs(nullptr),
+          m_quit(false) {
+    for (int i = 1; i <= numWorkers; ++i) {
+        m_workers.push_back(std::make_unique<Worker>(this, i));
+        m_workers.back()->start(QThread::TimeCriticalPriority);
+    }
+}
+
+EngineJobPool::~EngineJobPool() {
+    m_quit.store(true, std::memory_order_release);
+    for (const auto& pWorker : m_workers) {
+        pWorker->wakeToQuit();
+    }
+    for (const auto& pWorker : m_workers) {
+        pWorker->wait();
+    }
+}
+
+void EngineJobPool::run(EngineJob* const* ppJobs, int numJobs) {
+    VERIFY_OR_DEBUG_ASSERT(numJobs <= kMaxJobs) {
+        numJobs = kMaxJobs;
+    }
+    if (numJobs <= 0) {
+        return;
+    }
+    if (m_workers.empty() || numJobs == 1) {
+        for (int i = 0; i < numJobs; ++i) {
+            ppJobs[i]->run(0);
+        }
+        return;
+    }
+
+    // The previous batch is done, so no worker reads m_ppJobs now
+    m_ppJobs = ppJobs;
+    m_remainingJobs.store(numJobs, std::memory_order_relaxed);
+    const quint64 generation =
+            (m_claim.load(std::memory_order_relaxed) >> kGenerationShift) + 1;
+    m_claim.store((generation << kGenerationShift) |
+            (static_cast<quint64>(numJobs) << kCountShift));
+
+    // The engine thread takes one job itself, so wake no more workers than
+    // there are other jobs
+    const int numWorkers = math_min(numJobs - 1, workerCount());
+    for (int i = 0; i < numWorkers; ++i) {
+        m_workers[i]->wakeUp();
+    }
+
+    runPendingJobs(0);
+    // Wait for the jobs that workers are still running
+    while (m_remainingJobs.load(std::memory_order_acquire) > 0) {
+    }
+}
+
+bool EngineJobPool::runPendingJobs(int threadIndex) {
+    bool ranJobs = false;
+    quint64 claim = m_claim.load(std::memory_order_acquire);
+    while ((claim & kIndexMask) < ((claim >> kCountShift) & kIndexMask)) {
+        if (m_claim.compare_exchange_weak(claim, claim + 1,
+                    std::memory_order_acquire, std::memory_order_acquire)) {
+            m_ppJobs[claim & kIndexMask]->run(threadIndex);
+            m_remainingJobs.fetch_sub(1, std::memory_order_release);
+            ranJobs = true;
+            claim = m_claim.load(std::memory_order_acquire);
+        }
+    }
+    return ranJobs;
+}
+
+bool EngineJobPool::hasPendingJobs() const {
+    const quint64 claim = m_claim.load();
+    return (claim & kIndexMask) < ((claim >> kCountShift) & kIndexMask);
+}
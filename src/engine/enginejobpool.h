@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QtGlobal>
+
+#include "util/class.h"
+
+// A unit of work that EngineJobPool runs either on the engine thread or on
+// one of its workers. Jobs are owned and reused by the caller, so running
+// them neither allocates nor frees memory.
+class EngineJob {
+  public:
+    virtual ~EngineJob() = default;
+
+    // threadIndex is 0 on the engine thread and 1..workerCount() on the
+    // workers, so jobs can pick per-thread scratch memory.
+    virtual void run(int threadIndex) = 0;
+};
+
+// EngineJobPool runs batches of independent jobs for the engine thread on a
+// fixed set of worker threads. The engine thread never locks a mutex: it
+// publishes a batch with a single atomic store, processes jobs itself like
+// any worker, and afterwards only spins until the jobs that workers have
+// already started are done.
+//
+// Idle workers spin for a short while after each batch, because more batches
+// usually follow within the same callback. Between callbacks they block on a
+// WakeSemaphore, which the engine thread only releases for workers that are
+// asleep. Waking them costs at most one release per worker and callback,
+// which does not lock a mutex but may be a system call.
+// A worker that is late does not delay a batch, since the engine thread
+// processes all jobs that no worker has picked up yet.
+class EngineJobPool final {
+  public:
+    // The maximum number of jobs in one batch
+    static constexpr int kMaxJobs = 0xFFFF;
+
+    explicit EngineJobPool(int numWorkers);
+    ~EngineJobPool();
+
+    int workerCount() const {
+        return static_cast<int>(m_workers.size());
+    }
+
+    // Runs all jobs and returns once they are done. Realtime safe. Must
+    // only be called from the engine thread.
+    void run(EngineJob* const* ppJobs, int numJobs);
+
+  private:
+    class Worker;
+
+    // Runs jobs of the current batch until none are left to start.
+    // Returns true if any job was run.
+    bool runPendingJobs(int threadIndex);
+    bool hasPendingJobs() const;
+
+    // The generation of the batch (upper 32 bits), the number of its jobs
+    // (next 16 bits) and the index of the next job to start (lower 16 bits).
+    // Workers claim jobs by incrementing the index. A worker that still
+    // holds the claim of a previous batch fails to claim a job, because the
+    // generation has changed.
+    std::atomic<quint64> m_claim;
+    std::atomic<int> m_remainingJobs;
+    // Written by the engine thread before publishing a batch
+    EngineJob* const* m_ppJobs;
+
+    std::atomic<bool> m_quit;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    DISALLOW_COPY_AND_ASSIGN(EngineJobPool);
+};
@@ -36,6 +36,10 @@ EngineMaster::EngineMaster(UserSettingsPointer pConfig,
                            bool bEnableSidechain)
         : m_pChannelHandleFactory(pChannelHandleFactory),
           m_pEngineEffectsManager(pEffectsManager ? pEffectsManager->getEngineEffectsManager() : NULL),
+          m_traceStageSync(CallbackTrace::registerStage("Sync")),
+          m_traceStageHeadphoneMix(CallbackTrace::registerStage("Headphone mix")),
+          m_traceStageMasterMix(CallbackTrace::registerStage("Master mix")),
+          m_traceStageSidechain(CallbackTrace::registerStage("Sidechain")),
           m_masterGainOld(0.0),
           m_boothGainOld(0.0),
           m_headphoneMasterGainOld(0.0),
@@ -351,7 +355,10 @@ void EngineMaster::processChannels(int iBufferSize) {
              i < m_activeChannels.size(); ++i) {
         ChannelInfo* pChannelInfo = m_activeChannels[i];
         EngineChannel* pChannel = pChannelInfo->m_pChannel;
-        pChannel->process(pChannelInfo->m_pBuffer, iBufferSize);
+        {
+            ScopedCallbackTraceStage traceStage(pChannelInfo->m_traceStage);
+            pChannel->process(pChannelInfo->m_pBuffer, iBufferSize);
+        }
 
         // Collect metadata for effects
         if (m_pEngineEffectsManager) {
@@ -394,11 +401,17 @@ void EngineMaster::process(const int iBufferSize) {
     }
 
     // Update internal master sync rate.
-    m_pMasterSync->onCallbackStart(m_iSampleRate, m_iBufferSize);
+    {
+        ScopedCallbackTraceStage traceStage(m_traceStageSync);
+        m_pMasterSync->onCallbackStart(m_iSampleRate, m_iBufferSize);
+    }
     // Prepare each channel for output
     processChannels(m_iBufferSize);
     // Do internal master sync post-processing
-    m_pMasterSync->onCallbackEnd(m_iSampleRate, m_iBufferSize);
+    {
+        ScopedCallbackTraceStage traceStage(m_traceStageSync);
+        m_pMasterSync->onCallbackEnd(m_iSampleRate, m_iBufferSize);
+    }
 
     // Compute headphone mix
     // Head phone left/right mix
@@ -416,6 +429,7 @@ void EngineMaster::process(const int iBufferSize) {
     m_headphoneGain.setGain(pflMixGainInHeadphones);
 
     if (headphoneEnabled) {
+        ScopedCallbackTraceStage traceStage(m_traceStageHeadphoneMix);
         // Process effects and mix PFL channels together for the headphones.
         // Effects will be reprocessed post-fader for the crossfader busses
         // and master mix, so the channel input buffers cannot be modified here.
@@ -515,6 +529,7 @@ void EngineMaster::process(const int iBufferSize) {
     }
 
     if (masterEnabled) {
+        ScopedCallbackTraceStage traceStage(m_traceStageMasterMix);
         // Mix the crossfader orientation buffers together into the master mix
         SampleUtil::copy3WithGain(m_pMaster,
             m_pOutputBusBuffers[EngineChannel::LEFT], 1.0,
@@ -667,6 +682,7 @@ void EngineMaster::process(const int iBufferSize) {
         // so skip sending a buffer to m_pSidechain here.
         if (!m_bExternalRecordBroadcastInputConnected
             && m_pEngineSideChain != nullptr) {
+            ScopedCallbackTraceStage traceStage(m_traceStageSidechain);
             m_pEngineSideChain->writeSamples(m_pSidechainMix, iFrames);
         }
 
@@ -773,6 +789,8 @@ void EngineMaster::addChannel(EngineChannel* pChannel) {
     pChannelInfo->m_pChannel = pChannel;
     const QString& group = pChannel->getGroup();
     pChannelInfo->m_handle = m_pChannelHandleFactory->getOrCreateHandle(group);
+    pChannelInfo->m_traceStage = CallbackTrace::registerStage(
+            QString("Channel %1").arg(group));
     pChannelInfo->m_pVolumeControl = new ControlAudioTaperPot(
             ConfigKey(group, "volume"), -20, 0, 1);
     pChannelInfo->m_pVolumeControl->setDefaultValue(1.0);
@@ -30,6 +30,7 @@
 #include "soundio/soundmanager.h"
 #include "soundio/soundmanagerutil.h"
 #include "recording/recordingmanager.h"
+#include "util/callbacktrace.h"
 
 class EngineWorkerScheduler;
 class EngineBuffer;
@@ -129,7 +130,8 @@ class EngineMaster : public QObject, public AudioSource {
                   m_pBuffer(NULL),
                   m_pVolumeControl(NULL),
                   m_pMuteControl(NULL),
-                  m_index(index) {
+                  m_index(index),
+                  m_traceStage(CallbackTrace::kInvalidStage) {
         }
         ChannelHandle m_handle;
         EngineChannel* m_pChannel;
@@ -138,6 +140,8 @@ class EngineMaster : public QObject, public AudioSource {
         ControlPushButton* m_pMuteControl;
         GroupFeatureState m_features;
         int m_index;
+        // CallbackTrace stage for processing this channel.
+        int m_traceStage;
     };
 
     struct GainCache {
@@ -324,6 +328,12 @@ class EngineMaster : public QObject, public AudioSource {
     EngineVuMeter* m_pVumeter;
     EngineSideChain* m_pEngineSideChain;
 
+    // CallbackTrace stages. Effect chains register their own stages.
+    const int m_traceStageSync;
+    const int m_traceStageHeadphoneMix;
+    const int m_traceStageMasterMix;
+    const int m_traceStageSidechain;
+
     ControlPotmeter* m_pCrossfader;
     ControlPotmeter* m_pHeadMix;
     ControlPotmeter* m_pBalance;
@@ -40,7 +40,7 @@ void EngineWorkerScheduler::runWorkers() {
 }
 
 void EngineWorkerScheduler::run() {
-    static const QString tag("EngineWorkerScheduler");
+    static const StatTag tag("EngineWorkerScheduler");
     while (!m_bQuit) {
         Event::start(tag);
         {
@@ -0,0 +1,222 @@
+#include "engine/sidechain/bufferedfilewriter.h"
+
+#include <QMutexLocker>
+
+#ifdef __WINDOWS__
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("BufferedFileWriter");
+
+} // anonymous namespace
+
+constexpr int BufferedFileWriter::kDefaultBufferSize;
+constexpr qint64 BufferedFileWriter::kPreallocateBytes;
+constexpr int BufferedFileWriter::kSyncIntervalMillis;
+
+BufferedFileWriter::BufferedFileWriter(int bufferSize)
+        : m_bufferSize(bufferSize),
+          m_pFront(&m_buffers[0]),
+          m_pos(0),
+          m_size(0),
+          m_bOpen(false),
+          m_pBack(nullptr),
+          m_bStop(false),
+          m_preallocatedEnd(0),
+          m_bWriteError(false),
+          m_bufferedBytes(0),
+          m_stallCount(0) {
+    for (Buffer& buffer : m_buffers) {
+        // Allocate and touch the memory now, so the producer never has to.
+        buffer.data.fill('\0', m_bufferSize);
+        buffer.used = 0;
+        buffer.offset = 0;
+    }
+}
+
+BufferedFileWriter::~BufferedFileWriter() {
+    close();
+}
+
+bool BufferedFileWriter::open(const QString& fileName) {
+    VERIFY_OR_DEBUG_ASSERT(!m_bOpen) {
+        close();
+    }
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        kLogger.warning() << "Failed to open" << fileName << m_file.errorString();
+        return false;
+    }
+    m_pFront = &m_buffers[0];
+    m_pFront->used = 0;
+    m_pFront->offset = 0;
+    m_pos = 0;
+    m_size = 0;
+    m_pBack = nullptr;
+    m_bStop = false;
+    m_preallocatedEnd = 0;
+    m_bWriteError.store(false);
+    m_bufferedBytes.store(0);
+    m_stallCount.store(0);
+    m_syncTimer.start();
+    m_bOpen = true;
+    start(QThread::HighPriority);
+    return true;
+}
+
+void BufferedFileWriter::close() {
+    if (!m_bOpen) {
+        return;
+    }
+    if (m_pFront->used > 0) {
+        submitFrontBuffer();
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        m_bStop = true;
+        m_writeRequested.wakeAll();
+    }
+    wait();
+    sync();
+    // Releases the space preallocated past the end of the data.
+    if (!m_bWriteError) {
+        m_file.resize(m_size);
+    }
+    m_file.close();
+    m_bOpen = false;
+    m_bufferedBytes.store(0);
+}
+
+void BufferedFileWriter::write(const char* data, int size) {
+    if (!m_bOpen) {
+        return;
+    }
+    while (size > 0) {
+        if (m_pFront->used == m_bufferSize) {
+            submitFrontBuffer();
+        }
+        const int chunk = qMin(size, m_bufferSize - m_pFront->used);
+        memcpy(m_pFront->data.data() + m_pFront->used, data, chunk);
+        m_pFront->used += chunk;
+        m_bufferedBytes.fetch_add(chunk, std::memory_order_relaxed);
+        data += chunk;
+        size -= chunk;
+        m_pos += chunk;
+        m_size = qMax(m_size, m_pos);
+    }
+}
+
+bool BufferedFileWriter::seek(qint64 pos) {
+    if (!m_bOpen || pos < 0) {
+        return false;
+    }
+    if (pos == m_pos) {
+        return true;
+    }
+    if (m_pFront->used > 0) {
+        submitFrontBuffer();
+    }
+    m_pos = pos;
+    m_pFront->offset = pos;
+    return true;
+}
+
+void BufferedFileWriter::submitFrontBuffer() {
+    QMutexLocker locker(&m_mutex);
+    if (m_pBack != nullptr) {
+        // The disk does not keep up.
+        m_stallCount.fetch_add(1, std::memory_order_relaxed);
+        while (m_pBack != nullptr) {
+            m_writeDone.wait(&m_mutex);
+        }
+    }
+    m_pBack = m_pFront;
+    m_writeRequested.wakeAll();
+    locker.unlock();
+
+    m_pFront = (m_pBack == &m_buffers[0]) ? &m_buffers[1] : &m_buffers[0];
+    m_pFront->used = 0;
+    m_pFront->offset = m_pos;
+}
+
+void BufferedFileWriter::run() {
+    QThread::currentThread()->setObjectName("BufferedFileWriter");
+    QMutexLocker locker(&m_mutex);
+    while (true) {
+        while (m_pBack == nullptr && !m_bStop) {
+            m_writeRequested.wait(&m_mutex);
+        }
+        if (m_pBack == nullptr) {
+            // Stop requested and everything is written.
+            break;
+        }
+        Buffer* pBuffer = m_pBack;
+        locker.unlock();
+
+        writeBuffer(*pBuffer);
+        m_bufferedBytes.fetch_sub(pBuffer->used, std::memory_order_relaxed);
+        if (m_syncTimer.elapsed().toIntegerMillis() >= kSyncIntervalMillis) {
+            sync();
+            m_syncTimer.restart();
+        }
+
+        locker.relock();
+        m_pBack = nullptr;
+        m_writeDone.wakeAll();
+    }
+}
+
+void BufferedFileWriter::writeBuffer(const Buffer& buffer) {
+    if (m_bWriteError || buffer.used == 0) {
+        return;
+    }
+    preallocate(buffer.offset + buffer.used);
+    if (m_file.pos() != buffer.offset && !m_file.seek(buffer.offset)) {
+        kLogger.warning() << "Seek failed" << m_file.fileName() << m_file.errorString();
+        m_bWriteError.store(true);
+        return;
+    }
+    // QFile buffers internally, pass the data on to the OS right away.
+    if (m_file.write(buffer.data.constData(), buffer.used) != buffer.used ||
+            !m_file.flush()) {
+        kLogger.warning() << "Write failed" << m_file.fileName() << m_file.errorString();
+        m_bWriteError.store(true);
+    }
+}
+
+void BufferedFileWriter::preallocate(qint64 end) {
+    if (end <= m_preallocatedEnd) {
+        return;
+    }
+    const qint64 newEnd = end + kPreallocateBytes;
+#ifdef __LINUX__
+    // Reserve contiguous space ahead of the write position without changing
+    // the file size. This keeps long recordings from fragmenting. Failure is
+    // harmless, e.g. the filesystem does not support it.
+    fallocate(m_file.handle(), FALLOC_FL_KEEP_SIZE,
+            m_preallocatedEnd, newEnd - m_preallocatedEnd);
+#endif
+    m_preallocatedEnd = newEnd;
+}
+
+void BufferedFileWriter::sync() {
+    if (!m_file.isOpen() || m_bWriteError) {
+        return;
+    }
+    m_file.flush();
+#if defined(__WINDOWS__)
+    _commit(m_file.handle());
+#elif defined(__LINUX__)
+    fdatasync(m_file.handle());
+#else
+    fsync(m_file.handle());
+#endif
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "util/performancetimer.h"
+
+// BufferedFileWriter moves file I/O off the thread that produces the data.
+// The producer fills one of two large preallocated buffers, while a
+// dedicated thread writes the other one to disk. This keeps slow or stalling
+// disks (e.g. SD cards) from backing up the sidechain.
+//
+// Writes are sequential. The file is preallocated ahead of the write
+// position where supported and synced to disk periodically, so a crash loses
+// at most a few seconds of a long recording.
+//
+// Seeking is supported (encoders rewrite headers when they finish), it hands
+// the current buffer to the writer thread and continues at the new offset.
+//
+// A failed write, e.g. because the disk is full, is not retried. All later
+// data is discarded, the producer polls hasWriteError() to stop in that case.
+//
+// All methods except bufferFill(), stallCount() and hasWriteError() must be
+// called from the producer thread.
+class BufferedFileWriter : public QThread {
+    Q_OBJECT
+  public:
+    // 4 MiB per buffer is about 20 seconds of 44.1 kHz stereo 24 bit WAV.
+    static constexpr int kDefaultBufferSize = 4 * 1024 * 1024;
+    // The file is extended in steps of this size ahead of the write position.
+    static constexpr qint64 kPreallocateBytes = 64 * 1024 * 1024;
+    static constexpr int kSyncIntervalMillis = 5000;
+
+    explicit BufferedFileWriter(int bufferSize = kDefaultBufferSize);
+    ~BufferedFileWriter() override;
+
+    // Truncates or creates the file and starts the writer thread.
+    bool open(const QString& fileName);
+    // Writes all pending data, syncs the file to disk and closes it.
+    void close();
+    bool isOpen() const {
+        return m_bOpen;
+    }
+
+    void write(const char* data, int size);
+    qint64 pos() const {
+        return m_pos;
+    }
+    bool seek(qint64 pos);
+    qint64 size() const {
+        return m_size;
+    }
+
+    // The fraction of the buffer capacity that holds data not yet written to
+    // disk, in the range [0, 1].
+    double bufferFill() const {
+        return m_bufferedBytes.load(std::memory_order_relaxed) /
+                (2.0 * m_bufferSize);
+    }
+    // The number of times the producer had to wait for the disk since open().
+    int stallCount() const {
+        return m_stallCount.load(std::memory_order_relaxed);
+    }
+    // Whether writing to the file has failed since open().
+    bool hasWriteError() const {
+        return m_bWriteError.load(std::memory_order_relaxed);
+    }
+
+  protected:
+    void run() override;
+
+  private:
+    struct Buffer {
+        QByteArray data;
+        int used;
+        // The file offset data is written to.
+        qint64 offset;
+    };
+
+    // Hands the front buffer to the writer thread. Waits if the writer
+    // is still busy with the back buffer.
+    void submitFrontBuffer();
+    void writeBuffer(const Buffer& buffer);
+    void preallocate(qint64 end);
+    void sync();
+
+    const int m_bufferSize;
+    Buffer m_buffers[2];
+
+    // Producer state
+    Buffer* m_pFront;
+    qint64 m_pos;
+    qint64 m_size;
+    bool m_bOpen;
+
+    // Shared state, guarded by m_mutex
+    QMutex m_mutex;
+    QWaitCondition m_writeRequested;
+    QWaitCondition m_writeDone;
+    Buffer* m_pBack;
+    bool m_bStop;
+
+    // Writer thread state
+    QFile m_file;
+    qint64 m_preallocatedEnd;
+    PerformanceTimer m_syncTimer;
+
+    std::atomic<bool> m_bWriteError;
+    std::atomic<int> m_bufferedBytes;
+    std::atomic<int> m_stallCount;
+};
@@ -45,6 +45,13 @@ EngineNetworkStream::EngineNetworkStream(int numOutputChannels,
       m_inputStreamFramesWritten(0),
       m_inputStreamFramesRead(0),
       m_outputWorkers(BROADCAST_MAX_CONNECTIONS) {
+    if (numOutputChannels) {
+        // Workers that fall more than two chunks behind drop the output
+        // before the producer overwrites it.
+        m_pOutputRing = QSharedPointer<SpmcRing<CSAMPLE>>::create(
+                numOutputChannels * kBufferFrames,
+                numOutputChannels * kNetworkLatencyFrames * 2);
+    }
     if (numInputChannels) {
         m_pInputFifo = new FIFO<CSAMPLE>(numInputChannels * kBufferFrames);
     }
@@ -187,9 +194,7 @@ void EngineNetworkStream::addOutputWorker(NetworkOutputStreamWorkerPtr pWorker)
     if (pWorker && m_numOutputChannels) {
         int nextNullItem = nextOutputSlotAvailable();
         if(nextNullItem > -1) {
-            QSharedPointer<FIFO<CSAMPLE>> workerFifo(
-                    new FIFO<CSAMPLE>(m_numOutputChannels * kBufferFrames));
-            pWorker->setOutputFifo(workerFifo);
+            pWorker->setOutputRing(m_pOutputRing);
             pWorker->startStream(m_sampleRate, m_numOutputChannels);
             m_outputWorkers[nextNullItem] = pWorker;
 
@@ -3,10 +3,12 @@
 
 #include <engine/sidechain/networkoutputstreamworker.h>
 #include <engine/sidechain/networkinputstreamworker.h>
+#include <QSharedPointer>
 #include <QVector>
 
 #include "util/types.h"
 #include "util/fifo.h"
+#include "util/spmcring.h"
 
 class EngineNetworkStream {
   public:
@@ -41,11 +43,17 @@ class EngineNetworkStream {
         return m_outputWorkers;
     }
 
+    // The output of the network sound device, shared by all output workers
+    QSharedPointer<SpmcRing<CSAMPLE>> outputRing() {
+        return m_pOutputRing;
+    }
+
   private:
     int nextOutputSlotAvailable();
     void debugOutputSlots();
 
     FIFO<CSAMPLE>* m_pInputFifo;
+    QSharedPointer<SpmcRing<CSAMPLE>> m_pOutputRing;
     int m_numOutputChannels;
     int m_numInputChannels;
     double m_sampleRate;
@@ -30,6 +30,16 @@ EngineRecord::EngineRecord(UserSettingsPointer pConfig)
     m_pRecReady = new ControlProxy(RECORDING_PREF_KEY, "status", this);
     m_pSamplerate = new ControlProxy("[Master]", "samplerate", this);
     m_sampleRate = m_pSamplerate->get();
+
+    m_pWriteBufferFill = new ControlObject(
+            ConfigKey(RECORDING_PREF_KEY, "write_buffer_fill"));
+    m_pWriteBufferFill->setReadOnly();
+    m_pWriteStalls = new ControlObject(
+            ConfigKey(RECORDING_PREF_KEY, "write_stalls"));
+    m_pWriteStalls->setReadOnly();
+    m_pWriteError = new ControlObject(
+            ConfigKey(RECORDING_PREF_KEY, "write_error"));
+    m_pWriteError->setReadOnly();
 }
 
 EngineRecord::~EngineRecord() {
@@ -37,6 +47,9 @@ EngineRecord::~EngineRecord() {
     closeFile();
     delete m_pRecReady;
     delete m_pSamplerate;
+    delete m_pWriteBufferFill;
+    delete m_pWriteStalls;
+    delete m_pWriteError;
 }
 
 
@@ -109,7 +122,7 @@ bool EngineRecord::metaDataHasChanged()
 void EngineRecord::process(const CSAMPLE* pBuffer, const int iBufferSize) {
 
     float recordingStatus = m_pRecReady->get();
-    static const QString tag("EngineRecord recording");
+    static const StatTag tag("EngineRecord recording");
 
     if (recordingStatus == RECORD_OFF) {
         //qDebug("Setting record flag to: OFF");
@@ -128,6 +141,7 @@ void EngineRecord::process(const CSAMPLE* pBuffer, const int iBufferSize) {
         if (openFile()) {
             Event::start(tag);
             qDebug("Setting record flag to: ON");
+            m_pWriteError->forceSet(0.0);
             m_pRecReady->set(RECORD_ON);
             emit(isRecording(true, false));  // will notify the RecordingManager
 
@@ -160,6 +174,7 @@ void EngineRecord::process(const CSAMPLE* pBuffer, const int iBufferSize) {
         updateFromPreferences();  // Update file location from preferences.
         if (openFile()) {
             qDebug() << "Splitting to a new file: "<< m_fileName;
+            m_pWriteError->forceSet(0.0);
             m_pRecReady->set(RECORD_ON);
             emit(isRecording(true, false));  // will notify the RecordingManager
 
@@ -201,6 +216,25 @@ void EngineRecord::process(const CSAMPLE* pBuffer, const int iBufferSize) {
             m_cueFile.flush();
         }
 
+        m_pWriteBufferFill->forceSet(m_fileWriter.bufferFill());
+        m_pWriteStalls->forceSet(m_fileWriter.stallCount());
+
+        if (m_fileWriter.hasWriteError()) {
+            // All further audio would be discarded, so stop instead of
+            // recording into nothing.
+            qWarning() << "Writing to" << m_fileName << "failed, stopping recording";
+            Event::end(tag);
+            m_pWriteError->forceSet(1.0);
+            closeFile();
+            if (m_bCueIsEnabled) {
+                closeCueFile();
+            }
+            m_pRecReady->slotSet(RECORD_OFF);
+            emit(isRecording(false, false));
+            emit(writeFailed(m_fileName));
+            return;
+        }
+
         // update frames counting and recorded duration (seconds)
         m_frames += iBufferSize / 2;
         unsigned long lastDuration = m_recordedDuration;
@@ -255,10 +289,10 @@ void EngineRecord::write(const unsigned char *header, const unsigned char *body,
     }
     // Relevant for OGG
     if (headerLen > 0) {
-        m_dataStream.writeRawData((const char*) header, headerLen);
+        m_fileWriter.write((const char*) header, headerLen);
     }
     // Always write body
-    m_dataStream.writeRawData((const char*) body, bodyLen);
+    m_fileWriter.write((const char*) body, bodyLen);
     emit(bytesRecorded((headerLen+bodyLen)));
 
 }
@@ -267,37 +301,32 @@ int EngineRecord::tell() {
     if (!fileOpen()) {
         return -1;
     }
-    return m_dataStream.device()->pos();
+    return static_cast<int>(m_fileWriter.pos());
 }
 // Encoder calls this method to write compressed audio
 void EngineRecord::seek(int pos) {
     if (!fileOpen()) {
         return;
     }
-    m_dataStream.device()->seek(static_cast<qint64>(pos));
+    m_fileWriter.seek(static_cast<qint64>(pos));
 }
 // These are not used for streaming, but the interface requires them
 int EngineRecord::filelen() {
     if (!fileOpen()) {
         return 0;
     }
-    return m_dataStream.device()->size();
+    return static_cast<int>(m_fileWriter.size());
 }
 
 bool EngineRecord::fileOpen() {
-    return (m_file.handle() != -1);
+    return m_fileWriter.isOpen();
 }
 
 bool EngineRecord::openFile() {
-    // We can use a QFile to write compressed audio.
     if (m_pEncoder) {
-        m_file.setFileName(m_fileName);
-        if (!m_file.open(QIODevice::WriteOnly)) {
+        if (!m_fileWriter.open(m_fileName)) {
             return false;
         }
-        if (m_file.handle() != -1) {
-            m_dataStream.setDevice(&m_file);
-        }
     } else {
         return false;
     }
@@ -343,13 +372,14 @@ bool EngineRecord::openCueFile() {
 }
 
 void EngineRecord::closeFile() {
-    if (m_file.handle() != -1) {
-        // Close QFile and encoder, if open.
+    if (m_fileWriter.isOpen()) {
+        // Close file and encoder, if open.
         if (m_pEncoder) {
             m_pEncoder->flush();
             m_pEncoder.reset();
         }
-        m_file.close();
+        // Blocks until all buffered audio is on disk.
+        m_fileWriter.close();
     }
 }
 
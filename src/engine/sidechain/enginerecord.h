@@ -8,16 +8,17 @@
 #ifndef ENGINERECORD_H
 #define ENGINERECORD_H
 
-#include <QDataStream>
 #include <QFile>
 
 #include "preferences/usersettings.h"
 #include "encoder/encodercallback.h"
 #include "encoder/encoder.h"
+#include "engine/sidechain/bufferedfilewriter.h"
 #include "engine/sidechain/sidechainworker.h"
 #include "track/track.h"
 
 class ConfigKey;
+class ControlObject;
 class ControlProxy;
 
 class EngineRecord : public QObject, public EncoderCallback, public SideChainWorker {
@@ -56,6 +57,9 @@ class EngineRecord : public QObject, public EncoderCallback, public SideChainWor
     // only one error can occur: the specified file was unable to be opened for
     // writing.
     void isRecording(bool recording, bool error);
+    // Emitted when writing to the open file failed, e.g. because the disk is
+    // full. Recording has been stopped.
+    void writeFailed(QString fileName);
     void durationRecorded(quint64 durationInt);
 
   private:
@@ -75,12 +79,16 @@ class EngineRecord : public QObject, public EncoderCallback, public SideChainWor
     QString m_baAuthor;
     QString m_baAlbum;
 
-    QFile m_file;
+    // Encoded audio is written to disk by a separate thread, so a slow disk
+    // does not stall the sidechain.
+    BufferedFileWriter m_fileWriter;
     QFile m_cueFile;
-    QDataStream m_dataStream;
 
     ControlProxy* m_pRecReady;
     ControlProxy* m_pSamplerate;
+    ControlObject* m_pWriteBufferFill;
+    ControlObject* m_pWriteStalls;
+    ControlObject* m_pWriteError;
     quint64 m_frames;
     quint64 m_sampleRate;
     quint64 m_recordedDuration;
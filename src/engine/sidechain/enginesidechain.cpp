@@ -37,8 +37,8 @@
 EngineSideChain::EngineSideChain(UserSettingsPointer pConfig)
         : m_pConfig(pConfig),
           m_bStopThread(false),
-          m_sampleFifo(SIDECHAIN_BUFFER_SIZE),
-          m_pWorkBuffer(SampleUtil::alloc(SIDECHAIN_BUFFER_SIZE)) {
+          m_sampleRing(SIDECHAIN_BUFFER_SIZE, SIDECHAIN_BUFFER_SIZE / 2),
+          m_samplesSinceWakeup(0) {
     // We use HighPriority to prevent starvation by lower-priority processes (Qt
     // main thread, analysis, etc.). This used to be LowPriority but that is not
     // a suitable choice since we do semi-realtime tasks
@@ -59,18 +59,21 @@ EngineSideChain::~EngineSideChain() {
 
     MMutexLocker locker(&m_workerLock);
     while (!m_workers.empty()) {
-        SideChainWorker* pWorker = m_workers.takeLast();
+        SideChainWorker* pWorker = m_workers.takeLast().pWorker;
         pWorker->shutdown();
         delete pWorker;
     }
-    locker.unlock();
-
-    SampleUtil::free(m_pWorkBuffer);
 }
 
 void EngineSideChain::addSideChainWorker(SideChainWorker* pWorker) {
     MMutexLocker locker(&m_workerLock);
-    m_workers.append(pWorker);
+    Worker worker;
+    worker.pWorker = pWorker;
+    // New workers start with the next samples written.
+    worker.reader = m_sampleRing.createReader();
+    worker.overrunTag = StatTag(QString("EngineSideChain worker %1 overrun")
+            .arg(m_workers.size()));
+    m_workers.append(worker);
 }
 
 void EngineSideChain::receiveBuffer(AudioInput input,
@@ -88,15 +91,17 @@ void EngineSideChain::writeSamples(const CSAMPLE* pBuffer, int iFrames) {
     // TODO: remove assumption of stereo buffer
     const int kChannels = 2;
     const int iSamples = iFrames * kChannels;
-    int samples_written = m_sampleFifo.write(pBuffer, iSamples);
-
-    if (samples_written != iSamples) {
-        Counter("EngineSideChain::writeSamples buffer overrun").increment();
-    }
-
-    if (m_sampleFifo.writeAvailable() < SIDECHAIN_BUFFER_SIZE / 5) {
-        // Signal to the sidechain that samples are available.
+    // Never blocks. Workers that fall behind are overrun and report it
+    // themselves.
+    m_sampleRing.write(pBuffer, iSamples);
+
+    m_samplesSinceWakeup += iSamples;
+    if (m_samplesSinceWakeup >= SIDECHAIN_BUFFER_SIZE / 4) {
+        // Signal to the sidechain that samples are available. Unlike a FIFO,
+        // the ring overwrites unread samples, so leave the workers plenty of
+        // headroom.
         Trace wakeup("EngineSideChain::writeSamples wake up");
+        m_samplesSinceWakeup = 0;
         m_waitForSamples.wakeAll();
     }
 }
@@ -106,7 +111,7 @@ void EngineSideChain::run() {
     // factor this out somehow), -kousu 2/2009
     unsigned static id = 0;
     QThread::currentThread()->setObjectName(QString("EngineSideChain %1").arg(++id));
-    static const QString tag("EngineSideChain");
+    static const StatTag tag("EngineSideChain");
     Event::start(tag);
     while (!m_bStopThread) {
         // Sleep until samples are available.
@@ -117,13 +122,11 @@ void EngineSideChain::run() {
         m_waitLock.unlock();
         Event::start(tag);
 
-        int samples_read;
-        while ((samples_read = m_sampleFifo.read(m_pWorkBuffer,
-                                                 SIDECHAIN_BUFFER_SIZE))) {
+        {
             Trace process("EngineSideChain::process");
             MMutexLocker locker(&m_workerLock);
-            foreach (SideChainWorker* pWorker, m_workers) {
-                pWorker->process(m_pWorkBuffer, samples_read);
+            for (Worker& worker : m_workers) {
+                processWorker(&worker);
             }
         }
 
@@ -133,3 +136,28 @@ void EngineSideChain::run() {
         }
     }
 }
+
+void EngineSideChain::processWorker(Worker* pWorker) {
+    const quint64 overrunsBefore = pWorker->reader.overrunCount();
+    const CSAMPLE* dataPtr1;
+    int size1;
+    const CSAMPLE* dataPtr2;
+    int size2;
+    int samples_read;
+    while ((samples_read = m_sampleRing.acquireReadRegions(&pWorker->reader,
+            &dataPtr1, &size1, &dataPtr2, &size2))) {
+        // The worker reads directly from the ring, no copy involved. Samples
+        // that are about to be overwritten have been dropped by the ring
+        // before the worker gets to see them.
+        pWorker->pWorker->process(dataPtr1, size1);
+        if (size2 > 0) {
+            pWorker->pWorker->process(dataPtr2, size2);
+        }
+        m_sampleRing.releaseReadRegions(&pWorker->reader, samples_read);
+    }
+    const quint64 overruns = pWorker->reader.overrunCount() - overrunsBefore;
+    if (overruns > 0) {
+        qWarning() << "EngineSideChain: worker fell behind, samples lost";
+        Counter(pWorker->overrunTag).increment(static_cast<int>(overruns));
+    }
+}
@@ -25,8 +25,9 @@
 #include "preferences/usersettings.h"
 #include "engine/sidechain/sidechainworker.h"
 #include "soundio/soundmanagerutil.h"
-#include "util/fifo.h"
 #include "util/mutex.h"
+#include "util/spmcring.h"
+#include "util/stat.h"
 #include "util/types.h"
 
 class EngineSideChain : public QThread, public AudioDestination {
@@ -52,23 +53,38 @@ class EngineSideChain : public QThread, public AudioDestination {
     static const int SIDECHAIN_BUFFER_SIZE = 65536;
 
   private:
+    struct Worker;
+
     void run() override;
+    // Hands all samples that pWorker has not seen yet to it.
+    void processWorker(Worker* pWorker);
 
     UserSettingsPointer m_pConfig;
     // Indicates that the thread should exit.
     volatile bool m_bStopThread;
 
-    FIFO<CSAMPLE> m_sampleFifo;
-    CSAMPLE* m_pWorkBuffer;
+    // Every worker reads the master audio in place from the ring through its
+    // own reader. The workers are woken every quarter of the ring and have
+    // another half of it to process what they have acquired.
+    SpmcRing<CSAMPLE> m_sampleRing;
+    // Written samples since the sidechain thread was last woken up. Only
+    // accessed by the writer.
+    int m_samplesSinceWakeup;
 
     // Provides thread safety around the wait condition below.
     QMutex m_waitLock;
     // Allows sleeping until we have samples to process.
     QWaitCondition m_waitForSamples;
 
+    struct Worker {
+        SideChainWorker* pWorker;
+        SpmcRing<CSAMPLE>::Reader reader;
+        StatTag overrunTag;
+    };
+
     // Sidechain workers registered with EngineSideChain.
     MMutex m_workerLock;
-    QList<SideChainWorker*> m_workers GUARDED_BY(m_workerLock);
+    QList<Worker> m_workers GUARDED_BY(m_workerLock);
 };
 
 #endif
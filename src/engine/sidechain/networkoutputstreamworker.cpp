@@ -1,11 +1,15 @@
 #include <engine/sidechain/networkoutputstreamworker.h>
 #include "engine/sidechain/enginenetworkstream.h"
 #include "util/logger.h"
+#include "util/assert.h"
+#include "util/math.h"
 #include "util/sample.h"
 
 
 namespace {
 const mixxx::Logger kLogger("NetworkStreamWorker");
+
+const CSAMPLE kSilence[1024] = {};
 }
 
 NetworkOutputStreamWorker::NetworkOutputStreamWorker()
@@ -17,7 +21,11 @@ NetworkOutputStreamWorker::NetworkOutputStreamWorker()
       m_streamStartTimeUs(-1),
       m_streamFramesWritten(0),
       m_writeOverflowCount(0),
-      m_outputDrift(false) {
+      m_outputDrift(false),
+      m_pendingFrames(0),
+      m_pendingSilenceFrames(0),
+      m_pendingSkipFrames(0),
+      m_pendingDuplicateFrames(0) {
 }
 
 NetworkOutputStreamWorker::~NetworkOutputStreamWorker() {
@@ -26,12 +34,10 @@ NetworkOutputStreamWorker::~NetworkOutputStreamWorker() {
 void NetworkOutputStreamWorker::outputAvailable() {
 }
 
-void NetworkOutputStreamWorker::setOutputFifo(QSharedPointer<FIFO<CSAMPLE>> pOutputFifo) {
-    Q_UNUSED(pOutputFifo);
-}
-
-QSharedPointer<FIFO<CSAMPLE>> NetworkOutputStreamWorker::getOutputFifo() {
-    return QSharedPointer<FIFO<CSAMPLE>>();
+void NetworkOutputStreamWorker::setOutputRing(
+        QSharedPointer<SpmcRing<CSAMPLE>> pOutputRing) {
+    m_pOutputRing = pOutputRing;
+    m_outputReader = m_pOutputRing->createReader();
 }
 
 void NetworkOutputStreamWorker::startStream(double samplerate, int numOutputChannels) {
@@ -93,6 +99,121 @@ bool NetworkOutputStreamWorker::outputDrift() {
     return m_outputDrift;
 }
 
+void NetworkOutputStreamWorker::outputWritten(int frames) {
+    m_streamFramesWritten += frames;
+    if (threadWaiting()) {
+        m_pendingFrames += frames;
+    }
+}
+
+void NetworkOutputStreamWorker::insertSilence(int frames) {
+    m_streamFramesWritten += frames;
+    if (threadWaiting()) {
+        m_pendingFrames += frames;
+        m_pendingSilenceFrames.fetch_add(frames, std::memory_order_relaxed);
+    }
+}
+
+void NetworkOutputStreamWorker::skipOutput(int frames) {
+    if (threadWaiting()) {
+        m_pendingSkipFrames.fetch_add(frames, std::memory_order_relaxed);
+    }
+}
+
+void NetworkOutputStreamWorker::duplicateFrame() {
+    m_streamFramesWritten += 1;
+    if (threadWaiting()) {
+        m_pendingFrames += 1;
+        m_pendingDuplicateFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void NetworkOutputStreamWorker::wakeIfOutputPending(int latencyFrames,
+        int intervalFrames) {
+    // Check for the desired latency + 1/2 interval to avoid big jitter due to
+    // interferences with the sync code
+    if (m_pendingFrames > 0 && m_pendingFrames + intervalFrames / 2 >= latencyFrames) {
+        m_pendingFrames = 0;
+        outputAvailable();
+    }
+}
+
+void NetworkOutputStreamWorker::resetOutput() {
+    m_outputReader = m_pOutputRing->createReader();
+    m_pendingSilenceFrames.store(0, std::memory_order_relaxed);
+    m_pendingSkipFrames.store(0, std::memory_order_relaxed);
+    m_pendingDuplicateFrames.store(0, std::memory_order_relaxed);
+}
+
+void NetworkOutputStreamWorker::processOutput() {
+    VERIFY_OR_DEBUG_ASSERT(m_pOutputRing && m_numOutputChannels > 0) {
+        return;
+    }
+    processSilence(m_pendingSilenceFrames.exchange(0, std::memory_order_relaxed));
+
+    const quint64 skippedBefore = m_outputReader.skippedCount();
+    const CSAMPLE* dataPtr1;
+    int size1;
+    const CSAMPLE* dataPtr2;
+    int size2;
+    const int count = m_pOutputRing->acquireReadRegions(&m_outputReader,
+            &dataPtr1, &size1, &dataPtr2, &size2);
+    const int skipped = static_cast<int>(
+            m_outputReader.skippedCount() - skippedBefore);
+    if (skipped > 0) {
+        // The ring drops the output before we read any of it
+        kLogger.warning() << "processOutput: worker fell behind, losing samples";
+        incOverflowCount();
+        // The sound device has counted the lost samples as written, keep the
+        // stream in sync with its clock.
+        processSilence(skipped / m_numOutputChannels);
+    }
+    if (count == 0) {
+        return;
+    }
+
+    // Drop the output the stream is ahead of its clock
+    const int pendingSkip = m_pendingSkipFrames.exchange(0, std::memory_order_relaxed);
+    const int offset = math_min(count, pendingSkip * m_numOutputChannels);
+    if (offset < pendingSkip * m_numOutputChannels) {
+        m_pendingSkipFrames.fetch_add(
+                pendingSkip - offset / m_numOutputChannels,
+                std::memory_order_relaxed);
+    }
+    const CSAMPLE* pFirst = offset < size1 ?
+            dataPtr1 + offset : dataPtr2 + (offset - size1);
+    if (count - offset >= m_numOutputChannels) {
+        int duplicates = m_pendingDuplicateFrames.exchange(0, std::memory_order_relaxed);
+        for (; duplicates > 0; --duplicates) {
+            process(pFirst, m_numOutputChannels);
+        }
+    }
+    if (offset < size1) {
+        process(pFirst, size1 - offset);
+        if (size2 > 0) {
+            process(dataPtr2, size2);
+        }
+    } else if (offset < count) {
+        process(pFirst, count - offset);
+    }
+
+    if (!m_pOutputRing->releaseReadRegions(&m_outputReader, count)) {
+        kLogger.warning() << "processOutput: output overwritten while processing it";
+        incOverflowCount();
+    }
+}
+
+void NetworkOutputStreamWorker::processSilence(int frames) {
+    const int chunkSamples = static_cast<int>(sizeof(kSilence) / sizeof(kSilence[0])) -
+            static_cast<int>(sizeof(kSilence) / sizeof(kSilence[0])) % m_numOutputChannels;
+    int samples = frames * m_numOutputChannels;
+    while (samples > 0) {
+        const int chunk = math_min(samples, chunkSamples);
+        process(kSilence, chunk);
+        samples -= chunk;
+    }
+}
+
 int NetworkOutputStreamWorker::getState() {
     return m_workerState;
 }
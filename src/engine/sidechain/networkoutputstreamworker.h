@@ -1,10 +1,12 @@
 #ifndef NETWORKOUTPUTSTREAMWORKER_H
 #define NETWORKOUTPUTSTREAMWORKER_H
 
+#include <atomic>
+
 #include <QSharedPointer>
 
 #include "util/types.h"
-#include "util/fifo.h"
+#include "util/spmcring.h"
 
 /*
  * States:
@@ -50,8 +52,12 @@ class NetworkOutputStreamWorker {
     virtual void shutdown() = 0;
 
     virtual void outputAvailable();
-    virtual void setOutputFifo(QSharedPointer<FIFO<CSAMPLE>> pOutputFifo);
-    virtual QSharedPointer<FIFO<CSAMPLE>> getOutputFifo();
+    // The ring with the output of the network sound device, which all output
+    // workers read in place. Must be set before the worker thread starts.
+    void setOutputRing(QSharedPointer<SpmcRing<CSAMPLE>> pOutputRing);
+    bool hasOutputRing() const {
+        return !m_pOutputRing.isNull();
+    }
 
     void startStream(double samplerate, int numOutputChannels);
     void stopStream();
@@ -72,6 +78,21 @@ class NetworkOutputStreamWorker {
     void setOutputDrift(bool drift);
     bool outputDrift();
 
+    // Called by the network sound device, which keeps the stream of each
+    // worker in sync with the clock of the worker. The adjustments are
+    // applied by the worker thread in front of the next output it reads.
+    // frames of output have been written to the output ring.
+    void outputWritten(int frames);
+    // Inserts frames of silence.
+    void insertSilence(int frames);
+    // Drops frames of output.
+    void skipOutput(int frames);
+    // Repeats the next frame of output.
+    void duplicateFrame();
+    // Wakes the worker thread once latencyFrames of output are pending,
+    // allowing for half of the interval between two calls.
+    void wakeIfOutputPending(int latencyFrames, int intervalFrames);
+
     int getState();
     int getFunctionCode();
     int getRunCount();
@@ -83,7 +104,15 @@ protected:
     void setFunctionCode(int code);
     void incRunCount();
 
+    // Worker thread only. Drops all output that has not been processed yet.
+    void resetOutput();
+    // Worker thread only. Passes all output that has not been processed yet
+    // to process(), with the adjustments of the sound device applied.
+    void processOutput();
+
 private:
+    void processSilence(int frames);
+
     double m_sampleRate;
     int m_numOutputChannels;
 
@@ -95,6 +124,16 @@ private:
     qint64 m_streamFramesWritten;
     int m_writeOverflowCount;
     bool m_outputDrift;
+
+    QSharedPointer<SpmcRing<CSAMPLE>> m_pOutputRing;
+    SpmcRing<CSAMPLE>::Reader m_outputReader;
+    // Output frames since the worker thread was last woken. Sound device
+    // thread only.
+    int m_pendingFrames;
+    // Handed over from the sound device to the worker thread.
+    std::atomic<int> m_pendingSilenceFrames;
+    std::atomic<int> m_pendingSkipFrames;
+    std::atomic<int> m_pendingDuplicateFrames;
 };
 
 typedef QSharedPointer<NetworkOutputStreamWorker> NetworkOutputStreamWorkerPtr;
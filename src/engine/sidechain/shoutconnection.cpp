@@ -25,6 +25,7 @@
 #ifdef __OPUS__
 #include "encoder/encoderopus.h"
 #endif
+#include "encoder/sharedencoder.h"
 #include "mixer/playerinfo.h"
 #include "preferences/usersettings.h"
 #include "recording/defs_recording.h"
@@ -439,9 +440,21 @@ void ShoutConnection::updateFromPreferences() {
     // Initialize m_encoder
     EncoderBroadcastSettings broadcastSettings(m_pProfile);
     if (m_format_is_mp3) {
-        m_encoder = EncoderFactory::getFactory().getNewEncoder(
-            EncoderFactory::getFactory().getFormatFor(ENCODING_MP3), m_pConfig, this);
-        m_encoder->setEncoderSettings(broadcastSettings);
+        // Connections that stream MP3 with the same settings share one encoder
+        // instead of each running its own LAME instance on the same audio.
+        const QString sharedEncoderKey = QString("mp3:%1:%2:%3")
+                .arg(QString::number(iMasterSamplerate),
+                     QString::number(iBitrate),
+                     QString::number(m_pProfile->getChannels()));
+        UserSettingsPointer pConfig = m_pConfig;
+        m_encoder = SharedEncoder::createClient(sharedEncoderKey, this,
+                [pConfig, &broadcastSettings](EncoderCallback* pCallback) {
+                    EncoderPointer pEncoder = EncoderFactory::getFactory().getNewEncoder(
+                            EncoderFactory::getFactory().getFormatFor(ENCODING_MP3),
+                            pConfig, pCallback);
+                    pEncoder->setEncoderSettings(broadcastSettings);
+                    return pEncoder;
+                });
     } else if (m_format_is_ov) {
         m_encoder = EncoderFactory::getFactory().getNewEncoder(
             EncoderFactory::getFactory().getFormatFor(ENCODING_OGG), m_pConfig, this);
@@ -587,9 +600,7 @@ bool ShoutConnection::processConnect() {
 
             m_retryCount = 0;
 
-            if(m_pOutputFifo->readAvailable()) {
-            	m_pOutputFifo->flushReadData(m_pOutputFifo->readAvailable());
-            }
+            resetOutput();
             m_threadWaiting = true;
 
             setStatus(BroadcastProfile::STATUS_CONNECTED);
@@ -963,14 +974,6 @@ void ShoutConnection::outputAvailable() {
     m_readSema.release();
 }
 
-void ShoutConnection::setOutputFifo(QSharedPointer<FIFO<CSAMPLE>> pOutputFifo) {
-    m_pOutputFifo = pOutputFifo;
-}
-
-QSharedPointer<FIFO<CSAMPLE>> ShoutConnection::getOutputFifo() {
-    return m_pOutputFifo;
-}
-
 bool ShoutConnection::threadWaiting() {
     return atomicLoadRelaxed(m_threadWaiting);
 }
@@ -984,8 +987,8 @@ void ShoutConnection::run() {
     ignoreSigpipe();
 #endif
 
-    VERIFY_OR_DEBUG_ASSERT(m_pOutputFifo) {
-        kLogger.warning() << "run: Broadcast FIFO handle is not available. Aborting";
+    VERIFY_OR_DEBUG_ASSERT(hasOutputRing()) {
+        kLogger.warning() << "run: Broadcast output ring is not available. Aborting";
         return;
     }
 
@@ -1019,26 +1022,9 @@ void ShoutConnection::run() {
             continue;
         }
 
-        int readAvailable = m_pOutputFifo->readAvailable();
-        if (readAvailable) {
-            setFunctionCode(3);
-            CSAMPLE* dataPtr1;
-            ring_buffer_size_t size1;
-            CSAMPLE* dataPtr2;
-            ring_buffer_size_t size2;
-
-            // We use size1 and size2, so we can ignore the return value
-            (void)m_pOutputFifo->aquireReadRegions(readAvailable, &dataPtr1, &size1,
-                    &dataPtr2, &size2);
-
-            // Push frames to the encoder.
-            process(dataPtr1, size1);
-            if (size2 > 0) {
-                process(dataPtr2, size2);
-            }
-
-            m_pOutputFifo->releaseReadRegions(readAvailable);
-        }
+        setFunctionCode(3);
+        // Push frames to the encoder.
+        processOutput();
     }
 
     kLogger.debug() << "run: Thread stopped";
@@ -22,7 +22,6 @@
 #include "errordialoghandler.h"
 #include "preferences/usersettings.h"
 #include "track/track.h"
-#include "util/fifo.h"
 #include "preferences/broadcastprofile.h"
 
 // Forward declare libshout structures to prevent leaking shout.h definitions
@@ -63,8 +62,6 @@ class ShoutConnection
     void applySettings();
 
     void outputAvailable() override;
-    void setOutputFifo(QSharedPointer<FIFO<CSAMPLE>> pOutputFifo) override;
-    QSharedPointer<FIFO<CSAMPLE>> getOutputFifo() override;
     bool threadWaiting() override;
     void run() override;
 
@@ -149,7 +146,6 @@ class ShoutConnection
     bool m_ogg_dynamic_update;
     QAtomicInt m_threadWaiting;
     QSemaphore m_readSema;
-    QSharedPointer<FIFO<CSAMPLE>> m_pOutputFifo;
 
     QString m_lastErrorStr;
     int m_retryCount;
@@ -3,13 +3,15 @@
 #include <QMetaType>
 
 #include "engine/sync/internalclock.h"
+#include "util/assert.h"
 
 static const char* kInternalClockGroup = "[InternalClock]";
 
 BaseSyncableListener::BaseSyncableListener(UserSettingsPointer pConfig)
         : m_pConfig(pConfig),
           m_pInternalClock(new InternalClock(kInternalClockGroup, this)),
-          m_pMasterSyncable(NULL) {
+          m_pMasterSyncable(NULL),
+          m_synchronizedSyncableCount(0) {
     qRegisterMetaType<SyncMode>("SyncMode");
     m_pInternalClock->setMasterBpm(124.0);
 }
@@ -27,6 +29,20 @@ void BaseSyncableListener::addSyncableDeck(Syncable* pSyncable) {
         return;
     }
     m_syncables.append(pSyncable);
+    m_synchronizedSyncables.resize(m_syncables.size());
+    updateSynchronizedSyncables();
+}
+
+void BaseSyncableListener::updateSynchronizedSyncables() {
+    DEBUG_ASSERT(m_synchronizedSyncables.size() ==
+            static_cast<size_t>(m_syncables.size()));
+    int count = 0;
+    for (Syncable* pSyncable : m_syncables) {
+        if (pSyncable->isSynchronized()) {
+            m_synchronizedSyncables[count++] = pSyncable;
+        }
+    }
+    m_synchronizedSyncableCount.storeRelease(count);
 }
 
 void BaseSyncableListener::onCallbackStart(int sampleRate, int bufferSize) {
@@ -51,23 +67,22 @@ Syncable* BaseSyncableListener::getSyncableForGroup(const QString& group) {
 }
 
 bool BaseSyncableListener::syncDeckExists() const {
-    foreach (const Syncable* pSyncable, m_syncables) {
-        if (pSyncable->isSynchronized() && pSyncable->getBaseBpm() > 0) {
-            return true;
+    bool sync_deck_exists = false;
+    forEachSynchronizedSyncable([&sync_deck_exists](const Syncable* pSyncable) {
+        if (pSyncable->getBaseBpm() > 0) {
+            sync_deck_exists = true;
         }
-    }
-    return false;
+    });
+    return sync_deck_exists;
 }
 
 int BaseSyncableListener::playingSyncDeckCount() const {
     int playing_sync_decks = 0;
-
-    foreach (const Syncable* pSyncable, m_syncables) {
-        if (pSyncable->isSynchronized() && pSyncable->isPlaying()) {
+    forEachSynchronizedSyncable([&playing_sync_decks](const Syncable* pSyncable) {
+        if (pSyncable->isPlaying()) {
             ++playing_sync_decks;
         }
-    }
-
+    });
     return playing_sync_decks;
 }
 
@@ -97,52 +112,44 @@ void BaseSyncableListener::setMasterBpm(Syncable* pSource, double bpm) {
     if (pSource != m_pInternalClock) {
         m_pInternalClock->setMasterBpm(bpm);
     }
-    foreach (Syncable* pSyncable, m_syncables) {
-        if (pSyncable == pSource ||
-                !pSyncable->isSynchronized()) {
-            continue;
+    forEachSynchronizedSyncable([pSource, bpm](Syncable* pSyncable) {
+        if (pSyncable != pSource) {
+            pSyncable->setMasterBpm(bpm);
         }
-        pSyncable->setMasterBpm(bpm);
-    }
+    });
 }
 
 void BaseSyncableListener::setMasterInstantaneousBpm(Syncable* pSource, double bpm) {
     if (pSource != m_pInternalClock) {
         m_pInternalClock->setInstantaneousBpm(bpm);
     }
-    foreach (Syncable* pSyncable, m_syncables) {
-        if (pSyncable == pSource ||
-                !pSyncable->isSynchronized()) {
-            continue;
+    forEachSynchronizedSyncable([pSource, bpm](Syncable* pSyncable) {
+        if (pSyncable != pSource) {
+            pSyncable->setInstantaneousBpm(bpm);
         }
-        pSyncable->setInstantaneousBpm(bpm);
-    }
+    });
 }
 
 void BaseSyncableListener::setMasterBaseBpm(Syncable* pSource, double bpm) {
     if (pSource != m_pInternalClock) {
         m_pInternalClock->setMasterBaseBpm(bpm);
     }
-    foreach (Syncable* pSyncable, m_syncables) {
-        if (pSyncable == pSource ||
-                !pSyncable->isSynchronized()) {
-            continue;
+    forEachSynchronizedSyncable([pSource, bpm](Syncable* pSyncable) {
+        if (pSyncable != pSource) {
+            pSyncable->setMasterBaseBpm(bpm);
         }
-        pSyncable->setMasterBaseBpm(bpm);
-    }
+    });
 }
 
 void BaseSyncableListener::setMasterBeatDistance(Syncable* pSource, double beat_distance) {
     if (pSource != m_pInternalClock) {
         m_pInternalClock->setMasterBeatDistance(beat_distance);
     }
-    foreach (Syncable* pSyncable, m_syncables) {
-        if (pSyncable == pSource ||
-                !pSyncable->isSynchronized()) {
-            continue;
+    forEachSynchronizedSyncable([pSource, beat_distance](Syncable* pSyncable) {
+        if (pSyncable != pSource) {
+            pSyncable->setMasterBeatDistance(beat_distance);
         }
-        pSyncable->setMasterBeatDistance(beat_distance);
-    }
+    });
 }
 
 void BaseSyncableListener::setMasterParams(Syncable* pSource, double beat_distance,
@@ -150,31 +157,22 @@ void BaseSyncableListener::setMasterParams(Syncable* pSource, double beat_distan
     if (pSource != m_pInternalClock) {
         m_pInternalClock->setMasterParams(beat_distance, base_bpm, bpm);
     }
-    foreach (Syncable* pSyncable, m_syncables) {
-        if (pSyncable == pSource ||
-                !pSyncable->isSynchronized()) {
-            continue;
+    forEachSynchronizedSyncable([pSource, beat_distance, base_bpm, bpm](Syncable* pSyncable) {
+        if (pSyncable != pSource) {
+            pSyncable->setMasterParams(beat_distance, base_bpm, bpm);
         }
-        pSyncable->setMasterParams(beat_distance, base_bpm, bpm);
-    }
+    });
 }
 
 void BaseSyncableListener::checkUniquePlayingSyncable() {
     int playing_sync_decks = 0;
     Syncable* unique_syncable = NULL;
-    foreach (Syncable* pSyncable, m_syncables) {
-        if (!pSyncable->isSynchronized()) {
-            continue;
-        }
-
+    forEachSynchronizedSyncable([&playing_sync_decks, &unique_syncable](Syncable* pSyncable) {
         if (pSyncable->isPlaying()) {
-            if (playing_sync_decks > 0) {
-                return;
-            }
             unique_syncable = pSyncable;
             ++playing_sync_decks;
         }
-    }
+    });
     if (playing_sync_decks == 1) {
         unique_syncable->notifyOnlyPlayingSyncable();
     }
@@ -1,8 +1,13 @@
 #ifndef BASESYNCABLELISTENER_H
 #define BASESYNCABLELISTENER_H
 
+#include <QAtomicInt>
+
+#include <vector>
+
 #include "engine/sync/syncable.h"
 #include "preferences/usersettings.h"
+#include "util/compatibility.h"
 
 class InternalClock;
 class EngineChannel;
@@ -67,6 +72,10 @@ class BaseSyncableListener : public SyncableListener {
     // Check if there is only one playing syncable deck, and notify it if so.
     void checkUniquePlayingSyncable();
 
+    // Must be invoked after changing the sync mode of any Syncable of
+    // m_syncables.
+    void updateSynchronizedSyncables();
+
     UserSettingsPointer m_pConfig;
     // The InternalClock syncable.
     InternalClock* m_pInternalClock;
@@ -75,6 +84,24 @@ class BaseSyncableListener : public SyncableListener {
     // The list of all Syncables registered with BaseSyncableListener via
     // addSyncableDeck.
     QList<Syncable*> m_syncables;
+
+  private:
+    template<typename Function>
+    void forEachSynchronizedSyncable(Function function) const {
+        const int count = atomicLoadAcquire(m_synchronizedSyncableCount);
+        for (int i = 0; i < count; ++i) {
+            function(m_synchronizedSyncables[i]);
+        }
+    }
+
+    // The synchronized Syncables of m_syncables in the same order. The master
+    // sends its beat distance and instantaneous BPM several times per
+    // callback, and walking this array neither touches the unsynchronized
+    // decks and samplers nor reads the sync mode control of every Syncable.
+    // It is sized for all Syncables up front and never reallocated, because
+    // sync modes might also change outside of the engine thread.
+    std::vector<Syncable*> m_synchronizedSyncables;
+    QAtomicInt m_synchronizedSyncableCount;
 };
 
 #endif /* BASESYNCABLELISTENER_H */
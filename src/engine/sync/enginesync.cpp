@@ -278,7 +278,9 @@ void EngineSync::requestBpmUpdate(Syncable* pSyncable, double bpm) {
 
 void EngineSync::notifyInstantaneousBpmChanged(Syncable* pSyncable, double bpm) {
     //qDebug() << "EngineSync::notifyInstantaneousBpmChanged" << pSyncable->getGroup() << bpm;
-    if (pSyncable->getSyncMode() != SYNC_MASTER) {
+    // All followers report their speed in every callback. Don't query their
+    // sync mode only to find out that they are not master.
+    if (pSyncable != m_pMasterSyncable || pSyncable->getSyncMode() != SYNC_MASTER) {
         return;
     }
 
@@ -289,7 +291,7 @@ void EngineSync::notifyInstantaneousBpmChanged(Syncable* pSyncable, double bpm)
 
 void EngineSync::notifyBeatDistanceChanged(Syncable* pSyncable, double beat_distance) {
     //qDebug() << "EngineSync::notifyBeatDistanceChanged" << pSyncable->getGroup() << beat_distance;
-    if (pSyncable->getSyncMode() != SYNC_MASTER) {
+    if (pSyncable != m_pMasterSyncable || pSyncable->getSyncMode() != SYNC_MASTER) {
         return;
     }
 
@@ -303,6 +305,7 @@ void EngineSync::activateFollower(Syncable* pSyncable) {
     }
 
     pSyncable->notifySyncModeChanged(SYNC_FOLLOWER);
+    updateSynchronizedSyncables();
     pSyncable->setMasterParams(masterBeatDistance(), masterBaseBpm(), masterBpm());
 }
 
@@ -332,6 +335,7 @@ void EngineSync::activateMaster(Syncable* pSyncable) {
     //qDebug() << "Setting up master " << pSyncable->getGroup();
     m_pMasterSyncable = pSyncable;
     pSyncable->notifySyncModeChanged(SYNC_MASTER);
+    updateSynchronizedSyncables();
 
     // It is up to callers of this function to initialize bpm and beat_distance
     // if necessary.
@@ -345,6 +349,7 @@ void EngineSync::deactivateSync(Syncable* pSyncable) {
 
     // Notifications happen after-the-fact.
     pSyncable->notifySyncModeChanged(SYNC_NONE);
+    updateSynchronizedSyncables();
 
     bool bSyncDeckExists = syncDeckExists();
 
@@ -92,6 +92,10 @@ void AnalysisFeature::bindLibraryWidget(WLibrary* libraryWidget,
             &DlgAnalysis::analyzeTracks,
             this,
             &AnalysisFeature::analyzeTracks);
+    connect(m_pAnalysisView,
+            &DlgAnalysis::analyzeLoudness,
+            this,
+            &AnalysisFeature::analyzeLoudness);
     connect(m_pAnalysisView,
             &DlgAnalysis::stopAnalysis,
             this,
@@ -135,6 +139,18 @@ void AnalysisFeature::activate() {
 }
 
 void AnalysisFeature::analyzeTracks(QList<TrackId> trackIds) {
+    startAnalysis(trackIds, getAnalyzerModeFlags(m_pConfig));
+}
+
+void AnalysisFeature::analyzeLoudness(QList<TrackId> trackIds) {
+    startAnalysis(trackIds, AnalyzerModeFlags::LoudnessOnly);
+}
+
+void AnalysisFeature::startAnalysis(
+        const QList<TrackId>& trackIds,
+        AnalyzerModeFlags modeFlags) {
+    // Tracks that are added while an analysis is running are analyzed with
+    // the analyzers of the running analysis
     if (!m_pTrackAnalysisScheduler) {
         const int numAnalyzerThreads = numberOfAnalyzerThreads();
         kLogger.info()
@@ -145,7 +161,7 @@ void AnalysisFeature::analyzeTracks(QList<TrackId> trackIds) {
                 m_pLibrary,
                 numAnalyzerThreads,
                 m_pConfig,
-                getAnalyzerModeFlags(m_pConfig));
+                modeFlags);
 
         connect(m_pTrackAnalysisScheduler.get(),
                 &TrackAnalysisScheduler::progress,
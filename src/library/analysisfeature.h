@@ -49,6 +49,8 @@ class AnalysisFeature : public LibraryFeature {
   public slots:
     void activate() override;
     void analyzeTracks(QList<TrackId> trackIds);
+    // Only analyzes the loudness of the tracks for ReplayGain
+    void analyzeLoudness(QList<TrackId> trackIds);
 
     void suspendAnalysis();
     void resumeAnalysis();
@@ -59,6 +61,8 @@ class AnalysisFeature : public LibraryFeature {
     void onTrackAnalysisSchedulerFinished();
 
   private:
+    void startAnalysis(const QList<TrackId>& trackIds, AnalyzerModeFlags modeFlags);
+
     // Sets the title of this feature to the default name, given by
     // m_sAnalysisTitleName
     void resetTitle();
@@ -0,0 +1,168 @@
+#include "library/asyncselectthread.h"
+
+#include <QMutexLocker>
+#include <QSqlQuery>
+
+#include "library/queryutil.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("AsyncSelectThread");
+
+const QString kCreateView = QStringLiteral("CREATE VIEW ");
+
+QString quotedIdentifier(QString name) {
+    return "\"" + name.replace("\"", "\"\"") + "\"";
+}
+
+} // anonymous namespace
+
+AsyncSelectThread::AsyncSelectThread(mixxx::DbConnectionPoolPtr pDbConnectionPool)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_stop(false) {
+    setObjectName("AsyncSelectThread");
+}
+
+AsyncSelectThread::~AsyncSelectThread() {
+    stop();
+    wait();
+}
+
+// static
+QList<AsyncSelectThread::TemporaryView> AsyncSelectThread::temporaryViews(
+        const QSqlDatabase& database) {
+    QList<TemporaryView> views;
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT name, sql FROM sqlite_temp_master "
+                    "WHERE type='view' ORDER BY rowid")) {
+        LOG_FAILED_QUERY(query);
+        return views;
+    }
+    while (query.next()) {
+        TemporaryView view;
+        view.name = query.value(0).toString();
+        view.sql = query.value(1).toString();
+        views.append(view);
+    }
+    return views;
+}
+
+void AsyncSelectThread::submit(
+        QObject* pOwner,
+        QList<TemporaryView> temporaryViews,
+        Job job) {
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_stop) {
+            return;
+        }
+        for (int i = 0; i < m_pendingJobs.size(); ++i) {
+            if (m_pendingJobs.at(i).pOwner == pOwner) {
+                m_pendingJobs.removeAt(i);
+                break;
+            }
+        }
+        PendingJob pendingJob;
+        pendingJob.pOwner = pOwner;
+        pendingJob.temporaryViews = std::move(temporaryViews);
+        pendingJob.job = std::move(job);
+        m_pendingJobs.append(std::move(pendingJob));
+        m_jobAvailable.wakeOne();
+    }
+    if (!isRunning()) {
+        start(QThread::LowPriority);
+    }
+}
+
+void AsyncSelectThread::cancel(QObject* pOwner) {
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < m_pendingJobs.size(); ++i) {
+        if (m_pendingJobs.at(i).pOwner == pOwner) {
+            m_pendingJobs.removeAt(i);
+            return;
+        }
+    }
+}
+
+void AsyncSelectThread::stop() {
+    QMutexLocker locker(&m_mutex);
+    m_stop = true;
+    m_pendingJobs.clear();
+    m_jobAvailable.wakeAll();
+}
+
+void AsyncSelectThread::run() {
+    kLogger.debug() << "Entering thread";
+    {
+        const mixxx::DbConnectionPooler dbConnectionPooler(m_pDbConnectionPool);
+        const QSqlDatabase database = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+        if (!database.isOpen()) {
+            kLogger.warning()
+                    << "Failed to open database connection for background queries";
+        }
+
+        forever {
+            PendingJob pendingJob;
+            {
+                QMutexLocker locker(&m_mutex);
+                while (!m_stop && m_pendingJobs.isEmpty()) {
+                    m_jobAvailable.wait(&m_mutex);
+                }
+                if (m_stop) {
+                    break;
+                }
+                pendingJob = m_pendingJobs.takeFirst();
+            }
+            if (database.isOpen() &&
+                    createTemporaryViews(database, pendingJob.temporaryViews)) {
+                pendingJob.job(database);
+            } else {
+                pendingJob.job(QSqlDatabase());
+            }
+            emit jobDone(pendingJob.pOwner);
+        }
+        // The temporary views are dropped together with the connection
+        m_createdViews.clear();
+    }
+    kLogger.debug() << "Exiting thread";
+}
+
+bool AsyncSelectThread::createTemporaryViews(
+        const QSqlDatabase& database,
+        const QList<TemporaryView>& temporaryViews) {
+    for (const auto& view : temporaryViews) {
+        const auto created = m_createdViews.constFind(view.name);
+        if (created != m_createdViews.constEnd()) {
+            if (created.value() == view.sql) {
+                continue;
+            }
+            // The view has been redefined, e.g. for a different playlist
+            QSqlQuery query(database);
+            if (!query.exec("DROP VIEW IF EXISTS temp." +
+                        quotedIdentifier(view.name))) {
+                LOG_FAILED_QUERY(query);
+                return false;
+            }
+            m_createdViews.remove(view.name);
+        }
+        // SQLite strips the TEMPORARY keyword from the stored statement
+        if (!view.sql.startsWith(kCreateView, Qt::CaseInsensitive)) {
+            kLogger.warning()
+                    << "Unexpected definition of temporary view"
+                    << view.name << view.sql;
+            return false;
+        }
+        QSqlQuery query(database);
+        if (!query.exec("CREATE TEMPORARY VIEW " +
+                    view.sql.mid(kCreateView.size()))) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+        m_createdViews.insert(view.name, view.sql);
+    }
+    return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <functional>
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSqlDatabase>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "util/db/dbconnectionpool.h"
+
+// AsyncSelectThread executes read-only library queries on its own pooled
+// database connection, so that the GUI thread never has to wait for SQLite.
+//
+// The library table models read from TEMPORARY VIEWs that only exist on the
+// connection that created them. Each job therefore carries the definitions
+// of the temporary views of the submitting connection, which are recreated
+// on the connection of this thread before the job is executed.
+//
+// Jobs are queued per owner. Submitting a job replaces any job of the same
+// owner that has not been started yet. Jobs that are already running must
+// check themselves whether they have been superseded.
+class AsyncSelectThread : public QThread {
+    Q_OBJECT
+  public:
+    struct TemporaryView {
+        QString name;
+        // The CREATE VIEW statement as stored in sqlite_temp_master
+        QString sql;
+    };
+
+    // Receives the connection of the thread or an invalid QSqlDatabase if
+    // the connection could not be opened or the temporary views could not
+    // be created.
+    typedef std::function<void(const QSqlDatabase& database)> Job;
+
+    explicit AsyncSelectThread(mixxx::DbConnectionPoolPtr pDbConnectionPool);
+    ~AsyncSelectThread() override;
+
+    // Returns the definitions of all temporary views of the given connection
+    // in the order in which they have been created.
+    static QList<TemporaryView> temporaryViews(const QSqlDatabase& database);
+
+    // Starts the thread if needed. Must be called from the thread that owns
+    // this object.
+    void submit(
+            QObject* pOwner,
+            QList<TemporaryView> temporaryViews,
+            Job job);
+    // Discards the pending job of pOwner, if any.
+    void cancel(QObject* pOwner);
+
+    void stop();
+
+  signals:
+    // Emitted after a job of pOwner has been executed. pOwner must not be
+    // dereferenced by receivers, it might have been deleted in the meantime.
+    void jobDone(QObject* pOwner);
+
+  protected:
+    void run() override;
+
+  private:
+    struct PendingJob {
+        QObject* pOwner;
+        QList<TemporaryView> temporaryViews;
+        Job job;
+    };
+
+    bool createTemporaryViews(
+            const QSqlDatabase& database,
+            const QList<TemporaryView>& temporaryViews);
+
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+
+    QMutex m_mutex;
+    QWaitCondition m_jobAvailable;
+    QList<PendingJob> m_pendingJobs;
+    bool m_stop;
+
+    // Temporary views that have been created on the connection of this
+    // thread, by name. Only accessed from run().
+    QHash<QString, QString> m_createdViews;
+};
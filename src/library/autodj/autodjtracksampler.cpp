@@ -0,0 +1,284 @@
+#include "library/autodj/autodjtracksampler.h"
+
+#include <algorithm>
+
+#include "util/assert.h"
+#include "util/math.h"
+
+namespace {
+
+constexpr int kTimesPlayedOrder =
+        static_cast<int>(AutoDJTrackSampler::Order::TimesPlayed);
+constexpr int kLastPlayedOrder =
+        static_cast<int>(AutoDJTrackSampler::Order::LastPlayed);
+
+// floor(log2(value)) for positive values
+int floorLog2(qint64 value) {
+    DEBUG_ASSERT(value > 0);
+    int result = 0;
+    while (value > 1) {
+        value >>= 1;
+        ++result;
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+constexpr int AutoDJTrackSampler::kNumLevels;
+constexpr int AutoDJTrackSampler::kNumOrders;
+
+AutoDJTrackSampler::AutoDJTrackSampler()
+        : m_randomEngine(std::random_device()()) {
+}
+
+void AutoDJTrackSampler::clear() {
+    m_tracks.clear();
+    for (auto& levels : m_levels) {
+        for (auto& level : levels) {
+            level.clear();
+        }
+    }
+}
+
+// static
+bool AutoDJTrackSampler::isLessPlayed(
+        int order, const Entry& lhs, const Entry& rhs) {
+    if (order == kTimesPlayedOrder && lhs.timesPlayed != rhs.timesPlayed) {
+        return lhs.timesPlayed < rhs.timesPlayed;
+    }
+    // Tracks that have never been played come first
+    if (!rhs.lastPlayed.isValid()) {
+        return false;
+    }
+    if (!lhs.lastPlayed.isValid()) {
+        return true;
+    }
+    return lhs.lastPlayed < rhs.lastPlayed;
+}
+
+int AutoDJTrackSampler::levelFor(int order, const Entry& entry) const {
+    if (order == kTimesPlayedOrder) {
+        return math_clamp(entry.timesPlayed, 0, kNumLevels - 1);
+    }
+    if (!entry.lastPlayed.isValid()) {
+        return 0;
+    }
+    // Tracks played today or with a timestamp from the future end up in
+    // the last level
+    const qint64 ageDays = math_max<qint64>(
+            entry.lastPlayed.toUTC().date().daysTo(m_referenceDate), 0);
+    return kNumLevels - 1 - math_min(floorLog2(ageDays + 1), kNumLevels - 2);
+}
+
+void AutoDJTrackSampler::insertIntoLevel(
+        int order, TrackId trackId, Entry* pEntry) {
+    const int level = levelFor(order, *pEntry);
+    auto& levelTrackIds = m_levels[order][level];
+    pEntry->levels[order] = level;
+    pEntry->levelIndexes[order] = static_cast<int>(levelTrackIds.size());
+    levelTrackIds.push_back(trackId);
+}
+
+void AutoDJTrackSampler::removeFromLevel(int order, const Entry& entry) {
+    auto& levelTrackIds = m_levels[order][entry.levels[order]];
+    const int index = entry.levelIndexes[order];
+    DEBUG_ASSERT(index < static_cast<int>(levelTrackIds.size()));
+    // Fill the gap with the last track of the level
+    const TrackId movedTrackId = levelTrackIds.back();
+    levelTrackIds[index] = movedTrackId;
+    levelTrackIds.pop_back();
+    if (index < static_cast<int>(levelTrackIds.size())) {
+        auto moved = m_tracks.find(movedTrackId);
+        VERIFY_OR_DEBUG_ASSERT(moved != m_tracks.end()) {
+            return;
+        }
+        moved.value().levelIndexes[order] = index;
+    }
+}
+
+void AutoDJTrackSampler::updateReferenceDate() {
+    const QDate today = QDateTime::currentDateTimeUtc().date();
+    if (m_referenceDate == today) {
+        return;
+    }
+    m_referenceDate = today;
+    for (auto& level : m_levels[kLastPlayedOrder]) {
+        level.clear();
+    }
+    for (auto it = m_tracks.begin(); it != m_tracks.end(); ++it) {
+        insertIntoLevel(kLastPlayedOrder, it.key(), &it.value());
+    }
+}
+
+void AutoDJTrackSampler::addOrUpdateTrack(
+        TrackId trackId,
+        int timesPlayed,
+        const QDateTime& lastPlayed) {
+    DEBUG_ASSERT(trackId.isValid());
+    updateReferenceDate();
+
+    auto it = m_tracks.find(trackId);
+    if (it == m_tracks.end()) {
+        it = m_tracks.insert(trackId, Entry());
+    } else {
+        for (int order = 0; order < kNumOrders; ++order) {
+            removeFromLevel(order, it.value());
+        }
+    }
+    Entry* pEntry = &it.value();
+    pEntry->timesPlayed = timesPlayed;
+    pEntry->lastPlayed = lastPlayed;
+    for (int order = 0; order < kNumOrders; ++order) {
+        insertIntoLevel(order, trackId, pEntry);
+    }
+}
+
+void AutoDJTrackSampler::removeTrack(TrackId trackId) {
+    auto it = m_tracks.find(trackId);
+    if (it == m_tracks.end()) {
+        return;
+    }
+    for (int order = 0; order < kNumOrders; ++order) {
+        removeFromLevel(order, it.value());
+    }
+    m_tracks.erase(it);
+}
+
+int AutoDJTrackSampler::levelSize(Order order, int level) const {
+    VERIFY_OR_DEBUG_ASSERT(level >= 0 && level < kNumLevels) {
+        return 0;
+    }
+    return static_cast<int>(m_levels[static_cast<int>(order)][level].size());
+}
+
+int AutoDJTrackSampler::countPlayedBefore(const QDateTime& time) {
+    updateReferenceDate();
+    const qint64 timeAgeDays = time.toUTC().date().daysTo(m_referenceDate);
+    const auto& levels = m_levels[kLastPlayedOrder];
+    // Level 0 holds the tracks that have never been played
+    int count = static_cast<int>(levels[0].size());
+    for (int level = 1; level < kNumLevels; ++level) {
+        if (levels[level].empty()) {
+            continue;
+        }
+        const int ageBits = kNumLevels - 1 - level;
+        const qint64 minAgeDays = (Q_INT64_C(1) << ageBits) - 1;
+        const qint64 maxAgeDays = (Q_INT64_C(1) << (ageBits + 1)) - 2;
+        if (minAgeDays > timeAgeDays) {
+            // Played on an earlier day
+            count += static_cast<int>(levels[level].size());
+        } else if (level == 1 || maxAgeDays >= timeAgeDays) {
+            for (const auto& trackId : levels[level]) {
+                if (m_tracks.value(trackId).lastPlayed < time) {
+                    ++count;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+TrackId AutoDJTrackSampler::trackAt(
+        int order, int level, int rank, int poolCount) {
+    const auto& trackIds = m_levels[order][level];
+    DEBUG_ASSERT(rank < poolCount);
+    DEBUG_ASSERT(poolCount <= static_cast<int>(trackIds.size()));
+    if (poolCount == static_cast<int>(trackIds.size())) {
+        // The whole level is part of the pool and the rank is random
+        return trackIds[rank];
+    }
+    // Only the first tracks of the level are part of the pool
+    m_boundaryTracks.clear();
+    for (const auto& trackId : trackIds) {
+        const auto it = m_tracks.constFind(trackId);
+        VERIFY_OR_DEBUG_ASSERT(it != m_tracks.constEnd()) {
+            continue;
+        }
+        m_boundaryTracks.emplace_back(&it.value(), trackId);
+    }
+    VERIFY_OR_DEBUG_ASSERT(rank < static_cast<int>(m_boundaryTracks.size())) {
+        return TrackId();
+    }
+    std::nth_element(
+            m_boundaryTracks.begin(),
+            m_boundaryTracks.begin() + rank,
+            m_boundaryTracks.end(),
+            [order](const std::pair<const Entry*, TrackId>& lhs,
+                    const std::pair<const Entry*, TrackId>& rhs) {
+                return isLessPlayed(order, *lhs.first, *rhs.first);
+            });
+    return m_boundaryTracks[rank].second;
+}
+
+TrackId AutoDJTrackSampler::sample(
+        Order order, int poolSize, Weighting weighting) {
+    if (m_tracks.isEmpty()) {
+        return TrackId();
+    }
+    if (poolSize <= 0 || poolSize > size()) {
+        poolSize = size();
+    }
+
+    updateReferenceDate();
+    const int orderIndex = static_cast<int>(order);
+    const auto& levels = m_levels[orderIndex];
+
+    // The number of tracks of each level that are part of the pool
+    int levelPoolCounts[kNumLevels];
+    int firstLevel = -1;
+    int lastLevel = -1;
+    int remaining = poolSize;
+    for (int level = 0; level < kNumLevels && remaining > 0; ++level) {
+        levelPoolCounts[level] = math_min(
+                static_cast<int>(levels[level].size()), remaining);
+        if (levelPoolCounts[level] == 0) {
+            continue;
+        }
+        if (firstLevel < 0) {
+            firstLevel = level;
+        }
+        lastLevel = level;
+        remaining -= levelPoolCounts[level];
+    }
+    VERIFY_OR_DEBUG_ASSERT(firstLevel >= 0 && remaining == 0) {
+        return TrackId();
+    }
+
+    if (weighting == Weighting::Uniform) {
+        std::uniform_int_distribution<int> rankDist(0, poolSize - 1);
+        int rank = rankDist(m_randomEngine);
+        for (int level = firstLevel; level < lastLevel; ++level) {
+            if (rank < levelPoolCounts[level]) {
+                return trackAt(orderIndex, level, rank, levelPoolCounts[level]);
+            }
+            rank -= levelPoolCounts[level];
+        }
+        return trackAt(orderIndex, lastLevel, rank, levelPoolCounts[lastLevel]);
+    }
+
+    DEBUG_ASSERT(weighting == Weighting::Levels);
+    double levelWeights[kNumLevels];
+    double totalWeight = 0.0;
+    for (int level = firstLevel; level <= lastLevel; ++level) {
+        levelWeights[level] = static_cast<double>(levelPoolCounts[level]) /
+                (1 + level - firstLevel);
+        totalWeight += levelWeights[level];
+    }
+    std::uniform_real_distribution<double> weightDist(0.0, totalWeight);
+    double remainingWeight = weightDist(m_randomEngine);
+    // Empty levels have no weight and cannot be picked, except for the
+    // last one that is known to be non-empty
+    int pickedLevel = lastLevel;
+    for (int level = firstLevel; level < lastLevel; ++level) {
+        if (remainingWeight < levelWeights[level]) {
+            pickedLevel = level;
+            break;
+        }
+        remainingWeight -= levelWeights[level];
+    }
+    std::uniform_int_distribution<int> rankDist(
+            0, levelPoolCounts[pickedLevel] - 1);
+    return trackAt(orderIndex, pickedLevel, rankDist(m_randomEngine),
+            levelPoolCounts[pickedLevel]);
+}
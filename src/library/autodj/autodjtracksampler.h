@@ -0,0 +1,117 @@
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "track/trackid.h"
+
+// Picks random tracks from the active tracks of the Auto DJ crates, i.e. the
+// crate tracks that are neither queued in Auto DJ nor loaded into a deck.
+//
+// Every track is sorted into a level for each order, where level 0 holds
+// the least (recently) played tracks. Adding, updating and removing a track
+// only moves it between levels. Picking a track walks the fixed number of
+// levels and only orders the tracks of the level at the end of the pool.
+class AutoDJTrackSampler {
+  public:
+    // The order of the active tracks, the pool of a pick are the first
+    // tracks in this order
+    enum class Order {
+        // By times played, then by last played
+        TimesPlayed,
+        // By last played, tracks that have never been played first
+        LastPlayed,
+    };
+
+    enum class Weighting {
+        // Every track of the pool is equally likely
+        Uniform,
+        // Tracks in levels of less (recently) played tracks are more likely
+        Levels,
+    };
+
+    // TimesPlayed: one level per play count, the last level holds all
+    // tracks that have been played more often.
+    // LastPlayed: level 0 holds the tracks that have never been played, the
+    // other levels span exponentially growing ages in days, down to the
+    // last level for the tracks that have been played today.
+    static constexpr int kNumLevels = 32;
+
+    AutoDJTrackSampler();
+
+    void clear();
+
+    // Adds the track or updates its play statistics. An invalid lastPlayed
+    // means that the track has never been played.
+    void addOrUpdateTrack(
+            TrackId trackId,
+            int timesPlayed,
+            const QDateTime& lastPlayed);
+    void removeTrack(TrackId trackId);
+
+    int size() const {
+        return m_tracks.size();
+    }
+    bool isEmpty() const {
+        return m_tracks.isEmpty();
+    }
+    bool containsTrack(TrackId trackId) const {
+        return m_tracks.contains(trackId);
+    }
+    int unplayedCount() const {
+        return levelSize(Order::TimesPlayed, 0);
+    }
+    int levelSize(Order order, int level) const;
+
+    // The number of tracks that have not been played since the given time,
+    // including those that have never been played. Only the tracks of the
+    // LastPlayed levels that span this time are compared one by one.
+    int countPlayedBefore(const QDateTime& time);
+
+    // Picks a track from the first poolSize active tracks in the given
+    // order, or from all active tracks if poolSize is not positive. With
+    // the Levels weighting the weight of a track drops with the distance
+    // of its level from the first level of the pool.
+    //
+    // Returns an invalid track id if no track is active.
+    TrackId sample(
+            Order order,
+            int poolSize,
+            Weighting weighting = Weighting::Uniform);
+
+  private:
+    static constexpr int kNumOrders = 2;
+
+    struct Entry {
+        int timesPlayed;
+        QDateTime lastPlayed;
+        int levels[kNumOrders];
+        // Index into the vector of the level
+        int levelIndexes[kNumOrders];
+    };
+
+    static bool isLessPlayed(int order, const Entry& lhs, const Entry& rhs);
+    int levelFor(int order, const Entry& entry) const;
+    void insertIntoLevel(int order, TrackId trackId, Entry* pEntry);
+    void removeFromLevel(int order, const Entry& entry);
+
+    // Returns the track at rank in the order among the first poolCount
+    // tracks of the level
+    TrackId trackAt(int order, int level, int rank, int poolCount);
+
+    // The LastPlayed levels depend on the current date and are
+    // recalculated once per day
+    void updateReferenceDate();
+
+    QHash<TrackId, Entry> m_tracks;
+    std::vector<TrackId> m_levels[kNumOrders][kNumLevels];
+    // The tracks of the level at the end of the pool while ordering them
+    std::vector<std::pair<const Entry*, TrackId>> m_boundaryTracks;
+    QDate m_referenceDate;
+
+    std::mt19937 m_randomEngine;
+};
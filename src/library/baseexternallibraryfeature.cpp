@@ -1,8 +1,11 @@
 #include "library/baseexternallibraryfeature.h"
 
+#include <QDateTime>
+#include <QFileInfo>
 #include <QMenu>
 
 #include "library/basesqltablemodel.h"
+#include "library/dao/settingsdao.h"
 #include "library/library.h"
 #include "library/trackcollection.h"
 #include "library/trackcollectionmanager.h"
@@ -165,3 +168,39 @@ void BaseExternalLibraryFeature::appendTrackIdsFromRightClickIndex(
     }
 }
 
+
+// static
+QString BaseExternalLibraryFeature::sourceFilesSignature(
+        const QStringList& filePaths) {
+    QStringList fileSignatures;
+    for (const auto& filePath : filePaths) {
+        const QFileInfo fileInfo(filePath);
+        if (!fileInfo.exists()) {
+            return QString();
+        }
+        fileSignatures.append(QString("%1|%2|%3").arg(
+                fileInfo.absoluteFilePath(),
+                QString::number(fileInfo.size()),
+                QString::number(fileInfo.lastModified().toMSecsSinceEpoch())));
+    }
+    return fileSignatures.join(";");
+}
+
+// static
+bool BaseExternalLibraryFeature::isImportUpToDate(
+        const QSqlDatabase& database,
+        const QString& settingsKey,
+        const QString& signature) {
+    if (signature.isEmpty()) {
+        return false;
+    }
+    return SettingsDAO(database).getValue(settingsKey) == signature;
+}
+
+// static
+void BaseExternalLibraryFeature::setImportedSignature(
+        const QSqlDatabase& database,
+        const QString& settingsKey,
+        const QString& signature) {
+    SettingsDAO(database).setValue(settingsKey, signature);
+}
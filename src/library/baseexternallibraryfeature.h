@@ -4,6 +4,8 @@
 #include <QAction>
 #include <QModelIndex>
 #include <QPointer>
+#include <QSqlDatabase>
+#include <QStringList>
 
 #include "library/libraryfeature.h"
 #include "library/dao/playlistdao.h"
@@ -44,6 +46,22 @@ class BaseExternalLibraryFeature : public LibraryFeature {
         return m_lastRightClickedIndex;
     }
 
+    // The contents of an external library are kept in the Mixxx database
+    // between sessions. The import of the source files is skipped if their
+    // signature (path, size and modification time) matches the signature
+    // that has been stored under settingsKey after the last complete import.
+    // Returns an empty string if one of the files does not exist.
+    static QString sourceFilesSignature(const QStringList& filePaths);
+    static bool isImportUpToDate(
+            const QSqlDatabase& database,
+            const QString& settingsKey,
+            const QString& signature);
+    // Pass an empty signature to invalidate the previous import.
+    static void setImportedSignature(
+            const QSqlDatabase& database,
+            const QString& settingsKey,
+            const QString& signature);
+
     TrackCollection* const m_pTrackCollection;
 
   private:
@@ -6,6 +6,7 @@
 
 #include "library/basesqltablemodel.h"
 
+#include "library/asyncselectthread.h"
 #include "library/bpmdelegate.h"
 #include "library/coverartdelegate.h"
 #include "library/locationdelegate.h"
@@ -35,6 +36,13 @@ const bool sDebug = false;
 const int kIdColumn = 0;
 const int kMaxSortColumns = 3;
 
+// Rows of an asynchronous select are inserted into the model in batches of
+// this size, one batch per event loop iteration.
+const int kAsyncSelectRowBatchSize = 2000;
+// Asynchronous selects check every this many rows if they have been
+// superseded.
+const int kAsyncSelectCancelInterval = 1024;
+
 // Constant for getModelSetting(name)
 const QString COLUMNS_SORTING = QStringLiteral("ColumnsSorting");
 
@@ -49,7 +57,8 @@ BaseSqlTableModel::BaseSqlTableModel(QObject* pParent,
           m_database(pTrackCollectionManager->internalCollection()->database()),
           m_previewDeckGroup(PlayerManager::groupForPreviewDeck(0)),
           m_bInitialized(false),
-          m_currentSearch("") {
+          m_currentSearch(""),
+          m_rankColumn(-1) {
     connect(&PlayerInfo::instance(),
             &PlayerInfo::trackLoaded,
             this,
@@ -58,11 +67,18 @@ BaseSqlTableModel::BaseSqlTableModel(QObject* pParent,
             &TrackDAO::forceModelUpdate,
             this,
             &BaseSqlTableModel::select);
+    m_insertPendingRowsTimer.setSingleShot(true);
+    m_insertPendingRowsTimer.setInterval(0);
+    connect(&m_insertPendingRowsTimer,
+            &QTimer::timeout,
+            this,
+            &BaseSqlTableModel::slotInsertPendingRows);
     // TODO(rryan): This is a virtual function call from a constructor.
     trackLoaded(m_previewDeckGroup, PlayerInfo::instance().getTrackInfo(m_previewDeckGroup));
 }
 
 BaseSqlTableModel::~BaseSqlTableModel() {
+    cancelAsyncSelect();
 }
 
 void BaseSqlTableModel::initHeaderData() {
@@ -278,6 +294,14 @@ void BaseSqlTableModel::select() {
     //     return;
     // }
 
+    if (m_pAsyncSelectState) {
+        selectAsync();
+    } else {
+        selectSync();
+    }
+}
+
+void BaseSqlTableModel::selectSync() {
     if (sDebug) {
         qDebug() << this << "select()";
     }
@@ -285,6 +309,11 @@ void BaseSqlTableModel::select() {
     PerformanceTimer time;
     time.start();
 
+    // Discard the rows of a previous asynchronous select that have not
+    // been inserted yet
+    m_insertPendingRowsTimer.stop();
+    m_pendingRows.clear();
+
     // Prepare query for id and all columns not in m_trackSource
     QString queryString = QString("SELECT %1 FROM %2 %3")
             .arg(m_tableColumns.join(","), m_tableName, m_tableOrderBy);
@@ -351,6 +380,10 @@ void BaseSqlTableModel::select() {
         qDebug() << "Rows actually received:" << rowInfos.size();
     }
 
+    if (m_rankColumn >= 0) {
+        replaceValuesByRank(&rowInfos, m_rankColumn);
+    }
+
     if (m_trackSource) {
         m_trackSource->filterAndSort(trackIds,
                                      m_currentSearch,
@@ -362,24 +395,9 @@ void BaseSqlTableModel::select() {
 
         // Re-sort the track IDs since filterAndSort can change their order or mark
         // them for removal (by setting their row to -1).
-        for (auto& rowInfo: rowInfos) {
-            // If the sort is not a track column then we will sort only to
-            // separate removed tracks (order == -1) from present tracks (order ==
-            // 0). Otherwise we sort by the order that filterAndSort returned to us.
-            if (m_trackSourceOrderBy.isEmpty()) {
-                rowInfo.order = m_trackSortOrder.contains(rowInfo.trackId) ? 0 : -1;
-            } else {
-                rowInfo.order = m_trackSortOrder.value(rowInfo.trackId, -1);
-            }
-        }
+        sortRows(&rowInfos, m_trackSortOrder, !m_trackSourceOrderBy.isEmpty());
     }
 
-    // RowInfo::operator< sorts by the order field, except -1 is placed at the
-    // end so we can easily slice off rows that are no longer present. Stable
-    // sort is necessary because the tracks may be in pre-sorted order so we
-    // should not disturb that if we are only removing tracks.
-    std::stable_sort(rowInfos.begin(), rowInfos.end());
-
     TrackId2Rows trackIdToRows;
     // We expect almost all rows to be valid and that only a few tracks
     // are contained multiple times in rowInfos (e.g. in history playlists)
@@ -410,6 +428,321 @@ void BaseSqlTableModel::select() {
              << m_rowInfo.size();
 }
 
+// static
+void BaseSqlTableModel::sortRows(
+        QVector<RowInfo>* pRowInfos,
+        const QHash<TrackId, int>& trackSortOrder,
+        bool sortByTrackSource) {
+    for (auto& rowInfo: *pRowInfos) {
+        // If the sort is not a track column then we will sort only to
+        // separate removed tracks (order == -1) from present tracks (order ==
+        // 0). Otherwise we sort by the order that filterAndSort returned to us.
+        if (sortByTrackSource) {
+            rowInfo.order = trackSortOrder.value(rowInfo.trackId, -1);
+        } else {
+            rowInfo.order = trackSortOrder.contains(rowInfo.trackId) ? 0 : -1;
+        }
+    }
+
+    // RowInfo::operator< sorts by the order field, except -1 is placed at the
+    // end so we can easily slice off rows that are no longer present. Stable
+    // sort is necessary because the tracks may be in pre-sorted order so we
+    // should not disturb that if we are only removing tracks.
+    if (sortByTrackSource) {
+        std::stable_sort(pRowInfos->begin(), pRowInfos->end());
+    } else {
+        // Only the removed tracks need to be moved to the end
+        std::stable_partition(pRowInfos->begin(), pRowInfos->end(),
+                [](const RowInfo& rowInfo) {
+                    return rowInfo.order != -1;
+                });
+    }
+}
+
+// static
+void BaseSqlTableModel::replaceValuesByRank(
+        QVector<RowInfo>* pRowInfos,
+        int column) {
+    std::vector<int> sortedKeys;
+    sortedKeys.reserve(pRowInfos->size());
+    for (const auto& rowInfo : *pRowInfos) {
+        VERIFY_OR_DEBUG_ASSERT(column < rowInfo.metadata.size()) {
+            return;
+        }
+        sortedKeys.push_back(rowInfo.metadata[column].toInt());
+    }
+    std::sort(sortedKeys.begin(), sortedKeys.end());
+    for (auto& rowInfo : *pRowInfos) {
+        QVariant& value = rowInfo.metadata[column];
+        const auto lowerBound = std::lower_bound(
+                sortedKeys.begin(), sortedKeys.end(), value.toInt());
+        value = static_cast<int>(lowerBound - sortedKeys.begin()) + 1;
+    }
+}
+
+void BaseSqlTableModel::setAsyncSelect(bool asyncSelect) {
+    if (asyncSelect == static_cast<bool>(m_pAsyncSelectState)) {
+        return;
+    }
+    AsyncSelectThread* pThread = m_pTrackCollectionManager->asyncSelectThread();
+    if (asyncSelect) {
+        m_pAsyncSelectState = std::make_shared<AsyncSelectState>();
+        connect(pThread,
+                &AsyncSelectThread::jobDone,
+                this,
+                &BaseSqlTableModel::slotAsyncSelectDone);
+    } else {
+        cancelAsyncSelect();
+        disconnect(pThread,
+                &AsyncSelectThread::jobDone,
+                this,
+                &BaseSqlTableModel::slotAsyncSelectDone);
+        m_pAsyncSelectState.reset();
+    }
+}
+
+void BaseSqlTableModel::cancelAsyncSelect() {
+    if (!m_pAsyncSelectState) {
+        return;
+    }
+    // Abandons the query if it is already running
+    m_pAsyncSelectState->generation.fetch_add(1);
+    m_pTrackCollectionManager->asyncSelectThread()->cancel(this);
+}
+
+void BaseSqlTableModel::selectAsync() {
+    DEBUG_ASSERT(m_pAsyncSelectState);
+    if (sDebug) {
+        qDebug() << this << "select() asynchronously";
+    }
+    m_asyncSelectTimer.start();
+
+    AsyncSelectQuery query;
+    query.generation = m_pAsyncSelectState->generation.fetch_add(1) + 1;
+    query.tableQuery = QString("SELECT %1 FROM %2 %3")
+            .arg(m_tableColumns.join(","), m_tableName, m_tableOrderBy);
+    query.idColumn = m_idColumn;
+    query.columnCount = m_tableColumns.size();
+    if (m_trackSource) {
+        // Instead of passing the ids of all rows like filterAndSort() the
+        // query is restricted to the tracks of our table with a subquery.
+        query.filterQuery = m_trackSource->filterAndSortQuery(
+                m_currentSearch,
+                m_currentSearchFilter,
+                QString("SELECT %1 FROM %2").arg(m_idColumn, m_tableName),
+                m_trackSourceOrderBy);
+    }
+    query.sortByTrackSource = !m_trackSourceOrderBy.isEmpty();
+    query.rankColumn = m_rankColumn;
+
+    if (sDebug) {
+        qDebug() << this << "select() executing:" << query.tableQuery
+                 << query.filterQuery;
+    }
+
+    std::shared_ptr<AsyncSelectState> pState = m_pAsyncSelectState;
+    m_pTrackCollectionManager->asyncSelectThread()->submit(
+            this,
+            AsyncSelectThread::temporaryViews(m_database),
+            [pState, query](const QSqlDatabase& database) {
+                queryRowsAsync(database, query, pState.get());
+            });
+}
+
+// static
+void BaseSqlTableModel::queryRowsAsync(
+        const QSqlDatabase& database,
+        const AsyncSelectQuery& query,
+        AsyncSelectState* pState) {
+    const auto isSuperseded = [pState, &query] {
+        return pState->generation.load() != query.generation;
+    };
+    const auto publish = [pState, &query](AsyncSelectState&& result) {
+        QMutexLocker locker(&pState->mutex);
+        pState->resultGeneration = query.generation;
+        pState->ok = result.ok;
+        pState->rowInfos = std::move(result.rowInfos);
+        pState->trackIds = std::move(result.trackIds);
+        pState->sortedTrackIds = std::move(result.sortedTrackIds);
+        pState->sortedTrackIndex = std::move(result.sortedTrackIndex);
+    };
+    if (isSuperseded()) {
+        return;
+    }
+
+    AsyncSelectState result;
+    if (!database.isValid()) {
+        // The temporary views could not be cloned
+        publish(std::move(result));
+        return;
+    }
+
+    QSqlQuery tableQuery(database);
+    tableQuery.setForwardOnly(true);
+    if (!tableQuery.prepare(query.tableQuery) || !tableQuery.exec()) {
+        LOG_FAILED_QUERY(tableQuery);
+        publish(std::move(result));
+        return;
+    }
+    int idColumn = -1;
+    while (tableQuery.next()) {
+        if ((result.rowInfos.size() % kAsyncSelectCancelInterval) == 0 &&
+                isSuperseded()) {
+            return;
+        }
+        QSqlRecord sqlRecord = tableQuery.record();
+        if (idColumn < 0) {
+            idColumn = sqlRecord.indexOf(query.idColumn);
+        }
+        VERIFY_OR_DEBUG_ASSERT(idColumn == kIdColumn) {
+            qCritical()
+                    << "ID column not available in database query results:"
+                    << query.idColumn;
+            publish(std::move(result));
+            return;
+        }
+
+        TrackId trackId(sqlRecord.value(idColumn));
+        result.trackIds.insert(trackId);
+
+        RowInfo rowInfo;
+        rowInfo.trackId = trackId;
+        // current position defines the ordering
+        rowInfo.order = result.rowInfos.size();
+        rowInfo.metadata.reserve(query.columnCount);
+        for (int i = 0; i < query.columnCount; ++i) {
+            rowInfo.metadata.push_back(sqlRecord.value(i));
+        }
+        result.rowInfos.push_back(rowInfo);
+    }
+    if (query.rankColumn >= 0) {
+        replaceValuesByRank(&result.rowInfos, query.rankColumn);
+    }
+
+    if (!query.filterQuery.isEmpty() && !result.rowInfos.isEmpty()) {
+        QSqlQuery filterQuery(database);
+        filterQuery.setForwardOnly(true);
+        if (!filterQuery.prepare(query.filterQuery) || !filterQuery.exec()) {
+            LOG_FAILED_QUERY(filterQuery);
+            publish(std::move(result));
+            return;
+        }
+        while (filterQuery.next()) {
+            if ((result.sortedTrackIds.size() % kAsyncSelectCancelInterval) == 0 &&
+                    isSuperseded()) {
+                return;
+            }
+            TrackId trackId(filterQuery.value(0));
+            result.sortedTrackIndex.insert(trackId, result.sortedTrackIds.size());
+            result.sortedTrackIds.append(trackId);
+        }
+        if (isSuperseded()) {
+            return;
+        }
+        if (query.sortByTrackSource) {
+            // Sort in advance assuming that no dirty tracks need to be
+            // corrected, which is the common case. Otherwise the rows
+            // are kept in the order of the table, because dirty tracks
+            // might have to be added back at their original position.
+            sortRows(&result.rowInfos,
+                    result.sortedTrackIndex,
+                    query.sortByTrackSource);
+        }
+    }
+
+    result.ok = true;
+    publish(std::move(result));
+}
+
+void BaseSqlTableModel::slotAsyncSelectDone(QObject* pOwner) {
+    if (pOwner != this || !m_pAsyncSelectState) {
+        return;
+    }
+
+    AsyncSelectState result;
+    {
+        QMutexLocker locker(&m_pAsyncSelectState->mutex);
+        if (m_pAsyncSelectState->resultGeneration !=
+                m_pAsyncSelectState->generation.load()) {
+            // Superseded or already consumed
+            return;
+        }
+        // Consume the result
+        m_pAsyncSelectState->resultGeneration = 0;
+        result.ok = m_pAsyncSelectState->ok;
+        result.rowInfos = std::move(m_pAsyncSelectState->rowInfos);
+        result.trackIds = std::move(m_pAsyncSelectState->trackIds);
+        result.sortedTrackIds = std::move(m_pAsyncSelectState->sortedTrackIds);
+        result.sortedTrackIndex = std::move(m_pAsyncSelectState->sortedTrackIndex);
+    }
+
+    if (!result.ok) {
+        qWarning() << this
+                   << "Asynchronous select failed, selecting synchronously from now on";
+        setAsyncSelect(false);
+        selectSync();
+        return;
+    }
+
+    QVector<RowInfo> rowInfos = std::move(result.rowInfos);
+    if (m_trackSource && !rowInfos.isEmpty()) {
+        // Dirty tracks can only be corrected on this thread, because the
+        // track objects are not thread-safe
+        const bool corrected = m_trackSource->applyFilterAndSortResult(
+                result.trackIds,
+                result.sortedTrackIds,
+                result.sortedTrackIndex,
+                m_currentSearch,
+                m_currentSearchFilter,
+                m_sortColumns,
+                m_tableColumns.size() - 1, // exclude the 1st column with the id
+                &m_trackSortOrder);
+        const bool sortByTrackSource = !m_trackSourceOrderBy.isEmpty();
+        if (corrected || !sortByTrackSource) {
+            sortRows(&rowInfos, m_trackSortOrder, sortByTrackSource);
+        }
+    }
+
+    // Cut off the rows that are no longer present
+    int rowCount = rowInfos.size();
+    while (rowCount > 0 && rowInfos.at(rowCount - 1).order == -1) {
+        --rowCount;
+    }
+    rowInfos.resize(rowCount);
+
+    // Replace the rows after(!) the query has been executed successfully.
+    // See Bug #1090888.
+    m_insertPendingRowsTimer.stop();
+    clearRows();
+    m_pendingRows = std::move(rowInfos);
+    slotInsertPendingRows();
+}
+
+void BaseSqlTableModel::slotInsertPendingRows() {
+    const int firstRow = m_rowInfo.size();
+    const int lastRow = std::min(
+            firstRow + kAsyncSelectRowBatchSize, m_pendingRows.size()) - 1;
+    if (lastRow >= firstRow) {
+        beginInsertRows(QModelIndex(), firstRow, lastRow);
+        m_rowInfo.reserve(m_pendingRows.size());
+        for (int row = firstRow; row <= lastRow; ++row) {
+            const RowInfo& rowInfo = m_pendingRows.at(row);
+            m_rowInfo.append(rowInfo);
+            m_trackIdToRows[rowInfo.trackId].push_back(row);
+        }
+        endInsertRows();
+    }
+    if (m_rowInfo.size() < m_pendingRows.size()) {
+        // Let the event loop breathe before inserting the next batch
+        m_insertPendingRowsTimer.start();
+        return;
+    }
+    m_pendingRows.clear();
+    qDebug() << this << "select() took"
+             << m_asyncSelectTimer.elapsed().debugMillisWithUnit()
+             << m_rowInfo.size();
+}
+
 void BaseSqlTableModel::setTable(const QString& tableName,
                                  const QString& idColumn,
                                  const QStringList& tableColumns,
@@ -420,6 +753,7 @@ void BaseSqlTableModel::setTable(const QString& tableName,
     m_tableName = tableName;
     m_idColumn = idColumn;
     m_tableColumns = tableColumns;
+    m_rankColumn = -1;
 
     if (m_trackSource) {
         disconnect(m_trackSource.data(),
@@ -452,6 +786,13 @@ void BaseSqlTableModel::setTable(const QString& tableName,
     m_bInitialized = true;
 }
 
+void BaseSqlTableModel::setRankColumn(int column) {
+    VERIFY_OR_DEBUG_ASSERT(column < m_tableColumns.size()) {
+        return;
+    }
+    m_rankColumn = column;
+}
+
 int BaseSqlTableModel::columnIndexFromSortColumnId(TrackModel::SortColumnId column) {
     if (column == TrackModel::SortColumnId::SORTCOLUMN_INVALID) {
         return -1;
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+
 #include <QHash>
+#include <QMutex>
+#include <QTimer>
 #include <QtSql>
 
 #include "library/basetrackcache.h"
@@ -8,6 +13,7 @@
 #include "library/trackmodel.h"
 #include "library/columncache.h"
 #include "util/class.h"
+#include "util/performancetimer.h"
 
 class TrackCollectionManager;
 
@@ -31,6 +37,13 @@ class BaseSqlTableModel : public QAbstractTableModel, public TrackModel {
     void setSearch(const QString& searchText, const QString& extraFilter = QString());
     void setSort(int column, Qt::SortOrder order);
 
+    // If enabled, select() runs the queries on a background connection
+    // and returns immediately. The current rows stay visible until the
+    // result is available and are then replaced batch by batch. Only
+    // enable this for models that are displayed to the user and that are
+    // not read programmatically right after calling select().
+    void setAsyncSelect(bool asyncSelect);
+
     int fieldIndex(ColumnCache::Column column) const;
 
     ///////////////////////////////////////////////////////////////////////////
@@ -90,6 +103,10 @@ class BaseSqlTableModel : public QAbstractTableModel, public TrackModel {
     void setTable(const QString& tableName, const QString& trackIdColumn,
                   const QStringList& tableColumns,
                   QSharedPointer<BaseTrackCache> trackSource);
+    // The values of this table column are sparse ordering keys that are
+    // replaced by their 1-based rank among all rows of the table, i.e. the
+    // model exposes dense positions regardless of the stored keys.
+    void setRankColumn(int column);
     void initHeaderData();
     virtual void initSortColumnMapping();
 
@@ -113,6 +130,8 @@ class BaseSqlTableModel : public QAbstractTableModel, public TrackModel {
     virtual void tracksChanged(QSet<TrackId> trackIds);
     virtual void trackLoaded(QString group, TrackPointer pTrack);
     void refreshCell(int row, int column);
+    void slotAsyncSelectDone(QObject* pOwner);
+    void slotInsertPendingRows();
 
   private:
     // A simple helper function for initializing header title and width.  Note
@@ -144,6 +163,55 @@ class BaseSqlTableModel : public QAbstractTableModel, public TrackModel {
 
     typedef QHash<TrackId, QLinkedList<int>> TrackId2Rows;
 
+    // The result of an asynchronous select, written by the background
+    // thread and consumed by slotAsyncSelectDone().
+    struct AsyncSelectState {
+        // Incremented for each select(). Running queries are abandoned
+        // as soon as they notice that they have been superseded.
+        std::atomic<quint64> generation{0};
+
+        QMutex mutex;
+        quint64 resultGeneration = 0;
+        bool ok = false;
+        QVector<RowInfo> rowInfos;
+        QSet<TrackId> trackIds;
+        QVector<TrackId> sortedTrackIds;
+        QHash<TrackId, int> sortedTrackIndex;
+    };
+
+    struct AsyncSelectQuery {
+        quint64 generation;
+        QString tableQuery;
+        QString idColumn;
+        int columnCount;
+        // Empty if there is no track source
+        QString filterQuery;
+        bool sortByTrackSource;
+        // -1 if there is no rank column
+        int rankColumn;
+    };
+
+    void selectSync();
+    void selectAsync();
+    void cancelAsyncSelect();
+    // Executed on the thread of the AsyncSelectThread
+    static void queryRowsAsync(
+            const QSqlDatabase& database,
+            const AsyncSelectQuery& query,
+            AsyncSelectState* pState);
+
+    // Updates the order of all rows from the result of
+    // BaseTrackCache::filterAndSort() and sorts them.
+    static void sortRows(
+            QVector<RowInfo>* pRowInfos,
+            const QHash<TrackId, int>& trackSortOrder,
+            bool sortByTrackSource);
+
+    // Must be applied to all rows of the table before they are filtered
+    static void replaceValuesByRank(
+            QVector<RowInfo>* pRowInfos,
+            int column);
+
     void clearRows();
     void replaceRows(
             QVector<RowInfo>&& rows,
@@ -164,6 +232,14 @@ class BaseSqlTableModel : public QAbstractTableModel, public TrackModel {
     QString m_currentSearchFilter;
     QVector<QHash<int, QVariant> > m_headerInfo;
     QString m_trackSourceOrderBy;
+    int m_rankColumn;
+
+    // Only set if asynchronous selects are enabled
+    std::shared_ptr<AsyncSelectState> m_pAsyncSelectState;
+    PerformanceTimer m_asyncSelectTimer;
+    // Rows of the last asynchronous select, inserted batch by batch
+    QVector<RowInfo> m_pendingRows;
+    QTimer m_insertPendingRowsTimer;
 
     DISALLOW_COPY_AND_ASSIGN(BaseSqlTableModel);
 };
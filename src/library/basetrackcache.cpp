@@ -8,6 +8,7 @@
 #include "library/queryutil.h"
 #include "track/keyutils.h"
 #include "track/globaltrackcache.h"
+#include "util/assert.h"
 #include "util/performancetimer.h"
 #include "util/compatibility.h"
 
@@ -515,6 +516,44 @@ QVariant BaseTrackCache::data(TrackId trackId, int column) const {
     return result;
 }
 
+QString BaseTrackCache::filterAndSortQuery(const QString& searchQuery,
+                                           const QString& extraFilter,
+                                           const QString& trackIdsSql,
+                                           const QString& orderByClause) {
+    if (!m_bIndexBuilt) {
+        buildIndex();
+    }
+
+    const std::unique_ptr<QueryNode> pQuery =
+            parseFilter(searchQuery, extraFilter, trackIdsSql);
+
+    QString filter = pQuery->toSql();
+    if (!filter.isEmpty()) {
+        filter.prepend("WHERE ");
+    }
+
+    return QString("SELECT %1 FROM %2 %3 %4")
+            .arg(m_idColumn, m_tableName, filter, orderByClause);
+}
+
+std::unique_ptr<QueryNode> BaseTrackCache::parseFilter(
+        const QString& searchQuery,
+        const QString& extraFilter,
+        const QString& trackIdsSql) const {
+    QStringList queryFragments;
+    if (!extraFilter.isNull() && extraFilter != "") {
+        queryFragments << QString("(%1)").arg(extraFilter);
+    }
+    if (!trackIdsSql.isEmpty()) {
+        queryFragments << QString("%1 in (%2)")
+                .arg(m_idColumn, trackIdsSql);
+    }
+    return m_pQueryParser->parseQuery(
+            searchQuery,
+            m_searchColumns,
+            queryFragments.join(" AND "));
+}
+
 void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
                                    const QString& searchQuery,
                                    const QString& extraFilter,
@@ -527,43 +566,18 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         return;
     }
 
-    if (!m_bIndexBuilt) {
-        buildIndex();
-    }
-
     QStringList idStrings;
     // TODO(rryan) consider making this the data passed in and a separate
     // QVector for output
-    QSet<TrackId> dirtyTracks;
     for (const auto& trackId: trackIds) {
         idStrings << trackId.toString();
-        if (m_dirtyTracks.contains(trackId)) {
-            dirtyTracks.insert(trackId);
-        }
-    }
-
-    QStringList queryFragments;
-    if (!extraFilter.isNull() && extraFilter != "") {
-        queryFragments << QString("(%1)").arg(extraFilter);
-    }
-    if (idStrings.size() > 0) {
-        queryFragments << QString("%1 in (%2)")
-                .arg(m_idColumn, idStrings.join(","));
     }
 
-    const std::unique_ptr<QueryNode> pQuery =
-            m_pQueryParser->parseQuery(
-                    searchQuery,
-                    m_searchColumns,
-                    queryFragments.join(" AND "));
-
-    QString filter = pQuery->toSql();
-    if (!filter.isEmpty()) {
-        filter.prepend("WHERE ");
-    }
-
-    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
-            .arg(m_idColumn, m_tableName, filter, orderByClause);
+    QString queryString = filterAndSortQuery(
+            searchQuery,
+            extraFilter,
+            idStrings.join(","),
+            orderByClause);
 
     if (sDebug) {
         qDebug() << this << "select() executing:" << queryString;
@@ -599,6 +613,33 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         m_trackOrder.append(trackId);
     }
 
+    correctDirtyTracks(trackIds, searchQuery, extraFilter,
+            sortColumns, columnOffset, trackToIndex);
+}
+
+bool BaseTrackCache::applyFilterAndSortResult(const QSet<TrackId>& trackIds,
+                                              const QVector<TrackId>& sortedTrackIds,
+                                              const QHash<TrackId, int>& sortedTrackIndex,
+                                              const QString& searchQuery,
+                                              const QString& extraFilter,
+                                              const QList<SortColumn>& sortColumns,
+                                              const int columnOffset,
+                                              QHash<TrackId, int>* trackToIndex) {
+    DEBUG_ASSERT(sortedTrackIds.size() == sortedTrackIndex.size());
+    // Both containers are implicitly shared, no deep copies are made
+    // unless dirty tracks need to be corrected.
+    m_trackOrder = sortedTrackIds;
+    *trackToIndex = sortedTrackIndex;
+    return correctDirtyTracks(trackIds, searchQuery, extraFilter,
+            sortColumns, columnOffset, trackToIndex);
+}
+
+bool BaseTrackCache::correctDirtyTracks(const QSet<TrackId>& trackIds,
+                                        const QString& searchQuery,
+                                        const QString& extraFilter,
+                                        const QList<SortColumn>& sortColumns,
+                                        const int columnOffset,
+                                        QHash<TrackId, int>* trackToIndex) {
     // At this point, the original set of tracks have been divided into two
     // pieces: those that should be in the result set and those that should
     // not. Unfortunately, due to TrackDAO caching, there may be tracks in
@@ -608,10 +649,27 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
     // membership of tracks in either set, we must then insertion-sort the
     // missing tracks into the resulting index list.
 
-    if (!m_bIsCaching || dirtyTracks.isEmpty()) {
-        return;
+    if (!m_bIsCaching) {
+        return false;
     }
 
+    // getRecentTrack() modifies m_dirtyTracks, so collect the
+    // affected tracks first.
+    QSet<TrackId> dirtyTracks;
+    for (const auto& trackId : qAsConst(m_dirtyTracks)) {
+        if (trackIds.contains(trackId)) {
+            dirtyTracks.insert(trackId);
+        }
+    }
+    if (dirtyTracks.isEmpty()) {
+        return false;
+    }
+
+    // The restriction to trackIds does not affect matching
+    const std::unique_ptr<QueryNode> pQuery =
+            parseFilter(searchQuery, extraFilter, QString());
+
+    bool corrected = false;
     for (TrackId trackId: qAsConst(dirtyTracks)) {
         // Only get the track if it is in the cache. Tracks that
         // are not cached in memory cannot be dirty.
@@ -659,6 +717,7 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
             for (int i = 0; i < m_trackOrder.size(); ++i) {
                 (*trackToIndex)[m_trackOrder[i]] = i;
             }
+            corrected = true;
         } else if (isInResultSet) {
             // Track should not be in this result set, but it is. We need to
             // remove it.
@@ -670,8 +729,10 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
             for (int i = 0; i < m_trackOrder.size(); ++i) {
                 (*trackToIndex)[m_trackOrder[i]] = i;
             }
+            corrected = true;
         }
     }
+    return corrected;
 }
 
 int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
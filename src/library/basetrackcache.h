@@ -16,6 +16,7 @@
 #include "util/class.h"
 #include "util/string.h"
 
+class QueryNode;
 class SearchQueryParser;
 class TrackDAO;
 class TrackCollection;
@@ -67,6 +68,26 @@ class BaseTrackCache : public QObject {
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
                                QHash<TrackId, int>* trackToIndex);
+    // Returns the query that filterAndSort() executes, for executing it on
+    // a different connection. The result is restricted to the tracks in
+    // trackIdsSql, either a comma-separated list of ids or a subquery.
+    QString filterAndSortQuery(const QString& query,
+                               const QString& extraFilter,
+                               const QString& trackIdsSql,
+                               const QString& orderByClause);
+    // Completes a filterAndSort() whose query has been executed elsewhere.
+    // sortedTrackIds are the ids returned by the query in order and
+    // sortedTrackIndex maps them to their position. Returns true if dirty
+    // tracks had to be inserted, moved or removed, i.e. if trackToIndex
+    // does not match sortedTrackIndex.
+    bool applyFilterAndSortResult(const QSet<TrackId>& trackIds,
+                                  const QVector<TrackId>& sortedTrackIds,
+                                  const QHash<TrackId, int>& sortedTrackIndex,
+                                  const QString& query,
+                                  const QString& extraFilter,
+                                  const QList<SortColumn>& sortColumns,
+                                  const int columnOffset,
+                                  QHash<TrackId, int>* trackToIndex);
     virtual bool isCached(TrackId trackId) const;
     virtual void ensureCached(TrackId trackId);
     virtual void ensureCached(QSet<TrackId> trackIds);
@@ -100,6 +121,16 @@ class BaseTrackCache : public QObject {
     void getTrackValueForColumn(TrackPointer pTrack, int column,
                                 QVariant& trackValue) const;
 
+    std::unique_ptr<QueryNode> parseFilter(const QString& query,
+                                           const QString& extraFilter,
+                                           const QString& trackIdsSql) const;
+    bool correctDirtyTracks(const QSet<TrackId>& trackIds,
+                            const QString& query,
+                            const QString& extraFilter,
+                            const QList<SortColumn>& sortColumns,
+                            const int columnOffset,
+                            QHash<TrackId, int>* trackToIndex);
+
     int findSortInsertionPoint(TrackPointer pTrack,
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
@@ -1,11 +1,14 @@
 #include <QFutureWatcher>
 #include <QPixmapCache>
+#include <QThread>
 #include <QtConcurrentRun>
 #include <QtDebug>
 
 #include "library/coverartcache.h"
 #include "library/coverartutils.h"
+#include "util/counter.h"
 #include "util/logger.h"
+#include "util/math.h"
 
 
 namespace {
@@ -27,9 +30,20 @@ inline QImage resizeImageWidth(const QImage& image, int width) {
 
 const bool sDebug = false;
 
+// Loading covers is mostly I/O and decoding of small images. A few threads
+// are enough to keep up with scrolling without starving the analyzers.
+int loaderThreadCount() {
+    return math_clamp(QThread::idealThreadCount() / 2, 1, 4);
+}
+
 } // anonymous namespace
 
-CoverArtCache::CoverArtCache() {
+constexpr int CoverArtCache::kDefaultPrefetchRows;
+
+CoverArtCache::CoverArtCache()
+        : m_runningLoads(0),
+          m_prefetchRows(kDefaultPrefetchRows) {
+    m_loaderThreadPool.setMaxThreadCount(loaderThreadCount());
     // The initial QPixmapCache limit is 10MB.
     // But it is not used just by the coverArt stuff,
     // it is also used by Qt to handle other things behind the scenes.
@@ -42,6 +56,7 @@ CoverArtCache::CoverArtCache() {
 
 CoverArtCache::~CoverArtCache() {
     qDebug() << "~CoverArtCache()";
+    m_loaderThreadPool.waitForDone();
 }
 
 QPixmap CoverArtCache::requestCover(const CoverInfo& requestInfo,
@@ -63,10 +78,23 @@ QPixmap CoverArtCache::requestCover(const CoverInfo& requestInfo,
         return QPixmap();
     }
 
-    // keep a list of trackIds for which a future is currently running
-    // to avoid loading the same picture again while we are loading it
-    QPair<const QObject*, quint16> requestId = qMakePair(pRequestor, requestInfo.hash);
-    if (m_runningRequests.contains(requestId)) {
+    // keep a list of trackIds for which a request is currently pending
+    // or running to avoid loading the same picture again while we are
+    // loading it
+    RequestId requestId = qMakePair(pRequestor, requestInfo.hash);
+    auto request = m_requests.find(requestId);
+    if (request != m_requests.end()) {
+        if (signalWhenDone && !request.value()) {
+            // A prefetched cover is needed now
+            request.value() = true;
+            for (int i = 0; i < m_pendingPrefetchRequests.size(); ++i) {
+                if (m_pendingPrefetchRequests.at(i).pRequestor == pRequestor &&
+                        m_pendingPrefetchRequests.at(i).info.hash == requestInfo.hash) {
+                    m_pendingRequests.append(m_pendingPrefetchRequests.takeAt(i));
+                    break;
+                }
+            }
+        }
         return QPixmap();
     }
 
@@ -95,23 +123,90 @@ QPixmap CoverArtCache::requestCover(const CoverInfo& requestInfo,
         return QPixmap();
     }
 
-    if (sDebug) {
-        kLogger.debug() << "CoverArtCache::requestCover starting future for" << requestInfo;
-    }
-    m_runningRequests.insert(requestId);
-    // The watcher will be deleted in coverLoaded()
-    QFutureWatcher<FutureResult>* watcher = new QFutureWatcher<FutureResult>(this);
-    QFuture<FutureResult> future = QtConcurrent::run(
-            this, &CoverArtCache::loadCover, requestInfo, pRequestor,
-            desiredWidth, signalWhenDone);
-    connect(watcher,
-            &QFutureWatcher<FutureResult>::finished,
-            this,
-            &CoverArtCache::coverLoaded);
-    watcher->setFuture(future);
+    enqueueRequest(requestInfo, pRequestor, desiredWidth, signalWhenDone);
     return QPixmap();
 }
 
+void CoverArtCache::prefetchCover(const CoverInfo& info,
+                                  const QObject* pRequestor,
+                                  const int desiredWidth) {
+    if (info.type == CoverInfo::NONE) {
+        return;
+    }
+    if (m_requests.contains(qMakePair(pRequestor, info.hash))) {
+        return;
+    }
+    QPixmap pixmap;
+    if (QPixmapCache::find(pixmapCacheKey(info.hash, desiredWidth), &pixmap)) {
+        return;
+    }
+    enqueueRequest(info, pRequestor, desiredWidth, false);
+}
+
+void CoverArtCache::cancelPendingRequests(const QObject* pRequestor) {
+    int cancelled = 0;
+    for (auto* pPendingRequests : {&m_pendingRequests, &m_pendingPrefetchRequests}) {
+        auto i = pPendingRequests->begin();
+        while (i != pPendingRequests->end()) {
+            if (i->pRequestor == pRequestor) {
+                m_requests.remove(qMakePair(pRequestor, i->info.hash));
+                i = pPendingRequests->erase(i);
+                ++cancelled;
+            } else {
+                ++i;
+            }
+        }
+    }
+    if (cancelled > 0) {
+        Counter("CoverArtCache cancelled requests").increment(cancelled);
+    }
+}
+
+void CoverArtCache::enqueueRequest(const CoverInfo& info,
+                                   const QObject* pRequestor,
+                                   const int desiredWidth,
+                                   const bool signalWhenDone) {
+    if (sDebug) {
+        kLogger.debug() << "CoverArtCache::enqueueRequest" << info << signalWhenDone;
+    }
+    m_requests.insert(qMakePair(pRequestor, info.hash), signalWhenDone);
+    PendingRequest request;
+    request.info = info;
+    request.pRequestor = pRequestor;
+    request.desiredWidth = desiredWidth;
+    if (signalWhenDone) {
+        m_pendingRequests.append(request);
+    } else {
+        m_pendingPrefetchRequests.append(request);
+    }
+    startPendingRequests();
+}
+
+void CoverArtCache::startPendingRequests() {
+    while (m_runningLoads < m_loaderThreadPool.maxThreadCount()) {
+        PendingRequest request;
+        if (!m_pendingRequests.isEmpty()) {
+            request = m_pendingRequests.takeFirst();
+        } else if (!m_pendingPrefetchRequests.isEmpty()) {
+            request = m_pendingPrefetchRequests.takeFirst();
+        } else {
+            return;
+        }
+        ++m_runningLoads;
+        // The watcher will be deleted in coverLoaded()
+        QFutureWatcher<FutureResult>* watcher = new QFutureWatcher<FutureResult>(this);
+        QFuture<FutureResult> future = QtConcurrent::run(
+                &m_loaderThreadPool, this, &CoverArtCache::loadCover,
+                request.info, request.pRequestor, request.desiredWidth,
+                m_requests.value(qMakePair(request.pRequestor, request.info.hash)));
+        connect(watcher,
+                &QFutureWatcher<FutureResult>::finished,
+                this,
+                &CoverArtCache::coverLoaded);
+        watcher->setFuture(future);
+    }
+}
+
 //static
 void CoverArtCache::requestCover(const Track& track,
                          const QObject* pRequestor) {
@@ -185,9 +280,14 @@ void CoverArtCache::coverLoaded() {
         QPixmapCache::insert(cacheKey, pixmap);
     }
 
-    m_runningRequests.remove(qMakePair(res.pRequestor, res.cover.hash));
+    --m_runningLoads;
+    // The request might have been upgraded from a prefetch request
+    // while it was running
+    const bool signalWhenDone = m_requests.take(
+            qMakePair(res.pRequestor, res.cover.hash));
+    startPendingRequests();
 
-    if (res.signalWhenDone) {
+    if (signalWhenDone) {
         emit(coverFound(res.pRequestor, res.cover, pixmap, false));
     }
 }
@@ -1,8 +1,11 @@
 #ifndef COVERARTCACHE_H
 #define COVERARTCACHE_H
 
+#include <QHash>
+#include <QList>
 #include <QObject>
 #include <QPixmap>
+#include <QThreadPool>
 
 #include "library/coverart.h"
 #include "util/singleton.h"
@@ -32,6 +35,27 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
     static void requestCover(const Track& track,
                              const QObject* pRequestor);
 
+    // Loads a cover into the pixmap cache with a lower priority than
+    // requestCover() and without signaling when done. Used for covers
+    // that are likely to become visible soon.
+    void prefetchCover(const CoverInfo& info,
+                       const QObject* pRequestor,
+                       const int desiredWidth);
+
+    // Discards all requests of pRequestor that have not been started yet,
+    // e.g. for rows that have been scrolled out of view.
+    void cancelPendingRequests(const QObject* pRequestor);
+
+    // The number of rows above and below the visible rows of a track
+    // table whose covers are prefetched.
+    static constexpr int kDefaultPrefetchRows = 20;
+    int prefetchRows() const {
+        return m_prefetchRows;
+    }
+    void setPrefetchRows(int prefetchRows) {
+        m_prefetchRows = prefetchRows;
+    }
+
     // Guesses the cover art for the provided tracks by searching the tracks'
     // metadata and folders for image files. All I/O is done in a separate
     // thread.
@@ -74,7 +98,37 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
     void guessCover(TrackPointer pTrack);
 
   private:
-    QSet<QPair<const QObject*, quint16> > m_runningRequests;
+    typedef QPair<const QObject*, quint16> RequestId;
+
+    struct PendingRequest {
+        CoverInfo info;
+        const QObject* pRequestor;
+        int desiredWidth;
+    };
+
+    void enqueueRequest(const CoverInfo& info,
+                        const QObject* pRequestor,
+                        const int desiredWidth,
+                        const bool signalWhenDone);
+    // Starts pending requests while loader threads are available
+    void startPendingRequests();
+
+    // Covers are loaded by a dedicated pool with a bounded number of
+    // threads, that does not compete with other users of the global pool.
+    QThreadPool m_loaderThreadPool;
+    int m_runningLoads;
+
+    // Requests that have not been started yet. Requests for visible covers
+    // are started before prefetch requests.
+    QList<PendingRequest> m_pendingRequests;
+    QList<PendingRequest> m_pendingPrefetchRequests;
+
+    // All pending and running requests, to avoid loading the same picture
+    // again while we are loading it. The value tells whether to signal
+    // when done.
+    QHash<RequestId, bool> m_requests;
+
+    int m_prefetchRows;
 };
 
 #endif // COVERARTCACHE_H
@@ -1,4 +1,5 @@
 #include <QPainter>
+#include <QScrollBar>
 
 #include "library/coverartdelegate.h"
 #include "library/coverartcache.h"
@@ -19,12 +20,18 @@ CoverArtDelegate::CoverArtDelegate(WLibraryTableView* parent)
           m_iCoverLocationColumn(-1),
           m_iCoverHashColumn(-1),
           m_iTrackLocationColumn(-1),
-          m_iIdColumn(-1) {
+          m_iIdColumn(-1),
+          m_timeToVisibleCovers("CoverArtDelegate time to visible covers"),
+          m_bWaitingForVisibleCovers(false) {
     // This assumes that the parent is wtracktableview
     connect(parent,
             &WLibraryTableView::onlyCachedCoverArt,
             this,
             &CoverArtDelegate::slotOnlyCachedCoverArt);
+    connect(parent->verticalScrollBar(),
+            &QScrollBar::valueChanged,
+            this,
+            &CoverArtDelegate::slotScrolled);
 
     CoverArtCache* pCache = CoverArtCache::instance();
     if (pCache) {
@@ -58,12 +65,25 @@ CoverArtDelegate::CoverArtDelegate(WLibraryTableView* parent)
     }
 }
 
+CoverArtDelegate::~CoverArtDelegate() {
+    CoverArtCache* pCache = CoverArtCache::instance();
+    if (pCache) {
+        pCache->cancelPendingRequests(this);
+    }
+}
+
 void CoverArtDelegate::slotOnlyCachedCoverArt(bool b) {
     m_bOnlyCachedCover = b;
 
     // If we can request non-cache covers now, request updates for all rows that
     // were cache misses since the last time.
     if (!m_bOnlyCachedCover) {
+        if (m_cacheMissRows.isEmpty()) {
+            prefetchCovers();
+            return;
+        }
+        m_timeToVisibleCovers.start();
+        m_bWaitingForVisibleCovers = true;
         foreach (int row, m_cacheMissRows) {
             emit(coverReadyForCell(row, m_iCoverColumn));
         }
@@ -71,15 +91,92 @@ void CoverArtDelegate::slotOnlyCachedCoverArt(bool b) {
     }
 }
 
+void CoverArtDelegate::slotScrolled() {
+    CoverArtCache* pCache = CoverArtCache::instance();
+    if (pCache) {
+        pCache->cancelPendingRequests(this);
+    }
+    // The rows that are still visible request their covers again when
+    // they are painted.
+    m_hashToRow.clear();
+    m_bWaitingForVisibleCovers = false;
+}
+
 void CoverArtDelegate::slotCoverFound(const QObject* pRequestor,
                                       const CoverInfoRelative& info,
                                       QPixmap pixmap, bool fromCache) {
-    if (pRequestor == this && !pixmap.isNull() && !fromCache) {
+    if (pRequestor == this && !fromCache) {
         // qDebug() << "CoverArtDelegate::slotCoverFound" << pRequestor << info
         //          << pixmap.size();
         QLinkedList<int> rows = m_hashToRow.take(info.hash);
-        foreach(int row, rows) {
-            emit(coverReadyForCell(row, m_iCoverColumn));
+        if (!pixmap.isNull()) {
+            foreach(int row, rows) {
+                emit(coverReadyForCell(row, m_iCoverColumn));
+            }
+        }
+        if (m_bWaitingForVisibleCovers && m_hashToRow.isEmpty()) {
+            m_timeToVisibleCovers.elapsed(true);
+            m_bWaitingForVisibleCovers = false;
+            prefetchCovers();
+        }
+    }
+}
+
+bool CoverArtDelegate::coverInfoForRow(const QModelIndex& index,
+                                       CoverInfo* pInfo) const {
+    pInfo->type = static_cast<CoverInfo::Type>(
+        index.sibling(index.row(), m_iCoverTypeColumn).data().toInt());
+
+    // We don't support types other than METADATA or FILE currently.
+    if (pInfo->type != CoverInfo::METADATA && pInfo->type != CoverInfo::FILE) {
+        return false;
+    }
+
+    pInfo->source = static_cast<CoverInfo::Source>(
+        index.sibling(index.row(), m_iCoverSourceColumn).data().toInt());
+    pInfo->coverLocation = index.sibling(index.row(), m_iCoverLocationColumn).data().toString();
+    pInfo->hash = index.sibling(index.row(), m_iCoverHashColumn).data().toUInt();
+    pInfo->trackLocation = index.sibling(index.row(), m_iTrackLocationColumn).data().toString();
+    return true;
+}
+
+int CoverArtDelegate::coverWidth() const {
+    double scaleFactor = getDevicePixelRatioF(static_cast<QWidget*>(parent()));
+    return static_cast<int>(m_pTableView->columnWidth(m_iCoverColumn) * scaleFactor);
+}
+
+void CoverArtDelegate::prefetchCovers() {
+    CoverArtCache* pCache = CoverArtCache::instance();
+    QAbstractItemModel* pModel = m_pTableView->model();
+    if (pCache == NULL || pModel == NULL || m_iCoverColumn == -1 ||
+            m_iIdColumn == -1 || m_iCoverSourceColumn == -1 ||
+            m_iCoverTypeColumn == -1 || m_iCoverLocationColumn == -1 ||
+            m_iCoverHashColumn == -1 ||
+            m_pTableView->isColumnHidden(m_iCoverColumn)) {
+        return;
+    }
+    const int firstVisibleRow = m_pTableView->rowAt(0);
+    if (firstVisibleRow < 0) {
+        return;
+    }
+    const int rowCount = pModel->rowCount();
+    int lastVisibleRow = m_pTableView->rowAt(m_pTableView->viewport()->height() - 1);
+    if (lastVisibleRow < 0) {
+        lastVisibleRow = rowCount - 1;
+    }
+
+    const int width = coverWidth();
+    // Closest rows first, alternating below and above the visible rows
+    for (int distance = 1; distance <= pCache->prefetchRows(); ++distance) {
+        const int rows[] = {lastVisibleRow + distance, firstVisibleRow - distance};
+        for (int row : rows) {
+            if (row < 0 || row >= rowCount) {
+                continue;
+            }
+            CoverInfo info;
+            if (coverInfoForRow(pModel->index(row, m_iCoverColumn), &info)) {
+                pCache->prefetchCover(info, this, width);
+            }
         }
     }
 }
@@ -95,20 +192,10 @@ void CoverArtDelegate::paintItem(QPainter *painter,
     }
 
     CoverInfo info;
-    info.type = static_cast<CoverInfo::Type>(
-        index.sibling(index.row(), m_iCoverTypeColumn).data().toInt());
-
-    // We don't support types other than METADATA or FILE currently.
-    if (info.type != CoverInfo::METADATA && info.type != CoverInfo::FILE) {
+    if (!coverInfoForRow(index, &info)) {
         return;
     }
 
-    info.source = static_cast<CoverInfo::Source>(
-        index.sibling(index.row(), m_iCoverSourceColumn).data().toInt());
-    info.coverLocation = index.sibling(index.row(), m_iCoverLocationColumn).data().toString();
-    info.hash = index.sibling(index.row(), m_iCoverHashColumn).data().toUInt();
-    info.trackLocation = index.sibling(index.row(), m_iTrackLocationColumn).data().toString();
-
     double scaleFactor = getDevicePixelRatioF(static_cast<QWidget*>(parent()));
     // We listen for updates via slotCoverFound above and signal to
     // BaseSqlTableModel when a row's cover is ready.
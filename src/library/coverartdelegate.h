@@ -6,7 +6,9 @@
 #include <QLinkedList>
 
 #include "library/tableitemdelegate.h"
+#include "util/timer.h"
 
+class CoverInfo;
 class CoverInfoRelative;
 class TrackModel;
 class WLibraryTableView;
@@ -15,7 +17,7 @@ class CoverArtDelegate : public TableItemDelegate {
     Q_OBJECT
   public:
     explicit CoverArtDelegate(WLibraryTableView* parent);
-    ~CoverArtDelegate() override = default;
+    ~CoverArtDelegate() override;
 
     void paintItem(QPainter* painter,
                const QStyleOptionViewItem& option,
@@ -41,7 +43,18 @@ class CoverArtDelegate : public TableItemDelegate {
                         const CoverInfoRelative& info,
                         QPixmap pixmap, bool fromCache);
 
+    // Discards the requests for rows that have been scrolled away
+    void slotScrolled();
+
   private:
+    // Returns false if the row has no cover that we can load
+    bool coverInfoForRow(const QModelIndex& index, CoverInfo* pInfo) const;
+    int coverWidth() const;
+
+    // Requests the covers of the rows around the visible rows with a low
+    // priority, so that they are in the cache when scrolling on.
+    void prefetchCovers();
+
     QTableView* m_pTableView;
     bool m_bOnlyCachedCover;
     int m_iCoverColumn;
@@ -56,6 +69,11 @@ class CoverArtDelegate : public TableItemDelegate {
     // mutable.
     mutable QList<int> m_cacheMissRows;
     mutable QHash<quint16, QLinkedList<int> > m_hashToRow;
+
+    // Measures the time from the end of scrolling until all visible covers
+    // have been loaded.
+    Timer m_timeToVisibleCovers;
+    bool m_bWaitingForVisibleCovers;
 };
 
 #endif // COVERARTDELEGATE_H
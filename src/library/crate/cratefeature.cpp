@@ -49,6 +49,8 @@ CrateFeature::CrateFeature(Library* pLibrary,
           m_pTrackCollection(pLibrary->trackCollections()->internalCollection()),
           m_crateTableModel(this, pLibrary->trackCollections()) {
 
+    m_crateTableModel.setAsyncSelect(true);
+
     initActions();
 
     // construct child model
@@ -738,8 +740,8 @@ void CrateFeature::slotExportPlaylist() {
         QList<QString> playlist_items;
         int rows = pCrateTableModel->rowCount();
         for (int i = 0; i < rows; ++i) {
-            QModelIndex index = m_crateTableModel.index(i, 0);
-            playlist_items << m_crateTableModel.getTrackLocation(index);
+            QModelIndex index = pCrateTableModel->index(i, 0);
+            playlist_items << pCrateTableModel->getTrackLocation(index);
         }
 
         if (file_location.endsWith(".pls", Qt::CaseInsensitive)) {
@@ -769,8 +771,8 @@ void CrateFeature::slotExportTrackFiles() {
     int rows = pCrateTableModel->rowCount();
     QList<TrackPointer> trackpointers;
     for (int i = 0; i < rows; ++i) {
-        QModelIndex index = m_crateTableModel.index(i, 0);
-        trackpointers.push_back(m_crateTableModel.getTrack(index));
+        QModelIndex index = pCrateTableModel->index(i, 0);
+        trackpointers.push_back(pCrateTableModel->getTrack(index));
     }
 
     TrackExportWizard track_export(nullptr, m_pConfig, trackpointers);
@@ -27,15 +27,20 @@
 // INTEGER AUTODJCRATESTABLE_AUTODJREFS -> counts the occurrences of the track in the AutoDj queue
 // DATETIME AUTODJCRATESTABLE_LASTPLAYED -> from the history feature
 
-#define AUTODJACTIVETRACKS_TABLE "temp_autodj_activetracks"
-// The same table like above, but of all tracks that not already queued into Auto DJ
-// ordered by TimesPlayed.
-
 namespace {
 // Percentage of most and least played tracks to ignore [0,50)
 const int kLeastPreferredPercent = 15;
 const int kLeastPreferredPercentMin = 0;
 const int kLeastPreferredPercentMax = 50;
+
+// The last-played date/time is stored in sqlite's format, or as an empty
+// string for tracks that have never been played.
+QDateTime lastPlayedFromVariant(const QVariant& value) {
+    QDateTime lastPlayed = QDateTime::fromString(
+            value.toString(), "yyyy-MM-dd hh:mm:ss");
+    lastPlayed.setTimeSpec(Qt::UTC);
+    return lastPlayed;
+}
 } // anonymous namespace
 
 AutoDJCratesDAO::AutoDJCratesDAO(
@@ -60,37 +65,10 @@ AutoDJCratesDAO::~AutoDJCratesDAO() {
 // Done the first time it's used, since the user might not even make
 // use of this feature.
 void AutoDJCratesDAO::createAndConnectAutoDjCratesDatabase() {
-    // If the use of tracks that haven't been played in a while has changed,
-    // then the active-tracks view must be recreated.
-    bool bUseIgnoreTime = m_pConfig->getValue(
+    // Whether tracks that haven't been played in a while are preferred can
+    // change at any time.
+    m_bUseIgnoreTime = m_pConfig->getValue(
             ConfigKey("[Auto DJ]", "UseIgnoreTime"), false);
-    if (m_bAutoDjCratesDbCreated) {
-        if (m_bUseIgnoreTime != bUseIgnoreTime) {
-            // Do all this in a single transaction.
-            ScopedTransaction oTransaction(m_database);
-
-            // Get rid of the old active-tracks view.
-            QSqlQuery oQuery(m_database);
-            oQuery.exec ("DROP VIEW IF EXISTS " AUTODJACTIVETRACKS_TABLE);
-            if (!oQuery.exec()) {
-                LOG_FAILED_QUERY(oQuery);
-                return;
-            }
-
-            // Create the new active-tracks view.
-            if (!createActiveTracksView(bUseIgnoreTime)) {
-                return;
-            }
-
-            // Remember the new setting.
-            m_bUseIgnoreTime = bUseIgnoreTime;
-
-            // Commit these changes.
-            oTransaction.commit();
-        }
-    } else {
-        m_bUseIgnoreTime = bUseIgnoreTime;
-    }
 
     // If this database has already been created, skip this.
     if (m_bAutoDjCratesDbCreated) {
@@ -167,12 +145,6 @@ void AutoDJCratesDAO::createAndConnectAutoDjCratesDatabase() {
         return;
     }
 
-    // Create the active-tracks view.
-    //oQuery.exec ("DROP VIEW IF EXISTS " AUTODJACTIVETRACKS_TABLE);
-    if (!createActiveTracksView (m_bUseIgnoreTime)) {
-        return;
-    }
-
     // Make a list of the IDs of every set-log playlist.
     // SELECT id FROM Playlists WHERE hidden = 2;
     oQuery.prepare(QString("SELECT %1 FROM " PLAYLIST_TABLE " WHERE %2 = %3")
@@ -192,6 +164,9 @@ void AutoDJCratesDAO::createAndConnectAutoDjCratesDatabase() {
     // signals.
     oTransaction.commit();
 
+    // Load the active tracks into the track sampler.
+    reloadTrackSampler();
+
     // Be notified when a track is modified.
     // We only care when the number of times it's been played changes.
     connect(&m_pTrackCollection->getTrackDAO(),
@@ -255,60 +230,6 @@ void AutoDJCratesDAO::createAndConnectAutoDjCratesDatabase() {
     m_bAutoDjCratesDbCreated = true;
 }
 
-// Create the active-tracks view.
-bool AutoDJCratesDAO::createActiveTracksView (bool a_bUseIgnoreTime) {
-    // Create the active-tracks view.  This is a list of all tracks loaded into
-    // the auto-DJ-crates database, excluding all tracks already in the auto-DJ
-    // playlist, sorted by the number of times the track has been played, and
-    // limited by either the active percentage or by the number of tracks that
-    // have never been played, whichever is larger.
-    //
-    // At one point, I hoped that I could create this table in a single SQL
-    // statement, with a "limit" clause that dynamically updated the size of the
-    // view as the state of the system changed.  Unfortunately, that limit
-    // clause is only evaluated once.  For posterity, though, here's the monster
-    // SQL query that attempted to create that version:
-    //
-    // CREATE TEMP VIEW temp_autodj_activetracks AS
-    //     SELECT * FROM temp_autodj_crates
-    //     WHERE autodjrefs = 0
-    //     ORDER BY timesplayed, lastplayed LIMIT (
-    //         SELECT MAX(count)
-    //         FROM (
-    //             SELECT COUNT(*) AS count
-    //             FROM temp_autodj_crates WHERE timesplayed = 0
-    //             UNION ALL SELECT (
-    //                 count * (
-    //                     SELECT value
-    //                     FROM settings WHERE
-    //                     name="mixxx.db.model.autodjcrates.active_percentage")
-    //                 / 100) AS count
-    //                 FROM (
-    //                     SELECT COUNT(*) AS count
-    //                     FROM temp_autodj_crates)));
-
-    // CREATE TEMP VIEW temp_autodj_activetracks AS
-    // SELECT *
-    // FROM temp_autodj_crates
-    // WHERE autodjrefs = 0
-    // ORDER BY timesplayed, lastplayed;
-    QSqlQuery oQuery(m_database);
-    QString strTimesPlayed;
-    if (!a_bUseIgnoreTime) {
-        strTimesPlayed = AUTODJCRATESTABLE_TIMESPLAYED ", ";
-    }
-    oQuery.prepare(QString("CREATE TEMP VIEW " AUTODJACTIVETRACKS_TABLE
-            " AS SELECT * FROM " AUTODJCRATES_TABLE " WHERE "
-            AUTODJCRATESTABLE_AUTODJREFS " = 0 ORDER BY %1"
-            AUTODJCRATESTABLE_LASTPLAYED)
-            .arg(strTimesPlayed)); // %1
-    if (!oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
-        return false;
-    }
-    return true;
-}
-
 // Update the number of auto-DJ-playlist references to each track in the
 // auto-DJ-crates database.
 bool AutoDJCratesDAO::updateAutoDjPlaylistReferences() {
@@ -521,36 +442,70 @@ bool AutoDJCratesDAO::updateLastPlayedDateTimeForTrack(TrackId trackId) {
     return true;
 }
 
-// Get the ID, i.e. one that references library.id, of a random track.
-// Returns an invalid track id if there was an error.
-TrackId AutoDJCratesDAO::getRandomTrackId() {
-    // If necessary, create the temporary auto-DJ-crates database.
-    createAndConnectAutoDjCratesDatabase();
+// Reload all active tracks from the auto-DJ-crates database into the track
+// sampler.
+bool AutoDJCratesDAO::reloadTrackSampler() {
+    m_trackSampler.clear();
 
-    // Calculate the number of active-tracks that have never been played, and
-    // the total number of active-tracks.
+    // SELECT track_id, timesplayed, lastplayed
+    // FROM temp_autodj_crates
+    // WHERE autodjrefs = 0;
     QSqlQuery oQuery(m_database);
-    // SELECT COUNT(*) AS count
-    // FROM temp_autodj_activetracks
-    // WHERE timesplayed = 0
-    // UNION ALL SELECT COUNT(*) AS count
-    // FROM temp_autodj_activetracks;
-    oQuery.prepare("SELECT COUNT(*) AS count FROM " AUTODJACTIVETRACKS_TABLE
-        " WHERE " AUTODJCRATESTABLE_TIMESPLAYED
-        " = 0 UNION ALL SELECT COUNT(*) AS count FROM "
-        AUTODJACTIVETRACKS_TABLE);
-    VERIFY_OR_DEBUG_ASSERT(oQuery.exec()) {
+    oQuery.prepare("SELECT " AUTODJCRATESTABLE_TRACKID ", "
+            AUTODJCRATESTABLE_TIMESPLAYED ", " AUTODJCRATESTABLE_LASTPLAYED
+            " FROM " AUTODJCRATES_TABLE " WHERE "
+            AUTODJCRATESTABLE_AUTODJREFS " = 0");
+    if (!oQuery.exec()) {
         LOG_FAILED_QUERY(oQuery);
-        return TrackId();
+        return false;
+    }
+    while (oQuery.next()) {
+        m_trackSampler.addOrUpdateTrack(
+                TrackId(oQuery.value(0)),
+                oQuery.value(1).toInt(),
+                lastPlayedFromVariant(oQuery.value(2)));
+    }
+    return true;
+}
+
+// Update the given track in the track sampler from the auto-DJ-crates
+// database.
+bool AutoDJCratesDAO::updateTrackSampler(TrackId trackId) {
+    // SELECT timesplayed, lastplayed
+    // FROM temp_autodj_crates
+    // WHERE track_id = :track_id AND autodjrefs = 0;
+    QSqlQuery oQuery(m_database);
+    oQuery.prepare("SELECT " AUTODJCRATESTABLE_TIMESPLAYED ", "
+            AUTODJCRATESTABLE_LASTPLAYED " FROM " AUTODJCRATES_TABLE
+            " WHERE " AUTODJCRATESTABLE_TRACKID " = :track_id AND "
+            AUTODJCRATESTABLE_AUTODJREFS " = 0");
+    oQuery.bindValue(":track_id", trackId.toVariant());
+    if (!oQuery.exec()) {
+        LOG_FAILED_QUERY(oQuery);
+        return false;
     }
-    int iUnplayedTracks = 0;
-    int iTotalTracks = 0;
     if (oQuery.next()) {
-        iUnplayedTracks = oQuery.value(0).toInt();
-        if (oQuery.next()) {
-            iTotalTracks = oQuery.value(0).toInt();
-        }
+        m_trackSampler.addOrUpdateTrack(
+                trackId,
+                oQuery.value(0).toInt(),
+                lastPlayedFromVariant(oQuery.value(1)));
+    } else {
+        // Not in an auto-DJ crate, or queued in auto-DJ or in a deck
+        m_trackSampler.removeTrack(trackId);
     }
+    return true;
+}
+
+// Get the ID, i.e. one that references library.id, of a random track.
+// Returns an invalid track id if there was an error.
+TrackId AutoDJCratesDAO::getRandomTrackId() {
+    // If necessary, create the temporary auto-DJ-crates database.
+    createAndConnectAutoDjCratesDatabase();
+
+    // The number of active-tracks that have never been played, and the total
+    // number of active-tracks.
+    int iUnplayedTracks = m_trackSampler.unplayedCount();
+    int iTotalTracks = m_trackSampler.size();
 
     // Get the active percentage (default 20%).
     int minimumAvailablePercentage = m_pConfig->getValue(
@@ -575,7 +530,10 @@ TrackId AutoDJCratesDAO::getRandomTrackId() {
 
     // The number of active-tracks might also be tracks that haven't been played
     // in a while.
+    AutoDJTrackSampler::Order order = AutoDJTrackSampler::Order::TimesPlayed;
     if (m_bUseIgnoreTime) {
+        order = AutoDJTrackSampler::Order::LastPlayed;
+
         // Get the current time, in UTC (since that's what sqlite uses).
         QDateTime timeCurrent = QDateTime::currentDateTimeUtc();
 
@@ -585,29 +543,11 @@ TrackId AutoDJCratesDAO::getRandomTrackId() {
         timeCurrent = timeCurrent.addSecs(-(timIgnoreTime.hour() * 3600
             + timIgnoreTime.minute() * 60));
 
-        // Convert the time to sqlite's format, which is similar to ISO date,
-        // but not quite.
-        QString strDateTime = timeCurrent.toString("yyyy-MM-dd hh:mm:ss");
-
         // Count the number of tracks that haven't been played since this time.
-        // SELECT COUNT(*) FROM temp_autodj_activetracks WHERE lastplayed < :lastplayed;
-        int iIgnoreTimeTracks = 0;
-        oQuery.prepare("SELECT COUNT(*) FROM " AUTODJACTIVETRACKS_TABLE
-            " WHERE " AUTODJCRATESTABLE_LASTPLAYED " < :lastplayed");
-        oQuery.bindValue (":lastplayed", strDateTime);
-        if (oQuery.exec()) {
-            if (oQuery.next()) {
-                iIgnoreTimeTracks = oQuery.value(0).toInt();
-            }
-        } else {
-            LOG_FAILED_QUERY(oQuery);
-            return TrackId();
-        }
+        int iIgnoreTimeTracks = m_trackSampler.countPlayedBefore(timeCurrent);
 
         // Allow that to be a new maximum.
         iActiveTracks = qMax(iActiveTracks, iIgnoreTimeTracks);
-
-        qDebug() << iActiveTracks << iIgnoreTimeTracks;
     }
 
     // If there are no tracks, let our caller know.
@@ -616,24 +556,16 @@ TrackId AutoDJCratesDAO::getRandomTrackId() {
         return TrackId();
     }
 
-    // Pick a random track.
-    // SELECT track_id
-    // FROM temp_autodj_activetracks LIMIT 1 OFFSET ABS (RANDOM() % :active);
-    oQuery.prepare("SELECT " AUTODJCRATESTABLE_TRACKID " FROM "
-        AUTODJACTIVETRACKS_TABLE " LIMIT 1 OFFSET ABS (RANDOM() % :active)");
-    oQuery.bindValue (":active", iActiveTracks);
-    VERIFY_OR_DEBUG_ASSERT(oQuery.exec()) {
-        LOG_FAILED_QUERY(oQuery);
-        return TrackId();
-    }
-    if (oQuery.next()) {
-        // Give our caller the randomly-selected track.
-        return TrackId(oQuery.value(0));
-    } else {
-        DEBUG_ASSERT(false); // We should have exit earlier
-        qDebug() << "No random track available for Auto DJ";
-        return TrackId();
-    }
+    // Pick a random track from the least played (or least recently played)
+    // active-tracks.  If enabled, the less a track has been played the more
+    // likely it is picked within those.
+    const auto weighting = m_pConfig->getValue(
+            ConfigKey("[Auto DJ]", "WeightedRandom"), false) ?
+            AutoDJTrackSampler::Weighting::Levels :
+            AutoDJTrackSampler::Weighting::Uniform;
+    TrackId trackId = m_trackSampler.sample(order, iActiveTracks, weighting);
+    DEBUG_ASSERT(trackId.isValid()); // We should have exit earlier
+    return trackId;
 }
 
 TrackId AutoDJCratesDAO::getRandomTrackIdFromAutoDj(int percentActive) {
@@ -736,6 +668,9 @@ void AutoDJCratesDAO::slotTrackDirty(TrackId trackId) {
         LOG_FAILED_QUERY(oQuery);
         return;
     }
+    if (oQuery.numRowsAffected() > 0) {
+        updateTrackSampler(trackId);
+    }
 }
 
 void AutoDJCratesDAO::slotCrateInserted(CrateId crateId) {
@@ -852,6 +787,9 @@ void AutoDJCratesDAO::updateAutoDjCrate(CrateId crateId) {
 
     // The transaction was successful.
     oTransaction.commit();
+
+    // Many tracks may have become active.
+    reloadTrackSampler();
 }
 
 void AutoDJCratesDAO::deleteAutoDjCrate(CrateId crateId) {
@@ -889,6 +827,11 @@ void AutoDJCratesDAO::deleteAutoDjCrate(CrateId crateId) {
 
     // The transaction was successful.
     oTransaction.commit();
+
+    // Many tracks may have been removed.
+    if (oQuery.numRowsAffected() > 0) {
+        reloadTrackSampler();
+    }
 }
 
 void AutoDJCratesDAO::slotCrateTracksChanged(
@@ -982,6 +925,13 @@ void AutoDJCratesDAO::slotCrateTracksChanged(
     }
     // The transaction was successful.
     oTransaction.commit();
+
+    for (const auto& trackId: addedTrackIds) {
+        updateTrackSampler(trackId);
+    }
+    for (const auto& trackId: removedTrackIds) {
+        updateTrackSampler(trackId);
+    }
 }
 
 // Signaled by the playlistDAO when a playlist is added.
@@ -990,7 +940,9 @@ void AutoDJCratesDAO::slotPlaylistAdded(int playlistId) {
     if (m_pTrackCollection->getPlaylistDAO().getHiddenType(playlistId)
             == PlaylistDAO::PLHT_SET_LOG) {
         m_lstSetLogPlaylistIds.append(playlistId);
-        updateLastPlayedDateTime();
+        if (updateLastPlayedDateTime()) {
+            reloadTrackSampler();
+        }
     }
 }
 
@@ -1000,7 +952,9 @@ void AutoDJCratesDAO::slotPlaylistDeleted(int playlistId) {
     int iIndex = m_lstSetLogPlaylistIds.indexOf(playlistId);
     if (iIndex >= 0) {
         m_lstSetLogPlaylistIds.removeAt(iIndex);
-        updateLastPlayedDateTime();
+        if (updateLastPlayedDateTime()) {
+            reloadTrackSampler();
+        }
     }
 }
 
@@ -1020,12 +974,15 @@ void AutoDJCratesDAO::slotPlaylistTrackAdded(int playlistId, TrackId trackId,
             LOG_FAILED_QUERY(oQuery);
             return;
         }
+        updateTrackSampler(trackId);
     } else if (m_lstSetLogPlaylistIds.contains(playlistId)) {
         // Deal with changes to set-log playlists.
         // If this query doesn't succeed, it'll log a message.
         // Do nothing special otherwise -- any change it makes can be part of
         // any current transaction.
-        updateLastPlayedDateTimeForTrack(trackId);
+        if (updateLastPlayedDateTimeForTrack(trackId)) {
+            updateTrackSampler(trackId);
+        }
     }
 }
 
@@ -1045,12 +1002,15 @@ void AutoDJCratesDAO::slotPlaylistTrackRemoved(int playlistId,
             LOG_FAILED_QUERY(oQuery);
             return;
         }
+        updateTrackSampler(trackId);
     } else if (m_lstSetLogPlaylistIds.contains(playlistId)) {
         // Deal with changes to set-log playlists.
         // If this query doesn't succeed, it'll log a message.
         // Do nothing special otherwise -- any change it makes can be part of
         // any current transaction.
-        updateLastPlayedDateTimeForTrack(trackId);
+        if (updateLastPlayedDateTimeForTrack(trackId)) {
+            updateTrackSampler(trackId);
+        }
     }
 }
 
@@ -1080,6 +1040,7 @@ void AutoDJCratesDAO::slotPlayerInfoTrackLoaded(QString a_strGroup,
                 LOG_FAILED_QUERY(oQuery);
                 return;
             }
+            updateTrackSampler(trackId);
             return;
         }
     }
@@ -1106,6 +1067,7 @@ void AutoDJCratesDAO::slotPlayerInfoTrackUnloaded(QString group,
                 LOG_FAILED_QUERY(oQuery);
                 return;
             }
+            updateTrackSampler(trackId);
             return;
         }
     }
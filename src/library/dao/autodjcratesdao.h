@@ -5,6 +5,7 @@
 #include <QSqlDatabase>
 
 #include "preferences/usersettings.h"
+#include "library/autodj/autodjtracksampler.h"
 #include "library/crate/crateid.h"
 #include "track/track.h"
 #include "util/class.h"
@@ -37,9 +38,6 @@ class AutoDJCratesDAO : public QObject {
     // use of this feature.
     void createAndConnectAutoDjCratesDatabase();
 
-    // Create the active-tracks view.
-    bool createActiveTracksView(bool a_bUseIgnoreTime);
-
     // Update the number of auto-DJ-playlist references to each track in the
     // auto-DJ-crates database.  Returns true if successful.
     bool updateAutoDjPlaylistReferences();
@@ -56,6 +54,14 @@ class AutoDJCratesDAO : public QObject {
     // auto-DJ-crates database.  Returns true if successful.
     bool updateLastPlayedDateTimeForTrack(TrackId trackId);
 
+    // Reload all active tracks from the auto-DJ-crates database into the
+    // track sampler.  Only used after changes that affect many tracks.
+    bool reloadTrackSampler();
+
+    // Update the given track in the track sampler from the auto-DJ-crates
+    // database.  The track is removed if it is no longer active.
+    bool updateTrackSampler(TrackId trackId);
+
     // Calculates a random Track from AutoDJ,
     // This is used when all active tracks are already queued up.
     TrackId getRandomTrackIdFromAutoDj(int percentActive);
@@ -113,12 +119,16 @@ class AutoDJCratesDAO : public QObject {
     // True if the auto-DJ-crates database has been created.
     bool m_bAutoDjCratesDbCreated;
 
-    // True if active tracks can be tracks that haven't been played in
-    // a while.
+    // True if tracks that haven't been played in a while are preferred
+    // over tracks that have been played less often.
     bool m_bUseIgnoreTime;
 
     // The ID of every set-log playlist.
     QList<int> m_lstSetLogPlaylistIds;
+
+    // The active tracks of the auto-DJ-crates database, i.e. the tracks that
+    // getRandomTrackId() picks from.
+    AutoDJTrackSampler m_trackSampler;
 };
 
 #endif // AUTODJCRATESDAO_H
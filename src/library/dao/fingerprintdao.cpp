@@ -0,0 +1,155 @@
+#include "library/dao/fingerprintdao.h"
+
+#include <QtSql>
+
+#include <algorithm>
+
+#include "library/queryutil.h"
+#include "util/assert.h"
+
+namespace {
+
+// Keys that are shared by more tracks are caused by silence or other
+// generic audio and don't indicate duplicates. Comparing the track with
+// all tracks of such a key would also defeat the purpose of the index.
+constexpr int kMaxTracksPerKey = 64;
+
+} // anonymous namespace
+
+constexpr double FingerprintDAO::kDefaultMinSimilarity;
+
+bool FingerprintDAO::hasFingerprint(TrackId trackId) const {
+    QSqlQuery query(m_database);
+    query.prepare("SELECT 1 FROM " FINGERPRINT_TABLE " WHERE track_id=:track_id");
+    query.bindValue(":track_id", trackId.toVariant());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    return query.next();
+}
+
+mixxx::Fingerprint FingerprintDAO::getFingerprint(TrackId trackId) const {
+    QSqlQuery query(m_database);
+    query.prepare("SELECT fingerprint FROM " FINGERPRINT_TABLE " WHERE track_id=:track_id");
+    query.bindValue(":track_id", trackId.toVariant());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return mixxx::Fingerprint();
+    }
+    if (!query.next()) {
+        return mixxx::Fingerprint();
+    }
+    return mixxx::Fingerprint::fromBlob(query.value(0).toByteArray());
+}
+
+bool FingerprintDAO::saveFingerprint(
+        TrackId trackId, const mixxx::Fingerprint& fingerprint) {
+    VERIFY_OR_DEBUG_ASSERT(trackId.isValid()) {
+        return false;
+    }
+    ScopedTransaction transaction(m_database);
+    QSqlQuery query(m_database);
+    query.prepare("INSERT OR REPLACE INTO " FINGERPRINT_TABLE
+                  " (track_id, fingerprint) VALUES (:track_id, :fingerprint)");
+    query.bindValue(":track_id", trackId.toVariant());
+    query.bindValue(":fingerprint", fingerprint.toBlob());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+
+    query.prepare("DELETE FROM " FINGERPRINT_KEY_TABLE " WHERE track_id=:track_id");
+    query.bindValue(":track_id", trackId.toVariant());
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+
+    query.prepare("INSERT INTO " FINGERPRINT_KEY_TABLE
+                  " (index_key, track_id) VALUES (:index_key, :track_id)");
+    for (const auto key : fingerprint.indexKeys()) {
+        query.bindValue(":index_key", key);
+        query.bindValue(":track_id", trackId.toVariant());
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+    }
+    return transaction.commit();
+}
+
+bool FingerprintDAO::deleteFingerprints(const QList<TrackId>& trackIds) {
+    QStringList idList;
+    for (const auto& trackId : trackIds) {
+        idList << trackId.toString();
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare(QString("DELETE FROM " FINGERPRINT_KEY_TABLE " WHERE track_id IN (%1)")
+                  .arg(idList.join(",")));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    query.prepare(QString("DELETE FROM " FINGERPRINT_TABLE " WHERE track_id IN (%1)")
+                  .arg(idList.join(",")));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    return true;
+}
+
+QList<FingerprintDAO::DuplicateTracks> FingerprintDAO::findDuplicatesOfTrack(
+        TrackId trackId,
+        double minSimilarity) const {
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    query.prepare("SELECT DISTINCT other.track_id FROM " FINGERPRINT_KEY_TABLE " AS self "
+                  "JOIN " FINGERPRINT_KEY_TABLE " AS other ON other.index_key=self.index_key "
+                  "WHERE self.track_id=:track_id AND other.track_id!=:track_id "
+                  "AND (SELECT COUNT(*) FROM " FINGERPRINT_KEY_TABLE
+                  " WHERE index_key=self.index_key) <= :max_tracks_per_key");
+    query.bindValue(":track_id", trackId.toVariant());
+    query.bindValue(":max_tracks_per_key", kMaxTracksPerKey);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return QList<DuplicateTracks>();
+    }
+
+    QList<TrackIdPair> candidates;
+    while (query.next()) {
+        candidates.append(qMakePair(trackId, TrackId(query.value(0))));
+    }
+    return compareCandidates(candidates, minSimilarity);
+}
+
+QList<FingerprintDAO::DuplicateTracks> FingerprintDAO::compareCandidates(
+        const QList<TrackIdPair>& candidates,
+        double minSimilarity) const {
+    // Most tracks are part of several candidate pairs
+    QHash<TrackId, mixxx::Fingerprint> fingerprints;
+    auto loadFingerprint = [this, &fingerprints](TrackId trackId) {
+        auto it = fingerprints.find(trackId);
+        if (it == fingerprints.end()) {
+            it = fingerprints.insert(trackId, getFingerprint(trackId));
+        }
+        return it.value();
+    };
+
+    QList<DuplicateTracks> duplicates;
+    for (const auto& candidate : candidates) {
+        const double similarity = loadFingerprint(candidate.first).similarity(
+                loadFingerprint(candidate.second));
+        if (similarity >= minSimilarity) {
+            duplicates.append(DuplicateTracks{
+                    candidate.first, candidate.second, similarity});
+        }
+    }
+    std::sort(duplicates.begin(), duplicates.end(),
+            [](const DuplicateTracks& lhs, const DuplicateTracks& rhs) {
+                return lhs.similarity > rhs.similarity;
+            });
+    return duplicates;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QList>
+#include <QPair>
+#include <QSqlDatabase>
+
+#include "library/dao/dao.h"
+#include "track/fingerprint.h"
+#include "track/trackid.h"
+
+#define FINGERPRINT_TABLE "track_fingerprints"
+#define FINGERPRINT_KEY_TABLE "track_fingerprint_keys"
+
+// Stores the acoustic fingerprints of tracks together with their index keys
+// for finding duplicates.
+class FingerprintDAO : public DAO {
+  public:
+    // Two tracks that sound alike
+    struct DuplicateTracks {
+        TrackId trackId;
+        TrackId duplicateTrackId;
+        double similarity;
+    };
+
+    // Tracks that are at least this similar are considered duplicates. The
+    // same recording in different encodings usually exceeds this value by
+    // far.
+    static constexpr double kDefaultMinSimilarity = 0.85;
+
+    ~FingerprintDAO() override {}
+
+    void initialize(const QSqlDatabase& database) override {
+        m_database = database;
+    }
+
+    bool hasFingerprint(TrackId trackId) const;
+    mixxx::Fingerprint getFingerprint(TrackId trackId) const;
+    // Replaces both the fingerprint and the index keys of the track
+    bool saveFingerprint(TrackId trackId, const mixxx::Fingerprint& fingerprint);
+    bool deleteFingerprints(const QList<TrackId>& trackIds);
+
+    // The duplicates of a single track, most similar first. Only tracks
+    // that share an index key with the track are compared.
+    QList<DuplicateTracks> findDuplicatesOfTrack(
+            TrackId trackId,
+            double minSimilarity = kDefaultMinSimilarity) const;
+
+  private:
+    typedef QPair<TrackId, TrackId> TrackIdPair;
+
+    QList<DuplicateTracks> compareCandidates(
+            const QList<TrackIdPair>& candidates,
+            double minSimilarity) const;
+
+    QSqlDatabase m_database;
+};
@@ -9,6 +9,25 @@
 #include "util/compatibility.h"
 #include "util/math.h"
 
+namespace {
+
+// The distance between the position keys of consecutive tracks after
+// appending or renumbering
+constexpr int kPositionKeyGap = 1024;
+
+// Keeps the keys within the range of int
+constexpr qint64 kMaxPositionKey = Q_INT64_C(1) << 30;
+
+// Only the tracks that exist in the library have a position, i.e. the
+// same tracks that are shown by the view of PlaylistTableModel. The keys
+// of other tracks are skipped when counting positions.
+const QString kPositionedTracksFrom =
+        "FROM PlaylistTracks "
+        "INNER JOIN library ON library.id=PlaylistTracks.track_id "
+        "WHERE PlaylistTracks.playlist_id=:id";
+
+} // anonymous namespace
+
 PlaylistDAO::PlaylistDAO()
         : m_pAutoDJProcessor(nullptr) {
 }
@@ -247,14 +266,17 @@ bool PlaylistDAO::isPlaylistLocked(const int playlistId) const {
 bool PlaylistDAO::removeTracksFromPlaylist(int playlistId, int startIndex) {
     // Retain the first track if it is loaded in a deck
     ScopedTransaction transaction(m_database);
-    QSqlQuery query(m_database);
-    query.prepare("DELETE FROM PlaylistTracks "
-                  "WHERE playlist_id=:id AND position>=:pos");
-    query.bindValue(":id", playlistId);
-    query.bindValue(":pos", startIndex);
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-        return false;
+    const int startKey = getPositionKey(playlistId, math_max(startIndex, 1));
+    if (startKey >= 0) {
+        QSqlQuery query(m_database);
+        query.prepare("DELETE FROM PlaylistTracks "
+                      "WHERE playlist_id=:id AND position>=:pos");
+        query.bindValue(":id", playlistId);
+        query.bindValue(":pos", startKey);
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
     }
     transaction.commit();
     emit tracksChanged(QSet<int>{playlistId});
@@ -268,10 +290,12 @@ bool PlaylistDAO::appendTracksToPlaylist(const QList<TrackId>& trackIds, const i
     // Start the transaction
     ScopedTransaction transaction(m_database);
 
-    int position = getMaxPosition(playlistId);
-
     // Append after the last song. If no songs or a failed query then 0 becomes 1.
-    ++position;
+    int position = getMaxPosition(playlistId) + 1;
+    QVector<int> positionKeys;
+    if (!allocatePositionKeys(playlistId, &position, trackIds.size(), &positionKeys)) {
+        return false;
+    }
 
     //Insert the song into the PlaylistTracks table
     QSqlQuery query(m_database);
@@ -280,10 +304,9 @@ bool PlaylistDAO::appendTracksToPlaylist(const QList<TrackId>& trackIds, const i
     query.bindValue(":playlist_id", playlistId);
 
 
-    int insertPosition = position;
-    for (const auto& trackId: trackIds) {
-        query.bindValue(":track_id", trackId.toVariant());
-        query.bindValue(":position", insertPosition++);
+    for (int i = 0; i < trackIds.size(); ++i) {
+        query.bindValue(":track_id", trackIds[i].toVariant());
+        query.bindValue(":position", positionKeys[i]);
         if (!query.exec()) {
             LOG_FAILED_QUERY(query);
             return false;
@@ -293,7 +316,7 @@ bool PlaylistDAO::appendTracksToPlaylist(const QList<TrackId>& trackIds, const i
     // Commit the transaction
     transaction.commit();
 
-    insertPosition = position;
+    int insertPosition = position;
     for (const auto& trackId: trackIds) {
         m_playlistsTrackIsIn.insert(trackId, playlistId);
         // TODO(XXX) don't emit if the track didn't add successfully.
@@ -406,10 +429,11 @@ void PlaylistDAO::removeHiddenTracks(const int playlistId) {
         return;
     }
 
+    QVector<int> positionKeys;
     while (query.next()) {
-        int position = query.value(query.record().indexOf("position")).toInt();
-        removeTracksFromPlaylistInner(playlistId, position);
+        positionKeys.append(query.value(query.record().indexOf("position")).toInt());
     }
+    removeTracksFromPlaylistByKeys(playlistId, positionKeys);
 
     transaction.commit();
     emit tracksChanged(QSet<int>{playlistId});
@@ -436,10 +460,11 @@ void PlaylistDAO::removeTracksFromPlaylistByIdInner(int playlistId, TrackId trac
         return;
     }
 
+    QVector<int> positionKeys;
     while (query.next()) {
-        int position = query.value(query.record().indexOf("position")).toInt();
-        removeTracksFromPlaylistInner(playlistId, position);
+        positionKeys.append(query.value(query.record().indexOf("position")).toInt());
     }
+    removeTracksFromPlaylistByKeys(playlistId, positionKeys);
 }
 
 
@@ -447,7 +472,13 @@ void PlaylistDAO::removeTrackFromPlaylist(int playlistId, int position) {
     // qDebug() << "PlaylistDAO::removeTrackFromPlaylist"
     //          << QThread::currentThread() << m_database.connectionName();
     ScopedTransaction transaction(m_database);
-    removeTracksFromPlaylistInner(playlistId, position);
+    const int positionKey = getPositionKey(playlistId, position);
+    if (positionKey < 0) {
+        qDebug() << "removeTrackFromPlaylist no track exists at position:"
+                 << position << "in playlist:" << playlistId;
+        return;
+    }
+    removeTracksFromPlaylistInner(playlistId, positionKey, position);
     transaction.commit();
     emit tracksChanged(QSet<int>{playlistId});
 }
@@ -459,19 +490,44 @@ void PlaylistDAO::removeTracksFromPlaylist(int playlistId, QList<int> positions)
     //qDebug() << "PlaylistDAO::removeTrackFromPlaylist"
     //         << QThread::currentThread() << m_database.connectionName();
     ScopedTransaction transaction(m_database);
+    const QVector<int> positionKeys = getPositionKeys(playlistId);
     for (const auto position : qAsConst(positions)) {
-        removeTracksFromPlaylistInner(playlistId, position);
+        if (position < 1 || position > positionKeys.size()) {
+            qDebug() << "removeTrackFromPlaylist no track exists at position:"
+                     << position << "in playlist:" << playlistId;
+            continue;
+        }
+        removeTracksFromPlaylistInner(playlistId, positionKeys[position - 1], position);
     }
     transaction.commit();
     emit tracksChanged(QSet<int>{playlistId});
 }
 
-void PlaylistDAO::removeTracksFromPlaylistInner(int playlistId, int position) {
+void PlaylistDAO::removeTracksFromPlaylistByKeys(
+        int playlistId, QVector<int> positionKeys) {
+    if (positionKeys.isEmpty()) {
+        return;
+    }
+    // The positions of the tracks are their indexes in the ascending keys of
+    // the playlist. Removing the tracks in reversed order keeps the
+    // positions of the remaining tracks valid.
+    const QVector<int> allPositionKeys = getPositionKeys(playlistId);
+    std::sort(positionKeys.begin(), positionKeys.end(), std::greater<int>());
+    for (const auto positionKey : qAsConst(positionKeys)) {
+        const auto it = std::lower_bound(
+                allPositionKeys.begin(), allPositionKeys.end(), positionKey);
+        const int position = static_cast<int>(it - allPositionKeys.begin()) + 1;
+        removeTracksFromPlaylistInner(playlistId, positionKey, position);
+    }
+}
+
+void PlaylistDAO::removeTracksFromPlaylistInner(
+        int playlistId, int positionKey, int position) {
     QSqlQuery query(m_database);
     query.prepare("SELECT track_id FROM PlaylistTracks WHERE playlist_id=:id "
                   "AND position=:position");
     query.bindValue(":id", playlistId);
-    query.bindValue(":position", position);
+    query.bindValue(":position", positionKey);
 
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
@@ -489,22 +545,14 @@ void PlaylistDAO::removeTracksFromPlaylistInner(int playlistId, int position) {
     query.prepare("DELETE FROM PlaylistTracks "
                   "WHERE playlist_id=:id AND position= :position");
     query.bindValue(":id", playlistId);
-    query.bindValue(":position", position);
+    query.bindValue(":position", positionKey);
 
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
         return;
     }
 
-    QString queryString;
-    queryString = QString("UPDATE PlaylistTracks SET position=position-1 "
-                          "WHERE position>=%1 AND "
-                          "playlist_id=%2").arg(QString::number(position),
-                                                QString::number(playlistId));
-    if (!query.exec(queryString)) {
-        LOG_FAILED_QUERY(query);
-    }
-
+    // The following tracks keep their keys and move up implicitly
     m_playlistsTrackIsIn.remove(trackId, playlistId);
     emit(trackRemoved(playlistId, trackId, position));
 }
@@ -517,31 +565,18 @@ bool PlaylistDAO::insertTrackIntoPlaylist(TrackId trackId, const int playlistId,
 
     ScopedTransaction transaction(m_database);
 
-    int max_position = getMaxPosition(playlistId) + 1;
-
-    if (position > max_position) {
-        position = max_position;
-    }
-
-    // Move all the tracks in the playlist up by one
-    QString queryString =
-            QString("UPDATE PlaylistTracks SET position=position+1 "
-                    "WHERE position>=%1 AND "
-                    "playlist_id=%2").arg(QString::number(position),
-                                          QString::number(playlistId));
-
-    QSqlQuery query(m_database);
-    if (!query.exec(queryString)) {
-        LOG_FAILED_QUERY(query);
+    QVector<int> positionKeys;
+    if (!allocatePositionKeys(playlistId, &position, 1, &positionKeys)) {
         return false;
     }
 
     //Insert the song into the PlaylistTracks table
+    QSqlQuery query(m_database);
     query.prepare("INSERT INTO PlaylistTracks (playlist_id, track_id, position, pl_datetime_added)"
                   "VALUES (:playlist_id, :track_id, :position, CURRENT_TIMESTAMP)");
     query.bindValue(":playlist_id", playlistId);
     query.bindValue(":track_id", trackId.toVariant());
-    query.bindValue(":position", position);
+    query.bindValue(":position", positionKeys[0]);
 
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
@@ -561,56 +596,46 @@ int PlaylistDAO::insertTracksIntoPlaylist(const QList<TrackId>& trackIds,
         return 0;
     }
 
-    int tracksAdded = 0;
-    ScopedTransaction transaction(m_database);
+    QList<TrackId> validTrackIds;
+    for (const auto& trackId: trackIds) {
+        if (trackId.isValid()) {
+            validTrackIds.append(trackId);
+        }
+    }
 
-    int max_position = getMaxPosition(playlistId) + 1;
+    ScopedTransaction transaction(m_database);
 
-    if (position > max_position) {
-        position = max_position;
+    // All keys are allocated in advance between the keys of the tracks
+    // around the insert position
+    QVector<int> positionKeys;
+    if (!allocatePositionKeys(playlistId, &position,
+                validTrackIds.size(), &positionKeys)) {
+        return 0;
     }
 
     QSqlQuery insertQuery(m_database);
     insertQuery.prepare("INSERT INTO PlaylistTracks (playlist_id, track_id, position)"
                         "VALUES (:playlist_id, :track_id, :position)");
-    QSqlQuery query(m_database);
-    int insertPositon = position;
-    for (const auto& trackId: trackIds) {
-        if (!trackId.isValid()) {
-            continue;
-        }
-        // Move all tracks in playlist up by 1.
-        // TODO(XXX) We could do this in one query before the for loop.
-        query.prepare(QString("UPDATE PlaylistTracks SET position=position+1 "
-                              "WHERE position>=%1 AND "
-                              "playlist_id=%2").arg(insertPositon).arg(playlistId));
-
-        if (!query.exec()) {
-            LOG_FAILED_QUERY(query);
-            continue;
-        }
-
+    QList<TrackId> addedTrackIds;
+    for (int i = 0; i < validTrackIds.size(); ++i) {
         // Insert the track at the given position
         insertQuery.bindValue(":playlist_id", playlistId);
-        insertQuery.bindValue(":track_id", trackId.toVariant());
-        insertQuery.bindValue(":position", insertPositon);
+        insertQuery.bindValue(":track_id", validTrackIds[i].toVariant());
+        insertQuery.bindValue(":position", positionKeys[i]);
         if (!insertQuery.exec()) {
             LOG_FAILED_QUERY(insertQuery);
             continue;
         }
-
-        // Increment the insert position for the track.
-        ++insertPositon;
-        ++tracksAdded;
+        addedTrackIds.append(validTrackIds[i]);
     }
+    const int tracksAdded = addedTrackIds.size();
 
     transaction.commit();
 
-    insertPositon = position;
-    for (const auto& trackId: trackIds) {
+    int insertPosition = position;
+    for (const auto& trackId: addedTrackIds) {
         m_playlistsTrackIsIn.insert(trackId, playlistId);
-        // TODO(XXX) The position is wrong if any track failed to insert.
-        emit(trackAdded(playlistId, trackId, insertPositon++));
+        emit(trackAdded(playlistId, trackId, insertPosition++));
     }
     emit tracksChanged(QSet<int>{playlistId});
     return tracksAdded;
@@ -665,75 +690,232 @@ bool PlaylistDAO::copyPlaylistTracks(const int sourcePlaylistID, const int targe
     // Start the transaction
     ScopedTransaction transaction(m_database);
 
-    // Copy the new tracks after the last track in the target playlist.
-    int positionOffset = getMaxPosition(targetPlaylistID);
-
-    // Copy the tracks from one playlist to another, adjusting the position of
-    // each copied track, and preserving the date/time added.
-    // INSERT INTO PlaylistTracks (playlist_id, track_id, position, pl_datetime_added) SELECT :target_plid, track_id, position + :position_offset, pl_datetime_added FROM PlaylistTracks WHERE playlist_id = :source_plid;
+    // Read the tracks of the source playlist in their order, preserving
+    // the date/time added.
+    // SELECT track_id, pl_datetime_added FROM PlaylistTracks WHERE playlist_id = :source_plid ORDER BY position;
     QSqlQuery query(m_database);
-    query.prepare(QString("INSERT INTO " PLAYLIST_TRACKS_TABLE
-        " (%1, %2, %3, %4) SELECT :target_plid, %2, "
-        "%3 + :position_offset, %4 FROM " PLAYLIST_TRACKS_TABLE
-        " WHERE %1 = :source_plid")
+    query.prepare(QString("SELECT %2, %4 FROM " PLAYLIST_TRACKS_TABLE
+        " WHERE %1 = :source_plid ORDER BY %3")
         .arg(PLAYLISTTRACKSTABLE_PLAYLISTID)        // %1
         .arg(PLAYLISTTRACKSTABLE_TRACKID)           // %2
         .arg(PLAYLISTTRACKSTABLE_POSITION)          // %3
         .arg(PLAYLISTTRACKSTABLE_DATETIMEADDED));   // %4
-    query.bindValue(":position_offset", positionOffset);
     query.bindValue(":source_plid", sourcePlaylistID);
-    query.bindValue(":target_plid", targetPlaylistID);
-
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
         return false;
     }
+    QList<TrackId> copiedTrackIds;
+    QVariantList copiedDateTimesAdded;
+    while (query.next()) {
+        copiedTrackIds.append(TrackId(query.value(0)));
+        copiedDateTimesAdded.append(query.value(1));
+    }
 
-    // Query each added track and its new position.
-    // SELECT track_id, position FROM PlaylistTracks WHERE playlist_id = :target_plid AND position > :position_offset;
-    query.prepare(QString("SELECT %2, %3 FROM " PLAYLIST_TRACKS_TABLE
-        " WHERE %1 = :target_plid AND %3 > :position_offset")
-        .arg(PLAYLISTTRACKSTABLE_PLAYLISTID)    // %1
-        .arg(PLAYLISTTRACKSTABLE_TRACKID)       // %2
-        .arg(PLAYLISTTRACKSTABLE_POSITION));    // %3
-    query.bindValue(":target_plid", targetPlaylistID);
-    query.bindValue(":position_offset", positionOffset);
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    // Copy the new tracks after the last track in the target playlist.
+    int position = getMaxPosition(targetPlaylistID) + 1;
+    QVector<int> positionKeys;
+    if (!allocatePositionKeys(targetPlaylistID, &position,
+                copiedTrackIds.size(), &positionKeys)) {
         return false;
     }
 
+    // INSERT INTO PlaylistTracks (playlist_id, track_id, position, pl_datetime_added) VALUES (:target_plid, :track_id, :position, :datetime_added);
+    query.prepare(QString("INSERT INTO " PLAYLIST_TRACKS_TABLE
+        " (%1, %2, %3, %4) VALUES (:target_plid, :track_id, "
+        ":position, :datetime_added)")
+        .arg(PLAYLISTTRACKSTABLE_PLAYLISTID)        // %1
+        .arg(PLAYLISTTRACKSTABLE_TRACKID)           // %2
+        .arg(PLAYLISTTRACKSTABLE_POSITION)          // %3
+        .arg(PLAYLISTTRACKSTABLE_DATETIMEADDED));   // %4
+    query.bindValue(":target_plid", targetPlaylistID);
+    for (int i = 0; i < copiedTrackIds.size(); ++i) {
+        query.bindValue(":track_id", copiedTrackIds[i].toVariant());
+        query.bindValue(":position", positionKeys[i]);
+        query.bindValue(":datetime_added", copiedDateTimesAdded[i]);
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+    }
+
     // Commit the transaction
     transaction.commit();
 
     // Let subscribers know about each added track.
-    while (query.next()) {
-        TrackId copiedTrackId(query.value(0));
-        int copiedPosition = query.value(1).toInt();
+    for (const auto& copiedTrackId : qAsConst(copiedTrackIds)) {
         m_playlistsTrackIsIn.insert(copiedTrackId, targetPlaylistID);
-        emit(trackAdded(targetPlaylistID, copiedTrackId, copiedPosition));
+        emit(trackAdded(targetPlaylistID, copiedTrackId, position++));
     }
     emit tracksChanged(QSet<int>{targetPlaylistID});
     return true;
 }
 
 int PlaylistDAO::getMaxPosition(const int playlistId) const {
-    // Find out the highest position existing in the playlist so we know what
-    // position this track should have.
+    // The positions are dense, regardless of the stored keys
+    return math_max(numPositions(playlistId), 0);
+}
+
+int PlaylistDAO::numPositions(int playlistId) const {
     QSqlQuery query(m_database);
-    query.prepare("SELECT max(position) as position FROM PlaylistTracks "
-                  "WHERE playlist_id = :id");
+    query.prepare("SELECT COUNT(*) " + kPositionedTracksFrom);
+    query.bindValue(":id", playlistId);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return -1;
+    }
+    if (!query.next()) {
+        return -1;
+    }
+    return query.value(0).toInt();
+}
+
+int PlaylistDAO::getPositionKey(int playlistId, int position) const {
+    if (position < 1) {
+        return -1;
+    }
+    // SQLite can't look up a row by its rank in the index, so it steps over
+    // all rows in front of it
+    QSqlQuery query(m_database);
+    query.prepare("SELECT PlaylistTracks.position " + kPositionedTracksFrom +
+            " ORDER BY PlaylistTracks.position LIMIT 1 OFFSET :offset");
+    query.bindValue(":id", playlistId);
+    query.bindValue(":offset", position - 1);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return -1;
+    }
+    if (!query.next()) {
+        return -1;
+    }
+    return query.value(0).toInt();
+}
+
+int PlaylistDAO::getNextPositionKey(int playlistId, int positionKey) const {
+    QSqlQuery query(m_database);
+    query.prepare("SELECT MIN(position) FROM PlaylistTracks "
+                  "WHERE playlist_id=:id AND position>:position");
     query.bindValue(":id", playlistId);
+    query.bindValue(":position", positionKey);
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
+        return -1;
+    }
+    if (!query.next() || query.isNull(0)) {
+        return -1;
     }
+    return query.value(0).toInt();
+}
 
-    // Get the position of the highest track in the playlist.
+QVector<int> PlaylistDAO::getPositionKeys(int playlistId) const {
+    QVector<int> positionKeys;
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    query.prepare("SELECT PlaylistTracks.position " + kPositionedTracksFrom +
+            " ORDER BY PlaylistTracks.position");
+    query.bindValue(":id", playlistId);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return positionKeys;
+    }
+    while (query.next()) {
+        positionKeys.append(query.value(0).toInt());
+    }
+    return positionKeys;
+}
+
+bool PlaylistDAO::renumberPositionKeys(int playlistId, int holePosition, int holeSize) {
+    // Tracks without a position keep their place between the others
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    query.prepare("SELECT PlaylistTracks.id, library.id IS NOT NULL "
+                  "FROM PlaylistTracks "
+                  "LEFT JOIN library ON library.id=PlaylistTracks.track_id "
+                  "WHERE PlaylistTracks.playlist_id=:id "
+                  "ORDER BY PlaylistTracks.position, PlaylistTracks.id");
+    query.bindValue(":id", playlistId);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    // The hole directly follows the track in front of holePosition, see
+    // allocatePositionKeys()
+    QVector<int> ids;
+    QVector<int> keyIndexes;
+    int keyIndex = 0;
     int position = 0;
-    if (query.next()) {
-        position = query.value(query.record().indexOf("position")).toInt();
+    bool holeInserted = false;
+    while (query.next()) {
+        if (!holeInserted && position == holePosition - 1) {
+            keyIndex += holeSize;
+            holeInserted = true;
+        }
+        if (query.value(1).toBool()) {
+            ++position;
+        }
+        ids.append(query.value(0).toInt());
+        keyIndexes.append(++keyIndex);
+    }
+
+    // Huge playlists get smaller gaps
+    const qint64 numKeys = ids.size() + holeSize + 1;
+    const qint64 gap = math_clamp<qint64>(
+            kMaxPositionKey / numKeys, 1, kPositionKeyGap);
+
+    query.prepare("UPDATE PlaylistTracks SET position=:position WHERE id=:id");
+    for (int i = 0; i < ids.size(); ++i) {
+        query.bindValue(":position", static_cast<int>(keyIndexes[i] * gap));
+        query.bindValue(":id", ids[i]);
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PlaylistDAO::allocatePositionKeys(int playlistId, int* pPosition, int count,
+        QVector<int>* pPositionKeys) {
+    pPositionKeys->clear();
+    const int numTracks = numPositions(playlistId);
+    if (numTracks < 0) {
+        return false;
+    }
+    *pPosition = math_clamp(*pPosition, 1, numTracks + 1);
+    if (count <= 0) {
+        return true;
+    }
+
+    // A single renumbering always leaves enough room
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        const qint64 prevKey = *pPosition > 1
+                ? getPositionKey(playlistId, *pPosition - 1) : 0;
+        if (prevKey < 0) {
+            return false;
+        }
+        // The new tracks are placed directly behind the previous track,
+        // even in front of tracks without a position
+        qint64 nextKey = getNextPositionKey(playlistId, prevKey);
+        if (nextKey < 0) {
+            // Appended tracks are spaced like renumbered ones
+            nextKey = math_min(
+                    prevKey + static_cast<qint64>(count + 1) * kPositionKeyGap,
+                    kMaxPositionKey);
+        }
+        if (nextKey - prevKey > count) {
+            pPositionKeys->reserve(count);
+            for (int i = 1; i <= count; ++i) {
+                pPositionKeys->append(static_cast<int>(
+                        prevKey + (nextKey - prevKey) * i / (count + 1)));
+            }
+            return true;
+        }
+        if (!renumberPositionKeys(playlistId, *pPosition, count)) {
+            return false;
+        }
     }
-    return position;
+    DEBUG_ASSERT(!"Renumbering left no room for the new tracks");
+    return false;
 }
 
 void PlaylistDAO::removeTracksFromPlaylists(const QList<TrackId>& trackIds) {
@@ -777,57 +959,56 @@ int PlaylistDAO::tracksInPlaylist(const int playlistId) const {
 
 void PlaylistDAO::moveTrack(const int playlistId, const int oldPosition, const int newPosition) {
     ScopedTransaction transaction(m_database);
-    QSqlQuery query(m_database);
 
-    // Algorithm for code below
-    // Case 1: destination < source (newPositon < oldPosition)
-    //    1) Set position = -1 where pos=source -- Gives that track a dummy index to keep stuff simple.
-    //    2) Decrement position where pos >= dest AND pos < source
-    //    3) Set position = dest where pos=-1 -- Move track from dummy pos to final destination.
-
-     // Case 2: destination > source (newPos > oldPos)
-     //   1) Set position=-1 where pos=source -- Give track a dummy index again.
-     //   2) Decrement position where pos > source AND pos <= dest
-     //   3) Set position=dest where pos=-1 -- Move that track from dummy pos to final destination
-
-    QString queryString;
-
-    // Move moved track to dummy position -1
-    queryString = QString("UPDATE PlaylistTracks SET position=-1 "
-                          "WHERE position=%1 AND "
-                          "playlist_id=%2").arg(QString::number(oldPosition),
-                                                QString::number(playlistId));
-    query.exec(queryString);
-
-    if (newPosition < oldPosition) {
-        queryString = QString("UPDATE PlaylistTracks SET position=position+1 "
-                              "WHERE position >= %1 AND position < %2 AND "
-                              "playlist_id=%3").arg(QString::number(newPosition),
-                                                    QString::number(oldPosition),
-                                                    QString::number(playlistId));
-    } else {
-        queryString = QString("UPDATE PlaylistTracks SET position=position-1 "
-                              "WHERE position>%1 AND position<=%2 AND "
-                              "playlist_id=%3").arg(QString::number(oldPosition),
-                                                    QString::number(newPosition),
-                                                    QString::number(playlistId));
+    // Only the key of the moved track changes. It is placed between the
+    // keys of the tracks that surround the destination once the track has
+    // been taken out of its old position. The playlist is renumbered if
+    // these keys are adjacent.
+    const int numTracks = numPositions(playlistId);
+    if (oldPosition < 1 || oldPosition > numTracks) {
+        qDebug() << "moveTrack no track exists at position:"
+                 << oldPosition << "in playlist:" << playlistId;
+        return;
     }
-    query.exec(queryString);
-
-    queryString = QString("UPDATE PlaylistTracks SET position = %1 "
-                          "WHERE position=-1 AND "
-                          "playlist_id=%2").arg(QString::number(newPosition),
-                                                QString::number(playlistId));
-    query.exec(queryString);
-
-    transaction.commit();
-
-    // Print out any SQL error, if there was one.
-    if (query.lastError().isValid()) {
-        qDebug() << query.lastError();
+    const int destPosition = math_clamp(newPosition, 1, numTracks);
+    if (destPosition == oldPosition) {
+        return;
     }
+    // The position of the track in front of the destination before the move
+    const int prevPosition = destPosition < oldPosition ? destPosition - 1 : destPosition;
 
-    emit tracksChanged(QSet<int>{playlistId});
+    QSqlQuery query(m_database);
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        const int oldKey = getPositionKey(playlistId, oldPosition);
+        const qint64 prevKey = prevPosition > 0
+                ? getPositionKey(playlistId, prevPosition) : 0;
+        if (oldKey < 0 || prevKey < 0) {
+            return;
+        }
+        // See allocatePositionKeys()
+        qint64 nextKey = getNextPositionKey(playlistId, prevKey);
+        if (nextKey < 0) {
+            nextKey = math_min(prevKey + kPositionKeyGap, kMaxPositionKey);
+        }
+        if (nextKey - prevKey > 1) {
+            query.prepare("UPDATE PlaylistTracks SET position=:new_position "
+                          "WHERE playlist_id=:id AND position=:old_position");
+            query.bindValue(":new_position", static_cast<int>((prevKey + nextKey) / 2));
+            query.bindValue(":id", playlistId);
+            query.bindValue(":old_position", oldKey);
+            if (!query.exec()) {
+                LOG_FAILED_QUERY(query);
+                return;
+            }
+            transaction.commit();
+            emit tracksChanged(QSet<int>{playlistId});
+            return;
+        }
+        if (!renumberPositionKeys(playlistId, numTracks + 1, 0)) {
+            return;
+        }
+    }
+    DEBUG_ASSERT(!"Renumbering left no room for the moved track");
 }
 
 void PlaylistDAO::searchForDuplicateTrack(const int fromPosition,
@@ -857,6 +1038,8 @@ void PlaylistDAO::shuffleTracks(const int playlistId, const QList<int>& position
     qsrand(seed);
     QHash<int,TrackId> trackPositionIds = allIds;
     QList<int> newPositions = positions;
+    // The tracks are swapped by their keys
+    const QVector<int> positionKeys = getPositionKeys(playlistId);
     const int searchDistance = math_max(trackPositionIds.count() / 4, 1);
 
     qDebug() << "Shuffling Tracks";
@@ -986,15 +1169,22 @@ void PlaylistDAO::shuffleTracks(const int playlistId, const QList<int>& position
                                  newPositions.indexOf(trackBPosition));
         #endif
 
+        VERIFY_OR_DEBUG_ASSERT(
+                trackAPosition >= 1 && trackAPosition <= positionKeys.size() &&
+                trackBPosition >= 1 && trackBPosition <= positionKeys.size()) {
+            continue;
+        }
+        const int trackAKey = positionKeys[trackAPosition - 1];
+        const int trackBKey = positionKeys[trackBPosition - 1];
         QString swapQuery = "UPDATE PlaylistTracks SET position=%1 "
                 "WHERE position=%2 AND playlist_id=%3";
         query.exec(swapQuery.arg(QString::number(-1),
-                                 QString::number(trackAPosition),
+                                 QString::number(trackAKey),
                                  QString::number(playlistId)));
-        query.exec(swapQuery.arg(QString::number(trackAPosition),
-                                 QString::number(trackBPosition),
+        query.exec(swapQuery.arg(QString::number(trackAKey),
+                                 QString::number(trackBKey),
                                  QString::number(playlistId)));
-        query.exec(swapQuery.arg(QString::number(trackBPosition),
+        query.exec(swapQuery.arg(QString::number(trackBKey),
                                  QString::number(-1),
                                  QString::number(playlistId)));
 
@@ -5,6 +5,7 @@
 #include <QObject>
 #include <QSqlDatabase>
 #include <QSet>
+#include <QVector>
 
 #include "library/dao/dao.h"
 #include "track/trackid.h"
@@ -130,8 +131,35 @@ class PlaylistDAO : public QObject, public virtual DAO {
     void tracksChanged(QSet<int> playlistIds); // added/removed/reordered
 
   private:
+    // The position column of PlaylistTracks stores sparse ordering keys
+    // while the interface of this class uses dense 1-based positions. New
+    // tracks get keys between those of their neighbors, and the keys of a
+    // playlist are only renumbered when there is no gap left. Edits don't
+    // need to shift all following tracks this way. Only tracks that exist in
+    // the library have a position, like in PlaylistTableModel.
+
+    // Returns the number of tracks with a position or -1
+    int numPositions(int playlistId) const;
+    // Returns the key of the track at the given position or -1. The lookup
+    // steps over the keys of all tracks in front of it.
+    int getPositionKey(int playlistId, int position) const;
+    // Returns the smallest key of any track that is greater than positionKey
+    // or -1
+    int getNextPositionKey(int playlistId, int positionKey) const;
+    // Returns the keys of all tracks with a position in ascending order
+    QVector<int> getPositionKeys(int playlistId) const;
+    // Spreads the keys evenly, leaving room for holeSize tracks in front of
+    // the track at holePosition
+    bool renumberPositionKeys(int playlistId, int holePosition, int holeSize);
+    // Returns ascending keys for inserting count tracks at *pPosition, which
+    // is clamped to the valid range first
+    bool allocatePositionKeys(int playlistId, int* pPosition, int count,
+            QVector<int>* pPositionKeys);
+
     bool removeTracksFromPlaylist(int playlistId, int startIndex);
-    void removeTracksFromPlaylistInner(int playlistId, int position);
+    // Removes the tracks in descending order of their keys
+    void removeTracksFromPlaylistByKeys(int playlistId, QVector<int> positionKeys);
+    void removeTracksFromPlaylistInner(int playlistId, int positionKey, int position);
     void removeTracksFromPlaylistByIdInner(int playlistId, TrackId trackId);
     void searchForDuplicateTrack(const int fromPosition,
                                  const int toPosition,
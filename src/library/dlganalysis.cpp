@@ -157,13 +157,21 @@ void DlgAnalysis::analyze() {
                 trackIds.append(trackId);
             }
         }
-        emit(analyzeTracks(trackIds));
+        // Only applies to this analysis. Tracks analyzed from elsewhere in
+        // the library are analyzed completely.
+        if (checkBoxLoudnessOnly->isChecked()) {
+            emit(analyzeLoudness(trackIds));
+        } else {
+            emit(analyzeTracks(trackIds));
+        }
     }
 }
 
 void DlgAnalysis::slotAnalysisActive(bool bActive) {
     //qDebug() << this << "slotAnalysisActive" << bActive;
     m_bAnalysisActive = bActive;
+    // The analyzers are only selected when starting the analysis
+    checkBoxLoudnessOnly->setEnabled(!bActive);
     if (bActive) {
         pushButtonAnalyze->setEnabled(true);
         pushButtonAnalyze->setText(tr("Stop Analysis"));
@@ -51,6 +51,7 @@ class DlgAnalysis : public QWidget, public Ui::DlgAnalysis, public virtual Libra
     void loadTrack(TrackPointer pTrack);
     void loadTrackToPlayer(TrackPointer pTrack, QString player);
     void analyzeTracks(QList<TrackId> trackIds);
+    void analyzeLoudness(QList<TrackId> trackIds);
     void stopAnalysis();
     void trackSelected(TrackPointer pTrack);
 
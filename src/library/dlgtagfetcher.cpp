@@ -3,8 +3,9 @@
 
 #include "library/dlgtagfetcher.h"
 
-DlgTagFetcher::DlgTagFetcher(QWidget *parent)
+DlgTagFetcher::DlgTagFetcher(QWidget *parent, const FingerprintDAO& fingerprintDao)
         : QDialog(parent),
+          m_fingerprintDao(fingerprintDao),
           m_tagFetcher(parent),
           m_networkResult(NetworkResult::Ok) {
     init();
@@ -50,7 +51,9 @@ void DlgTagFetcher::loadTrack(const TrackPointer& track) {
     m_track = track;
     m_data = Data();
     m_networkResult = NetworkResult::Ok;
-    m_tagFetcher.startFetch(m_track);
+    // Tracks are only decoded again if they have not been fingerprinted
+    // during the analysis
+    m_tagFetcher.startFetch(m_track, m_fingerprintDao.getFingerprint(m_track->getId()));
 
     connect(track.get(), &Track::changed,
             this, &DlgTagFetcher::updateTrackMetadata);
@@ -4,6 +4,7 @@
 #include <QList>
 #include <QTreeWidget>
 
+#include "library/dao/fingerprintdao.h"
 #include "library/ui_dlgtagfetcher.h"
 #include "track/track.h"
 #include "musicbrainz/tagfetcher.h"
@@ -12,7 +13,7 @@ class DlgTagFetcher : public QDialog,  public Ui::DlgTagFetcher {
   Q_OBJECT
 
   public:
-    explicit DlgTagFetcher(QWidget *parent);
+    DlgTagFetcher(QWidget *parent, const FingerprintDAO& fingerprintDao);
     ~DlgTagFetcher() override = default;
 
     void init();
@@ -39,6 +40,8 @@ class DlgTagFetcher : public QDialog,  public Ui::DlgTagFetcher {
     void addTrack(const TrackPointer track, int resultIndex,
                   QTreeWidget* parent) const;
 
+    const FingerprintDAO& m_fingerprintDao;
+
     TagFetcher m_tagFetcher;
 
     TrackPointer m_track;
@@ -5,6 +5,7 @@
 #include <QMessageBox>
 
 #include "util/assert.h"
+#include "util/duration.h"
 
 TrackExportDlg::TrackExportDlg(QWidget *parent,
                                UserSettingsPointer pConfig,
@@ -22,12 +23,17 @@ TrackExportDlg::TrackExportDlg(QWidget *parent,
     exportProgress->setMaximum(1);
     exportProgress->setValue(0);
     statusLabel->setText("");
+    throughputLabel->setText("");
     setModal(true);
 
     connect(m_worker,
             &TrackExportWorker::progress,
             this,
             &TrackExportDlg::slotProgress);
+    connect(m_worker,
+            &TrackExportWorker::bytesProgress,
+            this,
+            &TrackExportDlg::slotBytesProgress);
     connect(m_worker,
             &TrackExportWorker::askOverwriteMode,
             this,
@@ -47,6 +53,7 @@ void TrackExportDlg::showEvent(QShowEvent* event) {
         qDebug() << "Programming error: did not initialize m_exporter, about to crash";
         return;
     }
+    m_timer.start();
     m_worker->start();
 }
 
@@ -62,6 +69,30 @@ void TrackExportDlg::slotProgress(QString filename, int progress, int count) {
     exportProgress->setValue(progress);
 }
 
+void TrackExportDlg::slotBytesProgress(qint64 bytesCopied, qint64 bytesTotal) {
+    const double megabytesCopied = bytesCopied / 1048576.0;
+    const double megabytesTotal = bytesTotal / 1048576.0;
+    if (bytesCopied <= 0) {
+        // Don't include the time spent asking about existing files
+        m_timer.start();
+        throughputLabel->setText(tr("%1 MiB").arg(
+                QString::number(megabytesTotal, 'f', 1)));
+        return;
+    }
+    const double seconds = m_timer.elapsed() / 1000.0;
+    if (seconds <= 0.0) {
+        return;
+    }
+    const double megabytesPerSecond = megabytesCopied / seconds;
+    const double remainingSeconds =
+            (megabytesTotal - megabytesCopied) / megabytesPerSecond;
+    throughputLabel->setText(tr("%1 of %2 MiB at %3 MiB/s, %4 remaining").arg(
+            QString::number(megabytesCopied, 'f', 1),
+            QString::number(megabytesTotal, 'f', 1),
+            QString::number(megabytesPerSecond, 'f', 1),
+            mixxx::Duration::formatTime(remainingSeconds)));
+}
+
 void TrackExportDlg::slotAskOverwriteMode(
         QString filename,
         std::promise<TrackExportWorker::OverwriteAnswer>* promise) {
@@ -4,6 +4,7 @@
 #include <future>
 
 #include <QDialog>
+#include <QElapsedTimer>
 #include <QString>
 #include <QScopedPointer>
 
@@ -31,6 +32,7 @@ class TrackExportDlg : public QDialog, public Ui::DlgTrackExport {
 
   public slots:
     void slotProgress(QString filename, int progress, int count);
+    void slotBytesProgress(qint64 bytesCopied, qint64 bytesTotal);
     void slotAskOverwriteMode(
             QString filename,
             std::promise<TrackExportWorker::OverwriteAnswer>* promise);
@@ -50,6 +52,7 @@ class TrackExportDlg : public QDialog, public Ui::DlgTrackExport {
     UserSettingsPointer m_pConfig;
     QList<TrackPointer> m_tracks;
     TrackExportWorker* m_worker;
+    QElapsedTimer m_timer;
 };
 
 #endif  // DLGTRACKEXPORT_H
@@ -29,6 +29,8 @@ bool TrackExportWizard::selectDestinationDirectory() {
                    ConfigValue(destDir));
 
     m_worker.reset(new TrackExportWorker(destDir, m_tracks));
+    m_worker->setVerify(m_pConfig->getValue(
+            ConfigKey("[Library]", "VerifyTrackExport"), false));
     m_dialog.reset(new TrackExportDlg(m_parent, m_pConfig, m_worker.data()));
     return true;
 }
@@ -3,9 +3,25 @@
 #include <QFileInfo>
 #include <QMessageBox>
 #include <QDebug>
+#include <QMutex>
+#include <QQueue>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QtConcurrentRun>
+
+#include "util/compatibility.h"
+#include "util/filecopier.h"
 
 namespace {
 
+// Copying files in parallel hides the latency of opening, allocating and
+// closing many small files.  More copiers would only compete for the
+// bandwidth of the destination device.
+constexpr int kMaxParallelCopies = 4;
+
+// How often the number of copied bytes is reported.
+constexpr unsigned long kBytesProgressIntervalMillis = 250;
+
 QString rewriteFilename(const QFileInfo& fileinfo, int index) {
     // We don't have total control over the inputs, so definitely
     // don't use .arg().arg().arg().
@@ -72,24 +88,37 @@ QMap<QString, TrackFile> createCopylist(const QList<TrackPointer>& tracks) {
 void TrackExportWorker::run() {
     int i = 0;
     QMap<QString, TrackFile> copy_list = createCopylist(m_tracks);
+    // All questions are asked before copying anything, so the user does
+    // not need to attend the export until it has finished.
+    QVector<CopyJob> jobs;
     for (auto it = copy_list.constBegin(); it != copy_list.constEnd(); ++it) {
-        // We emit progress twice per loop, which may seem excessive, but it
-        // guarantees that we emit a sane progress before we start and after
-        // we end.  In between, each filename will get its own visible tick
-        // on the bar, which looks really nice.
-        emit(progress(it->fileName(), i, copy_list.size()));
-        copyFile((*it).asFileInfo(), it.key());
+        CopyJob job;
+        const bool copy = prepareCopyJob((*it).asFileInfo(), it.key(), &job);
         if (atomicLoadAcquire(m_bStop)) {
             emit(canceled());
             return;
         }
-        ++i;
-        emit(progress(it->fileName(), i, copy_list.size()));
+        if (copy) {
+            jobs.append(job);
+        } else {
+            // Skipped files get their visible tick on the bar right away.
+            ++i;
+            emit(progress(it->fileName(), i, copy_list.size()));
+        }
+    }
+    if (jobs.isEmpty()) {
+        return;
+    }
+    // Emit a sane progress before we start copying.
+    emit(progress(jobs.first().fileName, i, copy_list.size()));
+    if (!runCopyJobs(&jobs, i, copy_list.size())) {
+        emit(canceled());
     }
 }
 
-void TrackExportWorker::copyFile(const QFileInfo& source_fileinfo,
-                                 const QString& dest_filename) {
+bool TrackExportWorker::prepareCopyJob(const QFileInfo& source_fileinfo,
+                                       const QString& dest_filename,
+                                       CopyJob* pJob) {
     QString sourceFilename = source_fileinfo.canonicalFilePath();
     const QString dest_path = QDir(m_destDir).filePath(dest_filename);
     QFileInfo dest_fileinfo(dest_path);
@@ -102,19 +131,19 @@ void TrackExportWorker::copyFile(const QFileInfo& source_fileinfo,
             case OverwriteAnswer::SKIP:
             case OverwriteAnswer::SKIP_ALL:
                 qDebug() << "skipping" << sourceFilename;
-                return;
+                return false;
             case OverwriteAnswer::OVERWRITE:
             case OverwriteAnswer::OVERWRITE_ALL:
                 break;
             case OverwriteAnswer::CANCEL:
                 m_errorMessage = tr("Export process was canceled");
                 stop();
-                return;
+                return false;
             }
             break;
         case OverwriteMode::SKIP_ALL:
             qDebug() << "skipping" << sourceFilename;
-            return;
+            return false;
         case OverwriteMode::OVERWRITE_ALL:;
         }
 
@@ -128,21 +157,88 @@ void TrackExportWorker::copyFile(const QFileInfo& source_fileinfo,
             qWarning() << error_message;
             m_errorMessage = error_message;
             stop();
-            return;
+            return false;
         }
     }
 
-    qDebug() << "Copying" << sourceFilename << "to" << dest_path;
-    QFile source_file(sourceFilename);
-    if (!source_file.copy(dest_path)) {
-        const QString error_message = tr(
-                "Error exporting track %1 to %2: %3. Stopping.").arg(
-                sourceFilename, dest_path, source_file.errorString());
-        qWarning() << error_message;
-        m_errorMessage = error_message;
-        stop();
-        return;
+    pJob->sourcePath = sourceFilename;
+    pJob->destPath = dest_path;
+    pJob->fileName = source_fileinfo.fileName();
+    pJob->size = source_fileinfo.size();
+    return true;
+}
+
+bool TrackExportWorker::runCopyJobs(QVector<CopyJob>* pJobs, int numFilesDone, int numFiles) {
+    qint64 bytesTotal = 0;
+    for (const auto& job : *pJobs) {
+        bytesTotal += job.size;
+    }
+    QAtomicInteger<qint64> bytesCopied = 0;
+    emit(bytesProgress(0, bytesTotal));
+
+    // The copiers only report which jobs have finished.  All signals are
+    // emitted from this thread.
+    QMutex mutex;
+    QWaitCondition jobFinished;
+    QQueue<int> finishedJobs;
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(kMaxParallelCopies);
+    CopyJob* const pJobData = pJobs->data();
+    for (int i = 0; i < pJobs->size(); ++i) {
+        QtConcurrent::run(&threadPool, [=, &bytesCopied, &mutex, &jobFinished, &finishedJobs]() {
+            CopyJob* const pJob = pJobData + i;
+            if (!atomicLoadAcquire(m_bStop)) {
+                qDebug() << "Copying" << pJob->sourcePath << "to" << pJob->destPath;
+                mixxx::FileCopier copier;
+                copier.setVerify(m_verify);
+                copier.setProgress(&bytesCopied, &m_bStop);
+                if (!copier.copy(pJob->sourcePath, pJob->destPath)) {
+                    pJob->errorMessage = copier.errorString();
+                }
+            }
+            QMutexLocker locker(&mutex);
+            finishedJobs.enqueue(i);
+            jobFinished.wakeOne();
+        });
+    }
+
+    int numJobsFinished = 0;
+    QMutexLocker locker(&mutex);
+    while (numJobsFinished < pJobs->size()) {
+        if (finishedJobs.isEmpty()) {
+            jobFinished.wait(&mutex, kBytesProgressIntervalMillis);
+        }
+        QQueue<int> newlyFinishedJobs;
+        newlyFinishedJobs.swap(finishedJobs);
+        locker.unlock();
+
+        emit(bytesProgress(atomicLoadRelaxed(bytesCopied), bytesTotal));
+        for (const int index : newlyFinishedJobs) {
+            ++numJobsFinished;
+            if (atomicLoadAcquire(m_bStop)) {
+                // Pending jobs are aborted, no more progress
+                continue;
+            }
+            const CopyJob& job = pJobs->at(index);
+            if (!job.errorMessage.isEmpty()) {
+                const QString error_message = tr(
+                        "Error exporting track %1 to %2: %3. Stopping.").arg(
+                        job.sourcePath, job.destPath, job.errorMessage);
+                qWarning() << error_message;
+                m_errorMessage = error_message;
+                stop();
+                continue;
+            }
+            ++numFilesDone;
+            emit(progress(job.fileName, numFilesDone, numFiles));
+        }
+
+        locker.relock();
     }
+    locker.unlock();
+    threadPool.waitForDone();
+    return numFilesDone == numFiles;
 }
 
 TrackExportWorker::OverwriteAnswer TrackExportWorker::makeOverwriteRequest(
@@ -191,6 +287,6 @@ TrackExportWorker::OverwriteAnswer TrackExportWorker::makeOverwriteRequest(
 }
 
 void TrackExportWorker::stop() {
-    // We'll wait for the current file to finish copying, then stop.
+    // The copiers abort their current file and remove it.
     m_bStop = true;
 }
@@ -5,14 +5,16 @@
 #include <QScopedPointer>
 #include <QString>
 #include <QThread>
+#include <QVector>
 #include <future>
 
 #include "track/track.h"
 
 // A QThread class for copying a list of files to a single destination directory.
-// Currently does not preserve subdirectory relationships.  This class performs
-// all copies in a blocking style within its own thread.  May be canceled from
-// another thread.
+// Currently does not preserve subdirectory relationships.  All questions about
+// overwriting existing files are asked up front, then the files are copied by
+// a bounded number of parallel copiers while this thread reports the progress.
+// May be canceled from another thread.
 class TrackExportWorker : public QThread {
     Q_OBJECT
   public:
@@ -47,7 +49,13 @@ class TrackExportWorker : public QThread {
         return m_errorMessage;
     }
 
-    // Cancels the export after the current copy operation.
+    // Compare checksums of each exported file with its original.  Must be
+    // set before the export is started.
+    void setVerify(bool verify) {
+        m_verify = verify;
+    }
+
+    // Cancels the export and aborts all pending copy operations.
     // May be called from another thread.
     void stop();
 
@@ -61,16 +69,33 @@ class TrackExportWorker : public QThread {
             QString filename,
             std::promise<TrackExportWorker::OverwriteAnswer>* promise);
     void progress(QString filename, int progress, int count);
+    // Emitted periodically while copying.  Skipped files are not included.
+    void bytesProgress(qint64 bytesCopied, qint64 bytesTotal);
     void canceled();
 
   private:
-    // Copies the file at source_fileinfo to the destination directory with the
-    // name given by dest_filename (not a full path).  If the destination file
-    // exists, will emit an overwrite request signal to ask how to proceed.
-    // On unrecoverable error, sets the error message and stops the export
-    // process entirely.
-    void copyFile(const QFileInfo& source_fileinfo,
-                  const QString& dest_filename);
+    struct CopyJob {
+        QString sourcePath;
+        QString destPath;
+        QString fileName;
+        qint64 size;
+        QString errorMessage;
+    };
+
+    // Decides whether the file at source_fileinfo needs to be copied to the
+    // destination directory with the name given by dest_filename (not a full
+    // path).  If the destination file exists, will emit an overwrite request
+    // signal to ask how to proceed.  Returns false if the file is skipped or
+    // the export has been canceled.
+    bool prepareCopyJob(const QFileInfo& source_fileinfo,
+                        const QString& dest_filename,
+                        CopyJob* pJob);
+
+    // Copies all files on a bounded thread pool and emits the progress
+    // while waiting.  On unrecoverable error, sets the error message and
+    // stops the export process entirely.  Returns false if not all files
+    // have been copied.
+    bool runCopyJobs(QVector<CopyJob>* pJobs, int numFilesDone, int numFiles);
 
     // Emit a signal requesting overwrite mode, and block until we get an
     // answer.  Updates m_overwriteMode appropriately.
@@ -78,6 +103,7 @@ class TrackExportWorker : public QThread {
 
     QAtomicInt m_bStop = false;
     QString m_errorMessage;
+    bool m_verify = false;
 
     OverwriteMode m_overwriteMode = OverwriteMode::ASK;
     const QString m_destDir;
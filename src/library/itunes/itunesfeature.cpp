@@ -30,6 +30,7 @@
 namespace {
 
 const QString ITDB_PATH_KEY = "mixxx.itunesfeature.itdbpath";
+const QString kImportedSourceKey = "mixxx.itunesfeature.imported_source";
 
 const QString kDict = "dict";
 const QString kKey = "key";
@@ -163,17 +164,13 @@ void ITunesFeature::activate() {
 void ITunesFeature::activate(bool forceReload) {
     //qDebug("ITunesFeature::activate()");
     if (!m_isActivated || forceReload) {
-
-        //Delete all table entries of iTunes feature
-        ScopedTransaction transaction(m_database);
-        clearTable("itunes_playlist_tracks");
-        clearTable("itunes_library");
-        clearTable("itunes_playlists");
-        transaction.commit();
-
         emit(showTrackModel(m_pITunesTrackModel));
 
         SettingsDAO settings(m_pTrackCollection->database());
+        if (forceReload) {
+            // Parse the file again even if it is unchanged
+            settings.setValue(kImportedSourceKey, QString());
+        }
         QString dbSetting(settings.getValue(ITDB_PATH_KEY));
         // if a path exists in the database, use it
         if (!dbSetting.isEmpty() && QFile::exists(dbSetting)) {
@@ -375,7 +372,19 @@ TreeItem* ITunesFeature::importLibrary() {
 
     qDebug() << "ITunesFeature::importLibrary() ";
 
+    const QString signature = sourceFilesSignature(QStringList(m_dbfile));
+    if (isImportUpToDate(m_database, kImportedSourceKey, signature)) {
+        qDebug() << "iTunes library is unchanged since the last import";
+        return loadPlaylists();
+    }
+    // Invalidate the previous import until this one is complete
+    setImportedSignature(m_database, kImportedSourceKey, QString());
+
+    //Delete all table entries of iTunes feature
     ScopedTransaction transaction(m_database);
+    clearTable("itunes_playlist_tracks");
+    clearTable("itunes_library");
+    clearTable("itunes_playlists");
 
     // By default set m_mixxxItunesRoot and m_dbItunesRoot to strip out
     // file://localhost/ from the URL. When we load the user's iTunes XML
@@ -446,9 +455,28 @@ TreeItem* ITunesFeature::importLibrary() {
         }
         playlist_root = NULL;
     }
+    if (playlist_root && !m_cancelImport) {
+        setImportedSignature(m_database, kImportedSourceKey, signature);
+    }
     return playlist_root;
 }
 
+// This method is executed in a separate thread
+// via QtConcurrent::run
+TreeItem* ITunesFeature::loadPlaylists() {
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT name FROM itunes_playlists ORDER BY id")) {
+        LOG_FAILED_QUERY(query);
+        return NULL;
+    }
+    TreeItem* rootItem = new TreeItem(this);
+    while (query.next()) {
+        rootItem->appendChild(query.value(0).toString());
+    }
+    return rootItem;
+}
+
 void ITunesFeature::parseTracks(QXmlStreamReader& xml) {
     bool in_container_dictionary = false;
     bool in_track_dictionary = false;
@@ -45,6 +45,8 @@ class ITunesFeature : public BaseExternalLibraryFeature {
     static QString getiTunesMusicPath();
     // returns the invisible rootItem for the sidebar model
     TreeItem* importLibrary();
+    // builds the sidebar model from a previous import
+    TreeItem* loadPlaylists();
     void guessMusicLibraryMountpoint(QXmlStreamReader& xml);
     void parseTracks(QXmlStreamReader& xml);
     void parseTrack(QXmlStreamReader& xml, QSqlQuery& query);
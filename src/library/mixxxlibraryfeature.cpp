@@ -94,6 +94,7 @@ MixxxLibraryFeature::MixxxLibraryFeature(Library* pLibrary,
 
     // These rely on the 'default' track source being present.
     m_pLibraryTableModel = new LibraryTableModel(this, pLibrary->trackCollections(), "mixxx.db.model.library");
+    m_pLibraryTableModel->setAsyncSelect(true);
 
     auto pRootItem = std::make_unique<TreeItem>(this);
     pRootItem->appendChild(kMissingTitle);
@@ -43,10 +43,12 @@ PlaylistFeature::PlaylistFeature(
                 pConfig,
                 QStringLiteral("PLAYLISTHOME")),
           m_icon(QStringLiteral(":/images/library/ic_library_playlist.svg")) {
-    initTableModel(new PlaylistTableModel(
+    auto pPlaylistTableModel = new PlaylistTableModel(
             this,
             pLibrary->trackCollections(),
-            "mixxx.db.model.playlist"));
+            "mixxx.db.model.playlist");
+    pPlaylistTableModel->setAsyncSelect(true);
+    initTableModel(pPlaylistTableModel);
 
     //construct child model
     auto pRootItem = std::make_unique<TreeItem>(this);
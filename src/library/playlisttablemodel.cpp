@@ -102,6 +102,9 @@ void PlaylistTableModel::setTableModel(int playlistId) {
     columns[4] = LIBRARYTABLE_COVERART;
     setTable(playlistTableName, LIBRARYTABLE_ID, columns,
             m_pTrackCollectionManager->internalCollection()->getTrackSource());
+    // The DAO stores sparse position keys, but the model exposes and
+    // expects the dense positions of the tracks
+    setRankColumn(fieldIndex(ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_POSITION));
     setSearch("");
     setDefaultSort(fieldIndex(ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_POSITION), Qt::AscendingOrder);
     setSort(defaultSortColumn(), defaultSortOrder());
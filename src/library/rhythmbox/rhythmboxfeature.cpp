@@ -13,6 +13,26 @@
 #include "library/treeitem.h"
 #include "library/queryutil.h"
 
+namespace {
+
+const QString kImportedSourceKey = "mixxx.rhythmboxfeature.imported_source";
+
+// Returns the path of a file in the Rhythmbox data directory or an empty
+// string if it does not exist
+QString findRhythmboxFile(const QString& fileName) {
+    QString filePath = QDir::homePath() + "/.gnome2/rhythmbox/" + fileName;
+    if (QFile::exists(filePath)) {
+        return filePath;
+    }
+    filePath = QDir::homePath() + "/.local/share/rhythmbox/" + fileName;
+    if (QFile::exists(filePath)) {
+        return filePath;
+    }
+    return QString();
+}
+
+} // anonymous namespace
+
 RhythmboxFeature::RhythmboxFeature(Library* pLibrary, UserSettingsPointer pConfig)
         : BaseExternalLibraryFeature(pLibrary, pConfig),
           m_cancelImport(false),
@@ -149,17 +169,31 @@ TreeItem* RhythmboxFeature::importMusicCollection() {
         }
     }
 
+    // Rhythmbox only writes playlists.xml after playlists have been created
+    QStringList sourceFiles(db.fileName());
+    const QString playlistsFile = findRhythmboxFile("playlists.xml");
+    if (!playlistsFile.isEmpty()) {
+        sourceFiles.append(playlistsFile);
+    }
+    const QString signature = sourceFilesSignature(sourceFiles);
+    if (isImportUpToDate(m_database, kImportedSourceKey, signature)) {
+        qDebug() << "Rhythmbox collection is unchanged since the last import";
+        return loadPlaylists();
+    }
+
     if (!db.open(QIODevice::ReadOnly | QIODevice::Text))
         return NULL;
 
-    //Delete all table entries of Traktor feature
+    // The whole import is rolled back if it is canceled or fails. The
+    // previous import and its signature are kept in this case.
     ScopedTransaction transaction(m_database);
+    setImportedSignature(m_database, kImportedSourceKey, QString());
+
+    //Delete all table entries of Rhythmbox feature
     clearTable("rhythmbox_playlist_tracks");
     clearTable("rhythmbox_library");
     clearTable("rhythmbox_playlists");
-    transaction.commit();
-
-    transaction.transaction();
+    m_trackIdsByLocation.clear();
     QSqlQuery query(m_database);
     query.prepare("INSERT INTO rhythmbox_library (artist, title, album, year, "
                   "genre, comment, tracknumber, bpm, bitrate,"
@@ -179,33 +213,66 @@ TreeItem* RhythmboxFeature::importMusicCollection() {
             }
         }
     }
-    transaction.commit();
 
     if (xml.hasError()) {
         // do error handling
         qDebug() << "Cannot process Rhythmbox music collection";
         qDebug() << "XML ERROR: " << xml.errorString();
+        transaction.rollback();
+        m_trackIdsByLocation.clear();
         return NULL;
     }
 
     db.close();
     if (m_cancelImport) {
+        transaction.rollback();
+        m_trackIdsByLocation.clear();
+        return NULL;
+    }
+
+    TreeItem* rootItem = importPlaylists(playlistsFile);
+    m_trackIdsByLocation.clear();
+    if (!rootItem || m_cancelImport) {
+        transaction.rollback();
+        delete rootItem;
+        return NULL;
+    }
+
+    setImportedSignature(m_database, kImportedSourceKey, signature);
+    if (!transaction.commit()) {
+        delete rootItem;
+        return NULL;
+    }
+    return rootItem;
+}
+
+TreeItem* RhythmboxFeature::loadPlaylists() {
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT name FROM rhythmbox_playlists ORDER BY id")) {
+        LOG_FAILED_QUERY(query);
         return NULL;
     }
-    return importPlaylists();
+    TreeItem* rootItem = new TreeItem(this);
+    while (query.next()) {
+        rootItem->appendChild(query.value(0).toString());
+    }
+    return rootItem;
 }
 
-TreeItem* RhythmboxFeature::importPlaylists() {
-    QFile db(QDir::homePath() + "/.gnome2/rhythmbox/playlists.xml");
-    if (!db.exists()) {
-        db.setFileName(QDir::homePath() + "/.local/share/rhythmbox/playlists.xml");
-        if (!db.exists()) {
-            return NULL;
-        }
+TreeItem* RhythmboxFeature::importPlaylists(const QString& playlistsFile) {
+    //The tree structure holding the playlists
+    TreeItem* rootItem = new TreeItem(this);
+    if (playlistsFile.isEmpty()) {
+        // No playlists have been created in Rhythmbox
+        return rootItem;
     }
     //Open file
-     if (!db.open(QIODevice::ReadOnly | QIODevice::Text))
+    QFile db(playlistsFile);
+    if (!db.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        delete rootItem;
         return NULL;
+    }
 
     QSqlQuery query_insert_to_playlists(m_database);
     query_insert_to_playlists.prepare("INSERT INTO rhythmbox_playlists (id, name) "
@@ -215,8 +282,6 @@ TreeItem* RhythmboxFeature::importPlaylists() {
     query_insert_to_playlist_tracks.prepare(
             "INSERT INTO rhythmbox_playlist_tracks (playlist_id, track_id, position) "
             "VALUES (:playlist_id, :track_id, :position)");
-    //The tree structure holding the playlists
-    TreeItem* rootItem = new TreeItem(this);
 
     QXmlStreamReader xml(&db);
     while (!xml.atEnd() && !m_cancelImport) {
@@ -358,6 +423,11 @@ void RhythmboxFeature::importTrack(QXmlStreamReader &xml, QSqlQuery &query) {
                  << " " << query.lastError();
         return;
     }
+    // Playlist entries refer to tracks by location. Looking them up in
+    // memory is much faster than querying the unindexed location column.
+    if (!m_trackIdsByLocation.contains(location)) {
+        m_trackIdsByLocation.insert(location, query.lastInsertId().toInt());
+    }
 }
 
 // reads all playlist entries and executes a SQL statement
@@ -372,26 +442,12 @@ void RhythmboxFeature::importPlaylist(QXmlStreamReader &xml,
             const auto trackFile = TrackFile::fromUrl(xml.readElementText());
 
             //get the ID of the file in the rhythmbox_library table
-            int track_id = -1;
-            QSqlQuery finder_query(m_database);
-            finder_query.prepare("select id from rhythmbox_library where location=:path");
-            finder_query.bindValue(":path", trackFile.location());
-            bool success = finder_query.exec();
-
-            if (success) {
-                const int idColumn = finder_query.record().indexOf("id");
-                while (finder_query.next()) {
-                    track_id = finder_query.value(idColumn).toInt();
-                }
-             } else {
-                qDebug() << "SQL Error in RhythmboxFeature.cpp: line"
-                         << __LINE__ << " " << finder_query.lastError();
-            }
+            const int track_id = m_trackIdsByLocation.value(trackFile.location(), -1);
 
             query_insert_to_playlist_tracks.bindValue(":playlist_id", playlist_id);
             query_insert_to_playlist_tracks.bindValue(":track_id", track_id);
             query_insert_to_playlist_tracks.bindValue(":position", playlist_position++);
-            success = query_insert_to_playlist_tracks.exec();
+            bool success = query_insert_to_playlist_tracks.exec();
 
             if (!success) {
                 qDebug() << "SQL Error in RhythmboxFeature.cpp: line" << __LINE__ << " "
@@ -4,6 +4,7 @@
 #ifndef RHYTHMBOXFEATURE_H
 #define RHYTHMBOXFEATURE_H
 
+#include <QHash>
 #include <QStringListModel>
 #include <QtSql>
 #include <QXmlStreamReader>
@@ -31,8 +32,10 @@ class RhythmboxFeature : public BaseExternalLibraryFeature {
     TreeItemModel* getChildModel();
     // processes the music collection
     TreeItem* importMusicCollection();
-    // processes the playlist entries
-    TreeItem* importPlaylists();
+    // processes the playlist entries of the given file, which might not exist
+    TreeItem* importPlaylists(const QString& playlistsFile);
+    // builds the childmodel from a previous import
+    TreeItem* loadPlaylists();
 
   public slots:
     void activate();
@@ -60,6 +63,8 @@ class RhythmboxFeature : public BaseExternalLibraryFeature {
     QFuture<TreeItem*> m_track_future;
     TreeItemModel m_childModel;
     bool m_cancelImport;
+    // Ids of the imported tracks, only accessed by the import
+    QHash<QString, int> m_trackIdsByLocation;
 
     QSharedPointer<BaseTrackCache>  m_trackSource;
     QIcon m_icon;
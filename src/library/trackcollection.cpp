@@ -48,6 +48,7 @@ void TrackCollection::connectDatabase(QSqlDatabase database) {
     m_cueDao.initialize(database);
     m_directoryDao.initialize(database);
     m_analysisDao.initialize(database);
+    m_fingerprintDao.initialize(database);
     m_libraryHashDao.initialize(database);
     m_crates.connectDatabase(database);
 }
@@ -299,6 +300,7 @@ bool TrackCollection::purgeTracks(
     m_cueDao.deleteCuesForTracks(trackIds);
     m_playlistDao.removeTracksFromPlaylists(trackIds);
     m_analysisDao.deleteAnalyses(trackIds);
+    m_fingerprintDao.deleteFingerprints(trackIds);
 
     // Post-processing
     // TODO(XXX): Move signals from TrackDAO to TrackCollection
@@ -12,6 +12,7 @@
 #include "library/dao/playlistdao.h"
 #include "library/dao/analysisdao.h"
 #include "library/dao/directorydao.h"
+#include "library/dao/fingerprintdao.h"
 #include "library/dao/libraryhashdao.h"
 
 // forward declaration(s)
@@ -55,6 +56,9 @@ class TrackCollection : public QObject,
     AnalysisDao& getAnalysisDAO() {
         return m_analysisDao;
     }
+    FingerprintDAO& getFingerprintDAO() {
+        return m_fingerprintDao;
+    }
 
     void connectTrackSource(QSharedPointer<BaseTrackCache> pTrackSource);
     QWeakPointer<BaseTrackCache> disconnectTrackSource();
@@ -139,6 +143,7 @@ class TrackCollection : public QObject,
     CueDAO m_cueDao;
     DirectoryDAO m_directoryDao;
     AnalysisDao m_analysisDao;
+    FingerprintDAO m_fingerprintDao;
     LibraryHashDAO m_libraryHashDao;
     TrackDAO m_trackDao;
 
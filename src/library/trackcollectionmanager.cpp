@@ -2,6 +2,7 @@
 
 #include "library/trackcollectionmanager.h"
 
+#include "library/asyncselectthread.h"
 #include "library/trackcollection.h"
 #include "library/externaltrackcollection.h"
 
@@ -28,7 +29,8 @@ TrackCollectionManager::TrackCollectionManager(
     : QObject(parent),
       m_pConfig(pConfig),
       m_pInternalCollection(make_parented<TrackCollection>(this, pConfig)),
-      m_scanner(pDbConnectionPool, m_pInternalCollection, pConfig) {
+      m_scanner(pDbConnectionPool, m_pInternalCollection, pConfig),
+      m_pAsyncSelectThread(std::make_unique<AsyncSelectThread>(pDbConnectionPool)) {
 
     const QSqlDatabase dbConnection = mixxx::DbConnectionPooled(std::move(pDbConnectionPool));
 
@@ -84,6 +86,10 @@ TrackCollectionManager::TrackCollectionManager(
 }
 
 TrackCollectionManager::~TrackCollectionManager() {
+    kLogger.info() << "Stopping background queries";
+    m_pAsyncSelectThread->stop();
+    m_pAsyncSelectThread->wait();
+
     const auto pWeakTrackSource = m_pInternalCollection->disconnectTrackSource();
     VERIFY_OR_DEBUG_ASSERT(pWeakTrackSource.isNull()) {
         kLogger.warning() << "BaseTrackCache is still in use";
@@ -5,12 +5,15 @@
 #include <QObject>
 #include <QSet>
 
+#include <memory>
+
 #include "library/scanner/libraryscanner.h"
 #include "preferences/usersettings.h"
 #include "track/globaltrackcache.h"
 #include "util/db/dbconnectionpool.h"
 #include "util/parented_ptr.h"
 
+class AsyncSelectThread;
 class TrackCollection;
 class ExternalTrackCollection;
 
@@ -42,6 +45,11 @@ class TrackCollectionManager: public QObject,
         return m_externalCollections;
     }
 
+    // Executes queries of the library models on a separate connection
+    AsyncSelectThread* asyncSelectThread() const {
+        return m_pAsyncSelectThread.get();
+    }
+
     bool hideTracks(const QList<TrackId>& trackIds);
     bool unhideTracks(const QList<TrackId>& trackIds);
     void hideAllTracks(const QDir& rootDir);
@@ -99,4 +107,6 @@ class TrackCollectionManager: public QObject,
     QList<ExternalTrackCollection*> m_externalCollections;
 
     LibraryScanner m_scanner;
+
+    const std::unique_ptr<AsyncSelectThread> m_pAsyncSelectThread;
 };
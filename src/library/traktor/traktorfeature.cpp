@@ -21,6 +21,8 @@
 
 namespace {
 
+const QString kImportedSourceKey = "mixxx.traktorfeature.imported_source";
+
 QString fromTraktorSeparators(QString path) {
     // Traktor uses /: instead of just / as delimiting character for some reasons
     return path.replace("/:", "/");
@@ -186,16 +188,23 @@ TreeItem* TraktorFeature::importLibrary(QString file) {
     //Give thread a low priority
     QThread* thisThread = QThread::currentThread();
     thisThread->setPriority(QThread::LowPriority);
+    const QString signature = sourceFilesSignature(QStringList(file));
+    if (isImportUpToDate(m_database, kImportedSourceKey, signature)) {
+        qDebug() << "Traktor collection is unchanged since the last import";
+        return loadPlaylists();
+    }
     //Invisible root item of Traktor's child model
     TreeItem* root = NULL;
-    //Delete all table entries of Traktor feature
+    // The whole import is rolled back if it is canceled or fails. The
+    // previous import and its signature are kept in this case.
     ScopedTransaction transaction(m_database);
+    setImportedSignature(m_database, kImportedSourceKey, QString());
+
+    //Delete all table entries of Traktor feature
     clearTable("traktor_playlist_tracks");
     clearTable("traktor_library");
     clearTable("traktor_playlists");
-    transaction.commit();
-
-    transaction.transaction();
+    m_trackIdsByLocation.clear();
     QSqlQuery query(m_database);
     query.prepare("INSERT INTO traktor_library (artist, title, album, year,"
                   "genre,comment,tracknumber,bpm, bitrate,duration, location,"
@@ -207,6 +216,8 @@ TreeItem* TraktorFeature::importLibrary(QString file) {
     QFile traktor_file(file);
     if (!traktor_file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         qDebug() << "Cannot open Traktor music collection";
+        transaction.rollback();
+        m_trackIdsByLocation.clear();
         return NULL;
     }
     QXmlStreamReader xml(&traktor_file);
@@ -250,21 +261,65 @@ TreeItem* TraktorFeature::importLibrary(QString file) {
             }
         }
     }
-    if (xml.hasError()) {
-         // do error handling
-         qDebug() << "Cannot process Traktor music collection";
-         if (root)
-             delete root;
-         return NULL;
+    m_trackIdsByLocation.clear();
+    if (xml.hasError() || m_cancelImport) {
+        if (xml.hasError()) {
+            qDebug() << "Cannot process Traktor music collection";
+            qDebug() << "XML ERROR: " << xml.errorString();
+        }
+        transaction.rollback();
+        delete root;
+        return NULL;
     }
 
     qDebug() << "Found: " << nAudioFiles << " audio files in Traktor";
     //initialize TraktorTableModel
-    transaction.commit();
-
+    if (root) {
+        setImportedSignature(m_database, kImportedSourceKey, signature);
+    }
+    if (!transaction.commit()) {
+        delete root;
+        return NULL;
+    }
     return root;
 }
 
+// Rebuilds the folder structure from the playlist paths of a previous
+// import. Empty folders are not stored and therefore not restored.
+TreeItem* TraktorFeature::loadPlaylists() {
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT name FROM traktor_playlists ORDER BY id")) {
+        LOG_FAILED_QUERY(query);
+        return NULL;
+    }
+    const QString delimiter = "-->";
+    TreeItem* rootItem = new TreeItem(this);
+    QHash<QString, TreeItem*> folders;
+    while (query.next()) {
+        const QString playlistPath = query.value(0).toString();
+        const QStringList names = playlistPath.split(delimiter);
+        TreeItem* parent = rootItem;
+        QString currentPath;
+        // The path starts with a delimiter, so names[0] is empty
+        for (int i = 1; i < names.size(); ++i) {
+            currentPath += delimiter;
+            currentPath += names[i];
+            if (i == names.size() - 1) {
+                parent->appendChild(names[i], currentPath);
+                break;
+            }
+            TreeItem* folder = folders.value(currentPath);
+            if (!folder) {
+                folder = parent->appendChild(names[i], currentPath);
+                folders.insert(currentPath, folder);
+            }
+            parent = folder;
+        }
+    }
+    return rootItem;
+}
+
 void TraktorFeature::parseTrack(QXmlStreamReader &xml, QSqlQuery &query) {
     QString title;
     QString artist;
@@ -374,6 +429,11 @@ void TraktorFeature::parseTrack(QXmlStreamReader &xml, QSqlQuery &query) {
                  << __LINE__ << " " << query.lastError();
         return;
     }
+    // Playlist entries refer to tracks by location. Looking them up in
+    // memory is much faster than querying the unindexed location column.
+    if (!m_trackIdsByLocation.contains(location)) {
+        m_trackIdsByLocation.insert(location, query.lastInsertId().toInt());
+    }
 }
 
 // Purpose: Parsing all the folder and playlists of Traktor
@@ -505,19 +565,7 @@ void TraktorFeature::parsePlaylistEntries(
                     #endif
 
                     //insert to database
-                    int track_id = -1;
-                    QSqlQuery finder_query(m_database);
-                    finder_query.prepare("select id from traktor_library where location=:path");
-                    finder_query.bindValue(":path", key);
-
-                    if (!finder_query.exec()) {
-                        LOG_FAILED_QUERY(finder_query) << "Could not get track id:" << key;
-                        continue;
-                    }
-
-                    if (finder_query.next()) {
-                        track_id = finder_query.value(finder_query.record().indexOf("id")).toInt();
-                    }
+                    const int track_id = m_trackIdsByLocation.value(key, -1);
 
                     query_insert_into_playlisttracks.bindValue(":playlist_id", playlist_id);
                     query_insert_into_playlisttracks.bindValue(":track_id", track_id);
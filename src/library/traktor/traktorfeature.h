@@ -4,6 +4,7 @@
 #ifndef TRAKTOR_FEATURE_H
 #define TRAKTOR_FEATURE_H
 
+#include <QHash>
 #include <QStringListModel>
 #include <QtSql>
 #include <QXmlStreamReader>
@@ -53,6 +54,8 @@ class TraktorFeature : public BaseExternalLibraryFeature {
   private:
     virtual BaseSqlTableModel* getPlaylistModelForPlaylist(QString playlist);
     TreeItem* importLibrary(QString file);
+    // builds the childmodel from a previous import
+    TreeItem* loadPlaylists();
     // parses a track in the music collection
     void parseTrack(QXmlStreamReader &xml, QSqlQuery &query);
     // Iterates over all playliost and folders and constructs the childmodel
@@ -69,6 +72,9 @@ class TraktorFeature : public BaseExternalLibraryFeature {
     TraktorTrackModel* m_pTraktorTableModel;
     TraktorPlaylistModel* m_pTraktorPlaylistModel;
 
+    // Ids of the imported tracks, only accessed by the import
+    QHash<QString, int> m_trackIdsByLocation;
+
     bool m_isActivated;
     bool m_cancelImport;
     QFutureWatcher<TreeItem*> m_future_watcher;
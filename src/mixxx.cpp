@@ -59,6 +59,7 @@
 #include "waveform/visualsmanager.h"
 #include "waveform/sharedglcontext.h"
 #include "database/mixxxdb.h"
+#include "util/callbacktrace.h"
 #include "util/debug.h"
 #include "util/statsmanager.h"
 #include "util/timer.h"
@@ -175,6 +176,9 @@ MixxxMainWindow::MixxxMainWindow(QApplication* pApp, const CmdlineArgs& args)
     // Only record stats in developer mode.
     if (m_cmdLineArgs.getDeveloper()) {
         StatsManager::createInstance();
+        // Stages are registered while the engine is set up, so this needs
+        // to happen before the engine is created.
+        CallbackTrace::enable();
     }
 
     m_pSettingsManager = new SettingsManager(this, args.getSettingsPath());
@@ -262,7 +266,7 @@ void MixxxMainWindow::initialize(QApplication* pApp, const CmdlineArgs& args) {
     BuiltInBackend* pBuiltInBackend = new BuiltInBackend(m_pEffectsManager);
     m_pEffectsManager->addEffectsBackend(pBuiltInBackend);
 #ifdef __LILV__
-    LV2Backend* pLV2Backend = new LV2Backend(m_pEffectsManager);
+    LV2Backend* pLV2Backend = new LV2Backend(m_pEffectsManager, pConfig);
     m_pEffectsManager->addEffectsBackend(pLV2Backend);
 #else
     LV2Backend* pLV2Backend = nullptr;
@@ -345,7 +349,10 @@ void MixxxMainWindow::initialize(QApplication* pApp, const CmdlineArgs& args) {
     delete pModplugPrefs; // not needed anymore
 #endif
 
-    CoverArtCache::createInstance();
+    CoverArtCache* pCoverArtCache = CoverArtCache::createInstance();
+    pCoverArtCache->setPrefetchRows(pConfig->getValue<int>(
+            ConfigKey("[Library]", "CoverArtPrefetchRows"),
+            CoverArtCache::kDefaultPrefetchRows));
 
     launchProgress(30);
 
@@ -29,6 +29,20 @@ namespace
 // --kain88 July 2012
 const SINT kFingerprintDuration = 120; // in seconds
 
+QString encodeFingerprint(uint32_p fprint, int size) {
+    char_p encoded = NULL;
+    int encoded_size = 0;
+    chromaprint_encode_fingerprint(fprint, size,
+                                   CHROMAPRINT_ALGORITHM_DEFAULT,
+                                   &encoded,
+                                   &encoded_size, 1);
+
+    QByteArray fingerprint;
+    fingerprint.append(reinterpret_cast<char*>(encoded), encoded_size);
+    chromaprint_dealloc(encoded);
+    return fingerprint;
+}
+
 QString calcFingerprint(
         mixxx::AudioSourceStereoProxy& audioSourceProxy,
         mixxx::IndexRange fingerprintRange) {
@@ -75,19 +89,10 @@ QString calcFingerprint(
     uint32_p fprint = NULL;
     int size = 0;
     int ret = chromaprint_get_raw_fingerprint(ctx, &fprint, &size);
-    QByteArray fingerprint;
+    QString fingerprint;
     if (ret == 1) {
-        char_p encoded = NULL;
-        int encoded_size = 0;
-        chromaprint_encode_fingerprint(fprint, size,
-                                       CHROMAPRINT_ALGORITHM_DEFAULT,
-                                       &encoded,
-                                       &encoded_size, 1);
-
-        fingerprint.append(reinterpret_cast<char*>(encoded), encoded_size);
-
+        fingerprint = encodeFingerprint(fprint, size);
         chromaprint_dealloc(fprint);
-        chromaprint_dealloc(encoded);
     }
     chromaprint_free(ctx);
 
@@ -125,3 +130,13 @@ QString ChromaPrinter::getFingerprint(TrackPointer pTrack) {
 
     return calcFingerprint(audioSourceProxy, fingerprintRange);
 }
+
+QString ChromaPrinter::getFingerprint(const mixxx::Fingerprint& fingerprint) {
+    if (fingerprint.isEmpty()) {
+        return QString();
+    }
+    // The raw fingerprint is only read by the encoder
+    return encodeFingerprint(
+            const_cast<quint32*>(fingerprint.values().constData()),
+            fingerprint.size());
+}
@@ -3,6 +3,7 @@
 
 #include <QObject>
 
+#include "track/fingerprint.h"
 #include "track/track.h"
 
 class ChromaPrinter: public QObject {
@@ -11,6 +12,9 @@ class ChromaPrinter: public QObject {
 public:
       explicit ChromaPrinter(QObject* parent = NULL);
       QString getFingerprint(TrackPointer pTrack);
+      // Encodes a fingerprint that has been calculated during the
+      // analysis without decoding the track again
+      QString getFingerprint(const mixxx::Fingerprint& fingerprint);
 };
 
 #endif //CHROMAPRINTER_H
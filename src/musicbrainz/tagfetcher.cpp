@@ -35,13 +35,22 @@ QString TagFetcher::getFingerprint(const TrackPointer tio) {
     return ChromaPrinter(NULL).getFingerprint(tio);
 }
 
-void TagFetcher::startFetch(const TrackPointer track) {
+void TagFetcher::startFetch(
+        const TrackPointer track,
+        const mixxx::Fingerprint& fingerprint) {
     cancel();
     // qDebug() << "start to fetch track metadata";
     QList<TrackPointer> tracks;
     tracks.append(track);
     m_tracks = tracks;
 
+    if (!fingerprint.isEmpty()) {
+        // The fingerprint from the analysis is reused instead of
+        // decoding the track again
+        lookupFingerprint(0, ChromaPrinter(NULL).getFingerprint(fingerprint));
+        return;
+    }
+
     QFuture<QString> future = QtConcurrent::mapped(m_tracks, getFingerprint);
     m_pFingerprintWatcher = new QFutureWatcher<QString>(this);
     m_pFingerprintWatcher->setFuture(future);
@@ -71,7 +80,10 @@ void TagFetcher::fingerprintFound(int index) {
         return;
     }
 
-    const QString fingerprint = watcher->resultAt(index);
+    lookupFingerprint(index, watcher->resultAt(index));
+}
+
+void TagFetcher::lookupFingerprint(int index, const QString& fingerprint) {
     const TrackPointer ptrack = m_tracks[index];
 
     if (fingerprint.isEmpty()) {
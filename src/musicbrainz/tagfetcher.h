@@ -15,6 +15,7 @@
 
 #include "musicbrainz/musicbrainzclient.h"
 #include "musicbrainz/acoustidclient.h"
+#include "track/fingerprint.h"
 #include "track/track.h"
 
 
@@ -27,7 +28,10 @@ class TagFetcher : public QObject {
   public:
     TagFetcher(QObject* parent = 0);
 
-    void startFetch(const TrackPointer track);
+    // The fingerprint is calculated from the track if none is provided
+    void startFetch(
+            const TrackPointer track,
+            const mixxx::Fingerprint& fingerprint = mixxx::Fingerprint());
 
   public slots:
     void cancel();
@@ -44,6 +48,8 @@ class TagFetcher : public QObject {
     void tagsFetched(int index, const MusicBrainzClient::ResultList& result);
 
   private:
+    void lookupFingerprint(int index, const QString& fingerprint);
+
     // has to be static so we can call it with QtConcurrent and have a nice
     // responsive UI while the fingerprint is calculated
     static QString getFingerprint(const TrackPointer tio);
@@ -29,6 +29,16 @@ DlgPrefAutoDJ::DlgPrefAutoDJ(QWidget* pParent,
     connect(autoDjIgnoreTimeEdit, SIGNAL(timeChanged(const QTime &)), this,
             SLOT(slotSetAutoDjIgnoreTime(const QTime &)));
 
+    // Prefer less played tracks among the randomly-selected tracks
+    autoDjWeightedRandomCheckBox->setChecked(
+            m_pConfig->getValue(
+                    ConfigKey("[Auto DJ]", "WeightedRandom"), false));
+    m_pConfig->setValue(ConfigKey("[Auto DJ]", "WeightedRandomBuff"),
+            m_pConfig->getValue(
+                    ConfigKey("[Auto DJ]", "WeightedRandom"), 0));
+    connect(autoDjWeightedRandomCheckBox, SIGNAL(stateChanged(int)), this,
+            SLOT(slotSetAutoDjWeightedRandom(int)));
+
     // Auto DJ random enqueue
     ComboBoxAutoDjRandomQueue->addItem(tr("Off"));
     ComboBoxAutoDjRandomQueue->addItem(tr("On"));
@@ -69,6 +79,9 @@ void DlgPrefAutoDJ::slotApply() {
     m_pConfig->setValue(ConfigKey("[Auto DJ]", "UseIgnoreTime"),
             m_pConfig->getValue(
                     ConfigKey("[Auto DJ]", "UseIgnoreTimeBuff"), "0"));
+    m_pConfig->setValue(ConfigKey("[Auto DJ]", "WeightedRandom"),
+            m_pConfig->getValue(
+                    ConfigKey("[Auto DJ]", "WeightedRandomBuff"), "0"));
 
     m_pConfig->setValue(ConfigKey("[Auto DJ]", "RandomQueueMinimumAllowed"),
             m_pConfig->getValue(
@@ -97,6 +110,12 @@ void DlgPrefAutoDJ::slotCancel() {
     m_pConfig->setValue(ConfigKey("[Auto DJ]", "UseIgnoreTimeBuff"),
             m_pConfig->getValue(
                     ConfigKey("[Auto DJ]", "UseIgnoreTime"), 0));
+    autoDjWeightedRandomCheckBox->setChecked(
+            m_pConfig->getValue(
+                    ConfigKey("[Auto DJ]", "WeightedRandom"), false));
+    m_pConfig->setValue(ConfigKey("[Auto DJ]", "WeightedRandomBuff"),
+            m_pConfig->getValue(
+                    ConfigKey("[Auto DJ]", "WeightedRandom"), 0));
 
     autoDJRandomQueueMinimumSpinBox->setValue(
             m_pConfig->getValue(
@@ -123,6 +142,8 @@ void DlgPrefAutoDJ::slotResetToDefaults() {
     autoDjIgnoreTimeCheckBox->setChecked(false);
     m_pConfig->set(ConfigKey("[Auto DJ]", "UseIgnoreTimeBuff"),QString("0"));
     autoDjIgnoreTimeEdit->setEnabled(false);
+    autoDjWeightedRandomCheckBox->setChecked(false);
+    m_pConfig->set(ConfigKey("[Auto DJ]", "WeightedRandomBuff"),QString("0"));
 
     autoDJRandomQueueMinimumSpinBox->setValue(5);
     ComboBoxAutoDjRandomQueue->setCurrentIndex(0);
@@ -149,6 +170,11 @@ void DlgPrefAutoDJ::slotSetAutoDjIgnoreTime(const QTime &a_rTime) {
     m_pConfig->set(ConfigKey("[Auto DJ]", "IgnoreTimeBuff"),str);
 }
 
+void DlgPrefAutoDJ::slotSetAutoDjWeightedRandom(int a_iState) {
+    QString strChecked = (a_iState == Qt::Checked) ? "1" : "0";
+    m_pConfig->set(ConfigKey("[Auto DJ]", "WeightedRandomBuff"), strChecked);
+}
+
 void DlgPrefAutoDJ::slotSetAutoDJRandomQueueMin(int a_iValue) {
     QString str;
     //qDebug() << "min allowed " << a_iValue;
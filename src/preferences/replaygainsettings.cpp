@@ -90,12 +90,16 @@ bool ReplayGainSettings::isAnalyzerEnabled(int version) const {
 
 bool ReplayGainSettings::isAnalyzerDisabled(int version, TrackPointer tio) const {
     if (isAnalyzerEnabled(version)) {
-        if (getReplayGainReanalyze()) {
-            // ignore stored replay gain
-            return false;
-        }
-        return tio->getReplayGain().hasRatio();
+        return isTrackAnalyzed(tio);
     }
     // not enabled, pretend we have already a stored value.
     return true;
 }
+
+bool ReplayGainSettings::isTrackAnalyzed(TrackPointer tio) const {
+    if (getReplayGainReanalyze()) {
+        // ignore stored replay gain
+        return false;
+    }
+    return tio->getReplayGain().hasRatio();
+}
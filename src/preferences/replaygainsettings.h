@@ -23,6 +23,9 @@ class ReplayGainSettings {
 
     bool isAnalyzerEnabled(int version) const;
     bool isAnalyzerDisabled(int version, TrackPointer tio) const;
+    // Whether the ReplayGain of the track has already been analyzed and
+    // should not be analyzed again
+    bool isTrackAnalyzed(TrackPointer tio) const;
 
   private:
     // Pointer to config object
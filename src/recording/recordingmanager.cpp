@@ -51,6 +51,8 @@ RecordingManager::RecordingManager(UserSettingsPointer pConfig, EngineMaster* pE
         EngineRecord* pEngineRecord = new EngineRecord(m_pConfig);
         connect(pEngineRecord, SIGNAL(isRecording(bool, bool)),
                 this, SLOT(slotIsRecording(bool, bool)));
+        connect(pEngineRecord, SIGNAL(writeFailed(QString)),
+                this, SLOT(slotWriteFailed(QString)));
         connect(pEngineRecord, SIGNAL(bytesRecorded(int)),
                 this, SLOT(slotBytesRecorded(int)));
         connect(pEngineRecord, SIGNAL(durationRecorded(quint64)),
@@ -292,6 +294,17 @@ void RecordingManager::slotIsRecording(bool isRecordingActive, bool error) {
     }
 }
 
+void RecordingManager::slotWriteFailed(QString fileName) {
+    ErrorDialogProperties* props = ErrorDialogHandler::instance()->newDialogProperties();
+    props->setType(DLG_WARNING);
+    props->setTitle(tr("Recording"));
+    props->setText("<html>"+tr("Recording has been stopped because writing to the audio file failed:")
+                   +"<p>"+fileName
+                   +"<p>"+tr("Ensure there is enough free disk space and you have write permission for the Recordings folder.")
+                   +"</p></html>");
+    ErrorDialogHandler::instance()->requestErrorDialog(props);
+}
+
 bool RecordingManager::isRecordingActive() const {
     return m_bRecording;
 }
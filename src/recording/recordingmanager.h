@@ -59,6 +59,7 @@ class RecordingManager : public QObject
 
   private slots:
     void slotToggleRecording(double v);
+    void slotWriteFailed(QString fileName);
 
   private:
     QString formatDateTimeForFilename(QDateTime dateTime) const;
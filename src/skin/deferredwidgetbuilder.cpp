@@ -0,0 +1,33 @@
+#include "skin/deferredwidgetbuilder.h"
+
+#include <QEvent>
+
+DeferredWidgetBuilder::DeferredWidgetBuilder(QWidget* pWidget,
+                                             std::function<void()> build)
+        : QObject(pWidget),
+          m_pWidget(pWidget),
+          m_build(std::move(build)) {
+    m_pWidget->installEventFilter(this);
+}
+
+bool DeferredWidgetBuilder::eventFilter(QObject* pObject, QEvent* pEvent) {
+    if (pObject == m_pWidget && pEvent->type() == QEvent::Show && m_build) {
+        m_pWidget->removeEventFilter(this);
+        std::function<void()> build = std::move(m_build);
+        m_build = nullptr;
+        build();
+
+        // Qt shows the children of a widget before it sends the show event,
+        // so the children we just created need to be shown explicitly.
+        const QList<QWidget*> children = m_pWidget->findChildren<QWidget*>(
+                QString(), Qt::FindDirectChildrenOnly);
+        for (QWidget* pChild : children) {
+            if (!pChild->isWindow() &&
+                    !pChild->testAttribute(Qt::WA_WState_ExplicitShowHide)) {
+                pChild->show();
+            }
+        }
+        deleteLater();
+    }
+    return QObject::eventFilter(pObject, pEvent);
+}
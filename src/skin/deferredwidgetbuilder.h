@@ -0,0 +1,25 @@
+#ifndef DEFERREDWIDGETBUILDER_H
+#define DEFERREDWIDGETBUILDER_H
+
+#include <functional>
+
+#include <QObject>
+#include <QWidget>
+
+// Runs a function the first time a widget is shown and then removes itself.
+// LegacySkinParser uses it to create the children of widgets that are hidden
+// when the skin is loaded only when they are needed.
+class DeferredWidgetBuilder : public QObject {
+    Q_OBJECT
+  public:
+    // The builder is owned by pWidget.
+    DeferredWidgetBuilder(QWidget* pWidget, std::function<void()> build);
+
+    bool eventFilter(QObject* pObject, QEvent* pEvent) override;
+
+  private:
+    QWidget* m_pWidget;
+    std::function<void()> m_build;
+};
+
+#endif /* DEFERREDWIDGETBUILDER_H */
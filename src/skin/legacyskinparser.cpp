@@ -3,10 +3,13 @@
 
 #include "skin/legacyskinparser.h"
 
+#include <algorithm>
+
 #include <QDir>
 #include <QGridLayout>
 #include <QLabel>
 #include <QMutexLocker>
+#include <QPair>
 #include <QSplitter>
 #include <QStackedWidget>
 #include <QVBoxLayout>
@@ -25,6 +28,7 @@
 #include "controllers/controllermanager.h"
 
 #include "skin/colorschemeparser.h"
+#include "skin/deferredwidgetbuilder.h"
 #include "skin/skincontext.h"
 #include "skin/launchimage.h"
 
@@ -84,6 +88,7 @@
 #include "widget/wsingletoncontainer.h"
 #include "util/valuetransformer.h"
 #include "util/cmdlineargs.h"
+#include "util/performancetimer.h"
 #include "util/timer.h"
 
 using mixxx::skin::SkinManifest;
@@ -150,7 +155,9 @@ LegacySkinParser::LegacySkinParser(UserSettingsPointer pConfig)
           m_pVCManager(NULL),
           m_pEffectsManager(NULL),
           m_pRecordingManager(NULL),
-          m_pParent(NULL) {
+          m_pParent(NULL),
+          m_bLazyConstruction(false),
+          m_pendingDeferredCount(0) {
 }
 
 LegacySkinParser::LegacySkinParser(UserSettingsPointer pConfig,
@@ -169,7 +176,9 @@ LegacySkinParser::LegacySkinParser(UserSettingsPointer pConfig,
           m_pVCManager(pVCMan),
           m_pEffectsManager(pEffectsManager),
           m_pRecordingManager(pRecordingManager),
-          m_pParent(NULL) {
+          m_pParent(NULL),
+          m_bLazyConstruction(false),
+          m_pendingDeferredCount(0) {
 }
 
 LegacySkinParser::~LegacySkinParser() {
@@ -400,6 +409,7 @@ QWidget* LegacySkinParser::parseSkin(const QString& skinPath, QWidget* pParent)
     foreach(ControlObject* pControl, created_attributes) {
         pControl->setParent(widgets[0]);
     }
+    logSectionTimings();
     return widgets[0];
 }
 
@@ -663,7 +673,18 @@ QWidget* LegacySkinParser::parseWidgetGroup(const QDomElement& node) {
     commonWidgetSetup(node, pGroup);
     pGroup->setup(node, *m_pContext);
     pGroup->Init();
-    parseChildren(node, pGroup);
+    if (m_bLazyConstruction && pGroup->isHidden() &&
+            pGroup->testAttribute(Qt::WA_WState_ExplicitShowHide)) {
+        // The group has been hidden by one of its connections, e.g. a
+        // collapsed sampler bank or effect unit. Create the children when the
+        // group is shown.
+        deferUntilShown(pGroup, "WidgetGroup " + pGroup->objectName(),
+                [this, node, pGroup] {
+                    parseChildren(node, pGroup);
+                });
+    } else {
+        parseChildren(node, pGroup);
+    }
     return pGroup;
 }
 
@@ -719,6 +740,13 @@ QWidget* LegacySkinParser::parseWidgetStack(const QDomElement& node) {
     QWidget* pOldParent = m_pParent;
     m_pParent = pStack;
 
+    // If lazy construction is enabled, only the pages that may be shown
+    // first are created right away: the current page and the pages whose
+    // trigger control is set. WWidgetStack selects one of them, depending on
+    // whether the stack is visible yet.
+    const int currentPage = pCurrentPageControl != nullptr ?
+            static_cast<int>(pCurrentPageControl->get()) : 0;
+
     QDomNode childrenNode = m_pContext->selectNode(node, "Children");
     if (!childrenNode.isNull()) {
         // Descend chilren
@@ -732,36 +760,63 @@ QWidget* LegacySkinParser::parseWidgetStack(const QDomElement& node) {
             }
             QDomElement element = node.toElement();
 
-            QList<QWidget*> child_widgets = parseNode(element);
-
-            if (child_widgets.empty()) {
-                SKIN_WARNING(node, *m_pContext)
-                        << "WidgetStack child produced no widget.";
-                continue;
+            ControlObject* pControl = NULL;
+            bool createdControl = false;
+            QString trigger_configkey = element.attribute("trigger");
+            if (trigger_configkey.length() > 0) {
+                ConfigKey configKey = ConfigKey::parseCommaSeparated(trigger_configkey);
+                pControl = controlFromConfigKey(configKey, false, &createdControl);
             }
 
-            if (child_widgets.size() > 1) {
-                SKIN_WARNING(node, *m_pContext)
-                        << "WidgetStack child produced multiple widgets."
-                        << "All but the first are ignored.";
+            QWidget* pChild = NULL;
+            if (m_bLazyConstruction && pStack->count() != currentPage &&
+                    (pControl == nullptr || pControl->get() <= 0.0) &&
+                    element.nodeName() != "SetVariable") {
+                // Add an empty page that hosts the real page once it is
+                // shown.
+                pChild = new QWidget(pStack);
+                QVBoxLayout* pLayout = new QVBoxLayout(pChild);
+                pLayout->setContentsMargins(0, 0, 0, 0);
+                pLayout->setSpacing(0);
+                deferUntilShown(pChild, "WidgetStack page " + pStack->objectName(),
+                        [this, element, pChild] {
+                            m_pParent = pChild;
+                            QList<QWidget*> child_widgets = parseNode(element);
+                            if (child_widgets.empty() || child_widgets[0] == NULL) {
+                                SKIN_WARNING(element, *m_pContext)
+                                        << "WidgetStack child produced no widget.";
+                                return;
+                            }
+                            pChild->layout()->addWidget(child_widgets[0]);
+                            pChild->setSizePolicy(child_widgets[0]->sizePolicy());
+                        });
+            } else {
+                QList<QWidget*> child_widgets = parseNode(element);
+
+                if (child_widgets.empty()) {
+                    SKIN_WARNING(node, *m_pContext)
+                            << "WidgetStack child produced no widget.";
+                } else {
+                    if (child_widgets.size() > 1) {
+                        SKIN_WARNING(node, *m_pContext)
+                                << "WidgetStack child produced multiple widgets."
+                                << "All but the first are ignored.";
+                    }
+                    pChild = child_widgets[0];
+                }
             }
-            QWidget* pChild = child_widgets[0];
 
             if (pChild == NULL) {
+                if (createdControl) {
+                    delete pControl;
+                }
                 continue;
             }
 
-            ControlObject* pControl = NULL;
-            QString trigger_configkey = element.attribute("trigger");
-            if (trigger_configkey.length() > 0) {
-                ConfigKey configKey = ConfigKey::parseCommaSeparated(trigger_configkey);
-                bool created;
-                pControl = controlFromConfigKey(configKey, false, &created);
-                if (pControl != nullptr && created) {
-                    // If we created the control, parent it to the child widget so
-                    // it doesn't leak.
-                    pControl->setParent(pChild);
-                }
+            if (pControl != nullptr && createdControl) {
+                // If we created the control, parent it to the child widget so
+                // it doesn't leak.
+                pControl->setParent(pChild);
             }
             int on_hide_select = -1;
             QString on_hide_attr = element.attribute("on_hide_select");
@@ -1502,6 +1557,8 @@ QList<QWidget*> LegacySkinParser::parseTemplate(const QDomElement& node) {
     }
 
     QString path = node.attribute("src");
+    PerformanceTimer timer;
+    timer.start();
 
     std::unique_ptr<SkinContext> pOldContext = std::move(m_pContext);
     m_pContext = std::make_unique<SkinContext>(*pOldContext);
@@ -1535,6 +1592,7 @@ QList<QWidget*> LegacySkinParser::parseTemplate(const QDomElement& node) {
     }
 
     m_pContext = std::move(pOldContext);
+    addSectionTime(path, timer.elapsed());
 
     if (sDebug) {
         qDebug() << "END TEMPLATE" << path;
@@ -1542,6 +1600,74 @@ QList<QWidget*> LegacySkinParser::parseTemplate(const QDomElement& node) {
     return widgets;
 }
 
+void LegacySkinParser::deferUntilShown(QWidget* pWidget, const QString& section,
+                                       std::function<void()> parse) {
+    DeferredScope scope;
+    scope.variables = m_pContext->variables();
+    scope.xmlPath = m_pContext->getXmlPath();
+    scope.searchPaths = QDir::searchPaths("skin");
+    ++m_pendingDeferredCount;
+    new DeferredWidgetBuilder(pWidget, [this, scope, section, parse] {
+        parseDeferred(scope, section, parse);
+    });
+}
+
+void LegacySkinParser::parseDeferred(const DeferredScope& scope,
+                                     const QString& section,
+                                     const std::function<void()>& parse) {
+    PerformanceTimer timer;
+    timer.start();
+    --m_pendingDeferredCount;
+
+    // Recreate the scope of the deferred node in a child context, the
+    // contexts of the enclosing templates are gone by now.
+    QWidget* pOldParent = m_pParent;
+    const QStringList oldSearchPaths = QDir::searchPaths("skin");
+    std::unique_ptr<SkinContext> pOldContext = std::move(m_pContext);
+    m_pContext = std::make_unique<SkinContext>(*pOldContext);
+    for (auto it = scope.variables.constBegin();
+            it != scope.variables.constEnd(); ++it) {
+        m_pContext->setVariable(it.key(), it.value());
+    }
+    m_pContext->setXmlPath(scope.xmlPath);
+    QDir::setSearchPaths("skin", scope.searchPaths);
+
+    parse();
+
+    QDir::setSearchPaths("skin", oldSearchPaths);
+    m_pContext = std::move(pOldContext);
+    m_pParent = pOldParent;
+
+    addSectionTime("(deferred) " + section, timer.elapsed());
+}
+
+void LegacySkinParser::addSectionTime(const QString& section,
+                                      mixxx::Duration elapsed) {
+    SectionTiming& timing = m_sectionTimings[section];
+    ++timing.count;
+    timing.totalNanos += elapsed.toIntegerNanos();
+}
+
+void LegacySkinParser::logSectionTimings() const {
+    QList<QPair<qint64, QString>> sections;
+    for (auto it = m_sectionTimings.constBegin();
+            it != m_sectionTimings.constEnd(); ++it) {
+        sections.append(qMakePair(it.value().totalNanos, it.key()));
+    }
+    std::sort(sections.begin(), sections.end());
+    qDebug() << "LegacySkinParser: skin section timings"
+             << "(templates include their nested templates):";
+    for (int i = sections.size() - 1; i >= 0; --i) {
+        const SectionTiming timing = m_sectionTimings.value(sections[i].second);
+        qDebug().noquote() << QString("  %1 ms  %2x  %3")
+                .arg(timing.totalNanos / 1e6, 9, 'f', 2)
+                .arg(timing.count, 4)
+                .arg(sections[i].second);
+    }
+    qDebug() << "LegacySkinParser:" << m_pendingDeferredCount
+             << "subtrees deferred until shown";
+}
+
 QString LegacySkinParser::lookupNodeGroup(const QDomElement& node) {
     QString group = m_pContext->selectString(node, "Group");
 
@@ -1,10 +1,14 @@
 #ifndef LEGACYSKINPARSER_H
 #define LEGACYSKINPARSER_H
 
+#include <functional>
+
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QList>
 #include <QDomElement>
+#include <QHash>
 #include <QMutex>
 
 #include "preferences/usersettings.h"
@@ -12,6 +16,7 @@
 #include "vinylcontrol/vinylcontrolmanager.h"
 #include "skin/tooltips.h"
 #include "proto/skin.pb.h"
+#include "util/duration.h"
 #include "util/memory.h"
 
 class WBaseWidget;
@@ -44,6 +49,22 @@ class LegacySkinParser : public QObject, public SkinParser {
 
     LaunchImage* parseLaunchImage(const QString& skinPath, QWidget* pParent);
 
+    // If enabled, hidden WidgetStack pages and WidgetGroups that are hidden
+    // by a <Connection> are only created when they are shown for the first
+    // time. The parser must then outlive the widgets returned by
+    // parseSkin(), e.g. by parenting it to the skin. Disabled by default,
+    // because the controls that the skin creates within these subtrees do
+    // not exist until they are shown, so controller mappings can't use them
+    // before.
+    void setLazyConstruction(bool lazy) {
+        m_bLazyConstruction = lazy;
+    }
+    // Returns the number of subtrees whose creation has been deferred and
+    // that have not been created yet.
+    int pendingDeferredCount() const {
+        return m_pendingDeferredCount;
+    }
+
     // Legacy support for looking up the scheme list.
     static QList<QString> getSchemeList(const QString& qSkinPath);
     // Parse a skin manifest from the provided skin document root.
@@ -137,6 +158,31 @@ class LegacySkinParser : public QObject, public SkinParser {
     QString parseLaunchImageStyle(const QDomNode& node);
     void parseChildren(const QDomElement& node, WWidgetGroup* pGroup);
 
+    // What is needed to parse a node outside of its enclosing templates.
+    struct DeferredScope {
+        QHash<QString, QString> variables;
+        QString xmlPath;
+        QStringList searchPaths;
+    };
+    // Runs parse the first time pWidget is shown, in the scope that is
+    // current now.
+    void deferUntilShown(QWidget* pWidget, const QString& section,
+                         std::function<void()> parse);
+    void parseDeferred(const DeferredScope& scope, const QString& section,
+                       const std::function<void()>& parse);
+
+    // Startup timing report, broken down by template.
+    struct SectionTiming {
+        SectionTiming()
+                : count(0),
+                  totalNanos(0) {
+        }
+        int count;
+        qint64 totalNanos;
+    };
+    void addSectionTime(const QString& section, mixxx::Duration elapsed);
+    void logSectionTimings() const;
+
     UserSettingsPointer m_pConfig;
     KeyboardEventFilter* m_pKeyboard;
     PlayerManager* m_pPlayerManager;
@@ -150,6 +196,9 @@ class LegacySkinParser : public QObject, public SkinParser {
     QString m_style;
     Tooltips m_tooltips;
     QHash<QString, QDomElement> m_templateCache;
+    bool m_bLazyConstruction;
+    int m_pendingDeferredCount;
+    QHash<QString, SectionTiming> m_sectionTimings;
     static QList<const char*> s_channelStrs;
     static QMutex s_safeStringMutex;
 };
@@ -64,6 +64,9 @@ class SkinContext {
     }
     void setVariable(const QString& name, const QString& value);
     void setXmlPath(const QString& xmlPath);
+    const QString& getXmlPath() const {
+        return m_xmlPath;
+    }
 
     // Returns whether the node has a <SetVariable> node.
     bool hasVariableUpdates(const QDomNode& node) const;
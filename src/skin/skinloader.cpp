@@ -122,10 +122,22 @@ QWidget* SkinLoader::loadConfiguredSkin(QWidget* pParent,
         return NULL;
     }
 
-    LegacySkinParser legacy(m_pConfig, pKeyboard, pPlayerManager,
-                            pControllerManager, pLibrary, pVCMan,
-                            pEffectsManager, pRecordingManager);
-    return legacy.parseSkin(skinPath, pParent);
+    LegacySkinParser* pLegacy = new LegacySkinParser(m_pConfig, pKeyboard,
+            pPlayerManager, pControllerManager, pLibrary, pVCMan,
+            pEffectsManager, pRecordingManager);
+    // Optionally, hidden parts of the skin are created when they are shown
+    // first. See LegacySkinParser::setLazyConstruction().
+    pLegacy->setLazyConstruction(
+            m_pConfig->getValue(ConfigKey("[Config]", "LazySkinLoading"), false));
+    QWidget* pSkin = pLegacy->parseSkin(skinPath, pParent);
+    if (pSkin != nullptr && pLegacy->pendingDeferredCount() > 0) {
+        // The parser creates the deferred widgets, keep it as long as the
+        // skin exists.
+        pLegacy->setParent(pSkin);
+    } else {
+        delete pLegacy;
+    }
+    return pSkin;
 }
 
 LaunchImage* SkinLoader::loadLaunchImage(QWidget* pParent) {
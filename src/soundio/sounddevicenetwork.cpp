@@ -42,6 +42,12 @@ SoundDeviceNetwork::SoundDeviceNetwork(UserSettingsPointer config,
     m_hostAPI = "Network stream";
     m_dSampleRate = 44100.0;
     m_deviceId.name = kNetworkDeviceInternalName;
+    m_callbackTraceTag = TraceTag(
+            QString("SoundDeviceNetwork::callbackProcessClkRef %1")
+                    .arg(m_deviceId.name));
+    m_prepareTimerTag = StatTag(
+            QString("SoundDevicePortAudio::callbackProcess prepare %1")
+                    .arg(m_deviceId.name));
     m_strDisplayName = QObject::tr("Network stream");
     m_iNumInputChannels = pNetworkStream->getNumInputChannels();
     m_iNumOutputChannels = pNetworkStream->getNumOutputChannels();
@@ -73,8 +79,7 @@ SoundDeviceError SoundDeviceNetwork::open(bool isClkRefDevice, int syncBuffers)
     // clock reference device callback
     // This is what should work best.
     if (m_iNumOutputChannels) {
-        m_outputFifo = std::make_unique<FIFO<CSAMPLE> >(
-                m_iNumOutputChannels * m_framesPerBuffer * 2);
+        m_pOutputRing = m_pNetworkStream->outputRing();
     }
     if (m_iNumInputChannels) {
         m_inputFifo = std::make_unique<FIFO<CSAMPLE> >(
@@ -106,7 +111,7 @@ SoundDeviceError SoundDeviceNetwork::open(bool isClkRefDevice, int syncBuffers)
 }
 
 bool SoundDeviceNetwork::isOpen() const {
-    return (m_inputFifo != NULL || m_outputFifo != NULL);
+    return (m_inputFifo != NULL || m_pOutputRing != NULL);
 }
 
 SoundDeviceError SoundDeviceNetwork::close() {
@@ -118,7 +123,7 @@ SoundDeviceError SoundDeviceNetwork::close() {
         m_pThread.reset();
     }
 
-    m_outputFifo.reset();
+    m_pOutputRing.reset();
     m_inputFifo.reset();
 
     return SOUNDDEVICE_ERROR_OK;
@@ -221,48 +226,29 @@ void SoundDeviceNetwork::readProcess() {
 }
 
 void SoundDeviceNetwork::writeProcess() {
-    if (!m_outputFifo || !m_pNetworkStream) return;
+    if (!m_pOutputRing || !m_pNetworkStream) return;
 
     int outChunkSize = m_framesPerBuffer * m_iNumOutputChannels;
-    int writeAvailable = m_outputFifo->writeAvailable();
-    int writeCount = outChunkSize;
-    if (outChunkSize > writeAvailable) {
-        writeCount = writeAvailable;
-        m_pSoundManager->underflowHappened(23);
-        //qDebug() << "writeProcess():" << (float) writeAvailable / outChunkSize << "Overflow";
-    }
-    //qDebug() << "writeProcess():" << (float) writeAvailable / outChunkSize;
-    if (writeCount > 0) {
-        CSAMPLE* dataPtr1;
-        ring_buffer_size_t size1;
-        CSAMPLE* dataPtr2;
-        ring_buffer_size_t size2;
-        // We use size1 and size2, so we can ignore the return value
-        (void)m_outputFifo->aquireWriteRegions(writeCount, &dataPtr1,
-                &size1, &dataPtr2, &size2);
-        // Fetch fresh samples and write to the the output buffer
-        composeOutputBuffer(dataPtr1, size1 / m_iNumOutputChannels, 0, m_iNumOutputChannels);
-        if (size2 > 0) {
-            composeOutputBuffer(dataPtr2,
-                    size2 / m_iNumOutputChannels,
-                    size1 / m_iNumOutputChannels,
-                    m_iNumOutputChannels);
-        }
-        m_outputFifo->releaseWriteRegions(writeCount);
-    }
-
-    int readAvailable = m_outputFifo->readAvailable();
-
     CSAMPLE* dataPtr1;
-    ring_buffer_size_t size1;
+    int size1;
     CSAMPLE* dataPtr2;
-    ring_buffer_size_t size2;
-    // Try to read as most frames as possible.
-    // NetworkStreamWorker::processWrite takes care of
-    // keeping every output worker in sync
-    m_outputFifo->aquireReadRegions(readAvailable,
+    int size2;
+    // The ring never waits for the workers, it drops the output of those
+    // that fall behind.
+    m_pOutputRing->acquireWriteRegions(outChunkSize,
             &dataPtr1, &size1, &dataPtr2, &size2);
+    // Fetch fresh samples and write to the the output buffer
+    composeOutputBuffer(dataPtr1, size1 / m_iNumOutputChannels, 0, m_iNumOutputChannels);
+    if (size2 > 0) {
+        composeOutputBuffer(dataPtr2,
+                size2 / m_iNumOutputChannels,
+                size1 / m_iNumOutputChannels,
+                m_iNumOutputChannels);
+    }
+    m_pOutputRing->commitWrite(outChunkSize);
 
+    // All workers read the same copy of the output in place.
+    // workerWriteProcess takes care of keeping every output worker in sync
     QVector<NetworkOutputStreamWorkerPtr> workers =
             m_pNetworkStream->outputWorkers();
     for(auto pWorker : workers) {
@@ -270,50 +256,45 @@ void SoundDeviceNetwork::writeProcess() {
             continue;
         }
 
-        workerWriteProcess(pWorker,
-                outChunkSize, readAvailable,
-                dataPtr1, size1,
-                dataPtr2, size2);
+        workerWriteProcess(pWorker, outChunkSize);
     }
-
-    m_outputFifo->releaseReadRegions(readAvailable);
 }
 
 void SoundDeviceNetwork::workerWriteProcess(NetworkOutputStreamWorkerPtr pWorker,
-        int outChunkSize, int readAvailable,
-        CSAMPLE* dataPtr1, ring_buffer_size_t size1,
-        CSAMPLE* dataPtr2, ring_buffer_size_t size2) {
+        int outChunkSize) {
     int writeExpected = static_cast<int>(pWorker->getStreamTimeFrames() - pWorker->framesWritten());
 
     int writeAvailable = writeExpected * m_iNumOutputChannels;
-    int copyCount = qMin(readAvailable, writeAvailable);
+    // The ring never holds back output for a worker: each callback hands
+    // over exactly the chunk just written, a worker that falls behind is
+    // caught up by its reader.
+    int copyCount = qMin(outChunkSize, writeAvailable);
 
     if (copyCount > 0) {
+        int skipFrames = 0;
         if (writeAvailable - copyCount > outChunkSize) {
             // Underflow
             //kLogger.debug() << "workerWriteProcess: buffer empty";
             // catch up by filling buffer until we are synced
-            workerWriteSilence(pWorker, writeAvailable - copyCount);
+            pWorker->insertSilence((writeAvailable - copyCount) / m_iNumOutputChannels);
             m_pSoundManager->underflowHappened(24);
         } else if (writeAvailable - copyCount > outChunkSize / 2) {
             // try to keep PAs buffer filled up to 0.5 chunks
             if (pWorker->outputDrift()) {
                 // duplicate one frame
                 //kLogger.debug() << "workerWriteProcess() duplicate one frame"
-                //                << (float)writeAvailable / outChunkSize << (float)readAvailable / outChunkSize;
-                workerWrite(pWorker, dataPtr1, 1);
+                //                << (float)writeAvailable / outChunkSize;
+                pWorker->duplicateFrame();
             } else {
                 pWorker->setOutputDrift(true);
             }
-        } else if (writeAvailable < outChunkSize / 2 ||
-                readAvailable > outChunkSize * 1.5
-           ) {
+        } else if (writeAvailable < outChunkSize / 2) {
             // We are not able to store at least the half of the new frames
-            // or we have a risk of an m_outputFifo overflow
             if (pWorker->outputDrift()) {
                 //kLogger.debug() << "SoundDeviceNetwork::workerWriteProcess() skip one frame"
-                //                << (float)writeAvailable / outChunkSize << (float)readAvailable / outChunkSize;
-                copyCount = qMin(readAvailable, copyCount + m_iNumOutputChannels);
+                //                << (float)writeAvailable / outChunkSize;
+                skipFrames = 1;
+                pWorker->skipOutput(skipFrames);
             } else {
                 pWorker->setOutputDrift(true);
             }
@@ -321,85 +302,13 @@ void SoundDeviceNetwork::workerWriteProcess(NetworkOutputStreamWorkerPtr pWorker
             pWorker->setOutputDrift(false);
         }
 
-        workerWrite(pWorker, dataPtr1, size1 / m_iNumOutputChannels);
-        if (size2 > 0) {
-            workerWrite(pWorker, dataPtr2, size2 / m_iNumOutputChannels);
-        }
-
-        QSharedPointer<FIFO<CSAMPLE>> pFifo = pWorker->getOutputFifo();
-        if (pFifo) {
-            // interval = copyCount
-            // Check for desired kNetworkLatencyFrames + 1/2 interval to
-            // avoid big jitter due to interferences with sync code
-            if (pFifo->readAvailable() + copyCount / 2
-                    >= (m_iNumOutputChannels * kNetworkLatencyFrames)) {
-                pWorker->outputAvailable();
-            }
-        }
-    }
-}
-
-void SoundDeviceNetwork::workerWrite(NetworkOutputStreamWorkerPtr pWorker,
-        const CSAMPLE* buffer, int frames) {
-    if (!pWorker->threadWaiting()) {
-        pWorker->addFramesWritten(frames);
-        return;
-    }
-
-    QSharedPointer<FIFO<CSAMPLE>> pFifo = pWorker->getOutputFifo();
-    if (pFifo) {
-        int writeAvailable = pFifo->writeAvailable();
-        int writeRequired = frames * m_iNumOutputChannels;
-        if (writeAvailable < writeRequired) {
-            kLogger.warning() << "write: worker buffer full, losing samples";
-            pWorker->incOverflowCount();
-        }
-
-        int copyCount = math_min(writeAvailable, writeRequired);
-        if (copyCount > 0) {
-            (void)pFifo->write(buffer, copyCount);
-            // we advance the frame only by the samples we have actually copied
-            // This means in case of buffer full (where we loose some frames)
-            // we do not get out of sync, and the syncing code tries to catch up the
-            // stream by writing silence, once the buffer is free.
-            pWorker->addFramesWritten(copyCount / m_iNumOutputChannels);
-        }
-    }
-}
-
-void SoundDeviceNetwork::workerWriteSilence(NetworkOutputStreamWorkerPtr pWorker, int frames) {
-    if (!pWorker->threadWaiting()) {
-        pWorker->addFramesWritten(frames);
-        return;
-    }
-
-    QSharedPointer<FIFO<CSAMPLE>> pFifo = pWorker->getOutputFifo();
-    if (pFifo) {
-        int writeAvailable = pFifo->writeAvailable();
-        int writeRequired = frames * m_iNumOutputChannels;
-        if (writeAvailable < writeRequired) {
-            kLogger.warning() << "writeSilence: worker buffer full, losing samples";
-            pWorker->incOverflowCount();
-        }
-
-        int clearCount = math_min(writeAvailable, writeRequired);
-        if (clearCount > 0) {
-            CSAMPLE* dataPtr1;
-            ring_buffer_size_t size1;
-            CSAMPLE* dataPtr2;
-            ring_buffer_size_t size2;
-
-            (void)pFifo->aquireWriteRegions(clearCount,
-                    &dataPtr1, &size1, &dataPtr2, &size2);
-            SampleUtil::clear(dataPtr1, size1);
-            if (size2 > 0) {
-                SampleUtil::clear(dataPtr2, size2);
-            }
-            pFifo->releaseWriteRegions(clearCount);
-
-            // we advance the frame only by the samples we have actually cleared
-            pWorker->addFramesWritten(clearCount / m_iNumOutputChannels);
-        }
+        pWorker->outputWritten(outChunkSize / m_iNumOutputChannels - skipFrames);
+        // interval = copyCount
+        pWorker->wakeIfOutputPending(kNetworkLatencyFrames,
+                copyCount / m_iNumOutputChannels);
+    } else {
+        // The stream is ahead of the clock of the worker
+        pWorker->skipOutput(outChunkSize / m_iNumOutputChannels);
     }
 }
 
@@ -407,8 +316,7 @@ void SoundDeviceNetwork::callbackProcessClkRef() {
     // This must be the very first call, to measure an exact value
     updateCallbackEntryToDacTime();
 
-    Trace trace("SoundDeviceNetwork::callbackProcessClkRef %1",
-                m_deviceId.name);
+    Trace trace(m_callbackTraceTag);
 
 
     if (!m_denormals) {
@@ -446,8 +354,7 @@ void SoundDeviceNetwork::callbackProcessClkRef() {
     m_pSoundManager->readProcess();
 
     {
-        ScopedTimer t("SoundDevicePortAudio::callbackProcess prepare %1",
-                m_deviceId.name);
+        ScopedTimer t(m_prepareTimerTag);
         m_pSoundManager->onDeviceOutputCallback(m_framesPerBuffer);
     }
 
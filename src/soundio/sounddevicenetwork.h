@@ -10,7 +10,10 @@
 #endif
 
 #include "util/performancetimer.h"
+#include "util/fifo.h"
 #include "util/memory.h"
+#include "util/stat.h"
+#include "util/trace.h"
 #include "soundio/sounddevice.h"
 #include "engine/sidechain/networkoutputstreamworker.h"
 
@@ -47,16 +50,13 @@ class SoundDeviceNetwork : public SoundDevice {
     void updateCallbackEntryToDacTime();
     void updateAudioLatencyUsage();
 
+    // Hands the outChunkSize samples just written to the output ring to
+    // pWorker, keeping its stream in sync with its clock.
     void workerWriteProcess(NetworkOutputStreamWorkerPtr pWorker,
-            int outChunkSize, int readAvailable,
-            CSAMPLE* dataPtr1, ring_buffer_size_t size1,
-            CSAMPLE* dataPtr2, ring_buffer_size_t size2);
-    void workerWrite(NetworkOutputStreamWorkerPtr pWorker,
-            const CSAMPLE* buffer, int frames);
-    void workerWriteSilence(NetworkOutputStreamWorkerPtr pWorker, int frames);
+            int outChunkSize);
 
     QSharedPointer<EngineNetworkStream> m_pNetworkStream;
-    std::unique_ptr<FIFO<CSAMPLE> > m_outputFifo;
+    QSharedPointer<SpmcRing<CSAMPLE>> m_pOutputRing;
     std::unique_ptr<FIFO<CSAMPLE> > m_inputFifo;
     bool m_inputDrift;
 
@@ -68,6 +68,9 @@ class SoundDeviceNetwork : public SoundDevice {
     bool m_denormals;
     qint64 m_targetTime;
     PerformanceTimer m_clkRefTimer;
+    // Interned once, so the callback does not format the timer key
+    TraceTag m_callbackTraceTag;
+    StatTag m_prepareTimerTag;
 };
 
 class SoundDeviceNetworkThread : public QThread {
@@ -33,6 +33,7 @@
 #include "soundio/sounddevice.h"
 #include "soundio/soundmanager.h"
 #include "soundio/soundmanagerutil.h"
+#include "util/callbacktrace.h"
 #include "util/denormalsarezero.h"
 #include "util/sample.h"
 #include "util/timer.h"
@@ -106,7 +107,9 @@ SoundDevicePortAudio::SoundDevicePortAudio(UserSettingsPointer config,
           m_framesSinceAudioLatencyUsageUpdate(0),
           m_syncBuffers(2),
           m_invalidTimeInfoCount(0),
-          m_lastCallbackEntrytoDacSecs(0) {
+          m_lastCallbackEntrytoDacSecs(0),
+          m_driftTraceStage(CallbackTrace::kInvalidStage),
+          m_driftCallbackNanos(0) {
     // Setting parent class members:
     m_hostAPI = Pa_GetHostApiInfo(deviceInfo->hostApi)->name;
     m_dSampleRate = deviceInfo->defaultSampleRate;
@@ -130,6 +133,24 @@ SoundDevicePortAudio::SoundDevicePortAudio(UserSettingsPointer config,
     }
     m_deviceId.portAudioIndex = devIndex;
     m_strDisplayName = QString::fromLocal8Bit(deviceInfo->name);
+    m_callbackTraceTag = TraceTag(
+            QString("SoundDevicePortAudio::callbackProcess %1")
+                    .arg(m_deviceId.debugName()));
+    m_callbackDriftTraceTag = TraceTag(
+            QString("SoundDevicePortAudio::callbackProcessDrift %1")
+                    .arg(m_deviceId.debugName()));
+    m_callbackClkRefTraceTag = TraceTag(
+            QString("SoundDevicePortAudio::callbackProcessClkRef %1")
+                    .arg(m_deviceId.debugName()));
+    m_inputTimerTag = StatTag(
+            QString("SoundDevicePortAudio::callbackProcess input %1")
+                    .arg(m_deviceId.debugName()));
+    m_prepareTimerTag = StatTag(
+            QString("SoundDevicePortAudio::callbackProcess prepare %1")
+                    .arg(m_deviceId.debugName()));
+    m_outputTimerTag = StatTag(
+            QString("SoundDevicePortAudio::callbackProcess output %1")
+                    .arg(m_deviceId.debugName()));
     m_iNumInputChannels = m_deviceInfo->maxInputChannels;
     m_iNumOutputChannels = m_deviceInfo->maxOutputChannels;
 
@@ -269,6 +290,8 @@ SoundDeviceError SoundDevicePortAudio::open(bool isClkRefDevice, int syncBuffers
         callback = paV19CallbackClkRef;
     } else if (m_syncBuffers == 2) { // "Default (long delay)"
         callback = paV19CallbackDrift;
+        m_driftTraceStage = CallbackTrace::registerStage(
+                QString("Drift callback %1").arg(m_deviceId.debugName()));
         // to avoid overflows when one callback overtakes the other or
         // when there is a clock drift compared to the clock reference device
         // we need an additional artificial delay
@@ -603,6 +626,12 @@ void SoundDevicePortAudio::readProcess() {
 void SoundDevicePortAudio::writeProcess() {
     PaStream* pStream = m_pStream;
 
+    if (m_driftTraceStage != CallbackTrace::kInvalidStage) {
+        CallbackTrace::addStageTime(m_driftTraceStage,
+                mixxx::Duration::fromNanos(m_driftCallbackNanos.exchange(
+                        0, std::memory_order_relaxed)));
+    }
+
     if (pStream && m_outputParams.channelCount && m_outputFifo) {
         int outChunkSize = m_framesPerBuffer * m_outputParams.channelCount;
         int writeAvailable = m_outputFifo->writeAvailable();
@@ -710,8 +739,13 @@ int SoundDevicePortAudio::callbackProcessDrift(
         const PaStreamCallbackTimeInfo *timeInfo,
         PaStreamCallbackFlags statusFlags) {
     Q_UNUSED(timeInfo);
-    Trace trace("SoundDevicePortAudio::callbackProcessDrift %1",
-            m_deviceId.debugName());
+    Trace trace(m_callbackDriftTraceTag);
+    // This runs on the thread of this device, so the time is handed over
+    // to the engine thread instead of being added to its callback here.
+    PerformanceTimer traceTimer;
+    if (m_driftTraceStage != CallbackTrace::kInvalidStage) {
+        traceTimer.start();
+    }
 
     if (statusFlags & (paOutputUnderflow | paInputOverflow)) {
         m_pSoundManager->underflowHappened(7);
@@ -835,6 +869,11 @@ int SoundDevicePortAudio::callbackProcessDrift(
             //qDebug() << "callbackProcess read:" << (float)readAvailable / outChunkSize << "Buffer empty";
         }
      }
+
+    if (m_driftTraceStage != CallbackTrace::kInvalidStage) {
+        m_driftCallbackNanos.fetch_add(traceTimer.elapsed().toIntegerNanos(),
+                std::memory_order_relaxed);
+    }
     return paContinue;
 }
 
@@ -843,7 +882,7 @@ int SoundDevicePortAudio::callbackProcess(const SINT framesPerBuffer,
         const PaStreamCallbackTimeInfo *timeInfo,
         PaStreamCallbackFlags statusFlags) {
     Q_UNUSED(timeInfo);
-    Trace trace("SoundDevicePortAudio::callbackProcess %1", m_deviceId.debugName());
+    Trace trace(m_callbackTraceTag);
 
     if (statusFlags & (paOutputUnderflow | paInputOverflow)) {
         m_pSoundManager->underflowHappened(1);
@@ -897,8 +936,8 @@ int SoundDevicePortAudio::callbackProcessClkRef(
     // This must be the very first call, else timeInfo becomes invalid
     updateCallbackEntryToDacTime(timeInfo);
 
-    Trace trace("SoundDevicePortAudio::callbackProcessClkRef %1",
-                m_deviceId.debugName());
+    Trace trace(m_callbackClkRefTraceTag);
+    CallbackTrace::beginCallback(framesPerBuffer);
 
     //qDebug() << "SoundDevicePortAudio::callbackProcess:" << m_deviceId;
     // Turn on TimeCritical priority for the callback thread. If we are running
@@ -964,8 +1003,7 @@ int SoundDevicePortAudio::callbackProcessClkRef(
 
     // Send audio from the soundcard's input off to the SoundManager...
     if (in) {
-        ScopedTimer t("SoundDevicePortAudio::callbackProcess input %1",
-                m_deviceId.debugName());
+        ScopedTimer t(m_inputTimerTag);
         composeInputBuffer(in, framesPerBuffer, 0, m_inputParams.channelCount);
         m_pSoundManager->pushInputBuffers(m_audioInputs, m_framesPerBuffer);
     }
@@ -973,20 +1011,19 @@ int SoundDevicePortAudio::callbackProcessClkRef(
     m_pSoundManager->readProcess();
 
     {
-        ScopedTimer t("SoundDevicePortAudio::callbackProcess prepare %1",
-                m_deviceId.debugName());
+        ScopedTimer t(m_prepareTimerTag);
         m_pSoundManager->onDeviceOutputCallback(framesPerBuffer);
     }
 
     if (out) {
-        ScopedTimer t("SoundDevicePortAudio::callbackProcess output %1",
-                m_deviceId.debugName());
+        ScopedTimer t(m_outputTimerTag);
 
         if (m_outputParams.channelCount <= 0) {
             qWarning()
                     << "SoundDevicePortAudio::callbackProcess m_outputParams channel count is zero or less:"
                     << m_outputParams.channelCount;
             // Bail out.
+            CallbackTrace::endCallback(m_clkRefTimer.elapsed());
             return paContinue;
         }
 
@@ -995,6 +1032,7 @@ int SoundDevicePortAudio::callbackProcessClkRef(
 
     m_pSoundManager->writeProcess();
 
+    CallbackTrace::endCallback(m_clkRefTimer.elapsed());
     updateAudioLatencyUsage(framesPerBuffer);
 
     return paContinue;
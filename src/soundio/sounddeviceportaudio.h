@@ -20,12 +20,16 @@
 
 #include <portaudio.h>
 
+#include <atomic>
+
 #include <QString>
 #include "util/performancetimer.h"
 
 #include "soundio/sounddevice.h"
 #include "util/duration.h"
 #include "util/fifo.h"
+#include "util/stat.h"
+#include "util/trace.h"
 
 #define CPU_USAGE_UPDATE_RATE 30 // in 1/s, fits to display frame rate
 
@@ -102,6 +106,18 @@ class SoundDevicePortAudio : public SoundDevice {
     int m_invalidTimeInfoCount;
     PerformanceTimer m_clkRefTimer;
     PaTime m_lastCallbackEntrytoDacSecs;
+    // CallbackTrace stage of the drift callback. The time spent in the
+    // drift callbacks is collected in m_driftCallbackNanos and added to the
+    // engine callback in writeProcess().
+    int m_driftTraceStage;
+    std::atomic<qint64> m_driftCallbackNanos;
+    // Interned once, so the callback does not format the timer keys
+    TraceTag m_callbackTraceTag;
+    TraceTag m_callbackDriftTraceTag;
+    TraceTag m_callbackClkRefTraceTag;
+    StatTag m_inputTimerTag;
+    StatTag m_prepareTimerTag;
+    StatTag m_outputTimerTag;
 };
 
 #endif
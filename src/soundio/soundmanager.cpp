@@ -47,6 +47,9 @@ namespace {
 
 #define CPU_OVERLOAD_DURATION 500 // in ms
 
+// How often CallbackTrace is polled for xruns that need to be written out.
+const int kXrunTraceIntervalMillis = 1000;
+
 struct DeviceMode {
     SoundDevicePointer pDevice;
     bool isInput;
@@ -83,6 +86,14 @@ SoundManager::SoundManager(UserSettingsPointer pConfig,
     m_pMasterAudioLatencyOverload = new ControlProxy("[Master]",
             "audio_latency_overload");
 
+    if (CallbackTrace::isEnabled()) {
+        connect(&m_xrunTraceTimer,
+                &QTimer::timeout,
+                this,
+                &SoundManager::slotWriteXrunTraces);
+        m_xrunTraceTimer.start(kXrunTraceIntervalMillis);
+    }
+
     //Hack because PortAudio samplerate enumeration is slow as hell on Linux (ALSA dmix sucks, so we can't blame PortAudio)
     m_samplerates.push_back(44100);
     m_samplerates.push_back(48000);
@@ -691,6 +702,14 @@ int SoundManager::getConfiguredDeckCount() const {
     return m_config.getDeckCount();
 }
 
+void SoundManager::slotWriteXrunTraces() {
+    QString fileName = CallbackTrace::writePendingXruns(
+            m_pConfig->getSettingsPath());
+    if (!fileName.isEmpty()) {
+        qDebug() << "SoundManager: wrote xrun callback trace to" << fileName;
+    }
+}
+
 void SoundManager::processUnderflowHappened() {
     if (m_underflowUpdateCount == 0) {
         if (atomicLoadRelaxed(m_underflowHappened)) {
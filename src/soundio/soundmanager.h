@@ -24,12 +24,14 @@
 #include <QList>
 #include <QHash>
 #include <QSharedPointer>
+#include <QTimer>
 
 #include "preferences/usersettings.h"
 #include "engine/sidechain/enginenetworkstream.h"
 #include "soundio/soundmanagerconfig.h"
 #include "soundio/sounddevice.h"
 #include "util/types.h"
+#include "util/callbacktrace.h"
 #include "util/cmdlineargs.h"
 
 
@@ -118,6 +120,7 @@ class SoundManager : public QObject {
 
     void underflowHappened(int code) {
         m_underflowHappened = 1;
+        CallbackTrace::markXrun();
         // Disable the engine warnings by default, because printing a warning is a
         // locking function that will make the problem worse
         if (CmdlineArgs::Instance().getDeveloper()) {
@@ -133,6 +136,11 @@ class SoundManager : public QObject {
     void outputRegistered(AudioOutput output, AudioSource *src);
     void inputRegistered(AudioInput input, AudioDestination *dest);
 
+  private slots:
+    // Writes the CallbackTrace records around recent xruns to the settings
+    // directory.
+    void slotWriteXrunTraces();
+
   private:
     // Closes all the devices and empties the list of devices we have.
     void clearDeviceList(bool sleepAfterClosing);
@@ -166,6 +174,7 @@ class SoundManager : public QObject {
     int m_underflowUpdateCount;
     ControlProxy* m_pMasterAudioLatencyOverloadCount;
     ControlProxy* m_pMasterAudioLatencyOverload;
+    QTimer m_xrunTraceTimer;
 };
 
 #endif
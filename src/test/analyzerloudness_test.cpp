@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "test/mixxxtest.h"
+
+#include "analyzer/analyzerebur128.h"
+#include "analyzer/analyzergain.h"
+#include "analyzer/constants.h"
+#include "util/math.h"
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+constexpr int kTrackLengthFrames = kSampleRate * 10;
+constexpr double kTonePitchHz = 1000.0; // 1kHz
+
+// A 1 kHz sine in both channels. Its integrated loudness in LUFS is
+// close to its peak level in dBFS.
+std::vector<CSAMPLE> makeSine(int numFrames, CSAMPLE amplitude) {
+    std::vector<CSAMPLE> samples(numFrames * mixxx::kAnalysisChannels);
+    for (int i = 0; i < numFrames; ++i) {
+        const CSAMPLE sample = amplitude *
+                static_cast<CSAMPLE>(sin(2 * M_PI * kTonePitchHz * i / kSampleRate));
+        samples[i * 2] = sample;
+        samples[i * 2 + 1] = sample;
+    }
+    return samples;
+}
+
+// Passes the samples in the chunks of the AnalyzerThread
+bool processSamples(Analyzer* pAnalyzer, const std::vector<CSAMPLE>& samples) {
+    const SINT numSamples = static_cast<SINT>(samples.size());
+    for (SINT offset = 0; offset < numSamples; offset += mixxx::kAnalysisSamplesPerChunk) {
+        const SINT length = math_min(mixxx::kAnalysisSamplesPerChunk, numSamples - offset);
+        if (!pAnalyzer->processSamples(&samples[offset], static_cast<int>(length))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+class AnalyzerLoudnessTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        pTrack = Track::newTemporary();
+        pTrack->setSampleRate(kSampleRate);
+        ReplayGainSettings rgSettings(config());
+        rgSettings.setReplayGainAnalyzerEnabled(true);
+        rgSettings.setReplayGainAnalyzerVersion(2);
+        rgSettings.setReplayGainReanalyze(false);
+    }
+
+    TrackPointer pTrack;
+};
+
+TEST_F(AnalyzerLoudnessTest, Ebur128MeasuresSine) {
+    const std::vector<CSAMPLE> samples = makeSine(kTrackLengthFrames, 0.1f);
+    AnalyzerEbur128 analyzer(config());
+    ASSERT_TRUE(analyzer.initialize(pTrack, kSampleRate, static_cast<int>(samples.size())));
+    EXPECT_TRUE(processSamples(&analyzer, samples));
+    analyzer.storeResults(pTrack);
+    analyzer.cleanup();
+
+    // -20 LUFS is 2 dB below the ReplayGain 2.0 reference level of -18 LUFS
+    ASSERT_TRUE(pTrack->getReplayGain().hasRatio());
+    EXPECT_NEAR(2.0, ratio2db(pTrack->getReplayGain().getRatio()), 0.1);
+}
+
+TEST_F(AnalyzerLoudnessTest, EnforcedAnalysisIgnoresPreferences) {
+    ReplayGainSettings(config()).setReplayGainAnalyzerEnabled(false);
+    const int totalSamples = kTrackLengthFrames * mixxx::kAnalysisChannels;
+
+    AnalyzerEbur128 analyzer(config());
+    EXPECT_FALSE(analyzer.initialize(pTrack, kSampleRate, totalSamples));
+
+    AnalyzerEbur128 enforcedAnalyzer(config(), true);
+    EXPECT_TRUE(enforcedAnalyzer.initialize(pTrack, kSampleRate, totalSamples));
+    enforcedAnalyzer.cleanup();
+
+    AnalyzerGain enforcedGainAnalyzer(config(), true);
+    EXPECT_TRUE(enforcedGainAnalyzer.initialize(pTrack, kSampleRate, totalSamples));
+    enforcedGainAnalyzer.cleanup();
+}
+
+TEST_F(AnalyzerLoudnessTest, EnforcedAnalysisSkipsAnalyzedTracks) {
+    mixxx::ReplayGain replayGain;
+    replayGain.setRatio(db2ratio(3.0));
+    pTrack->setReplayGain(replayGain);
+    const int totalSamples = kTrackLengthFrames * mixxx::kAnalysisChannels;
+
+    AnalyzerEbur128 enforcedAnalyzer(config(), true);
+    EXPECT_FALSE(enforcedAnalyzer.initialize(pTrack, kSampleRate, totalSamples));
+
+    ReplayGainSettings(config()).setReplayGainReanalyze(true);
+    EXPECT_TRUE(enforcedAnalyzer.initialize(pTrack, kSampleRate, totalSamples));
+    enforcedAnalyzer.cleanup();
+}
+
+// Throughput of the loudness analysis of decoded audio in frames per second.
+// Every thread runs its own analyzer like the analyzer threads do.
+template<typename AnalyzerType>
+static void BM_AnalyzeLoudness(benchmark::State& state) {
+    UserSettingsPointer pConfig(new UserSettings(QString()));
+    TrackPointer pTrack = Track::newTemporary();
+    const std::vector<CSAMPLE> samples = makeSine(kTrackLengthFrames, 0.1f);
+    AnalyzerType analyzer(pConfig, true);
+
+    while (state.KeepRunning()) {
+        analyzer.initialize(pTrack, kSampleRate, static_cast<int>(samples.size()));
+        processSamples(&analyzer, samples);
+        analyzer.cleanup();
+    }
+    state.SetItemsProcessed(state.iterations() * kTrackLengthFrames);
+}
+BENCHMARK_TEMPLATE(BM_AnalyzeLoudness, AnalyzerEbur128)->ThreadRange(1, 16);
+BENCHMARK_TEMPLATE(BM_AnalyzeLoudness, AnalyzerGain)->ThreadRange(1, 16);
+
+} // namespace
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <QSet>
+
+#include "library/autodj/autodjtracksampler.h"
+
+namespace {
+
+class AutoDJTrackSamplerTest : public testing::Test {
+  protected:
+    AutoDJTrackSamplerTest()
+            : m_now(QDateTime::currentDateTimeUtc()) {
+    }
+
+    QDateTime daysAgo(int days) const {
+        return m_now.addDays(-days);
+    }
+
+    const QDateTime m_now;
+    AutoDJTrackSampler m_sampler;
+};
+
+TEST_F(AutoDJTrackSamplerTest, EmptySampler) {
+    EXPECT_TRUE(m_sampler.isEmpty());
+    EXPECT_FALSE(m_sampler.sample(AutoDJTrackSampler::Order::TimesPlayed, 0).isValid());
+    EXPECT_FALSE(m_sampler.sample(AutoDJTrackSampler::Order::LastPlayed, 1).isValid());
+    EXPECT_FALSE(m_sampler.sample(AutoDJTrackSampler::Order::TimesPlayed, 1,
+            AutoDJTrackSampler::Weighting::Levels).isValid());
+}
+
+TEST_F(AutoDJTrackSamplerTest, AddUpdateRemove) {
+    for (int i = 1; i <= 10; ++i) {
+        m_sampler.addOrUpdateTrack(TrackId(i), i % 2, QDateTime());
+    }
+    EXPECT_EQ(10, m_sampler.size());
+    EXPECT_EQ(5, m_sampler.unplayedCount());
+
+    m_sampler.addOrUpdateTrack(TrackId(2), 1, daysAgo(3));
+    EXPECT_EQ(10, m_sampler.size());
+    EXPECT_EQ(4, m_sampler.unplayedCount());
+
+    m_sampler.removeTrack(TrackId(1));
+    m_sampler.removeTrack(TrackId(4));
+    // Not contained
+    m_sampler.removeTrack(TrackId(11));
+    EXPECT_EQ(8, m_sampler.size());
+    EXPECT_EQ(3, m_sampler.unplayedCount());
+    EXPECT_FALSE(m_sampler.containsTrack(TrackId(1)));
+    EXPECT_TRUE(m_sampler.containsTrack(TrackId(10)));
+
+    // Removed tracks are never picked
+    for (int i = 0; i < 100; ++i) {
+        const TrackId trackId = m_sampler.sample(
+                AutoDJTrackSampler::Order::TimesPlayed, 0);
+        EXPECT_TRUE(m_sampler.containsTrack(trackId));
+    }
+
+    m_sampler.clear();
+    EXPECT_TRUE(m_sampler.isEmpty());
+    EXPECT_EQ(0, m_sampler.unplayedCount());
+}
+
+TEST_F(AutoDJTrackSamplerTest, PicksAllTracksWithoutPoolSize) {
+    for (int i = 1; i <= 4; ++i) {
+        m_sampler.addOrUpdateTrack(TrackId(i), i * 10, daysAgo(i));
+    }
+    QSet<TrackId> picked;
+    for (int i = 0; i < 1000; ++i) {
+        picked.insert(m_sampler.sample(AutoDJTrackSampler::Order::TimesPlayed, 0));
+    }
+    EXPECT_EQ(4, picked.size());
+}
+
+TEST_F(AutoDJTrackSamplerTest, PoolContainsLeastPlayedTracks) {
+    m_sampler.addOrUpdateTrack(TrackId(1), 0, QDateTime());
+    m_sampler.addOrUpdateTrack(TrackId(2), 0, QDateTime());
+    m_sampler.addOrUpdateTrack(TrackId(3), 1, daysAgo(100));
+    m_sampler.addOrUpdateTrack(TrackId(4), 5, daysAgo(0));
+
+    QSet<TrackId> picked;
+    for (int i = 0; i < 1000; ++i) {
+        picked.insert(m_sampler.sample(AutoDJTrackSampler::Order::TimesPlayed, 3));
+    }
+    EXPECT_EQ(QSet<TrackId>({TrackId(1), TrackId(2), TrackId(3)}), picked);
+
+    picked.clear();
+    for (int i = 0; i < 1000; ++i) {
+        picked.insert(m_sampler.sample(AutoDJTrackSampler::Order::LastPlayed, 3));
+    }
+    EXPECT_EQ(QSet<TrackId>({TrackId(1), TrackId(2), TrackId(3)}), picked);
+
+    // Updates move tracks between levels
+    m_sampler.addOrUpdateTrack(TrackId(3), 6, daysAgo(0));
+    m_sampler.addOrUpdateTrack(TrackId(4), 1, daysAgo(100));
+    picked.clear();
+    for (int i = 0; i < 1000; ++i) {
+        picked.insert(m_sampler.sample(AutoDJTrackSampler::Order::TimesPlayed, 3));
+    }
+    EXPECT_EQ(QSet<TrackId>({TrackId(1), TrackId(2), TrackId(4)}), picked);
+}
+
+TEST_F(AutoDJTrackSamplerTest, PoolIsCutWithinLevel) {
+    // Every track has been played once, on different days
+    for (int i = 1; i <= 10; ++i) {
+        m_sampler.addOrUpdateTrack(TrackId(i), 1, daysAgo(i));
+    }
+    QSet<TrackId> picked;
+    for (int i = 0; i < 1000; ++i) {
+        picked.insert(m_sampler.sample(AutoDJTrackSampler::Order::TimesPlayed, 2));
+    }
+    EXPECT_EQ(QSet<TrackId>({TrackId(9), TrackId(10)}), picked);
+
+    // Tracks that have been played today share a level of the LastPlayed order
+    m_sampler.clear();
+    for (int i = 1; i <= 10; ++i) {
+        m_sampler.addOrUpdateTrack(TrackId(i), i, m_now.addSecs(-i));
+    }
+    picked.clear();
+    for (int i = 0; i < 1000; ++i) {
+        picked.insert(m_sampler.sample(AutoDJTrackSampler::Order::LastPlayed, 3));
+    }
+    EXPECT_EQ(QSet<TrackId>({TrackId(8), TrackId(9), TrackId(10)}), picked);
+}
+
+TEST_F(AutoDJTrackSamplerTest, UniformWithinPool) {
+    m_sampler.addOrUpdateTrack(TrackId(1), 0, QDateTime());
+    for (int i = 2; i <= 10; ++i) {
+        m_sampler.addOrUpdateTrack(TrackId(i), 1, daysAgo(i));
+    }
+    m_sampler.addOrUpdateTrack(TrackId(11), 5, daysAgo(0));
+
+    // Every track of the pool is equally likely, regardless of its level
+    int unplayedPicks = 0;
+    const int numPicks = 10000;
+    for (int i = 0; i < numPicks; ++i) {
+        const TrackId trackId = m_sampler.sample(
+                AutoDJTrackSampler::Order::TimesPlayed, 10);
+        EXPECT_NE(TrackId(11), trackId);
+        if (trackId == TrackId(1)) {
+            ++unplayedPicks;
+        }
+    }
+    EXPECT_NEAR(0.1, static_cast<double>(unplayedPicks) / numPicks, 0.02);
+}
+
+TEST_F(AutoDJTrackSamplerTest, WeightingPrefersLessPlayedTracks) {
+    for (int i = 1; i <= 100; ++i) {
+        m_sampler.addOrUpdateTrack(TrackId(i), 0, QDateTime());
+    }
+    for (int i = 101; i <= 200; ++i) {
+        m_sampler.addOrUpdateTrack(TrackId(i), 3, daysAgo(0));
+    }
+
+    // Level 3 has a quarter of the weight of level 0
+    int unplayedPicks = 0;
+    const int numPicks = 10000;
+    for (int i = 0; i < numPicks; ++i) {
+        const TrackId trackId = m_sampler.sample(
+                AutoDJTrackSampler::Order::TimesPlayed, 0,
+                AutoDJTrackSampler::Weighting::Levels);
+        if (trackId.value() <= 100) {
+            ++unplayedPicks;
+        }
+    }
+    EXPECT_NEAR(0.8, static_cast<double>(unplayedPicks) / numPicks, 0.05);
+}
+
+TEST_F(AutoDJTrackSamplerTest, CountPlayedBefore) {
+    m_sampler.addOrUpdateTrack(TrackId(1), 0, QDateTime());
+    m_sampler.addOrUpdateTrack(TrackId(2), 1, daysAgo(400));
+    m_sampler.addOrUpdateTrack(TrackId(3), 1, daysAgo(2));
+    m_sampler.addOrUpdateTrack(TrackId(4), 1, m_now.addSecs(-3600));
+    m_sampler.addOrUpdateTrack(TrackId(5), 1, m_now.addSecs(-60));
+
+    EXPECT_EQ(5, m_sampler.countPlayedBefore(m_now));
+    EXPECT_EQ(4, m_sampler.countPlayedBefore(m_now.addSecs(-120)));
+    EXPECT_EQ(3, m_sampler.countPlayedBefore(m_now.addSecs(-7200)));
+    EXPECT_EQ(2, m_sampler.countPlayedBefore(daysAgo(10)));
+    EXPECT_EQ(1, m_sampler.countPlayedBefore(daysAgo(1000)));
+}
+
+} // namespace
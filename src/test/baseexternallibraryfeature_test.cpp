@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "library/baseexternallibraryfeature.h"
+#include "library/queryutil.h"
+#include "test/librarytest.h"
+
+namespace {
+
+const QString kSettingsKey = "mixxx.test.imported_source";
+
+// Exposes the helpers that the external library features share
+class ExternalLibraryImport : public BaseExternalLibraryFeature {
+  public:
+    using BaseExternalLibraryFeature::isImportUpToDate;
+    using BaseExternalLibraryFeature::setImportedSignature;
+    using BaseExternalLibraryFeature::sourceFilesSignature;
+};
+
+class BaseExternalLibraryFeatureTest : public LibraryTest {
+  protected:
+    QString writeFile(const QString& fileName, const QByteArray& content) {
+        const QString filePath = m_tempDir.path() + "/" + fileName;
+        QFile file(filePath);
+        EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(content);
+        return filePath;
+    }
+
+    QTemporaryDir m_tempDir;
+};
+
+TEST_F(BaseExternalLibraryFeatureTest, SourceFilesSignature) {
+    const QString collectionFile = writeFile("rhythmdb.xml", "<rhythmdb/>");
+    const QString signature =
+            ExternalLibraryImport::sourceFilesSignature(QStringList(collectionFile));
+    EXPECT_FALSE(signature.isEmpty());
+    EXPECT_EQ(signature,
+            ExternalLibraryImport::sourceFilesSignature(QStringList(collectionFile)));
+
+    // A missing file never matches a previous import
+    EXPECT_TRUE(ExternalLibraryImport::sourceFilesSignature(
+            QStringList(m_tempDir.path() + "/missing.xml")).isEmpty());
+    EXPECT_TRUE(ExternalLibraryImport::sourceFilesSignature(
+            QStringList() << collectionFile << QString()).isEmpty());
+
+    // An optional file that appears later changes the signature
+    const QString playlistsFile = writeFile("playlists.xml", "<rhythmdb-playlists/>");
+    EXPECT_NE(signature, ExternalLibraryImport::sourceFilesSignature(
+            QStringList() << collectionFile << playlistsFile));
+
+    // So does a modification of the file
+    writeFile("rhythmdb.xml", "<rhythmdb></rhythmdb>");
+    EXPECT_NE(signature,
+            ExternalLibraryImport::sourceFilesSignature(QStringList(collectionFile)));
+}
+
+TEST_F(BaseExternalLibraryFeatureTest, ImportUpToDate) {
+    const QString signature = ExternalLibraryImport::sourceFilesSignature(
+            QStringList(writeFile("collection.nml", "<NML/>")));
+    EXPECT_FALSE(ExternalLibraryImport::isImportUpToDate(
+            dbConnection(), kSettingsKey, signature));
+
+    ExternalLibraryImport::setImportedSignature(dbConnection(), kSettingsKey, signature);
+    EXPECT_TRUE(ExternalLibraryImport::isImportUpToDate(
+            dbConnection(), kSettingsKey, signature));
+    // Files that don't exist are always imported
+    EXPECT_FALSE(ExternalLibraryImport::isImportUpToDate(
+            dbConnection(), kSettingsKey, QString()));
+}
+
+TEST_F(BaseExternalLibraryFeatureTest, AbortedImportKeepsPreviousImport) {
+    const QString signature = ExternalLibraryImport::sourceFilesSignature(
+            QStringList(writeFile("collection.nml", "<NML/>")));
+    ExternalLibraryImport::setImportedSignature(dbConnection(), kSettingsKey, signature);
+
+    // The features invalidate the signature within the import transaction
+    // and roll it back if the import is canceled or the XML is invalid
+    {
+        ScopedTransaction transaction(dbConnection());
+        ExternalLibraryImport::setImportedSignature(dbConnection(), kSettingsKey, QString());
+        EXPECT_FALSE(ExternalLibraryImport::isImportUpToDate(
+                dbConnection(), kSettingsKey, signature));
+        transaction.rollback();
+    }
+    EXPECT_TRUE(ExternalLibraryImport::isImportUpToDate(
+            dbConnection(), kSettingsKey, signature));
+}
+
+} // anonymous namespace
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "engine/sidechain/bufferedfilewriter.h"
+
+namespace {
+
+class BufferedFileWriterTest : public testing::Test {
+  protected:
+    QByteArray readFile() {
+        QFile file(m_fileName);
+        EXPECT_TRUE(file.open(QIODevice::ReadOnly));
+        return file.readAll();
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_fileName = m_tempDir.filePath("recording.wav");
+};
+
+TEST_F(BufferedFileWriterTest, WritesAcrossBuffers) {
+    // Tiny buffers, so the data spans several of them.
+    BufferedFileWriter writer(16);
+    ASSERT_TRUE(writer.open(m_fileName));
+
+    QByteArray expected;
+    for (int i = 0; i < 100; ++i) {
+        QByteArray chunk(7, static_cast<char>('a' + i % 26));
+        writer.write(chunk.constData(), chunk.size());
+        expected.append(chunk);
+    }
+    EXPECT_EQ(expected.size(), writer.pos());
+    EXPECT_EQ(expected.size(), writer.size());
+    writer.close();
+
+    EXPECT_FALSE(writer.isOpen());
+    EXPECT_EQ(expected, readFile());
+}
+
+TEST_F(BufferedFileWriterTest, SeekRewritesHeader) {
+    BufferedFileWriter writer(16);
+    ASSERT_TRUE(writer.open(m_fileName));
+
+    // Like an encoder: placeholder header, data, then the final header.
+    writer.write("HHHH", 4);
+    QByteArray data(40, 'd');
+    writer.write(data.constData(), data.size());
+    ASSERT_TRUE(writer.seek(0));
+    writer.write("RIFF", 4);
+    EXPECT_EQ(4, writer.pos());
+    EXPECT_EQ(44, writer.size());
+    ASSERT_TRUE(writer.seek(writer.size()));
+    writer.write("tail", 4);
+    writer.close();
+
+    EXPECT_EQ(QByteArray("RIFF") + data + QByteArray("tail"), readFile());
+}
+
+TEST_F(BufferedFileWriterTest, ReopenStartsEmpty) {
+    BufferedFileWriter writer(16);
+    ASSERT_TRUE(writer.open(m_fileName));
+    writer.write("first file", 10);
+    writer.close();
+
+    ASSERT_TRUE(writer.open(m_fileName));
+    EXPECT_EQ(0, writer.pos());
+    EXPECT_EQ(0, writer.stallCount());
+    writer.write("second", 6);
+    writer.close();
+
+    EXPECT_EQ(QByteArray("second"), readFile());
+}
+
+#ifdef __LINUX__
+TEST_F(BufferedFileWriterTest, ReportsWriteError) {
+    // Every write to /dev/full fails like on a full disk.
+    BufferedFileWriter writer(16);
+    ASSERT_TRUE(writer.open("/dev/full"));
+    EXPECT_FALSE(writer.hasWriteError());
+    QByteArray data(40, 'd');
+    writer.write(data.constData(), data.size());
+    writer.close();
+    EXPECT_TRUE(writer.hasWriteError());
+}
+#endif
+
+} // namespace
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <atomic>
+
+#include "engine/cachingreader/cachingreader.h"
+#include "engine/engineworkerscheduler.h"
+#include "test/mixxxtest.h"
+#include "track/track.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const QString kTrackLocation = QDir::currentPath() + "/src/test/sine-30.wav";
+
+constexpr qint64 kTimeoutMillis = 10000;
+
+// The number of frames that are read like the engine does in a callback
+constexpr SINT kReadFrames = 1024;
+
+// Preloaded chunks at every position where playback starts and at every
+// hotcue or loop, limited by the preload pool of the reader
+constexpr SINT kChunksPerPlayPosition = 3;
+constexpr SINT kPreloadChunks = 16;
+
+// Returns a sample position in the middle of the chunk
+double chunkSamplePosition(SINT chunkIndex) {
+    return CachingReaderChunk::frames2samples(
+            chunkIndex * CachingReaderChunk::kFrames + CachingReaderChunk::kFrames / 2);
+}
+
+class CachingReaderTest : public MixxxTest {
+  protected:
+    CachingReaderTest()
+            : m_reader("[Channel1]", config()),
+              m_loaded(false) {
+        m_reader.setScheduler(&m_scheduler);
+        m_scheduler.start();
+        QObject::connect(&m_reader, &CachingReader::trackLoaded,
+                [this](TrackPointer, int, int) { m_loaded = true; });
+    }
+
+    TrackPointer createTrack() {
+        return Track::newTemporary(kTrackLocation);
+    }
+
+    void addCue(const TrackPointer& pTrack, Cue::Type type, SINT chunkIndex) {
+        auto pCue = pTrack->createAndAddCue();
+        pCue->setType(type);
+        pCue->setStartPosition(chunkSamplePosition(chunkIndex));
+    }
+
+    // Loads the track without issuing any hints and adopts the chunks
+    // that have been reported together with the loaded track
+    bool loadTrack(const TrackPointer& pTrack) {
+        m_loaded = false;
+        m_reader.newTrack(pTrack);
+        QElapsedTimer timer;
+        timer.start();
+        while (!m_loaded && timer.elapsed() < kTimeoutMillis) {
+            // Like the engine after each audio callback
+            m_scheduler.workerReady();
+            m_scheduler.runWorkers();
+            QThread::msleep(1);
+        }
+        m_reader.process();
+        return m_loaded;
+    }
+
+    CachingReader::ReadResult readChunk(SINT chunkIndex) {
+        mixxx::SampleBuffer buffer(CachingReaderChunk::frames2samples(kReadFrames));
+        return m_reader.read(
+                static_cast<SINT>(chunkSamplePosition(chunkIndex)),
+                buffer.size(),
+                false,
+                buffer.data());
+    }
+
+    EngineWorkerScheduler m_scheduler;
+    CachingReader m_reader;
+    std::atomic<bool> m_loaded;
+};
+
+TEST_F(CachingReaderTest, FirstReadAfterLoadHitsCache) {
+    ASSERT_TRUE(loadTrack(createTrack()));
+    // The worker has not been asked for any chunk after loading
+    for (SINT chunkIndex = 0; chunkIndex < kChunksPerPlayPosition; ++chunkIndex) {
+        EXPECT_EQ(CachingReader::ReadResult::AVAILABLE, readChunk(chunkIndex));
+    }
+    EXPECT_EQ(CachingReader::ReadResult::UNAVAILABLE, readChunk(kChunksPerPlayPosition));
+}
+
+TEST_F(CachingReaderTest, PreloadCuePositions) {
+    TrackPointer pTrack = createTrack();
+    pTrack->setCuePoint(CuePosition(chunkSamplePosition(40)));
+    addCue(pTrack, Cue::Type::Intro, 60);
+    addCue(pTrack, Cue::Type::HotCue, 80);
+    addCue(pTrack, Cue::Type::Loop, 100);
+    addCue(pTrack, Cue::Type::Outro, 120);
+    ASSERT_TRUE(loadTrack(pTrack));
+
+    // Playback starts at the main cue, the start or the intro
+    for (SINT chunkIndex : {0, 40, 60}) {
+        for (SINT i = 0; i < kChunksPerPlayPosition; ++i) {
+            EXPECT_EQ(CachingReader::ReadResult::AVAILABLE, readChunk(chunkIndex + i));
+        }
+        EXPECT_EQ(CachingReader::ReadResult::UNAVAILABLE,
+                readChunk(chunkIndex + kChunksPerPlayPosition));
+    }
+    // Jump targets
+    for (SINT chunkIndex : {80, 100}) {
+        EXPECT_EQ(CachingReader::ReadResult::AVAILABLE, readChunk(chunkIndex));
+        EXPECT_EQ(CachingReader::ReadResult::UNAVAILABLE, readChunk(chunkIndex + 1));
+    }
+    EXPECT_EQ(CachingReader::ReadResult::UNAVAILABLE, readChunk(120));
+}
+
+TEST_F(CachingReaderTest, PreloadPoolIsReplenished) {
+    // More hotcues than preloaded chunks are left after the start
+    TrackPointer pTrack = createTrack();
+    const SINT numHotcues = kPreloadChunks - kChunksPerPlayPosition;
+    for (SINT i = 0; i <= numHotcues; ++i) {
+        addCue(pTrack, Cue::Type::HotCue, 10 * (i + 1));
+    }
+
+    // The pool has been refilled after adopting the chunks of the first load
+    for (int load = 0; load < 2; ++load) {
+        ASSERT_TRUE(loadTrack(pTrack));
+        EXPECT_EQ(CachingReader::ReadResult::AVAILABLE, readChunk(0));
+        for (SINT i = 0; i < numHotcues; ++i) {
+            EXPECT_EQ(CachingReader::ReadResult::AVAILABLE, readChunk(10 * (i + 1)));
+        }
+        EXPECT_EQ(CachingReader::ReadResult::UNAVAILABLE,
+                readChunk(10 * (numHotcues + 1)));
+    }
+}
+
+} // anonymous namespace
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include "util/callbacktrace.h"
+
+namespace {
+
+class CallbackTraceTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        CallbackTrace::enable();
+        m_stage = CallbackTrace::registerStage("CallbackTraceTest");
+    }
+
+    void runCallback(qint64 stageNanos, bool xrun) {
+        CallbackTrace::beginCallback(256);
+        CallbackTrace::addStageTime(m_stage,
+                mixxx::Duration::fromNanos(stageNanos));
+        if (xrun) {
+            CallbackTrace::markXrun();
+        }
+        CallbackTrace::endCallback(mixxx::Duration::fromNanos(2 * stageNanos));
+    }
+
+    int m_stage;
+};
+
+TEST_F(CallbackTraceTest, RegisterStageIsIdempotent) {
+    ASSERT_NE(CallbackTrace::kInvalidStage, m_stage);
+    EXPECT_EQ(m_stage, CallbackTrace::registerStage("CallbackTraceTest"));
+    EXPECT_EQ(QString("CallbackTraceTest"), CallbackTrace::stageName(m_stage));
+}
+
+TEST_F(CallbackTraceTest, SnapshotContainsStageTimes) {
+    const quint64 first = CallbackTrace::lastCompletedSequence() + 1;
+    for (int i = 0; i < 10; ++i) {
+        runCallback(1000 * (i + 1), false);
+    }
+
+    const QVector<CallbackTrace::Record> records = CallbackTrace::snapshot();
+    ASSERT_GE(records.size(), 10);
+    const CallbackTrace::Record& last = records.last();
+    EXPECT_EQ(first + 9, last.sequence);
+    EXPECT_EQ(256, last.frames);
+    EXPECT_EQ(10000, last.stageNanos[m_stage]);
+    EXPECT_EQ(20000, last.totalNanos);
+    EXPECT_FALSE(last.xrun);
+}
+
+TEST_F(CallbackTraceTest, NestedStagesRecordSelfTime) {
+    const int innerStage = CallbackTrace::registerStage("CallbackTraceTest inner");
+    ASSERT_NE(CallbackTrace::kInvalidStage, innerStage);
+
+    PerformanceTimer timer;
+    timer.start();
+    CallbackTrace::beginCallback(256);
+    {
+        ScopedCallbackTraceStage outer(m_stage);
+        ScopedCallbackTraceStage inner(innerStage);
+        QThread::msleep(20);
+    }
+    CallbackTrace::endCallback(timer.elapsed());
+
+    const CallbackTrace::Record& last = CallbackTrace::snapshot().last();
+    EXPECT_GE(last.stageNanos[innerStage], 20 * 1000 * 1000);
+    // Only the time outside of the inner stage
+    EXPECT_LT(last.stageNanos[m_stage], last.stageNanos[innerStage]);
+    EXPECT_LE(last.stageNanos[m_stage] + last.stageNanos[innerStage],
+            last.totalNanos);
+}
+
+TEST_F(CallbackTraceTest, SnapshotIsBoundedByRingSize) {
+    for (int i = 0; i < CallbackTrace::kRingSize + 10; ++i) {
+        runCallback(1000, false);
+    }
+    const QVector<CallbackTrace::Record> records = CallbackTrace::snapshot();
+    EXPECT_EQ(CallbackTrace::kRingSize, records.size());
+    for (int i = 1; i < records.size(); ++i) {
+        EXPECT_EQ(records[i - 1].sequence + 1, records[i].sequence);
+    }
+}
+
+TEST_F(CallbackTraceTest, XrunContextIsWrittenOnceComplete) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    runCallback(1000, false);
+    runCallback(50000, true);
+    const quint64 xrunSequence = CallbackTrace::lastCompletedSequence();
+    EXPECT_EQ(xrunSequence, CallbackTrace::lastXrunSequence());
+
+    // The callbacks after the xrun are not recorded yet.
+    EXPECT_TRUE(CallbackTrace::writePendingXruns(dir.path()).isEmpty());
+
+    for (int i = 0; i < CallbackTrace::kXrunContextAfter; ++i) {
+        runCallback(1000, false);
+    }
+    QString fileName = CallbackTrace::writePendingXruns(dir.path());
+    ASSERT_FALSE(fileName.isEmpty());
+    QFile file(fileName);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QString contents = QString::fromUtf8(file.readAll());
+    EXPECT_TRUE(contents.contains("CallbackTraceTest"));
+    EXPECT_TRUE(contents.contains(QString("\n%1,").arg(xrunSequence)));
+
+    // The same xrun is not written twice.
+    EXPECT_TRUE(CallbackTrace::writePendingXruns(dir.path()).isEmpty());
+}
+
+TEST_F(CallbackTraceTest, StageNamesAreEscaped) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    ASSERT_NE(CallbackTrace::kInvalidStage,
+            CallbackTrace::registerStage("[Channel1] \"Deck, 1\""));
+
+    runCallback(50000, true);
+    for (int i = 0; i < CallbackTrace::kXrunContextAfter; ++i) {
+        runCallback(1000, false);
+    }
+    QString fileName = CallbackTrace::writePendingXruns(dir.path());
+    ASSERT_FALSE(fileName.isEmpty());
+    QFile file(fileName);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QString header = QString::fromUtf8(file.readLine());
+    EXPECT_TRUE(header.contains(",\"[Channel1] \"\"Deck, 1\"\"\""));
+}
+
+} // namespace
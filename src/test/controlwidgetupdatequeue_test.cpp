@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+
+#include <QWidget>
+
+#include "mixxxtest.h"
+#include "control/controlobject.h"
+#include "widget/controlwidgetconnection.h"
+#include "widget/controlwidgetupdatequeue.h"
+#include "widget/wbasewidget.h"
+
+namespace {
+
+class CountingWidget : public QWidget, public WBaseWidget {
+  public:
+    CountingWidget()
+            : WBaseWidget(this),
+              m_updates(0),
+              m_lastValue(-1.0) {
+    }
+
+    int m_updates;
+    double m_lastValue;
+
+  protected:
+    void onConnectedControlChanged(double dParameter, double dValue) override {
+        Q_UNUSED(dParameter);
+        ++m_updates;
+        m_lastValue = dValue;
+    }
+};
+
+class ControlWidgetUpdateQueueTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_pControl = std::make_unique<ControlObject>(ConfigKey("[Test]", "queue"));
+        m_widget.addConnection(new ControlParameterWidgetConnection(
+                &m_widget,
+                m_pControl->getKey(),
+                nullptr,
+                ControlParameterWidgetConnection::DIR_TO_WIDGET,
+                ControlParameterWidgetConnection::EMIT_ON_PRESS));
+        // Discard anything left over from other tests
+        ControlWidgetUpdateQueue::instance()->drain();
+        m_widget.m_updates = 0;
+    }
+
+    std::unique_ptr<ControlObject> m_pControl;
+    CountingWidget m_widget;
+};
+
+TEST_F(ControlWidgetUpdateQueueTest, GuiThreadChangesAreImmediate) {
+    m_pControl->set(1.0);
+    EXPECT_EQ(1, m_widget.m_updates);
+    EXPECT_EQ(1.0, m_widget.m_lastValue);
+}
+
+TEST_F(ControlWidgetUpdateQueueTest, OtherThreadChangesAreCoalesced) {
+    std::thread engine([this] {
+        for (int i = 1; i <= 100; ++i) {
+            m_pControl->set(i);
+        }
+    });
+    engine.join();
+    EXPECT_EQ(0, m_widget.m_updates);
+
+    ControlWidgetUpdateQueue::instance()->drain();
+    EXPECT_EQ(1, m_widget.m_updates);
+    EXPECT_EQ(100.0, m_widget.m_lastValue);
+
+    // Nothing left to deliver
+    ControlWidgetUpdateQueue::instance()->drain();
+    EXPECT_EQ(1, m_widget.m_updates);
+}
+
+TEST_F(ControlWidgetUpdateQueueTest, DeletedConnectionIsNotUpdated) {
+    CountingWidget otherWidget;
+    auto pConnection = new ControlParameterWidgetConnection(
+            &otherWidget,
+            m_pControl->getKey(),
+            nullptr,
+            ControlParameterWidgetConnection::DIR_TO_WIDGET,
+            ControlParameterWidgetConnection::EMIT_ON_PRESS);
+    std::thread engine([this] {
+        m_pControl->set(5.0);
+    });
+    engine.join();
+
+    // The connection is still marked when it is deleted
+    delete pConnection;
+    ControlWidgetUpdateQueue::instance()->drain();
+    EXPECT_EQ(0, otherWidget.m_updates);
+    EXPECT_EQ(1, m_widget.m_updates);
+}
+
+} // namespace
@@ -0,0 +1,248 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+#include <QList>
+
+#include "effects/builtin/echoeffect.h"
+#include "effects/effectchain.h"
+#include "effects/effectchainslot.h"
+#include "effects/effectrack.h"
+#include "effects/effectsmanager.h"
+#include "effects/effectstatepool.h"
+#include "engine/effects/engineeffectsmanager.h"
+#include "engine/effects/groupfeaturestate.h"
+#include "test/baseeffecttest.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+// Allocations with operator new are only counted on the thread that
+// enabled counting.
+thread_local bool t_countAllocations = false;
+thread_local int t_allocations = 0;
+
+class AllocationCounter {
+  public:
+    AllocationCounter() {
+        t_allocations = 0;
+        t_countAllocations = true;
+    }
+    ~AllocationCounter() {
+        t_countAllocations = false;
+    }
+
+    int allocations() const {
+        return t_allocations;
+    }
+};
+
+} // anonymous namespace
+
+// Replaces the global allocation functions of the test binary. Every
+// allocation counts, whether it is served by an EffectStatePool or not.
+void* operator new(std::size_t size) {
+    if (t_countAllocations) {
+        ++t_allocations;
+    }
+    void* p = std::malloc(size > 0 ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+TEST(EffectStatePoolTest, DeletedStatesAreRecycled) {
+    EffectStatePool pool(64);
+    pool.reserve(2);
+    const int capacity = pool.capacity();
+    EXPECT_LE(2, capacity);
+    EXPECT_EQ(capacity, pool.numFreeStates());
+
+    void* pState1 = pool.allocate(64);
+    void* pState2 = pool.allocate(32);
+    EXPECT_NE(pState1, pState2);
+    EXPECT_EQ(capacity - 2, pool.numFreeStates());
+
+    EffectStatePool::deallocate(pState1);
+    EXPECT_EQ(capacity - 1, pool.numFreeStates());
+    EXPECT_EQ(pState1, pool.allocate(64));
+    EXPECT_EQ(capacity, pool.capacity());
+
+    EffectStatePool::deallocate(pState1);
+    EffectStatePool::deallocate(pState2);
+    EXPECT_EQ(capacity, pool.numFreeStates());
+}
+
+TEST(EffectStatePoolTest, ReserveOnlyGrowsIfNeeded) {
+    EffectStatePool pool(64);
+    pool.reserve(2);
+    const int capacity = pool.capacity();
+    pool.reserve(capacity);
+    EXPECT_EQ(capacity, pool.capacity());
+
+    void* pState = pool.allocate(64);
+    pool.reserve(capacity);
+    EXPECT_LT(capacity, pool.capacity());
+    EXPECT_LE(capacity, pool.numFreeStates());
+    EffectStatePool::deallocate(pState);
+}
+
+TEST(EffectStatePoolTest, GrowsWhenExhausted) {
+    EffectStatePool pool(64);
+    QList<void*> states;
+    for (int i = 0; i < 10; ++i) {
+        void* pState = pool.allocate(64);
+        EXPECT_FALSE(states.contains(pState));
+        states.append(pState);
+    }
+    EXPECT_LE(10, pool.capacity());
+    EXPECT_EQ(pool.capacity() - 10, pool.numFreeStates());
+    for (void* pState : states) {
+        EffectStatePool::deallocate(pState);
+    }
+    EXPECT_EQ(pool.capacity(), pool.numFreeStates());
+}
+
+TEST(EffectStatePoolTest, DeallocateFromOtherThread) {
+    EffectStatePool pool(64);
+    pool.reserve(8);
+    const int capacity = pool.capacity();
+    QList<void*> states;
+    for (int i = 0; i < capacity; ++i) {
+        states.append(pool.allocate(64));
+    }
+    EXPECT_EQ(0, pool.numFreeStates());
+
+    // Like the engine thread
+    std::thread thread([&states] {
+        for (void* pState : states) {
+            EffectStatePool::deallocate(pState);
+        }
+    });
+    thread.join();
+    EXPECT_EQ(capacity, pool.numFreeStates());
+
+    for (int i = 0; i < capacity; ++i) {
+        EXPECT_TRUE(states.contains(pool.allocate(64)));
+    }
+    EXPECT_EQ(capacity, pool.capacity());
+    for (void* pState : states) {
+        EffectStatePool::deallocate(pState);
+    }
+}
+
+TEST(EffectStatePoolTest, EchoDelayLineIsRecycled) {
+    EffectStatePool pool(sizeof(EchoGroupState));
+    pool.reserve(1);
+    const int capacity = pool.capacity();
+    const mixxx::EngineParameters bufferParameters(
+            mixxx::AudioSignal::SampleRate(96000),
+            MAX_BUFFER_LEN / mixxx::kEngineChannelCount);
+
+    EchoGroupState* pState = new (&pool) EchoGroupState(bufferParameters);
+    // The delay line is part of the memory of the state
+    const char* pBegin = reinterpret_cast<const char*>(pState);
+    const char* pDelayLine = reinterpret_cast<const char*>(pState->delay_buf.data());
+    EXPECT_LE(pBegin, pDelayLine);
+    EXPECT_GE(pBegin + sizeof(EchoGroupState),
+            pDelayLine + pState->delay_buf.length() * sizeof(CSAMPLE));
+    EXPECT_EQ(EchoGroupState::kMaxDelaySamples, pState->delay_buf.length());
+    delete pState;
+
+    EchoGroupState* pRecycledState = new (&pool) EchoGroupState(bufferParameters);
+    EXPECT_EQ(pState, pRecycledState);
+    EXPECT_EQ(capacity, pool.capacity());
+    delete pRecycledState;
+}
+
+class EffectStateAllocationTest : public BaseEffectTest {
+  protected:
+    EffectStateAllocationTest()
+            : m_master(m_pChannelHandleFactory->getOrCreateHandle("[Master]"),
+                      "[Master]"),
+              m_channel1(m_pChannelHandleFactory->getOrCreateHandle("[Channel1]"),
+                      "[Channel1]"),
+              m_buffer(kNumSamples) {
+        m_buffer.fill(0.5);
+    }
+
+    void SetUp() override {
+        registerTestBackend();
+        m_pTestBackend->registerEffect(EchoEffect::getId(),
+                EchoEffect::getManifest(),
+                EffectInstantiatorPointer(
+                        new EffectProcessorInstantiator<EchoEffect>()));
+        m_pEffectsManager->registerInputChannel(m_channel1);
+        m_pEffectsManager->registerOutputChannel(m_master);
+
+        StandardEffectRackPointer pRack = m_pEffectsManager->addStandardEffectRack();
+        EffectChainSlotPointer pChainSlot = pRack->getEffectChainSlot(0);
+        m_pChain = EffectChainPointer(new EffectChain(m_pEffectsManager.data(),
+                "org.mixxx.test.chain1"));
+        pChainSlot->loadEffectChainToSlot(m_pChain);
+        EffectPointer pEffect = m_pEffectsManager->instantiateEffect(EchoEffect::getId());
+        ASSERT_FALSE(pEffect.isNull());
+        m_pChain->addEffect(pEffect);
+        pEffect->setEnabled(true);
+        m_pChain->setEnabled(true);
+    }
+
+    // Runs the callbacks of the engine thread and returns the number of
+    // allocations in them
+    int processCallbacks(int numCallbacks) {
+        EngineEffectsManager* pEngineEffectsManager =
+                m_pEffectsManager->getEngineEffectsManager();
+        AllocationCounter counter;
+        for (int i = 0; i < numCallbacks; ++i) {
+            pEngineEffectsManager->onCallbackStart();
+            pEngineEffectsManager->processPostFaderInPlace(
+                    m_channel1.handle(), m_master.handle(),
+                    m_buffer.data(), kNumSamples, kSampleRate, m_groupFeatures);
+        }
+        return counter.allocations();
+    }
+
+    static constexpr unsigned int kSampleRate = 44100;
+    static constexpr unsigned int kNumSamples = 1024;
+
+    ChannelHandleAndGroup m_master;
+    ChannelHandleAndGroup m_channel1;
+    EffectChainPointer m_pChain;
+    mixxx::SampleBuffer m_buffer;
+    GroupFeatureState m_groupFeatures;
+};
+
+TEST_F(EffectStateAllocationTest, ProcessingDoesNotAllocate) {
+    m_pChain->enableForInputChannel(m_channel1);
+    // Apply the pending requests
+    processCallbacks(1);
+
+    EXPECT_EQ(0, processCallbacks(100));
+}
+
+TEST_F(EffectStateAllocationTest, EnablingAndDisablingDoesNotAllocate) {
+    // The states are created and deleted on this thread between the
+    // callbacks. The first cycle sets up what the engine thread only
+    // allocates once.
+    for (int cycle = 0; cycle < 4; ++cycle) {
+        m_pChain->enableForInputChannel(m_channel1);
+        const int enabledAllocations = processCallbacks(10);
+        m_pChain->disableForInputChannel(m_channel1);
+        const int disabledAllocations = processCallbacks(10);
+        if (cycle > 0) {
+            EXPECT_EQ(0, enabledAllocations);
+            EXPECT_EQ(0, disabledAllocations);
+        }
+    }
+}
+
+} // anonymous namespace
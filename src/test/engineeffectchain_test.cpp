@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+
+#include <QScopedPointer>
+
+#include <cmath>
+
+#include "effects/builtin/bitcrushereffect.h"
+#include "engine/effects/engineeffect.h"
+#include "engine/effects/engineeffectchain.h"
+#include "test/baseeffecttest.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr int kFrames = 64;
+constexpr int kSampleRate = 44100;
+
+class EngineEffectChainTest : public BaseEffectTest {
+  protected:
+    EngineEffectChainTest()
+            : m_input(m_factory.getOrCreateHandle("[Channel1]"), "[Channel1]"),
+              m_master(m_factory.getOrCreateHandle("[Master]"), "[Master]"),
+              m_input1(kFrames * mixxx::kEngineChannelCount),
+              m_input2(kFrames * mixxx::kEngineChannelCount) {
+        m_pEffectsManager->registerInputChannel(m_input);
+        m_pEffectsManager->registerOutputChannel(m_master);
+        QPair<EffectsRequestPipe*, EffectsResponsePipe*> pipes =
+                TwoWayMessagePipe<EffectsRequest*, EffectsResponse>::makeTwoWayMessagePipe(
+                        64, 64);
+        m_pRequestPipe.reset(pipes.first);
+        m_pResponsePipe.reset(pipes.second);
+
+        // Two callbacks of a signal that the bitcrusher changes
+        for (int i = 0; i < kFrames * mixxx::kEngineChannelCount; ++i) {
+            m_input1[i] = 0.9f * std::sin(0.05f * i);
+            m_input2[i] = 0.9f * std::cos(0.03f * i);
+        }
+    }
+
+    // The states of activeInputChannels are created up front, the others
+    // are loaded when the chain is enabled for them
+    EngineEffect* createBitCrusher(
+            const QSet<ChannelHandleAndGroup>& activeInputChannels) {
+        EngineEffect* pEffect = new EngineEffect(BitCrusherEffect::getManifest(),
+                activeInputChannels, m_pEffectsManager.data(),
+                EffectInstantiatorPointer(
+                        new EffectProcessorInstantiator<BitCrusherEffect>()));
+        EXPECT_TRUE(pEffect->supportsPlanarBuffers());
+        return pEffect;
+    }
+
+    void sendRequest(EffectsRequestHandler* pHandler, EffectsRequest& request) {
+        EXPECT_TRUE(pHandler->processEffectsRequest(request, m_pResponsePipe.data()));
+        EffectsResponse response;
+        while (m_pRequestPipe->readMessage(&response)) {
+            EXPECT_TRUE(response.success);
+        }
+    }
+
+    void setEnabled(EngineEffect* pEffect, bool enabled) {
+        EffectsRequest request;
+        request.type = EffectsRequest::SET_EFFECT_PARAMETERS;
+        request.pTargetEffect = pEffect;
+        request.SetEffectParameters.enabled = enabled;
+        sendRequest(pEffect, request);
+    }
+
+    // Returns a fully wet chain of the effects that is enabled for the input
+    EngineEffectChain* createChain(const QList<EngineEffect*>& effects) {
+        EngineEffectChain* pChain = new EngineEffectChain("org.mixxx.test.chain",
+                m_pEffectsManager->registeredInputChannels(),
+                m_pEffectsManager->registeredOutputChannels());
+        const mixxx::EngineParameters bufferParameters(
+                mixxx::AudioSignal::SampleRate(kSampleRate), kFrames);
+        EffectStatesMapArray* pStatesMapArray = new EffectStatesMapArray;
+        for (int i = 0; i < effects.size(); ++i) {
+            EffectsRequest request;
+            request.type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
+            request.pTargetChain = pChain;
+            request.AddEffectToChain.pEffect = effects[i];
+            request.AddEffectToChain.iIndex = i;
+            sendRequest(pChain, request);
+            (*pStatesMapArray)[i].insert(m_master.handle(),
+                    effects[i]->createState(bufferParameters));
+        }
+
+        EffectsRequest parameters;
+        parameters.type = EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS;
+        parameters.pTargetChain = pChain;
+        parameters.SetEffectChainParameters.enabled = true;
+        parameters.SetEffectChainParameters.mix_mode = EffectChainMixMode::DrySlashWet;
+        parameters.SetEffectChainParameters.mix = 1.0;
+        sendRequest(pChain, parameters);
+
+        // Deletes pStatesMapArray
+        EffectsRequest enable;
+        enable.type = EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
+        enable.pTargetChain = pChain;
+        enable.EnableInputChannelForChain.pEffectStatesMapArray = pStatesMapArray;
+        enable.EnableInputChannelForChain.pChannelHandle = &m_input.handle();
+        sendRequest(pChain, enable);
+        return pChain;
+    }
+
+    ChannelHandleFactory m_factory;
+    ChannelHandleAndGroup m_input;
+    ChannelHandleAndGroup m_master;
+    QScopedPointer<EffectsRequestPipe> m_pRequestPipe;
+    QScopedPointer<EffectsResponsePipe> m_pResponsePipe;
+    GroupFeatureState m_features;
+    mixxx::SampleBuffer m_input1;
+    mixxx::SampleBuffer m_input2;
+};
+
+TEST_F(EngineEffectChainTest, ProcessPlanarMatchesProcess) {
+    const QSet<ChannelHandleAndGroup> activeInputChannels{m_input};
+    QScopedPointer<EngineEffect> pInterleaved(createBitCrusher(activeInputChannels));
+    QScopedPointer<EngineEffect> pPlanar(createBitCrusher(activeInputChannels));
+
+    mixxx::SampleBuffer output(kFrames * mixxx::kEngineChannelCount);
+    mixxx::SampleBuffer planarInput(kFrames * mixxx::kEngineChannelCount);
+    mixxx::SampleBuffer planarOutput(kFrames * mixxx::kEngineChannelCount);
+    const CSAMPLE* pInputs[] = {planarInput.data(), planarInput.data(kFrames)};
+    CSAMPLE* pOutputs[] = {planarOutput.data(), planarOutput.data(kFrames)};
+
+    // Disabled, enabling, enabled, disabling
+    const bool enabled[] = {false, true, true, false};
+    for (int callback = 0; callback < 4; ++callback) {
+        if (callback > 0 && enabled[callback] != enabled[callback - 1]) {
+            setEnabled(pInterleaved.data(), enabled[callback]);
+            setEnabled(pPlanar.data(), enabled[callback]);
+        }
+        const mixxx::SampleBuffer& input = callback % 2 ? m_input2 : m_input1;
+        SampleUtil::deinterleaveBuffer(planarInput.data(),
+                planarInput.data(kFrames), input.data(), kFrames);
+
+        const bool processed = pInterleaved->process(m_input.handle(), m_master.handle(),
+                input.data(), output.data(), kFrames * mixxx::kEngineChannelCount,
+                kSampleRate, EffectEnableState::Enabled, m_features);
+        EXPECT_EQ(callback > 0, processed);
+        EXPECT_EQ(processed, pPlanar->processPlanar(m_input.handle(), m_master.handle(),
+                pInputs, pOutputs, kFrames,
+                kSampleRate, EffectEnableState::Enabled, m_features));
+        if (!processed) {
+            continue;
+        }
+        for (int i = 0; i < kFrames; ++i) {
+            EXPECT_FLOAT_EQ(output[2 * i], pOutputs[0][i]);
+            EXPECT_FLOAT_EQ(output[2 * i + 1], pOutputs[1][i]);
+        }
+    }
+}
+
+TEST_F(EngineEffectChainTest, PlanarChainMatchesInterleavedEffects) {
+    const QSet<ChannelHandleAndGroup> activeInputChannels{m_input};
+    QScopedPointer<EngineEffect> pReference1(createBitCrusher(activeInputChannels));
+    QScopedPointer<EngineEffect> pReference2(createBitCrusher(activeInputChannels));
+    QScopedPointer<EngineEffect> pEffect1(createBitCrusher(QSet<ChannelHandleAndGroup>()));
+    QScopedPointer<EngineEffect> pEffect2(createBitCrusher(QSet<ChannelHandleAndGroup>()));
+    for (EngineEffect* pEffect : {pReference1.data(), pReference2.data(),
+                 pEffect1.data(), pEffect2.data()}) {
+        setEnabled(pEffect, true);
+    }
+    QScopedPointer<EngineEffectChain> pChain(
+            createChain({pEffect1.data(), pEffect2.data()}));
+    EngineEffectScratchBuffers scratch;
+
+    mixxx::SampleBuffer output(kFrames * mixxx::kEngineChannelCount);
+    mixxx::SampleBuffer reference1(kFrames * mixxx::kEngineChannelCount);
+    mixxx::SampleBuffer reference2(kFrames * mixxx::kEngineChannelCount);
+    for (int callback = 0; callback < 3; ++callback) {
+        const mixxx::SampleBuffer& input = callback % 2 ? m_input2 : m_input1;
+        pChain->onCallbackStart();
+        EXPECT_TRUE(pChain->process(m_input.handle(), m_master.handle(),
+                input.data(), output.data(), kFrames * mixxx::kEngineChannelCount,
+                kSampleRate, m_features, &scratch));
+
+        // The chain is enabling for the channel in the first callback
+        const EffectEnableState chainEnableState = callback == 0 ?
+                EffectEnableState::Enabling : EffectEnableState::Enabled;
+        EXPECT_TRUE(pReference1->process(m_input.handle(), m_master.handle(),
+                input.data(), reference1.data(), kFrames * mixxx::kEngineChannelCount,
+                kSampleRate, chainEnableState, m_features));
+        EXPECT_TRUE(pReference2->process(m_input.handle(), m_master.handle(),
+                reference1.data(), reference2.data(), kFrames * mixxx::kEngineChannelCount,
+                kSampleRate, chainEnableState, m_features));
+        // The mix knob ramps up from dry in the first callback
+        if (callback == 0) {
+            continue;
+        }
+        for (int i = 0; i < kFrames * mixxx::kEngineChannelCount; ++i) {
+            EXPECT_FLOAT_EQ(reference2[i], output[i]);
+        }
+    }
+}
+
+TEST_F(EngineEffectChainTest, DisabledPlanarEffectsAreNotDeinterleaved) {
+    QScopedPointer<EngineEffect> pEffect1(createBitCrusher(QSet<ChannelHandleAndGroup>()));
+    QScopedPointer<EngineEffect> pEffect2(createBitCrusher(QSet<ChannelHandleAndGroup>()));
+    QScopedPointer<EngineEffectChain> pChain(
+            createChain({pEffect1.data(), pEffect2.data()}));
+    EngineEffectScratchBuffers scratch;
+    SampleUtil::fill(scratch.planarBuffer1.data(), 42.0f, scratch.planarBuffer1.size());
+
+    mixxx::SampleBuffer output(kFrames * mixxx::kEngineChannelCount);
+    pChain->onCallbackStart();
+    EXPECT_FALSE(pChain->process(m_input.handle(), m_master.handle(),
+            m_input1.data(), output.data(), kFrames * mixxx::kEngineChannelCount,
+            kSampleRate, m_features, &scratch));
+    for (int i = 0; i < kFrames; ++i) {
+        EXPECT_EQ(42.0f, scratch.planar1[0][i]);
+        EXPECT_EQ(42.0f, scratch.planar1[1][i]);
+    }
+
+    // Once an effect is enabled the signal is deinterleaved for it
+    setEnabled(pEffect2.data(), true);
+    pChain->onCallbackStart();
+    EXPECT_TRUE(pChain->process(m_input.handle(), m_master.handle(),
+            m_input1.data(), output.data(), kFrames * mixxx::kEngineChannelCount,
+            kSampleRate, m_features, &scratch));
+    EXPECT_EQ(m_input1[0], scratch.planar1[0][0]);
+    EXPECT_EQ(m_input1[1], scratch.planar1[1][0]);
+}
+
+} // anonymous namespace
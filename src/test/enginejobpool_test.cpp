@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "engine/enginejobpool.h"
+
+namespace {
+
+class CountingJob : public EngineJob {
+  public:
+    CountingJob()
+            : m_runs(0),
+              m_lastThreadIndex(-1) {
+    }
+
+    void run(int threadIndex) override {
+        m_runs.fetch_add(1);
+        m_lastThreadIndex = threadIndex;
+    }
+
+    std::atomic<int> m_runs;
+    int m_lastThreadIndex;
+};
+
+TEST(EngineJobPoolTest, EveryJobRunsOncePerBatch) {
+    EngineJobPool pool(3);
+    ASSERT_EQ(3, pool.workerCount());
+
+    std::vector<CountingJob> jobs(16);
+    std::vector<EngineJob*> pJobs;
+    for (auto& job : jobs) {
+        pJobs.push_back(&job);
+    }
+
+    const int kBatches = 1000;
+    for (int batch = 0; batch < kBatches; ++batch) {
+        // Vary the batch size to catch workers that run jobs of a
+        // previous batch
+        const int numJobs = 1 + batch % static_cast<int>(pJobs.size());
+        pool.run(pJobs.data(), numJobs);
+        for (int i = 0; i < numJobs; ++i) {
+            EXPECT_GE(jobs[i].m_lastThreadIndex, 0);
+            EXPECT_LE(jobs[i].m_lastThreadIndex, pool.workerCount());
+        }
+    }
+
+    int totalRuns = 0;
+    for (int i = 0; i < static_cast<int>(jobs.size()); ++i) {
+        int expectedRuns = 0;
+        for (int batch = 0; batch < kBatches; ++batch) {
+            if (i < 1 + batch % static_cast<int>(jobs.size())) {
+                ++expectedRuns;
+            }
+        }
+        EXPECT_EQ(expectedRuns, jobs[i].m_runs.load());
+        totalRuns += jobs[i].m_runs.load();
+    }
+    EXPECT_GT(totalRuns, 0);
+}
+
+TEST(EngineJobPoolTest, WithoutWorkersJobsRunOnCallingThread) {
+    EngineJobPool pool(0);
+    std::vector<CountingJob> jobs(4);
+    std::vector<EngineJob*> pJobs;
+    for (auto& job : jobs) {
+        pJobs.push_back(&job);
+    }
+    pool.run(pJobs.data(), static_cast<int>(pJobs.size()));
+    for (const auto& job : jobs) {
+        EXPECT_EQ(1, job.m_runs.load());
+        EXPECT_EQ(0, job.m_lastThreadIndex);
+    }
+}
+
+// Waits until the other job has started too, which only happens if a worker
+// runs it.
+class RendezvousJob : public EngineJob {
+  public:
+    explicit RendezvousJob(std::atomic<int>* pStarted)
+            : m_pStarted(pStarted),
+              m_metOther(false) {
+    }
+
+    void run(int threadIndex) override {
+        Q_UNUSED(threadIndex);
+        m_pStarted->fetch_add(1);
+        const auto deadline =
+                std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (m_pStarted->load() < 2) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return;
+            }
+        }
+        m_metOther = true;
+    }
+
+    std::atomic<int>* const m_pStarted;
+    bool m_metOther;
+};
+
+TEST(EngineJobPoolTest, SleepingWorkersAreWoken) {
+    EngineJobPool pool(1);
+    for (int callback = 0; callback < 10; ++callback) {
+        // Long enough for the worker to go to sleep
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        std::atomic<int> started(0);
+        RendezvousJob job1(&started);
+        RendezvousJob job2(&started);
+        EngineJob* pJobs[] = {&job1, &job2};
+        pool.run(pJobs, 2);
+        EXPECT_TRUE(job1.m_metOther);
+        EXPECT_TRUE(job2.m_metOther);
+    }
+}
+
+} // namespace
@@ -5,6 +5,8 @@
 // * vinyl??
 
 #include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
@@ -13,6 +15,7 @@
 #include "preferences/usersettings.h"
 #include "control/controlobject.h"
 #include "engine/controls/bpmcontrol.h"
+#include "engine/sync/enginesync.h"
 #include "engine/sync/synccontrol.h"
 #include "test/mockedenginebackendtest.h"
 #include "test/mixxxtest.h"
@@ -1653,3 +1656,148 @@ TEST_F(EngineSyncTest, ChangeBeatGrid) {
     EXPECT_FLOAT_EQ(130.0, ControlObject::get(ConfigKey(m_sInternalClockGroup, "bpm")));
 }
 
+namespace {
+
+// A Syncable without controls that reports to EngineSync like SyncControl
+// does from EngineBuffer::postProcess().
+class FakeSyncable : public Syncable {
+  public:
+    explicit FakeSyncable(const QString& group)
+            : m_group(group),
+              m_mode(SYNC_NONE),
+              m_bpm(120.0),
+              m_beatDistance(0.0),
+              m_masterUpdates(0) {
+    }
+
+    const QString& getGroup() const override {
+        return m_group;
+    }
+    EngineChannel* getChannel() const override {
+        return nullptr;
+    }
+    void notifySyncModeChanged(SyncMode mode) override {
+        m_mode = mode;
+    }
+    void notifyOnlyPlayingSyncable() override {
+    }
+    void requestSync() override {
+    }
+    SyncMode getSyncMode() const override {
+        return m_mode;
+    }
+    bool isPlaying() const override {
+        return true;
+    }
+    double getBpm() const override {
+        return m_bpm;
+    }
+    double getBeatDistance() const override {
+        return m_beatDistance;
+    }
+    double getBaseBpm() const override {
+        return m_bpm;
+    }
+    void setMasterBeatDistance(double beatDistance) override {
+        m_beatDistance = beatDistance;
+        ++m_masterUpdates;
+    }
+    void setMasterBaseBpm(double) override {
+    }
+    void setMasterBpm(double bpm) override {
+        m_bpm = bpm;
+    }
+    void setMasterParams(double beatDistance, double baseBpm, double bpm) override {
+        Q_UNUSED(baseBpm);
+        m_beatDistance = beatDistance;
+        m_bpm = bpm;
+    }
+    void setInstantaneousBpm(double) override {
+    }
+
+    void process(EngineSync* pEngineSync) {
+        if (m_mode == SYNC_MASTER) {
+            m_beatDistance += 0.01;
+            if (m_beatDistance >= 1.0) {
+                m_beatDistance -= 1.0;
+            }
+            pEngineSync->notifyBeatDistanceChanged(this, m_beatDistance);
+        } else {
+            pEngineSync->notifyInstantaneousBpmChanged(this, m_bpm);
+        }
+    }
+
+    int masterUpdates() const {
+        return m_masterUpdates;
+    }
+
+  private:
+    const QString m_group;
+    SyncMode m_mode;
+    double m_bpm;
+    double m_beatDistance;
+    int m_masterUpdates;
+};
+
+constexpr int kSampleRate = 44100;
+constexpr int kBufferSize = 1024;
+
+class EngineSyncSyncablesTest : public MixxxTest {
+};
+
+TEST_F(EngineSyncSyncablesTest, OnlySynchronizedSyncablesFollowMaster) {
+    EngineSync engineSync(config());
+    FakeSyncable master("[Channel1]");
+    FakeSyncable follower("[Channel2]");
+    FakeSyncable sampler("[Sampler1]");
+    engineSync.addSyncableDeck(&master);
+    engineSync.addSyncableDeck(&follower);
+    engineSync.addSyncableDeck(&sampler);
+
+    engineSync.requestSyncMode(&master, SYNC_MASTER);
+    engineSync.requestSyncMode(&follower, SYNC_FOLLOWER);
+    ASSERT_EQ(&master, engineSync.getMasterSyncable());
+
+    master.process(&engineSync);
+    follower.process(&engineSync);
+    sampler.process(&engineSync);
+    EXPECT_EQ(1, follower.masterUpdates());
+    EXPECT_DOUBLE_EQ(master.getBeatDistance(), follower.getBeatDistance());
+    EXPECT_EQ(0, sampler.masterUpdates());
+    EXPECT_EQ(0, master.masterUpdates());
+
+    // A follower that disables sync doesn't receive any more updates
+    engineSync.requestEnableSync(&follower, false);
+    master.process(&engineSync);
+    EXPECT_EQ(1, follower.masterUpdates());
+    EXPECT_EQ(0, sampler.masterUpdates());
+}
+
+// The cost of the sync updates of one engine callback with
+// state.range_x() players of which half are synchronized.
+static void BM_EngineSyncCallback(benchmark::State& state) {
+    UserSettingsPointer pConfig(new UserSettings(QString()));
+    EngineSync engineSync(pConfig);
+    const int numPlayers = state.range_x();
+    std::vector<std::unique_ptr<FakeSyncable>> players;
+    for (int i = 0; i < numPlayers; ++i) {
+        players.push_back(std::make_unique<FakeSyncable>(
+                QString("[Channel%1]").arg(i + 1)));
+        engineSync.addSyncableDeck(players.back().get());
+    }
+    engineSync.requestSyncMode(players[0].get(), SYNC_MASTER);
+    for (int i = 1; i < numPlayers / 2; ++i) {
+        engineSync.requestSyncMode(players[i].get(), SYNC_FOLLOWER);
+    }
+
+    while (state.KeepRunning()) {
+        engineSync.onCallbackStart(kSampleRate, kBufferSize);
+        for (const auto& pPlayer : players) {
+            pPlayer->process(&engineSync);
+        }
+        engineSync.onCallbackEnd(kSampleRate, kBufferSize);
+    }
+}
+BENCHMARK(BM_EngineSyncCallback)->Arg(4)->Arg(8)->Arg(16);
+
+} // anonymous namespace
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "util/compatibility.h"
+#include "util/filecopier.h"
+
+namespace {
+
+class FileCopierTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        m_sourcePath = m_tempDir.filePath("source.bin");
+        m_destPath = m_tempDir.filePath("dest.bin");
+
+        // Larger than a single chunk of the stream buffer
+        m_data.resize(5 * 1024 * 1024 + 123);
+        for (int i = 0; i < m_data.size(); ++i) {
+            m_data[i] = static_cast<char>(i * 31);
+        }
+        QFile sourceFile(m_sourcePath);
+        ASSERT_TRUE(sourceFile.open(QIODevice::WriteOnly));
+        ASSERT_EQ(m_data.size(), sourceFile.write(m_data));
+    }
+
+    QByteArray readDest() const {
+        QFile destFile(m_destPath);
+        if (!destFile.open(QIODevice::ReadOnly)) {
+            return QByteArray();
+        }
+        return destFile.readAll();
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_sourcePath;
+    QString m_destPath;
+    QByteArray m_data;
+};
+
+TEST_F(FileCopierTest, Copy) {
+    QAtomicInteger<qint64> bytesCopied = 0;
+    mixxx::FileCopier copier;
+    copier.setProgress(&bytesCopied, nullptr);
+    ASSERT_TRUE(copier.copy(m_sourcePath, m_destPath));
+    EXPECT_NE(mixxx::FileCopier::Method::None, copier.method());
+    EXPECT_EQ(m_data.size(), atomicLoadRelaxed(bytesCopied));
+    EXPECT_EQ(m_data, readDest());
+}
+
+TEST_F(FileCopierTest, CopyAndVerify) {
+    mixxx::FileCopier copier;
+    copier.setVerify(true);
+    ASSERT_TRUE(copier.copy(m_sourcePath, m_destPath));
+    EXPECT_EQ(m_data, readDest());
+}
+
+TEST_F(FileCopierTest, Overwrite) {
+    QFile destFile(m_destPath);
+    ASSERT_TRUE(destFile.open(QIODevice::WriteOnly));
+    destFile.write(QByteArray(m_data.size() * 2, 'x'));
+    destFile.close();
+
+    mixxx::FileCopier copier;
+    ASSERT_TRUE(copier.copy(m_sourcePath, m_destPath));
+    EXPECT_EQ(m_data, readDest());
+}
+
+TEST_F(FileCopierTest, Abort) {
+    const QAtomicInt stop = true;
+    mixxx::FileCopier copier;
+    copier.setProgress(nullptr, &stop);
+    // A reflink is not aborted, because it doesn't take any time
+    if (copier.copy(m_sourcePath, m_destPath)) {
+        EXPECT_EQ(mixxx::FileCopier::Method::Reflink, copier.method());
+    } else {
+        EXPECT_FALSE(copier.errorString().isEmpty());
+        EXPECT_FALSE(QFile::exists(m_destPath));
+    }
+}
+
+TEST_F(FileCopierTest, MissingSource) {
+    mixxx::FileCopier copier;
+    EXPECT_FALSE(copier.copy(m_tempDir.filePath("missing.bin"), m_destPath));
+    EXPECT_FALSE(copier.errorString().isEmpty());
+}
+
+} // anonymous namespace
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include "test/fingerprintvalues.h"
+#include "track/fingerprint.h"
+
+namespace {
+
+// Deterministic pseudo random sub-fingerprints
+QVector<quint32> randomValues(int size, quint32 seed) {
+    QVector<quint32> values;
+    values.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        values.append(seed);
+    }
+    return values;
+}
+
+int countSharedKeys(const mixxx::Fingerprint& first, const mixxx::Fingerprint& second) {
+    const auto keys = first.indexKeys();
+    int count = 0;
+    for (const auto key : second.indexKeys()) {
+        count += keys.count(key);
+    }
+    return count;
+}
+
+class FingerprintTest : public testing::Test {
+};
+
+TEST_F(FingerprintTest, BlobRoundTrip) {
+    const mixxx::Fingerprint fingerprint(randomValues(1000, 1));
+    const QByteArray blob = fingerprint.toBlob();
+    EXPECT_EQ(4000, blob.size());
+    EXPECT_EQ(fingerprint.values(), mixxx::Fingerprint::fromBlob(blob).values());
+}
+
+TEST_F(FingerprintTest, TooShort) {
+    const mixxx::Fingerprint fingerprint(randomValues(50, 1));
+    EXPECT_TRUE(fingerprint.indexKeys().isEmpty());
+    EXPECT_EQ(0.0, fingerprint.similarity(fingerprint));
+}
+
+TEST_F(FingerprintTest, Identical) {
+    const mixxx::Fingerprint fingerprint(randomValues(1000, 1));
+    EXPECT_EQ(mixxx::Fingerprint::kNumBands, fingerprint.indexKeys().size());
+    EXPECT_EQ(1.0, fingerprint.similarity(fingerprint));
+}
+
+TEST_F(FingerprintTest, Shifted) {
+    const QVector<quint32> values = randomValues(1000, 1);
+    const mixxx::Fingerprint fingerprint(values);
+    // Starts 10 sub-fingerprints later, i.e. with less leading silence
+    const mixxx::Fingerprint shifted(values.mid(10));
+    EXPECT_EQ(1.0, fingerprint.similarity(shifted));
+    EXPECT_EQ(1.0, shifted.similarity(fingerprint));
+}
+
+TEST_F(FingerprintTest, BitErrors) {
+    const QVector<quint32> values = audioLikeValues(1100, 1);
+    const mixxx::Fingerprint fingerprint(values.mid(0, 1000));
+    for (const double errorRate : {0.05, 0.1, 0.15}) {
+        // Shifted and with bit errors spread over all bits
+        const mixxx::Fingerprint reencoded(
+                withBitErrors(values.mid(20), errorRate, 2));
+        EXPECT_NEAR(1.0 - errorRate, fingerprint.similarity(reencoded), 0.01);
+        EXPECT_LT(0, countSharedKeys(fingerprint, reencoded));
+    }
+}
+
+TEST_F(FingerprintTest, BitErrorsOfManyTracks) {
+    int missed = 0;
+    for (quint32 seed = 1; seed <= 100; ++seed) {
+        const QVector<quint32> values = audioLikeValues(1100, seed);
+        const mixxx::Fingerprint fingerprint(values.mid(0, 1000));
+        const mixxx::Fingerprint reencoded(
+                withBitErrors(values.mid(20), 0.1, seed + 1));
+        if (countSharedKeys(fingerprint, reencoded) == 0) {
+            ++missed;
+        }
+    }
+    EXPECT_EQ(0, missed);
+}
+
+TEST_F(FingerprintTest, UnrelatedAudio) {
+    const mixxx::Fingerprint fingerprint(audioLikeValues(1000, 1));
+    for (quint32 seed = 2; seed <= 10; ++seed) {
+        const mixxx::Fingerprint other(audioLikeValues(1000, seed));
+        EXPECT_LT(fingerprint.similarity(other), 0.6);
+        EXPECT_EQ(0, countSharedKeys(fingerprint, other));
+    }
+}
+
+TEST_F(FingerprintTest, Unrelated) {
+    const mixxx::Fingerprint fingerprint(randomValues(1000, 1));
+    const mixxx::Fingerprint other(randomValues(1000, 2));
+    EXPECT_LT(fingerprint.similarity(other), 0.75);
+    EXPECT_EQ(0, countSharedKeys(fingerprint, other));
+}
+
+} // anonymous namespace
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <QtSql>
+
+#include "library/dao/fingerprintdao.h"
+#include "test/fingerprintvalues.h"
+#include "test/librarytest.h"
+
+namespace {
+
+class FingerprintDAOTest : public LibraryTest {
+  protected:
+    FingerprintDAOTest()
+            : m_fingerprintDao(internalCollection()->getFingerprintDAO()) {
+    }
+
+    TrackId addTrack(int number) {
+        TrackPointer pTrack = Track::newTemporary(TrackFile(
+                QDir(QDir::tempPath()), QString("track%1.mp3").arg(number)));
+        return internalCollection()->addTrack(pTrack, false);
+    }
+
+    int countIndexKeys(TrackId trackId) {
+        QSqlQuery query(dbConnection());
+        query.prepare("SELECT COUNT(*) FROM " FINGERPRINT_KEY_TABLE
+                      " WHERE track_id=:track_id");
+        query.bindValue(":track_id", trackId.toVariant());
+        EXPECT_TRUE(query.exec());
+        EXPECT_TRUE(query.next());
+        return query.value(0).toInt();
+    }
+
+    FingerprintDAO& m_fingerprintDao;
+};
+
+TEST_F(FingerprintDAOTest, SaveAndGet) {
+    const TrackId trackId = addTrack(1);
+    EXPECT_FALSE(m_fingerprintDao.hasFingerprint(trackId));
+    EXPECT_TRUE(m_fingerprintDao.getFingerprint(trackId).isEmpty());
+
+    const mixxx::Fingerprint fingerprint(audioLikeValues(1000, 1));
+    ASSERT_TRUE(m_fingerprintDao.saveFingerprint(trackId, fingerprint));
+    EXPECT_TRUE(m_fingerprintDao.hasFingerprint(trackId));
+    EXPECT_EQ(fingerprint.values(), m_fingerprintDao.getFingerprint(trackId).values());
+    EXPECT_EQ(mixxx::Fingerprint::kNumBands, countIndexKeys(trackId));
+}
+
+TEST_F(FingerprintDAOTest, SaveReplacesFingerprint) {
+    const TrackId trackId = addTrack(1);
+    ASSERT_TRUE(m_fingerprintDao.saveFingerprint(
+            trackId, mixxx::Fingerprint(audioLikeValues(1000, 1))));
+
+    const mixxx::Fingerprint fingerprint(audioLikeValues(1000, 2));
+    ASSERT_TRUE(m_fingerprintDao.saveFingerprint(trackId, fingerprint));
+    EXPECT_EQ(fingerprint.values(), m_fingerprintDao.getFingerprint(trackId).values());
+    // The index keys of the old fingerprint are gone
+    EXPECT_EQ(mixxx::Fingerprint::kNumBands, countIndexKeys(trackId));
+}
+
+TEST_F(FingerprintDAOTest, DeleteFingerprints) {
+    const TrackId trackId = addTrack(1);
+    const TrackId otherTrackId = addTrack(2);
+    ASSERT_TRUE(m_fingerprintDao.saveFingerprint(
+            trackId, mixxx::Fingerprint(audioLikeValues(1000, 1))));
+    ASSERT_TRUE(m_fingerprintDao.saveFingerprint(
+            otherTrackId, mixxx::Fingerprint(audioLikeValues(1000, 2))));
+
+    ASSERT_TRUE(m_fingerprintDao.deleteFingerprints(QList<TrackId>{trackId}));
+    EXPECT_FALSE(m_fingerprintDao.hasFingerprint(trackId));
+    EXPECT_EQ(0, countIndexKeys(trackId));
+    EXPECT_TRUE(m_fingerprintDao.hasFingerprint(otherTrackId));
+    EXPECT_EQ(mixxx::Fingerprint::kNumBands, countIndexKeys(otherTrackId));
+}
+
+TEST_F(FingerprintDAOTest, FindDuplicatesOfTrack) {
+    const QVector<quint32> values = audioLikeValues(1100, 1);
+    const TrackId trackId = addTrack(1);
+    ASSERT_TRUE(m_fingerprintDao.saveFingerprint(
+            trackId, mixxx::Fingerprint(values.mid(0, 1000))));
+    // The same recording from a different encoding
+    const TrackId duplicateTrackId = addTrack(2);
+    ASSERT_TRUE(m_fingerprintDao.saveFingerprint(
+            duplicateTrackId, mixxx::Fingerprint(withBitErrors(values.mid(20), 0.1, 2))));
+    const TrackId unrelatedTrackId = addTrack(3);
+    ASSERT_TRUE(m_fingerprintDao.saveFingerprint(
+            unrelatedTrackId, mixxx::Fingerprint(audioLikeValues(1000, 3))));
+
+    const auto duplicates = m_fingerprintDao.findDuplicatesOfTrack(trackId);
+    ASSERT_EQ(1, duplicates.size());
+    EXPECT_EQ(trackId, duplicates[0].trackId);
+    EXPECT_EQ(duplicateTrackId, duplicates[0].duplicateTrackId);
+    EXPECT_NEAR(0.9, duplicates[0].similarity, 0.01);
+
+    EXPECT_TRUE(m_fingerprintDao.findDuplicatesOfTrack(unrelatedTrackId).isEmpty());
+    // Not similar enough
+    EXPECT_TRUE(m_fingerprintDao.findDuplicatesOfTrack(trackId, 0.95).isEmpty());
+}
+
+TEST_F(FingerprintDAOTest, IgnoreGenericIndexKeys) {
+    // Tracks of silence share all their keys
+    const mixxx::Fingerprint fingerprint(audioLikeValues(1000, 1));
+    QList<TrackId> trackIds;
+    for (int i = 0; i < 65; ++i) {
+        trackIds.append(addTrack(i));
+        ASSERT_TRUE(m_fingerprintDao.saveFingerprint(trackIds.last(), fingerprint));
+    }
+    EXPECT_TRUE(m_fingerprintDao.findDuplicatesOfTrack(trackIds.first()).isEmpty());
+
+    ASSERT_TRUE(m_fingerprintDao.deleteFingerprints(trackIds.mid(1, 60)));
+    EXPECT_EQ(4, m_fingerprintDao.findDuplicatesOfTrack(trackIds.first()).size());
+}
+
+} // anonymous namespace
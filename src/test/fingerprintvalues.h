@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QVector>
+
+// Sub-fingerprints for testing fingerprints without decoding audio
+
+// Pseudo random numbers in [0, 1)
+class PseudoRandom {
+  public:
+    explicit PseudoRandom(quint32 seed)
+            : m_state(seed) {
+    }
+    double next() {
+        m_state = m_state * 1664525u + 1013904223u;
+        return (m_state >> 8) / 16777216.0;
+    }
+
+  private:
+    quint32 m_state;
+};
+
+// Sub-fingerprints with the properties of real audio: Each bit is set with
+// a different probability and tends to keep its value for a while.
+inline QVector<quint32> audioLikeValues(int size, quint32 seed) {
+    PseudoRandom random(seed);
+    double keepSet[32];
+    double keepCleared[32];
+    bool bits[32];
+    for (int bit = 0; bit < 32; ++bit) {
+        keepSet[bit] = 0.6 + 0.37 * random.next();
+        keepCleared[bit] = 0.6 + 0.37 * random.next();
+        bits[bit] = random.next() < 0.5;
+    }
+    QVector<quint32> values;
+    values.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        quint32 value = 0;
+        for (int bit = 0; bit < 32; ++bit) {
+            bits[bit] = random.next() <
+                    (bits[bit] ? keepSet[bit] : 1.0 - keepCleared[bit]);
+            value |= static_cast<quint32>(bits[bit]) << bit;
+        }
+        values.append(value);
+    }
+    return values;
+}
+
+// Flips each bit with the same probability like a different encoding
+// of the same recording
+inline QVector<quint32> withBitErrors(QVector<quint32> values, double errorRate, quint32 seed) {
+    PseudoRandom random(seed);
+    for (auto& value : values) {
+        for (int bit = 0; bit < 32; ++bit) {
+            if (random.next() < errorRate) {
+                value ^= 1u << bit;
+            }
+        }
+    }
+    return values;
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QScopedPointer>
+#include <QTemporaryDir>
+
+#include "control/controlobject.h"
+#include "skin/legacyskinparser.h"
+#include "test/mixxxtest.h"
+#include "widget/wwidgetgroup.h"
+#include "widget/wwidgetstack.h"
+
+namespace {
+
+// A stack of three pages, the second one selected by its trigger, and a
+// group that is hidden by its connection.
+const QByteArray kSkin =
+        "<skin>"
+        "  <Layout>vertical</Layout>"
+        "  <Children>"
+        "    <WidgetStack currentpage=\"[SkinTest],page\">"
+        "      <ObjectName>Stack</ObjectName>"
+        "      <Children>"
+        "        <WidgetGroup><ObjectName>Page0</ObjectName></WidgetGroup>"
+        "        <WidgetGroup trigger=\"[SkinTest],page1\">"
+        "          <ObjectName>Page1</ObjectName>"
+        "        </WidgetGroup>"
+        "        <WidgetGroup><ObjectName>Page2</ObjectName></WidgetGroup>"
+        "      </Children>"
+        "    </WidgetStack>"
+        "    <WidgetGroup>"
+        "      <ObjectName>Collapsed</ObjectName>"
+        "      <Layout>vertical</Layout>"
+        "      <Connection>"
+        "        <ConfigKey>[SkinTest],show_collapsed</ConfigKey>"
+        "        <BindProperty>visible</BindProperty>"
+        "      </Connection>"
+        "      <Children>"
+        "        <WidgetGroup>"
+        "          <ObjectName>CollapsedChild</ObjectName>"
+        "          <Connection>"
+        "            <ConfigKey>[SkinTest],collapsed_child</ConfigKey>"
+        "            <BindProperty>enabled</BindProperty>"
+        "          </Connection>"
+        "        </WidgetGroup>"
+        "      </Children>"
+        "    </WidgetGroup>"
+        "  </Children>"
+        "</skin>";
+
+class LegacySkinParserTest : public MixxxTest {
+  protected:
+    LegacySkinParserTest()
+            : m_pageTrigger(ConfigKey("[SkinTest]", "page1")),
+              m_pendingDeferredCount(0) {
+        QFile file(m_skinDir.path() + "/skin.xml");
+        EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(kSkin);
+        m_pageTrigger.set(1.0);
+    }
+
+    // The parser is parented to the skin if it has deferred subtrees
+    QWidget* parseSkin(bool lazy) {
+        LegacySkinParser* pParser = new LegacySkinParser(config());
+        pParser->setLazyConstruction(lazy);
+        QWidget* pSkin = pParser->parseSkin(m_skinDir.path(), nullptr);
+        m_pendingDeferredCount = pParser->pendingDeferredCount();
+        if (pSkin != nullptr && m_pendingDeferredCount > 0) {
+            pParser->setParent(pSkin);
+        } else {
+            delete pParser;
+        }
+        return pSkin;
+    }
+
+    QTemporaryDir m_skinDir;
+    ControlObject m_pageTrigger;
+    int m_pendingDeferredCount;
+};
+
+TEST_F(LegacySkinParserTest, EagerConstruction) {
+    QScopedPointer<QWidget> pSkin(parseSkin(false));
+    ASSERT_FALSE(pSkin.isNull());
+    EXPECT_EQ(0, m_pendingDeferredCount);
+    EXPECT_NE(nullptr, pSkin->findChild<QWidget*>("Page2"));
+    EXPECT_NE(nullptr, pSkin->findChild<QWidget*>("CollapsedChild"));
+    EXPECT_NE(nullptr, ControlObject::getControl(
+            ConfigKey("[SkinTest]", "collapsed_child"), false));
+}
+
+TEST_F(LegacySkinParserTest, HiddenSubtreesAreCreatedWhenShown) {
+    QScopedPointer<QWidget> pSkin(parseSkin(true));
+    ASSERT_FALSE(pSkin.isNull());
+    // The third page and the children of the collapsed group
+    EXPECT_EQ(2, m_pendingDeferredCount);
+    EXPECT_EQ(nullptr, pSkin->findChild<QWidget*>("Page2"));
+    EXPECT_EQ(nullptr, pSkin->findChild<QWidget*>("CollapsedChild"));
+    // Controls of deferred subtrees don't exist until they are shown
+    EXPECT_EQ(nullptr, ControlObject::getControl(
+            ConfigKey("[SkinTest]", "collapsed_child"), false));
+
+    pSkin->show();
+    WWidgetGroup* pCollapsed = pSkin->findChild<WWidgetGroup*>("Collapsed");
+    ASSERT_NE(nullptr, pCollapsed);
+    pCollapsed->show();
+    EXPECT_NE(nullptr, pSkin->findChild<QWidget*>("CollapsedChild"));
+    EXPECT_NE(nullptr, ControlObject::getControl(
+            ConfigKey("[SkinTest]", "collapsed_child"), false));
+
+    WWidgetStack* pStack = pSkin->findChild<WWidgetStack*>("Stack");
+    ASSERT_NE(nullptr, pStack);
+    pStack->setCurrentIndex(2);
+    QWidget* pPage2 = pSkin->findChild<QWidget*>("Page2");
+    ASSERT_NE(nullptr, pPage2);
+    EXPECT_TRUE(pPage2->isVisible());
+}
+
+TEST_F(LegacySkinParserTest, PagesSelectedByTriggerAreNotDeferred) {
+    QScopedPointer<QWidget> pSkin(parseSkin(true));
+    ASSERT_FALSE(pSkin.isNull());
+    // The current page and the page with the trigger set
+    EXPECT_NE(nullptr, pSkin->findChild<QWidget*>("Page0"));
+    EXPECT_NE(nullptr, pSkin->findChild<QWidget*>("Page1"));
+
+    m_pageTrigger.set(0.0);
+    QScopedPointer<QWidget> pOtherSkin(parseSkin(true));
+    ASSERT_FALSE(pOtherSkin.isNull());
+    EXPECT_EQ(nullptr, pOtherSkin->findChild<QWidget*>("Page1"));
+}
+
+} // anonymous namespace
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <QtSql>
+
+#include "library/dao/playlistdao.h"
+#include "test/librarytest.h"
+
+namespace {
+
+// The distance between the keys of appended tracks
+constexpr int kPositionKeyGap = 1024;
+
+class PlaylistDAOTest : public LibraryTest {
+  protected:
+    PlaylistDAOTest()
+            : m_playlistDao(internalCollection()->getPlaylistDAO()),
+              m_playlistId(m_playlistDao.createPlaylist("Test")) {
+    }
+
+    TrackId addTrack(int number) {
+        TrackPointer pTrack = Track::newTemporary(TrackFile(
+                QDir(QDir::tempPath()), QString("track%1.mp3").arg(number)));
+        return internalCollection()->addTrack(pTrack, false);
+    }
+
+    QList<TrackId> addTracks(int count) {
+        QList<TrackId> trackIds;
+        for (int i = 0; i < count; ++i) {
+            trackIds.append(addTrack(i));
+        }
+        return trackIds;
+    }
+
+    // Returns the tracks of the playlist in their order
+    QList<TrackId> trackIds() {
+        QList<TrackId> trackIds;
+        QSqlQuery query(dbConnection());
+        query.prepare("SELECT track_id FROM PlaylistTracks "
+                      "WHERE playlist_id=:id ORDER BY position");
+        query.bindValue(":id", m_playlistId);
+        EXPECT_TRUE(query.exec());
+        while (query.next()) {
+            trackIds.append(TrackId(query.value(0)));
+        }
+        return trackIds;
+    }
+
+    // Returns the stored position keys of the tracks in their order
+    QList<int> positionKeys() {
+        QList<int> positionKeys;
+        QSqlQuery query(dbConnection());
+        query.prepare("SELECT position FROM PlaylistTracks "
+                      "WHERE playlist_id=:id ORDER BY position");
+        query.bindValue(":id", m_playlistId);
+        EXPECT_TRUE(query.exec());
+        while (query.next()) {
+            positionKeys.append(query.value(0).toInt());
+        }
+        return positionKeys;
+    }
+
+    PlaylistDAO& m_playlistDao;
+    const int m_playlistId;
+};
+
+TEST_F(PlaylistDAOTest, AppendTracks) {
+    const QList<TrackId> tracks = addTracks(3);
+    ASSERT_TRUE(m_playlistDao.appendTracksToPlaylist(tracks, m_playlistId));
+    EXPECT_EQ(tracks, trackIds());
+    EXPECT_EQ(3, m_playlistDao.getMaxPosition(m_playlistId));
+    EXPECT_EQ((QList<int>{kPositionKeyGap, 2 * kPositionKeyGap, 3 * kPositionKeyGap}),
+            positionKeys());
+}
+
+TEST_F(PlaylistDAOTest, InsertTracks) {
+    const QList<TrackId> tracks = addTracks(5);
+    ASSERT_TRUE(m_playlistDao.appendTracksToPlaylist(tracks.mid(0, 2), m_playlistId));
+    const QList<int> keys = positionKeys();
+
+    ASSERT_TRUE(m_playlistDao.insertTrackIntoPlaylist(tracks[2], m_playlistId, 2));
+    EXPECT_EQ((QList<TrackId>{tracks[0], tracks[2], tracks[1]}), trackIds());
+    EXPECT_EQ(2, m_playlistDao.insertTracksIntoPlaylist(
+            tracks.mid(3, 2), m_playlistId, 1));
+    EXPECT_EQ((QList<TrackId>{tracks[3], tracks[4], tracks[0], tracks[2], tracks[1]}),
+            trackIds());
+
+    // The surrounding tracks keep their keys
+    EXPECT_TRUE(positionKeys().contains(keys[0]));
+    EXPECT_TRUE(positionKeys().contains(keys[1]));
+}
+
+TEST_F(PlaylistDAOTest, MoveTrack) {
+    const QList<TrackId> tracks = addTracks(4);
+    ASSERT_TRUE(m_playlistDao.appendTracksToPlaylist(tracks, m_playlistId));
+
+    m_playlistDao.moveTrack(m_playlistId, 4, 1);
+    EXPECT_EQ((QList<TrackId>{tracks[3], tracks[0], tracks[1], tracks[2]}), trackIds());
+    m_playlistDao.moveTrack(m_playlistId, 1, 3);
+    EXPECT_EQ((QList<TrackId>{tracks[0], tracks[1], tracks[3], tracks[2]}), trackIds());
+    m_playlistDao.moveTrack(m_playlistId, 2, 4);
+    EXPECT_EQ((QList<TrackId>{tracks[0], tracks[3], tracks[2], tracks[1]}), trackIds());
+
+    // Only the key of the moved track changes
+    const QList<int> keys = positionKeys();
+    m_playlistDao.moveTrack(m_playlistId, 1, 2);
+    EXPECT_EQ((QList<TrackId>{tracks[3], tracks[0], tracks[2], tracks[1]}), trackIds());
+    EXPECT_EQ(keys[1], positionKeys()[0]);
+    EXPECT_EQ(keys.mid(2), positionKeys().mid(2));
+}
+
+TEST_F(PlaylistDAOTest, RemoveTracks) {
+    const QList<TrackId> tracks = addTracks(5);
+    ASSERT_TRUE(m_playlistDao.appendTracksToPlaylist(tracks, m_playlistId));
+    const QList<int> keys = positionKeys();
+
+    m_playlistDao.removeTrackFromPlaylist(m_playlistId, 2);
+    EXPECT_EQ((QList<TrackId>{tracks[0], tracks[2], tracks[3], tracks[4]}), trackIds());
+    m_playlistDao.removeTracksFromPlaylist(m_playlistId, QList<int>{1, 3});
+    EXPECT_EQ((QList<TrackId>{tracks[2], tracks[4]}), trackIds());
+    EXPECT_EQ(2, m_playlistDao.getMaxPosition(m_playlistId));
+
+    // The remaining tracks keep their keys
+    EXPECT_EQ((QList<int>{keys[2], keys[4]}), positionKeys());
+}
+
+TEST_F(PlaylistDAOTest, RenumberWhenGapIsExhausted) {
+    const QList<TrackId> tracks = addTracks(2);
+    ASSERT_TRUE(m_playlistDao.appendTracksToPlaylist(tracks, m_playlistId));
+
+    // Every insert halves the gap in front of the last track until it is
+    // exhausted
+    QList<TrackId> expectedTrackIds = tracks;
+    for (int i = 0; i < 12; ++i) {
+        const TrackId trackId = addTrack(i + 2);
+        ASSERT_TRUE(m_playlistDao.insertTrackIntoPlaylist(trackId, m_playlistId, 2));
+        expectedTrackIds.insert(1, trackId);
+        EXPECT_EQ(expectedTrackIds, trackIds());
+    }
+    EXPECT_NE(2 * kPositionKeyGap, positionKeys().last());
+
+    const QList<int> keys = positionKeys();
+    for (int i = 1; i < keys.size(); ++i) {
+        EXPECT_LT(keys[i - 1], keys[i]);
+    }
+}
+
+TEST_F(PlaylistDAOTest, RenumberWhenMovingIntoExhaustedGap) {
+    const QList<TrackId> tracks = addTracks(3);
+    ASSERT_TRUE(m_playlistDao.appendTracksToPlaylist(tracks, m_playlistId));
+
+    // Moves the track at 3 between the first two tracks back and forth
+    QList<TrackId> expectedTrackIds = tracks;
+    for (int i = 0; i < 12; ++i) {
+        m_playlistDao.moveTrack(m_playlistId, 3, 2);
+        expectedTrackIds.move(2, 1);
+        EXPECT_EQ(expectedTrackIds, trackIds());
+    }
+    EXPECT_EQ(3, positionKeys().toSet().size());
+}
+
+TEST_F(PlaylistDAOTest, TracksNotInLibraryHaveNoPosition) {
+    const QList<TrackId> tracks = addTracks(3);
+    ASSERT_TRUE(m_playlistDao.appendTracksToPlaylist(tracks.mid(0, 2), m_playlistId));
+    // A track that has been removed from the library behind the first track
+    const TrackId missingTrackId(1000);
+    QSqlQuery query(dbConnection());
+    query.prepare("INSERT INTO PlaylistTracks (playlist_id, track_id, position) "
+                  "VALUES (:id, :track_id, :position)");
+    query.bindValue(":id", m_playlistId);
+    query.bindValue(":track_id", missingTrackId.toVariant());
+    query.bindValue(":position", kPositionKeyGap + 1);
+    ASSERT_TRUE(query.exec());
+
+    // The positions are those of PlaylistTableModel
+    EXPECT_EQ(2, m_playlistDao.getMaxPosition(m_playlistId));
+    ASSERT_TRUE(m_playlistDao.insertTrackIntoPlaylist(tracks[2], m_playlistId, 2));
+    EXPECT_EQ((QList<TrackId>{tracks[0], tracks[2], missingTrackId, tracks[1]}),
+            trackIds());
+
+    m_playlistDao.moveTrack(m_playlistId, 3, 1);
+    EXPECT_EQ((QList<TrackId>{tracks[1], tracks[0], tracks[2], missingTrackId}),
+            trackIds());
+    m_playlistDao.removeTrackFromPlaylist(m_playlistId, 3);
+    EXPECT_EQ((QList<TrackId>{tracks[1], tracks[0], missingTrackId}), trackIds());
+}
+
+} // anonymous namespace
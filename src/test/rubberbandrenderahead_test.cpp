@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QThread>
+
+#include "engine/bufferscalers/rubberbandrenderahead.h"
+#include "engine/engineworkerscheduler.h"
+#include "test/mixxxtest.h"
+#include "track/track.h"
+
+namespace {
+
+const QString kTrackLocation = QDir::currentPath() + "/src/test/sine-30.wav";
+// Properties of the test file
+constexpr SINT kTrackSampleRate = 44100;
+constexpr SINT kTrackFrames = 1323000;
+
+constexpr qint64 kTimeoutMillis = 10000;
+
+class RubberBandRenderAheadTest : public MixxxTest {
+  protected:
+    RubberBandRenderAheadTest()
+            : m_renderAhead("[Channel1]") {
+        // The scheduler thread is not started. The test wakes the worker
+        // like the scheduler would after each audio callback.
+        m_renderAhead.setScheduler(&m_scheduler);
+        m_renderAhead.start();
+    }
+
+    ~RubberBandRenderAheadTest() override {
+        m_renderAhead.quitWait();
+    }
+
+    void loadTrack() {
+        m_renderAhead.newTrack(Track::newTemporary(kTrackLocation));
+        m_renderAhead.wakeIfNewTrack();
+    }
+
+    void request(int generation, SINT startFrame, double timeRatio) {
+        RubberBandRenderAhead::Request request;
+        request.generation = generation;
+        request.startFrame = startFrame;
+        request.sampleRate = kTrackSampleRate;
+        request.timeRatio = timeRatio;
+        request.pitchScale = 1.0;
+        m_renderAhead.requestRender(request);
+        m_renderAhead.wakeIfReady();
+    }
+
+    // Plays all rendered blocks until the end of the track and returns
+    // the number of rendered frames
+    SINT renderUntilEndOfTrack(int generation) {
+        SINT renderedFrames = 0;
+        QElapsedTimer timer;
+        timer.start();
+        while (timer.elapsed() < kTimeoutMillis) {
+            RubberBandRenderAhead::Block* pBlock = m_renderAhead.takeBlock();
+            if (!pBlock) {
+                m_renderAhead.wakeIfReady();
+                QThread::msleep(1);
+                continue;
+            }
+            EXPECT_EQ(generation, pBlock->generation);
+            EXPECT_LE(pBlock->numFrames, RubberBandRenderAhead::kBlockFrames);
+            renderedFrames += pBlock->numFrames;
+            const bool endOfTrack = pBlock->endOfTrack;
+            m_renderAhead.recycleBlock(pBlock);
+            m_renderAhead.wakeIfReady();
+            if (endOfTrack) {
+                return renderedFrames;
+            }
+        }
+        ADD_FAILURE() << "Timed out while rendering";
+        return renderedFrames;
+    }
+
+    EngineWorkerScheduler m_scheduler;
+    RubberBandRenderAhead m_renderAhead;
+};
+
+TEST_F(RubberBandRenderAheadTest, RenderUntilEndOfTrack) {
+    loadTrack();
+    const SINT inputFrames = 2 * kTrackSampleRate;
+    request(1, kTrackFrames - inputFrames, 1.0);
+    // The latency of the stretcher is not part of the output
+    EXPECT_NEAR(inputFrames, renderUntilEndOfTrack(1), 1024);
+}
+
+TEST_F(RubberBandRenderAheadTest, RenderStretched) {
+    loadTrack();
+    const SINT inputFrames = 2 * kTrackSampleRate;
+    request(1, kTrackFrames - inputFrames, 1.5);
+    EXPECT_NEAR(1.5 * inputFrames, renderUntilEndOfTrack(1), 1024);
+}
+
+TEST_F(RubberBandRenderAheadTest, LatestRequestReplacesStaleRequests) {
+    loadTrack();
+    const SINT inputFrames = kTrackSampleRate;
+    request(1, 0, 1.0);
+    request(2, kTrackFrames - inputFrames, 1.0);
+    // Blocks of the stale request are recycled like the engine does
+    SINT renderedFrames = 0;
+    QElapsedTimer timer;
+    timer.start();
+    bool endOfTrack = false;
+    while (!endOfTrack && timer.elapsed() < kTimeoutMillis) {
+        RubberBandRenderAhead::Block* pBlock = m_renderAhead.takeBlock();
+        if (!pBlock) {
+            m_renderAhead.wakeIfReady();
+            QThread::msleep(1);
+            continue;
+        }
+        if (pBlock->generation == 2) {
+            renderedFrames += pBlock->numFrames;
+            endOfTrack = pBlock->endOfTrack;
+        }
+        m_renderAhead.recycleBlock(pBlock);
+        m_renderAhead.wakeIfReady();
+    }
+    EXPECT_TRUE(endOfTrack);
+    EXPECT_NEAR(inputFrames, renderedFrames, 1024);
+}
+
+TEST_F(RubberBandRenderAheadTest, CancelStopsRendering) {
+    loadTrack();
+    request(1, 0, 1.0);
+    request(2, -1, 0.0);
+    // Wait until the worker has picked up both requests and drain all
+    // blocks that it might have rendered in between
+    QThread::msleep(100);
+    while (RubberBandRenderAhead::Block* pBlock = m_renderAhead.takeBlock()) {
+        EXPECT_EQ(1, pBlock->generation);
+        m_renderAhead.recycleBlock(pBlock);
+        m_renderAhead.wakeIfReady();
+    }
+    QThread::msleep(100);
+    EXPECT_EQ(nullptr, m_renderAhead.takeBlock());
+}
+
+TEST_F(RubberBandRenderAheadTest, NoTrack) {
+    request(1, 0, 1.0);
+    QThread::msleep(100);
+    EXPECT_EQ(nullptr, m_renderAhead.takeBlock());
+}
+
+} // anonymous namespace
@@ -4,8 +4,10 @@
 #include <QtDebug>
 #include <QList>
 #include <QPair>
+#include <QVector>
 
 #include "util/sample.h"
+#include "util/samplekernels.h"
 #include "util/timer.h"
 
 namespace {
@@ -435,6 +437,210 @@ TEST_F(SampleUtilTest, copyReverse) {
     }
 }
 
+TEST_F(SampleUtilTest, sumBuffers) {
+    const int kMaxSources = 20;
+    for (int size : sizes) {
+        QList<CSAMPLE*> sources;
+        for (int i = 0; i < kMaxSources; ++i) {
+            CSAMPLE* pSource = SampleUtil::alloc(size);
+            for (int j = 0; j < size; ++j) {
+                pSource[j] = (i + 1) * 0.01f - j * 0.0001f;
+            }
+            sources.append(pSource);
+        }
+        CSAMPLE* pDest = SampleUtil::alloc(size);
+        for (int numSources = 0; numSources <= kMaxSources; ++numSources) {
+            FillBuffer(pDest, 1.0f, size);
+            SampleUtil::sumBuffers(pDest, sources.toVector().constData(),
+                    numSources, size);
+            for (int j = 0; j < size; ++j) {
+                CSAMPLE expected = 0;
+                for (int i = 0; i < numSources; ++i) {
+                    expected += sources[i][j];
+                }
+                EXPECT_FLOAT_EQ(expected, pDest[j]);
+            }
+        }
+        SampleUtil::free(pDest);
+        for (CSAMPLE* pSource : sources) {
+            SampleUtil::free(pSource);
+        }
+    }
+}
+
+// A signal in [-1.5, 1.5] that clips in both channels
+void FillTestSignal(CSAMPLE* pBuffer, int length, int seed) {
+    for (int i = 0; i < length; ++i) {
+        pBuffer[i] = ((i * 37 + seed * 11) % 301 - 150) * 0.01f;
+    }
+}
+
+// The SIMD kernels handle the samples that do not fill a whole register
+// separately, so test every remainder of the widest registers
+class SampleKernelsTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        for (int numFrames = 0; numFrames <= 40; ++numFrames) {
+            frameCounts.append(numFrames);
+        }
+        frameCounts.append(513);
+        kernels = mixxx::SampleKernels::available();
+    }
+
+    QList<int> frameCounts;
+    QVector<const mixxx::SampleKernels*> kernels;
+};
+
+TEST_F(SampleKernelsTest, rampingGain) {
+    const mixxx::SampleKernels& generic = mixxx::SampleKernels::generic();
+    for (const mixxx::SampleKernels* pKernels : kernels) {
+        for (int numFrames : frameCounts) {
+            const int size = numFrames * 2;
+            QVector<CSAMPLE> src(size);
+            FillTestSignal(src.data(), size, 1);
+            QVector<CSAMPLE> expected(size);
+            QVector<CSAMPLE> actual(size);
+
+            FillTestSignal(expected.data(), size, 2);
+            FillTestSignal(actual.data(), size, 2);
+            generic.applyRampingGain(expected.data(), 0.1f, 0.01f, numFrames);
+            pKernels->applyRampingGain(actual.data(), 0.1f, 0.01f, numFrames);
+            for (int i = 0; i < size; ++i) {
+                EXPECT_NEAR(expected[i], actual[i], 1e-5f)
+                        << pKernels->name << " applyRampingGain " << numFrames;
+            }
+
+            generic.copyWithRampingGain(expected.data(), src.data(),
+                    1.0f, -0.002f, numFrames);
+            pKernels->copyWithRampingGain(actual.data(), src.data(),
+                    1.0f, -0.002f, numFrames);
+            for (int i = 0; i < size; ++i) {
+                EXPECT_NEAR(expected[i], actual[i], 1e-5f)
+                        << pKernels->name << " copyWithRampingGain " << numFrames;
+            }
+
+            FillTestSignal(expected.data(), size, 3);
+            FillTestSignal(actual.data(), size, 3);
+            generic.addWithRampingGain(expected.data(), src.data(),
+                    0.5f, 0.003f, numFrames);
+            pKernels->addWithRampingGain(actual.data(), src.data(),
+                    0.5f, 0.003f, numFrames);
+            for (int i = 0; i < size; ++i) {
+                EXPECT_NEAR(expected[i], actual[i], 1e-5f)
+                        << pKernels->name << " addWithRampingGain " << numFrames;
+            }
+        }
+    }
+}
+
+TEST_F(SampleKernelsTest, sumAbsPerChannel) {
+    const mixxx::SampleKernels& generic = mixxx::SampleKernels::generic();
+    for (const mixxx::SampleKernels* pKernels : kernels) {
+        for (int numFrames : frameCounts) {
+            const int size = numFrames * 2;
+            QVector<CSAMPLE> buffer(size);
+            FillTestSignal(buffer.data(), size, 4);
+            CSAMPLE expectedL, expectedR, actualL, actualR;
+            EXPECT_EQ(generic.sumAbsPerChannel(
+                              &expectedL, &expectedR, buffer.constData(), numFrames),
+                    pKernels->sumAbsPerChannel(
+                            &actualL, &actualR, buffer.constData(), numFrames))
+                    << pKernels->name << " " << numFrames;
+            // The kernels add in a different order
+            EXPECT_NEAR(expectedL, actualL, expectedL * 1e-5f);
+            EXPECT_NEAR(expectedR, actualR, expectedR * 1e-5f);
+
+            // A single clipping sample is detected in each channel and
+            // at each position
+            SampleUtil::applyGain(buffer.data(), 0.5f, size);
+            for (int i = 0; i < size; ++i) {
+                const CSAMPLE sample = buffer[i];
+                buffer[i] = -1.1f;
+                EXPECT_EQ(i % 2 ? SampleUtil::CLIPPING_RIGHT : SampleUtil::CLIPPING_LEFT,
+                        pKernels->sumAbsPerChannel(
+                                &actualL, &actualR, buffer.constData(), numFrames))
+                        << pKernels->name << " " << numFrames << " " << i;
+                buffer[i] = sample;
+            }
+        }
+    }
+}
+
+TEST_F(SampleKernelsTest, copyClampBuffer) {
+    for (const mixxx::SampleKernels* pKernels : kernels) {
+        for (int numFrames : frameCounts) {
+            const int size = numFrames * 2 + 1;
+            QVector<CSAMPLE> src(size);
+            FillTestSignal(src.data(), size, 5);
+            QVector<CSAMPLE> dest(size);
+            pKernels->copyClampBuffer(dest.data(), src.constData(), size);
+            for (int i = 0; i < size; ++i) {
+                EXPECT_EQ(SampleUtil::clampSample(src[i]), dest[i])
+                        << pKernels->name << " " << size;
+            }
+            // In place
+            pKernels->copyClampBuffer(src.data(), src.constData(), size);
+            EXPECT_EQ(dest, src) << pKernels->name << " " << size;
+        }
+    }
+}
+
+TEST_F(SampleKernelsTest, interleaveAndDeinterleave) {
+    for (const mixxx::SampleKernels* pKernels : kernels) {
+        for (int numFrames : frameCounts) {
+            QVector<CSAMPLE> left(numFrames);
+            QVector<CSAMPLE> right(numFrames);
+            FillTestSignal(left.data(), numFrames, 6);
+            FillTestSignal(right.data(), numFrames, 7);
+            // One more sample that must not be touched
+            QVector<CSAMPLE> interleaved(numFrames * 2 + 1, 2.0f);
+            pKernels->interleaveBuffer(interleaved.data(),
+                    left.constData(), right.constData(), numFrames);
+            for (int i = 0; i < numFrames; ++i) {
+                EXPECT_EQ(left[i], interleaved[i * 2]) << pKernels->name;
+                EXPECT_EQ(right[i], interleaved[i * 2 + 1]) << pKernels->name;
+            }
+            EXPECT_EQ(2.0f, interleaved.last()) << pKernels->name;
+
+            QVector<CSAMPLE> left2(numFrames + 1, 2.0f);
+            QVector<CSAMPLE> right2(numFrames + 1, 2.0f);
+            pKernels->deinterleaveBuffer(left2.data(), right2.data(),
+                    interleaved.constData(), numFrames);
+            EXPECT_EQ(left, left2.mid(0, numFrames)) << pKernels->name;
+            EXPECT_EQ(right, right2.mid(0, numFrames)) << pKernels->name;
+            EXPECT_EQ(2.0f, left2.last()) << pKernels->name;
+            EXPECT_EQ(2.0f, right2.last()) << pKernels->name;
+        }
+    }
+}
+
+TEST_F(SampleKernelsTest, sumBuffers) {
+    const mixxx::SampleKernels& generic = mixxx::SampleKernels::generic();
+    const int kMaxSources = 9;
+    for (const mixxx::SampleKernels* pKernels : kernels) {
+        for (int numFrames : frameCounts) {
+            const int size = numFrames * 2 + 1;
+            QVector<QVector<CSAMPLE>> sources(kMaxSources, QVector<CSAMPLE>(size));
+            QVector<const CSAMPLE*> pSources;
+            for (int i = 0; i < kMaxSources; ++i) {
+                FillTestSignal(sources[i].data(), size, i);
+                pSources.append(sources[i].constData());
+            }
+            QVector<CSAMPLE> expected(size);
+            QVector<CSAMPLE> actual(size);
+            for (int numSources = 1; numSources <= kMaxSources; ++numSources) {
+                generic.sumBuffers(expected.data(), pSources.constData(),
+                        numSources, size);
+                pKernels->sumBuffers(actual.data(), pSources.constData(),
+                        numSources, size);
+                // All kernels add the sources in order
+                EXPECT_EQ(expected, actual)
+                        << pKernels->name << " " << numSources << " " << size;
+            }
+        }
+    }
+}
+
 static void BM_MemCpy(benchmark::State& state) {
     size_t size = state.range_x();
     CSAMPLE* buffer = SampleUtil::alloc(size);
@@ -621,4 +827,193 @@ static void BM_Copy2WithRampingGain(benchmark::State& state) {
 }
 BENCHMARK(BM_Copy2WithRampingGain)->Range(64, 4096);
 
+// The mix of the channels as it was done by the unrolled ChannelMixer code
+// generated for every number of channels
+template <int kNumChannels>
+void sumBuffersUnrolled(CSAMPLE* pDest, const CSAMPLE* const* ppSrc,
+        SINT numSamples) {
+    for (SINT i = 0; i < numSamples; ++i) {
+        CSAMPLE sum = ppSrc[0][i];
+        for (int j = 1; j < kNumChannels; ++j) {
+            sum += ppSrc[j][i];
+        }
+        pDest[i] = sum;
+    }
+}
+
+template <int kNumChannels>
+static void BM_SumBuffersUnrolled(benchmark::State& state) {
+    const SINT size = 1024;
+    CSAMPLE* pDest = SampleUtil::alloc(size);
+    QVector<CSAMPLE*> sources;
+    for (int i = 0; i < kNumChannels; ++i) {
+        sources.append(SampleUtil::alloc(size));
+        SampleUtil::fill(sources.last(), 0.1f, size);
+    }
+
+    while (state.KeepRunning()) {
+        sumBuffersUnrolled<kNumChannels>(pDest, sources.constData(), size);
+    }
+
+    SampleUtil::free(pDest);
+    for (CSAMPLE* pSource : sources) {
+        SampleUtil::free(pSource);
+    }
+}
+BENCHMARK_TEMPLATE(BM_SumBuffersUnrolled, 1);
+BENCHMARK_TEMPLATE(BM_SumBuffersUnrolled, 2);
+BENCHMARK_TEMPLATE(BM_SumBuffersUnrolled, 3);
+BENCHMARK_TEMPLATE(BM_SumBuffersUnrolled, 4);
+BENCHMARK_TEMPLATE(BM_SumBuffersUnrolled, 6);
+BENCHMARK_TEMPLATE(BM_SumBuffersUnrolled, 8);
+BENCHMARK_TEMPLATE(BM_SumBuffersUnrolled, 12);
+BENCHMARK_TEMPLATE(BM_SumBuffersUnrolled, 16);
+
+static void BM_SumBuffers(benchmark::State& state) {
+    const SINT size = 1024;
+    const int numChannels = state.range_x();
+    CSAMPLE* pDest = SampleUtil::alloc(size);
+    QVector<CSAMPLE*> sources;
+    for (int i = 0; i < numChannels; ++i) {
+        sources.append(SampleUtil::alloc(size));
+        SampleUtil::fill(sources.last(), 0.1f, size);
+    }
+
+    while (state.KeepRunning()) {
+        SampleUtil::sumBuffers(pDest, sources.constData(), numChannels, size);
+    }
+
+    SampleUtil::free(pDest);
+    for (CSAMPLE* pSource : sources) {
+        SampleUtil::free(pSource);
+    }
+}
+BENCHMARK(BM_SumBuffers)->DenseRange(1, 16);
+
+// The sample kernels of one instruction set, selected by the argument. The
+// kernels that the CPU does not support are skipped.
+const mixxx::SampleKernels* benchmarkKernels(benchmark::State& state) {
+    const QVector<const mixxx::SampleKernels*> kernels =
+            mixxx::SampleKernels::available();
+    if (state.range_x() >= kernels.size()) {
+        state.SetLabel("unsupported");
+        return nullptr;
+    }
+    const mixxx::SampleKernels* pKernels = kernels[state.range_x()];
+    state.SetLabel(pKernels->name);
+    return pKernels;
+}
+
+static void BM_KernelApplyRampingGain(benchmark::State& state) {
+    const SINT size = 1024;
+    const mixxx::SampleKernels* pKernels = benchmarkKernels(state);
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.1f, size);
+
+    while (state.KeepRunning()) {
+        if (pKernels) {
+            pKernels->applyRampingGain(buffer, 1.0f, 0.0f, size / 2);
+        }
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK(BM_KernelApplyRampingGain)->DenseRange(0, 3);
+
+static void BM_KernelAddWithRampingGain(benchmark::State& state) {
+    const SINT size = 1024;
+    const mixxx::SampleKernels* pKernels = benchmarkKernels(state);
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.1f, size);
+
+    while (state.KeepRunning()) {
+        if (pKernels) {
+            pKernels->addWithRampingGain(buffer, buffer2, 0.0f, 0.0f, size / 2);
+        }
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK(BM_KernelAddWithRampingGain)->DenseRange(0, 3);
+
+static void BM_KernelSumAbsPerChannel(benchmark::State& state) {
+    const SINT size = 1024;
+    const mixxx::SampleKernels* pKernels = benchmarkKernels(state);
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.1f, size);
+    CSAMPLE absL, absR;
+
+    while (state.KeepRunning()) {
+        if (pKernels) {
+            pKernels->sumAbsPerChannel(&absL, &absR, buffer, size / 2);
+        }
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK(BM_KernelSumAbsPerChannel)->DenseRange(0, 3);
+
+static void BM_KernelCopyClampBuffer(benchmark::State& state) {
+    const SINT size = 1024;
+    const mixxx::SampleKernels* pKernels = benchmarkKernels(state);
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 1.1f, size);
+
+    while (state.KeepRunning()) {
+        if (pKernels) {
+            pKernels->copyClampBuffer(buffer, buffer2, size);
+        }
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK(BM_KernelCopyClampBuffer)->DenseRange(0, 3);
+
+static void BM_KernelInterleaveBuffer(benchmark::State& state) {
+    const SINT numFrames = 512;
+    const mixxx::SampleKernels* pKernels = benchmarkKernels(state);
+    CSAMPLE* buffer = SampleUtil::alloc(numFrames * 2);
+    CSAMPLE* buffer2 = SampleUtil::alloc(numFrames);
+    SampleUtil::fill(buffer2, 0.1f, numFrames);
+    CSAMPLE* buffer3 = SampleUtil::alloc(numFrames);
+    SampleUtil::fill(buffer3, 0.2f, numFrames);
+
+    while (state.KeepRunning()) {
+        if (pKernels) {
+            pKernels->interleaveBuffer(buffer, buffer2, buffer3, numFrames);
+        }
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+}
+BENCHMARK(BM_KernelInterleaveBuffer)->DenseRange(0, 3);
+
+static void BM_KernelDeinterleaveBuffer(benchmark::State& state) {
+    const SINT numFrames = 512;
+    const mixxx::SampleKernels* pKernels = benchmarkKernels(state);
+    CSAMPLE* buffer = SampleUtil::alloc(numFrames * 2);
+    SampleUtil::fill(buffer, 0.1f, numFrames * 2);
+    CSAMPLE* buffer2 = SampleUtil::alloc(numFrames);
+    CSAMPLE* buffer3 = SampleUtil::alloc(numFrames);
+
+    while (state.KeepRunning()) {
+        if (pKernels) {
+            pKernels->deinterleaveBuffer(buffer2, buffer3, buffer, numFrames);
+        }
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+}
+BENCHMARK(BM_KernelDeinterleaveBuffer)->DenseRange(0, 3);
+
 }  // namespace
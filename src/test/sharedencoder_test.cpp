@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+
+#include <QByteArray>
+
+#include "encoder/sharedencoder.h"
+
+namespace {
+
+// Stands in for the broadcast connection that receives the encoded stream.
+class FakeSink : public EncoderCallback {
+  public:
+    void write(const unsigned char* header, const unsigned char* body,
+               int headerLen, int bodyLen) override {
+        if (headerLen > 0) {
+            m_data.append(reinterpret_cast<const char*>(header), headerLen);
+        }
+        if (bodyLen > 0) {
+            m_data.append(reinterpret_cast<const char*>(body), bodyLen);
+        }
+    }
+    int tell() override {
+        return -1;
+    }
+    void seek(int pos) override {
+        Q_UNUSED(pos);
+    }
+    int filelen() override {
+        return 0;
+    }
+
+    QByteArray m_data;
+};
+
+// "Encodes" each buffer into one byte holding the first sample.
+class FakeEncoder : public Encoder {
+  public:
+    explicit FakeEncoder(EncoderCallback* pCallback)
+            : m_pCallback(pCallback) {
+        ++s_instances;
+    }
+    ~FakeEncoder() override {
+        --s_instances;
+    }
+
+    int initEncoder(int samplerate, QString errorMessage) override {
+        Q_UNUSED(samplerate);
+        Q_UNUSED(errorMessage);
+        ++s_inits;
+        return 0;
+    }
+    void encodeBuffer(const CSAMPLE* samples, const int size) override {
+        ++s_encodedBuffers;
+        unsigned char byte = size > 0 ? static_cast<unsigned char>(samples[0]) : 0;
+        m_pCallback->write(nullptr, &byte, 0, 1);
+    }
+    void updateMetaData(const QString&, const QString&, const QString&) override {
+    }
+    void flush() override {
+    }
+    void setEncoderSettings(const EncoderSettings&) override {
+    }
+
+    static int s_instances;
+    static int s_inits;
+    static int s_encodedBuffers;
+
+  private:
+    EncoderCallback* m_pCallback;
+};
+
+int FakeEncoder::s_instances = 0;
+int FakeEncoder::s_inits = 0;
+int FakeEncoder::s_encodedBuffers = 0;
+
+class SharedEncoderTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        FakeEncoder::s_instances = 0;
+        FakeEncoder::s_inits = 0;
+        FakeEncoder::s_encodedBuffers = 0;
+    }
+
+    EncoderPointer createClient(const QString& key, FakeSink* pSink) {
+        return SharedEncoder::createClient(key, pSink,
+                [](EncoderCallback* pCallback) {
+                    return EncoderPointer(new FakeEncoder(pCallback));
+                });
+    }
+};
+
+TEST_F(SharedEncoderTest, SameKeySharesEncoder) {
+    FakeSink sink1;
+    FakeSink sink2;
+    EncoderPointer pClient1 = createClient("mp3:44100:128:2", &sink1);
+    EncoderPointer pClient2 = createClient("mp3:44100:128:2", &sink2);
+    EXPECT_EQ(1, FakeEncoder::s_instances);
+    EXPECT_EQ(2, SharedEncoder::clientCount("mp3:44100:128:2"));
+
+    FakeSink sink3;
+    EncoderPointer pClient3 = createClient("mp3:48000:128:2", &sink3);
+    EXPECT_EQ(2, FakeEncoder::s_instances);
+
+    EXPECT_EQ(0, pClient1->initEncoder(44100, QString()));
+    EXPECT_EQ(0, pClient2->initEncoder(44100, QString()));
+    EXPECT_EQ(0, pClient3->initEncoder(48000, QString()));
+    EXPECT_EQ(2, FakeEncoder::s_inits);
+
+    pClient1.reset();
+    pClient2.reset();
+    pClient3.reset();
+    EXPECT_EQ(0, FakeEncoder::s_instances);
+    EXPECT_EQ(0, SharedEncoder::clientCount("mp3:44100:128:2"));
+}
+
+TEST_F(SharedEncoderTest, EncodesOnceAndFansOut) {
+    FakeSink sink1;
+    FakeSink sink2;
+    EncoderPointer pClient1 = createClient("fanout", &sink1);
+    EncoderPointer pClient2 = createClient("fanout", &sink2);
+    pClient1->initEncoder(44100, QString());
+    pClient2->initEncoder(44100, QString());
+
+    // Both connections are fed the same audio, as the sidechain does.
+    for (int i = 1; i <= 3; ++i) {
+        CSAMPLE buffer[2] = {static_cast<CSAMPLE>(i), 0};
+        pClient1->encodeBuffer(buffer, 2);
+        pClient2->encodeBuffer(buffer, 2);
+    }
+    EXPECT_EQ(3, FakeEncoder::s_encodedBuffers);
+    EXPECT_EQ(QByteArray("\x01\x02\x03", 3), sink1.m_data);
+    EXPECT_EQ(QByteArray("\x01\x02\x03", 3), sink2.m_data);
+}
+
+TEST_F(SharedEncoderTest, DetachedClientDoesNotStall) {
+    FakeSink sink1;
+    FakeSink sink2;
+    EncoderPointer pClient1 = createClient("detach", &sink1);
+    EncoderPointer pClient2 = createClient("detach", &sink2);
+    pClient1->initEncoder(44100, QString());
+
+    CSAMPLE buffer[2] = {1, 0};
+    pClient1->encodeBuffer(buffer, 2);
+    pClient2->encodeBuffer(buffer, 2);
+    pClient1.reset();
+
+    // The remaining client continues immediately.
+    buffer[0] = 2;
+    pClient2->encodeBuffer(buffer, 2);
+    EXPECT_EQ(2, FakeEncoder::s_encodedBuffers);
+    EXPECT_EQ(QByteArray("\x01\x02", 2), sink2.m_data);
+}
+
+TEST_F(SharedEncoderTest, IdleClientDoesNotStall) {
+    FakeSink sink1;
+    FakeSink sink2;
+    EncoderPointer pClient1 = createClient("idle", &sink1);
+    EncoderPointer pClient2 = createClient("idle", &sink2);
+    pClient1->initEncoder(44100, QString());
+
+    // The first client is ahead and then stops encoding, e.g. because its
+    // connection is down, without being destroyed.
+    for (int i = 1; i <= 2; ++i) {
+        CSAMPLE buffer[2] = {static_cast<CSAMPLE>(i), 0};
+        pClient1->encodeBuffer(buffer, 2);
+    }
+    // The second client receives the same audio later. Its first buffer
+    // joins the stream at the current position.
+    for (int i = 3; i <= 5; ++i) {
+        CSAMPLE buffer[2] = {static_cast<CSAMPLE>(i), 0};
+        pClient2->encodeBuffer(buffer, 2);
+    }
+    EXPECT_EQ(5, FakeEncoder::s_encodedBuffers);
+    EXPECT_EQ(QByteArray("\x01\x02", 2), sink1.m_data);
+    EXPECT_EQ(QByteArray("\x03\x04\x05", 3), sink2.m_data);
+}
+
+TEST_F(SharedEncoderTest, AudioIsEncodedOnce) {
+    FakeSink sink1;
+    FakeSink sink2;
+    EncoderPointer pClient1 = createClient("once", &sink1);
+    EncoderPointer pClient2 = createClient("once", &sink2);
+    pClient1->initEncoder(44100, QString());
+
+    // Both clients join at the same position
+    CSAMPLE buffer[2] = {1, 0};
+    pClient1->encodeBuffer(buffer, 2);
+    pClient2->encodeBuffer(buffer, 2);
+
+    // The first client is one buffer ahead of the second client
+    buffer[0] = 2;
+    pClient1->encodeBuffer(buffer, 2);
+    buffer[0] = 3;
+    pClient1->encodeBuffer(buffer, 2);
+    buffer[0] = 2;
+    pClient2->encodeBuffer(buffer, 2);
+    EXPECT_EQ(3, FakeEncoder::s_encodedBuffers);
+
+    // The second client takes over without repeating or skipping audio
+    pClient1.reset();
+    buffer[0] = 3;
+    pClient2->encodeBuffer(buffer, 2);
+    EXPECT_EQ(3, FakeEncoder::s_encodedBuffers);
+    buffer[0] = 4;
+    pClient2->encodeBuffer(buffer, 2);
+    EXPECT_EQ(4, FakeEncoder::s_encodedBuffers);
+    EXPECT_EQ(QByteArray("\x01\x02\x03\x04", 4), sink2.m_data);
+}
+
+TEST_F(SharedEncoderTest, PartiallyEncodedBuffer) {
+    FakeSink sink1;
+    FakeSink sink2;
+    EncoderPointer pClient1 = createClient("partial", &sink1);
+    EncoderPointer pClient2 = createClient("partial", &sink2);
+    pClient1->initEncoder(44100, QString());
+
+    CSAMPLE buffer[4] = {1, 0, 2, 0};
+    pClient1->encodeBuffer(buffer, 2);
+    pClient2->encodeBuffer(buffer, 2);
+    pClient1->encodeBuffer(buffer + 2, 2);
+    // The client passes the same audio in a larger buffer. Only the part
+    // that has not been encoded yet is encoded.
+    CSAMPLE largerBuffer[4] = {2, 0, 3, 0};
+    pClient2->encodeBuffer(largerBuffer, 4);
+    EXPECT_EQ(3, FakeEncoder::s_encodedBuffers);
+    EXPECT_EQ(QByteArray("\x01\x02\x03", 3), sink2.m_data);
+}
+
+TEST_F(SharedEncoderTest, StalledClientSkipsStalePackets) {
+    FakeSink sink1;
+    FakeSink sink2;
+    EncoderPointer pClient1 = createClient("stalled", &sink1);
+    EncoderPointer pClient2 = createClient("stalled", &sink2);
+    pClient1->initEncoder(44100, QString());
+
+    CSAMPLE buffer[2] = {1, 0};
+    pClient1->encodeBuffer(buffer, 2);
+    pClient2->encodeBuffer(buffer, 2);
+
+    // The connection of the second client stalls
+    const int packets = SharedEncoder::kMaxPendingPackets + 10;
+    for (int i = 0; i < packets; ++i) {
+        pClient1->encodeBuffer(buffer, 2);
+    }
+    EXPECT_EQ(packets + 1, sink1.m_data.size());
+
+    // It resumes with the newest audio instead of sending stale packets
+    buffer[0] = 2;
+    pClient2->encodeBuffer(buffer, 2);
+    EXPECT_EQ(QByteArray("\x01\x02", 2), sink2.m_data);
+}
+
+} // namespace
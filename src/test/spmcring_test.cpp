@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <QVector>
+
+#include "util/spmcring.h"
+
+namespace {
+
+QVector<int> readAll(const SpmcRing<int>& ring, SpmcRing<int>::Reader* pReader) {
+    QVector<int> result;
+    const int* dataPtr1;
+    int size1;
+    const int* dataPtr2;
+    int size2;
+    int count = ring.acquireReadRegions(pReader, &dataPtr1, &size1, &dataPtr2, &size2);
+    for (int i = 0; i < size1; ++i) {
+        result.append(dataPtr1[i]);
+    }
+    for (int i = 0; i < size2; ++i) {
+        result.append(dataPtr2[i]);
+    }
+    EXPECT_TRUE(ring.releaseReadRegions(pReader, count));
+    return result;
+}
+
+TEST(SpmcRingTest, ReadersSeeTheSameData) {
+    SpmcRing<int> ring(8);
+    SpmcRing<int>::Reader reader1 = ring.createReader();
+    SpmcRing<int>::Reader reader2 = ring.createReader();
+
+    const int data[] = {1, 2, 3, 4, 5, 6};
+    ring.write(data, 6);
+    EXPECT_EQ(QVector<int>({1, 2, 3, 4, 5, 6}), readAll(ring, &reader1));
+    EXPECT_EQ(QVector<int>({1, 2, 3, 4, 5, 6}), readAll(ring, &reader2));
+
+    // Wraps around the end of the buffer.
+    ring.write(data, 4);
+    EXPECT_EQ(QVector<int>({1, 2, 3, 4}), readAll(ring, &reader1));
+    EXPECT_EQ(QVector<int>({1, 2, 3, 4}), readAll(ring, &reader2));
+    EXPECT_EQ(0u, reader1.overrunCount());
+    EXPECT_EQ(0u, reader2.overrunCount());
+}
+
+TEST(SpmcRingTest, LateReaderStartsAtWritePosition) {
+    SpmcRing<int> ring(8);
+    const int data[] = {1, 2, 3};
+    ring.write(data, 3);
+    SpmcRing<int>::Reader reader = ring.createReader();
+    EXPECT_EQ(0u, ring.readAvailable(reader));
+    ring.write(data + 2, 1);
+    EXPECT_EQ(QVector<int>({3}), readAll(ring, &reader));
+}
+
+TEST(SpmcRingTest, SlowReaderIsOverrun) {
+    SpmcRing<int> ring(8);
+    SpmcRing<int>::Reader fastReader = ring.createReader();
+    SpmcRing<int>::Reader slowReader = ring.createReader();
+
+    const int data[] = {1, 2, 3, 4, 5, 6};
+    ring.write(data, 6);
+    readAll(ring, &fastReader);
+    ring.write(data, 6);
+    readAll(ring, &fastReader);
+
+    // The slow reader lost its data, but resumes with new data.
+    EXPECT_TRUE(readAll(ring, &slowReader).isEmpty());
+    EXPECT_EQ(1u, slowReader.overrunCount());
+    EXPECT_EQ(0u, fastReader.overrunCount());
+    ring.write(data, 2);
+    EXPECT_EQ(QVector<int>({1, 2}), readAll(ring, &slowReader));
+}
+
+TEST(SpmcRingTest, OverwriteWhileReadingIsDetected) {
+    SpmcRing<int> ring(8);
+    SpmcRing<int>::Reader reader = ring.createReader();
+    const int data[] = {1, 2, 3, 4, 5, 6};
+    ring.write(data, 6);
+
+    const int* dataPtr1;
+    int size1;
+    const int* dataPtr2;
+    int size2;
+    int count = ring.acquireReadRegions(&reader, &dataPtr1, &size1, &dataPtr2, &size2);
+    EXPECT_EQ(6, count);
+    // The producer laps the reader while it holds the regions.
+    ring.write(data, 6);
+    EXPECT_FALSE(ring.releaseReadRegions(&reader, count));
+    EXPECT_EQ(1u, reader.overrunCount());
+}
+
+TEST(SpmcRingTest, ReaderWithoutHeadroomDropsData) {
+    SpmcRing<int> ring(8, 4);
+    SpmcRing<int>::Reader reader = ring.createReader();
+    const int data[] = {1, 2, 3, 4, 5, 6};
+    ring.write(data, 4);
+    EXPECT_EQ(QVector<int>({1, 2, 3, 4}), readAll(ring, &reader));
+    EXPECT_EQ(0u, reader.skippedCount());
+
+    // Nothing is overwritten yet, but the producer would overwrite the data
+    // while the reader uses it.
+    ring.write(data, 5);
+    EXPECT_TRUE(readAll(ring, &reader).isEmpty());
+    EXPECT_EQ(1u, reader.overrunCount());
+    EXPECT_EQ(5u, reader.skippedCount());
+
+    ring.write(data + 4, 2);
+    EXPECT_EQ(QVector<int>({5, 6}), readAll(ring, &reader));
+    EXPECT_EQ(5u, reader.skippedCount());
+}
+
+TEST(SpmcRingTest, ProducerWritesInPlace) {
+    SpmcRing<int> ring(8);
+    SpmcRing<int>::Reader reader = ring.createReader();
+    const int data[] = {1, 2, 3, 4, 5, 6};
+    ring.write(data, 6);
+    readAll(ring, &reader);
+
+    int* dataPtr1;
+    int size1;
+    int* dataPtr2;
+    int size2;
+    ring.acquireWriteRegions(4, &dataPtr1, &size1, &dataPtr2, &size2);
+    EXPECT_EQ(2, size1);
+    EXPECT_EQ(2, size2);
+    // Not visible before it is committed
+    EXPECT_EQ(0u, ring.readAvailable(reader));
+    dataPtr1[0] = 7;
+    dataPtr1[1] = 8;
+    dataPtr2[0] = 9;
+    dataPtr2[1] = 10;
+    ring.commitWrite(4);
+    EXPECT_EQ(QVector<int>({7, 8, 9, 10}), readAll(ring, &reader));
+}
+
+} // namespace
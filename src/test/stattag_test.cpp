@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include "util/counter.h"
+#include "util/stat.h"
+#include "util/trace.h"
+
+namespace {
+
+TEST(StatTagTest, InternsNamesOnce) {
+    const StatTag tag("StatTagTest tag");
+    ASSERT_TRUE(tag.isValid());
+    EXPECT_EQ("StatTagTest tag", tag.name());
+    EXPECT_EQ(tag.id(), StatTag(QString("StatTagTest tag")).id());
+    EXPECT_NE(tag.id(), StatTag("StatTagTest other tag").id());
+
+    EXPECT_FALSE(StatTag().isValid());
+}
+
+TEST(StatTagTest, LiteralsShareTheTagOfTheirName) {
+    const char* const kLiteral = "StatTagTest literal";
+    const StatTag tag = StatTag::fromLiteral(kLiteral);
+    EXPECT_EQ(tag.id(), StatTag::fromLiteral(kLiteral).id());
+    EXPECT_EQ(tag.id(), StatTag(QString(kLiteral)).id());
+    EXPECT_EQ(kLiteral, tag.name());
+}
+
+TEST(StatTagTest, TraceTagsAreInternedUpFront) {
+    const TraceTag traceTag(QString("StatTagTest trace %1").arg(1));
+    EXPECT_EQ("StatTagTest trace 1", traceTag.name());
+    EXPECT_EQ(StatTag("StatTagTest trace 1").id(), traceTag.tag().id());
+    EXPECT_EQ(StatTag("StatTagTest trace 1_duration").id(),
+            traceTag.durationTag().id());
+
+    EXPECT_FALSE(TraceTag().tag().isValid());
+    // A trace with a default constructed tag does nothing
+    Trace trace((TraceTag()));
+}
+
+} // anonymous namespace
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include "util/wakesemaphore.h"
+
+namespace {
+
+TEST(WakeSemaphoreTest, ReleaseBeforeAcquire) {
+    WakeSemaphore semaphore;
+    semaphore.release();
+    semaphore.release();
+    // Neither blocks
+    semaphore.acquire();
+    semaphore.acquire();
+}
+
+TEST(WakeSemaphoreTest, ReleaseWakesWaitingThread) {
+    WakeSemaphore semaphore;
+    WakeSemaphore done;
+    std::atomic<int> wakeups(0);
+    std::thread thread([&] {
+        for (int i = 0; i < 1000; ++i) {
+            semaphore.acquire();
+            wakeups.fetch_add(1);
+            done.release();
+        }
+    });
+    for (int i = 0; i < 1000; ++i) {
+        semaphore.release();
+        done.acquire();
+        EXPECT_EQ(i + 1, wakeups.load());
+    }
+    thread.join();
+}
+
+} // anonymous namespace
@@ -0,0 +1,133 @@
+#include "track/fingerprint.h"
+
+#include <QtEndian>
+
+#include <bitset>
+
+#include "util/math.h"
+
+namespace mixxx {
+
+/*static*/ constexpr int Fingerprint::kNumBands;
+/*static*/ constexpr int Fingerprint::kBitsPerBand;
+
+namespace {
+
+// About 10 s of audio
+constexpr int kMinOverlap = 80;
+
+// Different encodings of a recording might start with a few seconds more
+// or less of silence
+constexpr int kMaxAlignmentOffset = 32;
+
+constexpr int kBitsPerValue = 32;
+
+// The finalizer of MurmurHash3
+inline quint32 mixBits(quint32 value) {
+    value ^= value >> 16;
+    value *= 0x85ebca6bu;
+    value ^= value >> 13;
+    value *= 0xc2b2ae35u;
+    value ^= value >> 16;
+    return value;
+}
+
+inline int countBits(quint32 value) {
+    return static_cast<int>(std::bitset<32>(value).count());
+}
+
+// The frequencies that are compared by a bit of the index keys, selected
+// pseudo-randomly but identically for all fingerprints
+void comparedFrequencies(int comparison, int* pFirstBit, int* pSecondBit) {
+    *pFirstBit = mixBits(2 * comparison + 1) % kBitsPerValue;
+    *pSecondBit = mixBits(2 * comparison + 2) % (kBitsPerValue - 1);
+    if (*pSecondBit >= *pFirstBit) {
+        ++*pSecondBit;
+    }
+}
+
+} // anonymous namespace
+
+QByteArray Fingerprint::toBlob() const {
+    QByteArray blob(m_values.size() * static_cast<int>(sizeof(quint32)), '\0');
+    uchar* pData = reinterpret_cast<uchar*>(blob.data());
+    for (const auto value : m_values) {
+        qToLittleEndian(value, pData);
+        pData += sizeof(quint32);
+    }
+    return blob;
+}
+
+// static
+Fingerprint Fingerprint::fromBlob(const QByteArray& blob) {
+    const int size = blob.size() / static_cast<int>(sizeof(quint32));
+    QVector<quint32> values;
+    values.reserve(size);
+    const uchar* pData = reinterpret_cast<const uchar*>(blob.constData());
+    for (int i = 0; i < size; ++i) {
+        values.append(qFromLittleEndian<quint32>(pData));
+        pData += sizeof(quint32);
+    }
+    return Fingerprint(std::move(values));
+}
+
+QVector<qint64> Fingerprint::indexKeys() const {
+    QVector<qint64> keys;
+    if (m_values.size() < kMinOverlap) {
+        return keys;
+    }
+
+    int setCounts[kBitsPerValue] = {};
+    int flipCounts[kBitsPerValue] = {};
+    quint32 previousValue = m_values.first();
+    for (const auto value : m_values) {
+        const quint32 flips = value ^ previousValue;
+        for (int bit = 0; bit < kBitsPerValue; ++bit) {
+            setCounts[bit] += (value >> bit) & 1;
+            flipCounts[bit] += (flips >> bit) & 1;
+        }
+        previousValue = value;
+    }
+
+    // Alternate between both kinds of frequencies. The band number in the
+    // upper half keeps the keys of different bands apart.
+    const int* const counts[] = {setCounts, flipCounts};
+    keys.reserve(kNumBands);
+    for (int band = 0; band < kNumBands; ++band) {
+        quint32 bandBits = 0;
+        for (int i = 0; i < kBitsPerBand; ++i) {
+            const int comparison = band * kBitsPerBand + i;
+            const int* const pCounts = counts[comparison % 2];
+            int firstBit;
+            int secondBit;
+            comparedFrequencies(comparison, &firstBit, &secondBit);
+            if (pCounts[firstBit] > pCounts[secondBit]) {
+                bandBits |= 1u << i;
+            }
+        }
+        keys.append((static_cast<qint64>(band) << 32) | bandBits);
+    }
+    return keys;
+}
+
+double Fingerprint::similarity(const Fingerprint& other) const {
+    double bestSimilarity = 0.0;
+    for (int offset = -kMaxAlignmentOffset; offset <= kMaxAlignmentOffset; ++offset) {
+        // Compares m_values[i] with other.m_values[i + offset]
+        const int begin = math_max(0, -offset);
+        const int end = math_min(size(), other.size() - offset);
+        const int overlap = end - begin;
+        if (overlap < kMinOverlap) {
+            continue;
+        }
+        int bitErrors = 0;
+        for (int i = begin; i < end; ++i) {
+            bitErrors += countBits(m_values[i] ^ other.m_values[i + offset]);
+        }
+        bestSimilarity = math_max(bestSimilarity,
+                1.0 - static_cast<double>(bitErrors) / (32.0 * overlap));
+    }
+    return bestSimilarity;
+}
+
+} // namespace mixxx
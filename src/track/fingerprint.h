@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+
+namespace mixxx {
+
+// The raw acoustic fingerprint of a track as calculated by Chromaprint, i.e.
+// a sequence of 32-bit sub-fingerprints for ~0.12 s of audio each.
+//
+// Duplicate detection
+// -------------------
+// Comparing the fingerprints of all pairs of tracks doesn't scale. Instead
+// each fingerprint is reduced to a few index keys with locality sensitive
+// hashing. Only the tracks with a common key need to be compared with
+// similarity() afterwards.
+//
+// Different encodings of a recording differ in bits all over the
+// sub-fingerprints, so no sub-fingerprint can be expected to survive
+// unchanged. The keys are derived from how often each bit is set and how
+// often it flips between consecutive sub-fingerprints instead. Uniformly
+// spread bit errors move all of these frequencies towards 1/2 without
+// changing their order, and they don't depend on the alignment. Each key
+// bit compares two frequencies of the same kind.
+class Fingerprint final {
+  public:
+    // The number of index keys of a fingerprint. Similar fingerprints need
+    // to agree on all kBitsPerBand comparisons of a band to share its key.
+    static constexpr int kNumBands = 10;
+    static constexpr int kBitsPerBand = 12;
+
+    Fingerprint() = default;
+    explicit Fingerprint(QVector<quint32> values)
+            : m_values(std::move(values)) {
+    }
+
+    bool isEmpty() const {
+        return m_values.isEmpty();
+    }
+    int size() const {
+        return m_values.size();
+    }
+    const QVector<quint32>& values() const {
+        return m_values;
+    }
+
+    // Little-endian sub-fingerprints for storing them in the database
+    QByteArray toBlob() const;
+    static Fingerprint fromBlob(const QByteArray& blob);
+
+    // Returns kNumBands keys, or none if the fingerprint is too short to be
+    // compared reliably.
+    QVector<qint64> indexKeys() const;
+
+    // The fraction of equal bits of the sub-fingerprints at the best
+    // alignment of both fingerprints. Unrelated tracks score about 0.5 and
+    // different encodings of the same recording close to 1.0. Returns 0.0 if
+    // the fingerprints don't overlap sufficiently.
+    double similarity(const Fingerprint& other) const;
+
+  private:
+    QVector<quint32> m_values;
+};
+
+} // namespace mixxx
@@ -0,0 +1,267 @@
+#include "util/callbacktrace.h"
+
+#include <cstring>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QtDebug>
+
+namespace {
+
+QMutex s_stageMutex;
+QVector<QString> s_stageNames;
+
+// Quotes a CSV field as described in RFC 4180 if it contains a separator,
+// a quote or a line break. Stage names contain user defined group names.
+QString escapeCsvField(const QString& field) {
+    if (!field.contains(QChar(',')) && !field.contains(QChar('"')) &&
+            !field.contains(QChar('\n')) && !field.contains(QChar('\r'))) {
+        return field;
+    }
+    QString escaped = field;
+    escaped.replace(QChar('"'), QStringLiteral("\"\""));
+    return QChar('"') + escaped + QChar('"');
+}
+
+} // anonymous namespace
+
+constexpr int CallbackTrace::kMaxStages;
+constexpr int CallbackTrace::kInvalidStage;
+constexpr int CallbackTrace::kRingSize;
+constexpr int CallbackTrace::kXrunContextBefore;
+constexpr int CallbackTrace::kXrunContextAfter;
+
+// static
+bool CallbackTrace::s_enabled = false;
+// static
+CallbackTrace::Record* CallbackTrace::s_pRing = nullptr;
+// static
+std::atomic<quint64>* CallbackTrace::s_pSequences = nullptr;
+// static
+CallbackTrace::Record* CallbackTrace::s_pCurrent = nullptr;
+// static
+thread_local qint64* CallbackTrace::s_pThreadStageNanos = nullptr;
+// static
+quint64 CallbackTrace::s_writeSequence = 0;
+// static
+std::atomic<quint64> CallbackTrace::s_published(0);
+// static
+std::atomic<quint64> CallbackTrace::s_lastXrunSequence(0);
+// static
+std::atomic<bool> CallbackTrace::s_xrunPending(false);
+// static
+quint64 CallbackTrace::s_lastDumpedXrunSequence = 0;
+// static
+PerformanceTimer CallbackTrace::s_clock;
+
+// static
+thread_local ScopedCallbackTraceStage* ScopedCallbackTraceStage::s_pInnermost = nullptr;
+
+// static
+void CallbackTrace::enable() {
+    if (s_enabled) {
+        return;
+    }
+    // The ring lives until the process exits, because the audio callback
+    // may still be running while Mixxx shuts down.
+    s_pRing = new Record[kRingSize];
+    std::memset(s_pRing, 0, sizeof(Record) * kRingSize);
+    s_pSequences = new std::atomic<quint64>[kRingSize];
+    for (int i = 0; i < kRingSize; ++i) {
+        s_pSequences[i].store(0, std::memory_order_relaxed);
+    }
+    s_stageNames.reserve(kMaxStages);
+    s_clock.start();
+    s_enabled = true;
+}
+
+// static
+int CallbackTrace::registerStage(const QString& name) {
+    if (!s_enabled) {
+        return kInvalidStage;
+    }
+    QMutexLocker locker(&s_stageMutex);
+    int stage = s_stageNames.indexOf(name);
+    if (stage >= 0) {
+        return stage;
+    }
+    if (s_stageNames.size() >= kMaxStages) {
+        qWarning() << "CallbackTrace: too many stages, not tracing" << name;
+        return kInvalidStage;
+    }
+    s_stageNames.append(name);
+    return s_stageNames.size() - 1;
+}
+
+// static
+QString CallbackTrace::stageName(int stage) {
+    QMutexLocker locker(&s_stageMutex);
+    return s_stageNames.value(stage);
+}
+
+// static
+int CallbackTrace::stageCount() {
+    QMutexLocker locker(&s_stageMutex);
+    return s_stageNames.size();
+}
+
+// static
+void CallbackTrace::beginCallback(int frames) {
+    if (!s_enabled) {
+        return;
+    }
+    const quint64 sequence = ++s_writeSequence;
+    const int index = static_cast<int>(sequence % kRingSize);
+    // Invalidate the slot before touching it, so readers that race with us
+    // discard their copy.
+    s_pSequences[index].store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Record* pRecord = &s_pRing[index];
+    pRecord->sequence = sequence;
+    pRecord->startNanos = s_clock.elapsed().toIntegerNanos();
+    pRecord->totalNanos = 0;
+    pRecord->frames = frames;
+    pRecord->xrun = false;
+    std::memset(pRecord->stageNanos, 0, sizeof(pRecord->stageNanos));
+    s_pCurrent = pRecord;
+}
+
+// static
+void CallbackTrace::addStageTimes(qint64* pStageNanos) {
+    if (!s_enabled) {
+        return;
+    }
+    if (s_pCurrent) {
+        for (int stage = 0; stage < kMaxStages; ++stage) {
+            s_pCurrent->stageNanos[stage] += pStageNanos[stage];
+        }
+    }
+    std::memset(pStageNanos, 0, sizeof(qint64) * kMaxStages);
+}
+
+// static
+void CallbackTrace::endCallback(mixxx::Duration total) {
+    if (!s_enabled || !s_pCurrent) {
+        return;
+    }
+    Record* pRecord = s_pCurrent;
+    s_pCurrent = nullptr;
+    pRecord->totalNanos = total.toIntegerNanos();
+    if (s_xrunPending.exchange(false, std::memory_order_acq_rel)) {
+        pRecord->xrun = true;
+        s_lastXrunSequence.store(pRecord->sequence, std::memory_order_release);
+    }
+    const int index = static_cast<int>(pRecord->sequence % kRingSize);
+    s_pSequences[index].store(pRecord->sequence, std::memory_order_release);
+    s_published.store(pRecord->sequence, std::memory_order_release);
+}
+
+// static
+void CallbackTrace::markXrun() {
+    if (s_enabled) {
+        s_xrunPending.store(true, std::memory_order_release);
+    }
+}
+
+// static
+QVector<CallbackTrace::Record> CallbackTrace::snapshot() {
+    QVector<Record> records;
+    if (!s_enabled) {
+        return records;
+    }
+    const quint64 published = s_published.load(std::memory_order_acquire);
+    const quint64 first = published >= static_cast<quint64>(kRingSize) ?
+            published - kRingSize + 1 : 1;
+    records.reserve(static_cast<int>(published - first + 1));
+    for (quint64 sequence = first; sequence <= published; ++sequence) {
+        const int index = static_cast<int>(sequence % kRingSize);
+        if (s_pSequences[index].load(std::memory_order_acquire) != sequence) {
+            continue;
+        }
+        Record copy;
+        std::memcpy(&copy, &s_pRing[index], sizeof(Record));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s_pSequences[index].load(std::memory_order_relaxed) != sequence) {
+            // Overwritten by the engine while we were copying.
+            continue;
+        }
+        copy.sequence = sequence;
+        records.append(copy);
+    }
+    return records;
+}
+
+// static
+QString CallbackTrace::writePendingXruns(const QString& directory) {
+    if (!s_enabled || lastXrunSequence() <= s_lastDumpedXrunSequence) {
+        return QString();
+    }
+
+    const QVector<Record> records = snapshot();
+    if (records.isEmpty()) {
+        return QString();
+    }
+    const quint64 newest = records.last().sequence;
+
+    // Select all callbacks within the context of an xrun that has its
+    // trailing context complete.
+    QVector<bool> selected(records.size(), false);
+    quint64 lastDumpedXrun = s_lastDumpedXrunSequence;
+    for (int i = 0; i < records.size(); ++i) {
+        const Record& record = records.at(i);
+        if (!record.xrun || record.sequence <= s_lastDumpedXrunSequence) {
+            continue;
+        }
+        if (record.sequence + kXrunContextAfter > newest) {
+            break;
+        }
+        for (int j = qMax(0, i - kXrunContextBefore);
+                j <= qMin(records.size() - 1, i + kXrunContextAfter); ++j) {
+            selected[j] = true;
+        }
+        lastDumpedXrun = record.sequence;
+    }
+    if (lastDumpedXrun == s_lastDumpedXrunSequence) {
+        return QString();
+    }
+    s_lastDumpedXrunSequence = lastDumpedXrun;
+
+    QString timestamp = QDateTime::currentDateTime()
+            .toString("yyyy-MM-dd_hh'h'mm'm'ss's'");
+    QString fileName = QDir(directory).filePath(
+            "xrun_trace_" + timestamp + ".csv");
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "CallbackTrace: open" << fileName << "failed";
+        return QString();
+    }
+
+    const int numStages = stageCount();
+    QTextStream out(&file);
+    out << "callback,start_ms,frames,xrun,total_us";
+    for (int stage = 0; stage < numStages; ++stage) {
+        out << "," << escapeCsvField(stageName(stage));
+    }
+    out << "\n";
+    for (int i = 0; i < records.size(); ++i) {
+        if (!selected.at(i)) {
+            continue;
+        }
+        const Record& record = records.at(i);
+        out << record.sequence << ","
+            << record.startNanos / 1e6 << ","
+            << record.frames << ","
+            << (record.xrun ? 1 : 0) << ","
+            << record.totalNanos / 1e3;
+        for (int stage = 0; stage < numStages; ++stage) {
+            out << "," << record.stageNanos[stage] / 1e3;
+        }
+        out << "\n";
+    }
+    return fileName;
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+
+#include <QString>
+#include <QVector>
+
+#include "util/duration.h"
+#include "util/performancetimer.h"
+
+// CallbackTrace records per-stage timings of every audio engine callback into
+// a fixed-size lock-free ring. It is meant to answer the question "what made
+// this callback miss its deadline?" when an xrun happens.
+//
+// The engine thread is the only writer. It brackets each callback with
+// beginCallback()/endCallback() and reports the time spent in named stages
+// (each channel, each effect chain, the master mix, the sidechain) with
+// addStageTime() or the ScopedCallbackTraceStage helper. Any thread may call
+// markXrun(). Readers take consistent copies of the ring with snapshot()
+// without ever blocking the writer.
+//
+// Stage names are registered up front from a non-realtime thread, so that
+// the realtime path only deals with small integer ids.
+//
+// Stages record self time: a ScopedCallbackTraceStage that is nested in
+// another one on the same thread subtracts its time from the enclosing
+// stage, so the stages of a callback add up to at most its total. Stages
+// that run on other threads in parallel, like the effect chains processed
+// by the effect workers or the drift callbacks of secondary sound devices,
+// are not subtracted from anything and may add up to more than the total.
+//
+// Tracing is disabled by default and costs a single branch per stage when
+// disabled. It is enabled in developer mode.
+class CallbackTrace final {
+  public:
+    static constexpr int kMaxStages = 128;
+    static constexpr int kInvalidStage = -1;
+    // The number of callbacks kept in the ring. With 256 frames per buffer
+    // at 44.1 kHz this is about 3 seconds of history.
+    static constexpr int kRingSize = 512;
+    // The number of callbacks before and after an xrun that are written to
+    // the dump file.
+    static constexpr int kXrunContextBefore = 16;
+    static constexpr int kXrunContextAfter = 4;
+
+    struct Record {
+        // Callback number, starting at 1. 0 while the record is written.
+        quint64 sequence;
+        // Start of the callback, relative to an arbitrary fixed point.
+        qint64 startNanos;
+        // Total time spent in the callback.
+        qint64 totalNanos;
+        int frames;
+        bool xrun;
+        // Time spent in each registered stage, indexed by stage id.
+        qint64 stageNanos[kMaxStages];
+    };
+
+    // Allocates the ring and turns tracing on for the rest of the session.
+    // Must be called from a non-realtime thread before the engine is set up.
+    static void enable();
+    static bool isEnabled() {
+        return s_enabled;
+    }
+
+    // Returns an id for the stage with the given name, registering it if it is
+    // not known yet. Returns kInvalidStage if tracing is disabled or all
+    // stage slots are used. Not realtime safe.
+    static int registerStage(const QString& name);
+    static QString stageName(int stage);
+    static int stageCount();
+
+    // Realtime safe, engine thread only.
+    static void beginCallback(int frames);
+    static void endCallback(mixxx::Duration total);
+    static void addStageTime(int stage, mixxx::Duration elapsed) {
+        if (s_enabled && stage >= 0) {
+            if (s_pThreadStageNanos) {
+                s_pThreadStageNanos[stage] += elapsed.toIntegerNanos();
+            } else if (s_pCurrent) {
+                s_pCurrent->stageNanos[stage] += elapsed.toIntegerNanos();
+            }
+        }
+    }
+
+    // Threads that process parts of a callback on behalf of the engine
+    // thread collect their stage times in pStageNanos, an array of
+    // kMaxStages entries, instead of writing to the current record. The
+    // engine thread adds them with addStageTimes() once the work is done.
+    // Realtime safe.
+    static void setThreadStageTimes(qint64* pStageNanos) {
+        s_pThreadStageNanos = pStageNanos;
+    }
+    // Adds the times in pStageNanos to the current callback and resets them.
+    // Realtime safe, engine thread only.
+    static void addStageTimes(qint64* pStageNanos);
+
+    // Flags the current (or, if no callback is in progress, the next)
+    // callback as having caused or suffered an xrun. Realtime safe, may be
+    // called from any thread.
+    static void markXrun();
+
+    // Returns consistent copies of all complete records in the ring, oldest
+    // first. Not realtime safe.
+    static QVector<Record> snapshot();
+
+    // Sequence number of the most recent callback flagged with an xrun, or 0.
+    static quint64 lastXrunSequence() {
+        return s_lastXrunSequence.load(std::memory_order_acquire);
+    }
+
+    // Sequence number of the most recently completed callback.
+    static quint64 lastCompletedSequence() {
+        return s_published.load(std::memory_order_acquire);
+    }
+
+    // Writes all callbacks around xruns that have not been written yet to a
+    // CSV file in directory. Callbacks whose trailing context has not been
+    // recorded yet are kept for a later call. Returns the file name or an
+    // empty string if nothing has been written. Not realtime safe.
+    static QString writePendingXruns(const QString& directory);
+
+  private:
+    static bool s_enabled;
+    static Record* s_pRing;
+    static std::atomic<quint64>* s_pSequences;
+    static Record* s_pCurrent;
+    static thread_local qint64* s_pThreadStageNanos;
+    static quint64 s_writeSequence;
+    static std::atomic<quint64> s_published;
+    static std::atomic<quint64> s_lastXrunSequence;
+    static std::atomic<bool> s_xrunPending;
+    static quint64 s_lastDumpedXrunSequence;
+    static PerformanceTimer s_clock;
+
+    CallbackTrace() = delete;
+};
+
+// Adds the time between construction and destruction to a CallbackTrace
+// stage, minus the time of the stages nested within it on the same thread.
+class ScopedCallbackTraceStage final {
+  public:
+    explicit ScopedCallbackTraceStage(int stage)
+            : m_stage(CallbackTrace::isEnabled() ? stage : CallbackTrace::kInvalidStage),
+              m_pEnclosing(nullptr),
+              m_nestedNanos(0) {
+        if (m_stage != CallbackTrace::kInvalidStage) {
+            m_pEnclosing = s_pInnermost;
+            s_pInnermost = this;
+            m_timer.start();
+        }
+    }
+
+    ~ScopedCallbackTraceStage() {
+        if (m_stage != CallbackTrace::kInvalidStage) {
+            const qint64 nanos = m_timer.elapsed().toIntegerNanos();
+            CallbackTrace::addStageTime(m_stage,
+                    mixxx::Duration::fromNanos(nanos - m_nestedNanos));
+            if (m_pEnclosing) {
+                m_pEnclosing->m_nestedNanos += nanos;
+            }
+            s_pInnermost = m_pEnclosing;
+        }
+    }
+
+  private:
+    static thread_local ScopedCallbackTraceStage* s_pInnermost;
+
+    const int m_stage;
+    ScopedCallbackTraceStage* m_pEnclosing;
+    qint64 m_nestedNanos;
+    PerformanceTimer m_timer;
+};
@@ -0,0 +1,123 @@
+#include "util/callbacktracemodel.h"
+
+#include "util/callbacktrace.h"
+#include "util/math.h"
+
+namespace {
+
+// The number of callbacks before an xrun that are taken into account for the
+// xrun maximum. The offending callback is usually the one just before the
+// callback that observes the xrun.
+const int kXrunLookBehind = 2;
+
+} // anonymous namespace
+
+CallbackTraceModel::CallbackTraceModel(QObject* pParent)
+        : QAbstractTableModel(pParent) {
+}
+
+CallbackTraceModel::~CallbackTraceModel() {
+}
+
+void CallbackTraceModel::refresh() {
+    const QVector<CallbackTrace::Record> records = CallbackTrace::snapshot();
+    const int numStages = CallbackTrace::stageCount();
+
+    beginResetModel();
+    // The first row summarizes the callback as a whole.
+    m_stages.fill(StageSummary{QString(), 0, 0.0, 0.0, 0.0}, numStages + 1);
+    m_stages[0].name = tr("Callback total");
+    for (int stage = 0; stage < numStages; ++stage) {
+        m_stages[stage + 1].name = CallbackTrace::stageName(stage);
+    }
+
+    for (int i = 0; i < records.size(); ++i) {
+        const CallbackTrace::Record& record = records.at(i);
+        bool nearXrun = false;
+        for (int j = i; j < records.size() && j <= i + kXrunLookBehind; ++j) {
+            if (records.at(j).xrun) {
+                nearXrun = true;
+                break;
+            }
+        }
+        for (int row = 0; row <= numStages; ++row) {
+            const qint64 nanos = row == 0 ?
+                    record.totalNanos : record.stageNanos[row - 1];
+            if (nanos <= 0) {
+                continue;
+            }
+            const double micros = nanos / 1e3;
+            StageSummary& summary = m_stages[row];
+            ++summary.count;
+            summary.sumMicros += micros;
+            summary.maxMicros = math_max(summary.maxMicros, micros);
+            if (nearXrun) {
+                summary.xrunMaxMicros = math_max(summary.xrunMaxMicros, micros);
+            }
+        }
+    }
+    endResetModel();
+}
+
+int CallbackTraceModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_stages.size();
+}
+
+int CallbackTraceModel::columnCount(const QModelIndex& parent) const {
+    if (parent.isValid()) {
+        return 0;
+    }
+    return NUM_CALLBACK_TRACE_COLUMNS;
+}
+
+QVariant CallbackTraceModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || (role != Qt::DisplayRole &&
+                             role != Qt::EditRole)) {
+        return QVariant();
+    }
+
+    int row = index.row();
+    if (row < 0 || row >= m_stages.size()) {
+        return QVariant();
+    }
+
+    const StageSummary& summary = m_stages.at(row);
+    switch (index.column()) {
+        case CALLBACK_TRACE_COLUMN_STAGE:
+            return summary.name;
+        case CALLBACK_TRACE_COLUMN_COUNT:
+            return summary.count;
+        case CALLBACK_TRACE_COLUMN_MEAN:
+            return summary.count > 0 ?
+                    QVariant(summary.sumMicros / summary.count) : QVariant();
+        case CALLBACK_TRACE_COLUMN_MAX:
+            return summary.maxMicros;
+        case CALLBACK_TRACE_COLUMN_XRUN_MAX:
+            return summary.xrunMaxMicros;
+    }
+    return QVariant();
+}
+
+QVariant CallbackTraceModel::headerData(int section,
+                                        Qt::Orientation orientation,
+                                        int role) const {
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section) {
+        case CALLBACK_TRACE_COLUMN_STAGE:
+            return tr("Stage");
+        case CALLBACK_TRACE_COLUMN_COUNT:
+            return tr("Callbacks");
+        case CALLBACK_TRACE_COLUMN_MEAN:
+            return tr("Mean (us)");
+        case CALLBACK_TRACE_COLUMN_MAX:
+            return tr("Max (us)");
+        case CALLBACK_TRACE_COLUMN_XRUN_MAX:
+            return tr("Max near xrun (us)");
+    }
+    return QVariant();
+}
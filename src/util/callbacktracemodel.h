@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QModelIndex>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+// Summarizes the callbacks currently held by CallbackTrace per stage, so that
+// the stages that are most likely responsible for xruns can be spotted in the
+// developer tools. All durations are in microseconds.
+class CallbackTraceModel final : public QAbstractTableModel {
+    Q_OBJECT
+  public:
+    enum CallbackTraceColumn {
+        CALLBACK_TRACE_COLUMN_STAGE = 0,
+        CALLBACK_TRACE_COLUMN_COUNT,
+        CALLBACK_TRACE_COLUMN_MEAN,
+        CALLBACK_TRACE_COLUMN_MAX,
+        CALLBACK_TRACE_COLUMN_XRUN_MAX,
+        NUM_CALLBACK_TRACE_COLUMNS
+    };
+
+    CallbackTraceModel(QObject* pParent = nullptr);
+    ~CallbackTraceModel() override;
+
+    // Re-reads the CallbackTrace ring.
+    void refresh();
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+  private:
+    struct StageSummary {
+        QString name;
+        int count;
+        double sumMicros;
+        double maxMicros;
+        // Maximum within the callbacks flagged with an xrun and the callbacks
+        // just before them.
+        double xrunMaxMicros;
+    };
+
+    QVector<StageSummary> m_stages;
+};
@@ -5,7 +5,12 @@
 
 class Counter {
   public:
-    Counter(const QString& tag)
+    // Interns the tag every time
+    explicit Counter(const QString& tag)
+    : m_tag(StatTag(tag)) {
+    }
+    // Does not intern the tag again, use this in hot code paths
+    explicit Counter(const StatTag& tag)
     : m_tag(tag) {
     }
     void increment(int by=1) {
@@ -24,7 +29,7 @@ class Counter {
         return result;
     }
   private:
-    QString m_tag;
+    StatTag m_tag;
 };
 
 #endif /* COUNTER_H */
@@ -0,0 +1,64 @@
+#include "util/cpufeatures.h"
+
+#if defined(MIXXX_CPU_DISPATCH) && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace mixxx {
+
+namespace {
+
+struct DetectedFeatures {
+    DetectedFeatures()
+            : avx2(false),
+              avx512(false) {
+#if defined(MIXXX_CPU_DISPATCH) && !defined(_MSC_VER)
+        __builtin_cpu_init();
+        avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        avx512 = __builtin_cpu_supports("avx512f");
+#elif defined(MIXXX_CPU_DISPATCH)
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+        if (maxLeaf < 7) {
+            return;
+        }
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        if (!osxsave) {
+            return;
+        }
+        // The OS must save the YMM (and ZMM) registers on context switches
+        const unsigned long long xcr0 = _xgetbv(0);
+        const bool osAvx = (xcr0 & 0x6) == 0x6;
+        const bool osAvx512 = (xcr0 & 0xE6) == 0xE6;
+        __cpuidex(info, 7, 0);
+        avx2 = osAvx && fma && (info[1] & (1 << 5)) != 0;
+        avx512 = osAvx512 && (info[1] & (1 << 16)) != 0;
+#endif
+    }
+
+    bool avx2;
+    bool avx512;
+};
+
+const DetectedFeatures& detectedFeatures() {
+    static const DetectedFeatures s_features;
+    return s_features;
+}
+
+} // anonymous namespace
+
+// static
+bool CpuFeatures::hasAvx2() {
+    return detectedFeatures().avx2;
+}
+
+// static
+bool CpuFeatures::hasAvx512() {
+    return detectedFeatures().avx512;
+}
+
+} // namespace mixxx
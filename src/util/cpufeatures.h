@@ -0,0 +1,44 @@
+#pragma once
+
+// The instruction set extensions of the CPU that Mixxx is running on. Code
+// that is compiled for the baseline of a build uses this to select faster
+// kernels at runtime.
+//
+// The SIMD kernels are only compiled for x86 CPUs. On other architectures
+// all extensions are reported as unavailable.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MIXXX_CPU_X86
+#endif
+
+#if defined(MIXXX_CPU_X86) && (defined(__SSE2__) || defined(_M_X64) || \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+// SSE2 is part of the build baseline
+#define MIXXX_CPU_SSE2
+#endif
+
+#if defined(MIXXX_CPU_X86) && (defined(__GNUC__) || defined(__clang__))
+// Allows using the intrinsics of an extension in a single function without
+// raising the baseline of the whole build
+#define MIXXX_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define MIXXX_TARGET_AVX512 __attribute__((target("avx512f")))
+#define MIXXX_CPU_DISPATCH
+#elif defined(MIXXX_CPU_X86) && defined(_MSC_VER)
+// MSVC allows all intrinsics regardless of the target architecture
+#define MIXXX_TARGET_AVX2
+#define MIXXX_TARGET_AVX512
+#define MIXXX_CPU_DISPATCH
+#endif
+
+namespace mixxx {
+
+class CpuFeatures final {
+  public:
+    // The features are detected once and cached
+    static bool hasAvx2();
+    static bool hasAvx512();
+
+  private:
+    CpuFeatures() = delete;
+};
+
+} // namespace mixxx
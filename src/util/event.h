@@ -7,34 +7,43 @@
 #include "util/stat.h"
 #include "util/duration.h"
 
+// An entry of the timeline. Durations are recorded as events that end at
+// m_time.
 class Event {
   public:
     Event()
-            : m_type(Stat::UNSPECIFIED) {
+            : m_tagId(-1),
+              m_threadId(-1),
+              m_type(Stat::UNSPECIFIED) {
     }
 
     typedef Stat::StatType EventType;
 
-    QString m_tag;
+    int m_tagId;
+    int m_threadId;
     EventType m_type;
     mixxx::Duration m_time;
+    mixxx::Duration m_duration;
 
-    static bool event(const QString& tag, Event::EventType type = Stat::EVENT) {
+    static bool event(const StatTag& tag, Event::EventType type = Stat::EVENT) {
         return Stat::track(tag, type, Stat::experimentFlags(Stat::COUNT), 0.0);
     }
 
-    static bool start(const QString& tag) {
+    static bool start(const StatTag& tag) {
         return event(tag, Stat::EVENT_START);
     }
 
-    static bool end(const QString& tag) {
+    static bool end(const StatTag& tag) {
         return event(tag, Stat::EVENT_END);
     }
 
-    // Disallow to use this class with implicit converted char strings.
-    // This should not be uses to avoid unicode encoding and memory
-    // allocation at every call. Use a static tag like this:
-    // static const QString tag("TAG TEXT");
+    // Disallow to use this class with implicit converted strings.
+    // This should not be uses to avoid unicode encoding, memory
+    // allocation and interning at every call. Use a static tag like this:
+    // static const StatTag tag("TAG TEXT");
+    static bool event(const QString&, Event::EventType) = delete;
+    static bool start(const QString&) = delete;
+    static bool end(const QString&) = delete;
     static bool event(const char*, Event::EventType) = delete;
     static bool start(const char*) = delete;
     static bool end(const char*) = delete;
@@ -0,0 +1,214 @@
+#include "util/filecopier.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QObject>
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <vector>
+
+#include "util/compatibility.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("FileCopier");
+
+// Large enough to keep the overhead of system calls and the seeks of
+// rotating disks and cheap flash drives negligible
+constexpr qint64 kStreamBufferSize = 4 * 1024 * 1024;
+
+// copy_file_range() is invoked in chunks for reporting the progress
+// and for responding to cancellation in time
+constexpr size_t kCopyRangeChunkSize = 16 * 1024 * 1024;
+
+#ifdef Q_OS_LINUX
+bool reflink(int sourceFd, int destFd) {
+#ifdef FICLONE
+    return ::ioctl(destFd, FICLONE, sourceFd) == 0;
+#else
+    Q_UNUSED(sourceFd);
+    Q_UNUSED(destFd);
+    return false;
+#endif
+}
+
+ssize_t copyFileRange(int sourceFd, int destFd, size_t length) {
+#ifdef __NR_copy_file_range
+    // The glibc wrapper is only available since version 2.27
+    return ::syscall(__NR_copy_file_range,
+            sourceFd, nullptr, destFd, nullptr, length, 0u);
+#else
+    Q_UNUSED(sourceFd);
+    Q_UNUSED(destFd);
+    Q_UNUSED(length);
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+// The kernel refuses to copy between these files, e.g. between different
+// file systems before Linux 5.3 or from/to some network file systems
+bool isCopyFileRangeUnsupported(int error) {
+    return error == EXDEV ||
+            error == ENOSYS ||
+            error == EINVAL ||
+            error == EOPNOTSUPP;
+}
+#endif
+
+QByteArray checksum(QFile* pFile) {
+    if (!pFile->seek(0)) {
+        return QByteArray();
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(pFile)) {
+        return QByteArray();
+    }
+    return hash.result();
+}
+
+} // anonymous namespace
+
+bool FileCopier::copy(const QString& sourcePath, const QString& destPath) {
+    m_errorString.clear();
+    m_method = Method::None;
+
+    // Unbuffered, because the file descriptors are also used directly
+    QFile sourceFile(sourcePath);
+    if (!sourceFile.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        m_errorString = sourceFile.errorString();
+        return false;
+    }
+    QFile destFile(destPath);
+    if (!destFile.open(QIODevice::ReadWrite | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        m_errorString = destFile.errorString();
+        return false;
+    }
+
+    const bool copied = copyData(&sourceFile, &destFile) &&
+            (!m_verify || m_method == Method::Reflink || verifyData(&sourceFile, &destFile));
+    destFile.close();
+    if (!copied) {
+        kLogger.debug() << "Removing incomplete file" << destPath;
+        destFile.remove();
+        return false;
+    }
+    return true;
+}
+
+bool FileCopier::copyData(QFile* pSourceFile, QFile* pDestFile) {
+#ifdef Q_OS_LINUX
+    const int sourceFd = pSourceFile->handle();
+    const int destFd = pDestFile->handle();
+    if (reflink(sourceFd, destFd)) {
+        m_method = Method::Reflink;
+        addBytesCopied(pSourceFile->size());
+        return true;
+    }
+
+    m_method = Method::CopyFileRange;
+    qint64 offset = 0;
+    for (;;) {
+        if (isStopped()) {
+            m_errorString = QObject::tr("Copying was aborted");
+            return false;
+        }
+        // Copies from and advances the current offsets of both files
+        const ssize_t bytesCopied = copyFileRange(sourceFd, destFd, kCopyRangeChunkSize);
+        if (bytesCopied < 0) {
+            const int error = errno;
+            if (error == EINTR) {
+                continue;
+            }
+            if (offset == 0 && isCopyFileRangeUnsupported(error)) {
+                break;
+            }
+            m_errorString = QString::fromLocal8Bit(::strerror(error));
+            return false;
+        }
+        if (bytesCopied == 0) {
+            return true;
+        }
+        offset += bytesCopied;
+        addBytesCopied(bytesCopied);
+    }
+#endif
+
+    m_method = Method::Stream;
+    std::vector<char> buffer(kStreamBufferSize);
+    for (;;) {
+        if (isStopped()) {
+            m_errorString = QObject::tr("Copying was aborted");
+            return false;
+        }
+        const qint64 bytesRead = pSourceFile->read(buffer.data(), kStreamBufferSize);
+        if (bytesRead < 0) {
+            m_errorString = pSourceFile->errorString();
+            return false;
+        }
+        if (bytesRead == 0) {
+            return true;
+        }
+        if (pDestFile->write(buffer.data(), bytesRead) != bytesRead) {
+            m_errorString = pDestFile->errorString();
+            return false;
+        }
+        addBytesCopied(bytesRead);
+    }
+}
+
+bool FileCopier::verifyData(QFile* pSourceFile, QFile* pDestFile) {
+    if (!pDestFile->flush()) {
+        m_errorString = pDestFile->errorString();
+        return false;
+    }
+#ifdef Q_OS_LINUX
+    // Otherwise the checksum would be calculated from the page cache
+    // instead of the data that has actually been written
+    const int destFd = pDestFile->handle();
+    if (::fsync(destFd) != 0) {
+        m_errorString = QString::fromLocal8Bit(::strerror(errno));
+        return false;
+    }
+    ::posix_fadvise(destFd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+    const QByteArray sourceChecksum = checksum(pSourceFile);
+    if (sourceChecksum.isEmpty()) {
+        m_errorString = pSourceFile->errorString();
+        return false;
+    }
+    const QByteArray destChecksum = checksum(pDestFile);
+    if (destChecksum.isEmpty()) {
+        m_errorString = pDestFile->errorString();
+        return false;
+    }
+    if (sourceChecksum != destChecksum) {
+        m_errorString = QObject::tr("The copied file differs from the original");
+        return false;
+    }
+    return true;
+}
+
+bool FileCopier::isStopped() const {
+    return m_pStop && atomicLoadAcquire(*m_pStop);
+}
+
+void FileCopier::addBytesCopied(qint64 bytes) {
+    if (m_pBytesCopied) {
+        m_pBytesCopied->fetchAndAddRelaxed(bytes);
+    }
+}
+
+} // namespace mixxx
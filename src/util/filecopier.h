@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <QAtomicInteger>
+#include <QFile>
+#include <QString>
+
+namespace mixxx {
+
+// Copies a single file as efficiently as the involved file systems permit:
+//  1. Reflink (Linux, copy-on-write file systems like Btrfs or XFS): The
+//     destination shares the data of the source and no data is copied.
+//  2. copy_file_range() (Linux): The data is copied within the kernel and
+//     might be offloaded to the file system or storage device.
+//  3. Streaming through a large user space buffer on all other platforms or
+//     if the kernel refuses to copy between the file systems.
+//
+// Instances are not thread-safe, but multiple instances may copy in
+// parallel.
+class FileCopier final {
+  public:
+    enum class Method {
+        None,
+        Reflink,
+        CopyFileRange,
+        Stream,
+    };
+
+    FileCopier() = default;
+
+    // Compare checksums of the source and the destination after copying.
+    // The destination is synced and its cached pages are dropped before,
+    // so that the data is actually read back from the storage device where
+    // possible. Reflinked files are never verified.
+    void setVerify(bool verify) {
+        m_verify = verify;
+    }
+
+    // The number of copied bytes is added to pBytesCopied while copying.
+    // Copying is aborted as soon as pStop becomes non-zero. Both are
+    // optional and may be shared between multiple copiers.
+    void setProgress(QAtomicInteger<qint64>* pBytesCopied, const QAtomicInt* pStop) {
+        m_pBytesCopied = pBytesCopied;
+        m_pStop = pStop;
+    }
+
+    // Copies the source file to the destination, which is created or
+    // truncated. On failure or when aborted an incomplete destination
+    // file is removed and errorString() describes the failure.
+    bool copy(const QString& sourcePath, const QString& destPath);
+
+    QString errorString() const {
+        return m_errorString;
+    }
+
+    // How the last file has been copied
+    Method method() const {
+        return m_method;
+    }
+
+  private:
+    bool copyData(QFile* pSourceFile, QFile* pDestFile);
+    bool verifyData(QFile* pSourceFile, QFile* pDestFile);
+    bool isStopped() const;
+    void addBytesCopied(qint64 bytes);
+
+    bool m_verify = false;
+    QAtomicInteger<qint64>* m_pBytesCopied = nullptr;
+    const QAtomicInt* m_pStop = nullptr;
+
+    QString m_errorString;
+    Method m_method = Method::None;
+};
+
+} // namespace mixxx
@@ -3,6 +3,7 @@
 
 #include "util/sample.h"
 #include "util/math.h"
+#include "util/samplekernels.h"
 
 #ifdef __WINDOWS__
 #include <QtGlobal>
@@ -16,6 +17,9 @@ typedef qint32 int32_t;
 // https://gcc.gnu.org/projects/tree-ssa/vectorization.html
 // This also utilizes AVX registers when compiled for a recent 64-bit CPU
 // using scons optimize=native.
+// The functions that matter most in the engine callback call hand-written
+// kernels instead, see util/samplekernels.cpp. Those use AVX2 or AVX-512 at
+// runtime if the CPU supports them, regardless of the build baseline.
 
 namespace {
 
@@ -34,6 +38,13 @@ constexpr bool useAlignedAlloc() {
             sizeof(CSAMPLE*) == sizeof(size_t);
 }
 
+// The SIMD kernels are selected once on the first call
+inline const mixxx::SampleKernels& kernels() {
+    static const mixxx::SampleKernels& s_kernels =
+            mixxx::SampleKernels::selected();
+    return s_kernels;
+}
+
 } // anonymous namespace
 
 // static
@@ -131,13 +142,8 @@ void SampleUtil::applyRampingGain(CSAMPLE* pBuffer, CSAMPLE_GAIN old_gain,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            // a loop counter i += 2 prevents vectorizing.
-            pBuffer[i * 2] *= gain;
-            pBuffer[i * 2 + 1] *= gain;
-        }
+        kernels().applyRampingGain(pBuffer, start_gain, gain_delta,
+                numSamples / 2);
     } else {
         // note: LOOP VECTORIZED.
         for (int i = 0; i < numSamples; ++i) {
@@ -239,12 +245,8 @@ void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] += pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
-        }
+        kernels().addWithRampingGain(pDest, pSrc, start_gain, gain_delta,
+                numSamples / 2);
     } else {
         // note: LOOP VECTORIZED.
         for (int i = 0; i < numSamples; ++i) {
@@ -290,6 +292,16 @@ void SampleUtil::add3WithGain(CSAMPLE* pDest,
     }
 }
 
+// static
+void SampleUtil::sumBuffers(CSAMPLE* pDest, const CSAMPLE* const* ppSrc,
+        int numSrc, SINT numSamples) {
+    if (numSrc <= 0) {
+        clear(pDest, numSamples);
+        return;
+    }
+    kernels().sumBuffers(pDest, ppSrc, numSrc, numSamples);
+}
+
 // static
 void SampleUtil::copyWithGain(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc,
@@ -332,12 +344,8 @@ void SampleUtil::copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED only with "int i"
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] = pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
-        }
+        kernels().copyWithRampingGain(pDest, pSrc, start_gain, gain_delta,
+                numSamples / 2);
     } else {
         // note: LOOP VECTORIZED.
         for (SINT i = 0; i < numSamples; ++i) {
@@ -378,65 +386,29 @@ void SampleUtil::convertFloat32ToS16(SAMPLE* pDest, const CSAMPLE* pSrc,
 // static
 SampleUtil::CLIP_STATUS SampleUtil::sumAbsPerChannel(CSAMPLE* pfAbsL,
         CSAMPLE* pfAbsR, const CSAMPLE* pBuffer, SINT numSamples) {
-    CSAMPLE fAbsL = CSAMPLE_ZERO;
-    CSAMPLE fAbsR = CSAMPLE_ZERO;
-    CSAMPLE clippedL = 0;
-    CSAMPLE clippedR = 0;
-
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples / 2; ++i) {
-        CSAMPLE absl = fabs(pBuffer[i * 2]);
-        fAbsL += absl;
-        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
-        CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
-        fAbsR += absr;
-        // Replacing the code with a bool clipped will prevent vetorizing
-        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
-    }
-
-    *pfAbsL = fAbsL;
-    *pfAbsR = fAbsR;
-    SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
-    if (clippedL > 0) {
-        clipping |= SampleUtil::CLIPPING_LEFT;
-    }
-    if (clippedR > 0) {
-        clipping |= SampleUtil::CLIPPING_RIGHT;
-    }
-    return clipping;
+    return kernels().sumAbsPerChannel(pfAbsL, pfAbsR, pBuffer, numSamples / 2);
 }
 
 // static
-void SampleUtil::copyClampBuffer(CSAMPLE* M_RESTRICT pDest,
-        const CSAMPLE* M_RESTRICT pSrc, SINT iNumSamples) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < iNumSamples; ++i) {
-        pDest[i] = clampSample(pSrc[i]);
-    }
+void SampleUtil::copyClampBuffer(CSAMPLE* pDest,
+        const CSAMPLE* pSrc, SINT iNumSamples) {
+    kernels().copyClampBuffer(pDest, pSrc, iNumSamples);
 }
 
 // static
-void SampleUtil::interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
-        const CSAMPLE* M_RESTRICT pSrc1,
-        const CSAMPLE* M_RESTRICT pSrc2,
+void SampleUtil::interleaveBuffer(CSAMPLE* pDest,
+        const CSAMPLE* pSrc1,
+        const CSAMPLE* pSrc2,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest[2 * i] = pSrc1[i];
-        pDest[2 * i + 1] = pSrc2[i];
-    }
+    kernels().interleaveBuffer(pDest, pSrc1, pSrc2, numFrames);
 }
 
 // static
-void SampleUtil::deinterleaveBuffer(CSAMPLE* M_RESTRICT pDest1,
-        CSAMPLE* M_RESTRICT pDest2,
-        const CSAMPLE* M_RESTRICT pSrc,
+void SampleUtil::deinterleaveBuffer(CSAMPLE* pDest1,
+        CSAMPLE* pDest2,
+        const CSAMPLE* pSrc,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest1[i] = pSrc[i * 2];
-        pDest2[i] = pSrc[i * 2 + 1];
-    }
+    kernels().deinterleaveBuffer(pDest1, pDest2, pSrc, numFrames);
 }
 
 // static
@@ -185,6 +185,13 @@ class SampleUtil {
             CSAMPLE_GAIN gain1, const CSAMPLE* pSrc2, CSAMPLE_GAIN gain2,
             const CSAMPLE* pSrc3, CSAMPLE_GAIN gain3, SINT numSamples);
 
+    // Set each sample of pDest to the sum of the samples of the numSrc
+    // buffers in ppSrc, added in order. Clears pDest if numSrc is 0. pDest
+    // must not overlap any source. Uses the widest SIMD instructions that
+    // the CPU supports.
+    static void sumBuffers(CSAMPLE* pDest, const CSAMPLE* const* ppSrc,
+            int numSrc, SINT numSamples);
+
     // Convert and normalize a buffer of SAMPLEs in the range [-SAMPLE_MAX, SAMPLE_MAX]
     // to a buffer of CSAMPLEs in the range [-1.0, 1.0].
     static void convertS16ToFloat32(CSAMPLE* pDest, const SAMPLE* pSrc,
@@ -0,0 +1,849 @@
+#include "util/samplekernels.h"
+
+#include "util/cpufeatures.h"
+#include "util/math.h"
+
+#if defined(MIXXX_CPU_SSE2) || defined(MIXXX_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
+
+// The SIMD kernels process whole registers in the main loop and hand the
+// remaining samples to the scalar helpers below. They use unaligned loads and
+// stores, because the engine passes buffers at arbitrary offsets.
+
+namespace mixxx {
+
+namespace {
+
+SampleUtil::CLIP_STATUS clipStatus(bool clippedL, bool clippedR) {
+    SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
+    if (clippedL) {
+        clipping |= SampleUtil::CLIPPING_LEFT;
+    }
+    if (clippedR) {
+        clipping |= SampleUtil::CLIPPING_RIGHT;
+    }
+    return clipping;
+}
+
+// Scalar helpers for the frames or samples in [first, last). pDest and pSrc
+// may be aliases.
+
+template<bool kAdd>
+inline void rampFrames(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        int first,
+        int last) {
+    for (int i = first; i < last; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        if (kAdd) {
+            pDest[i * 2] += pSrc[i * 2] * gain;
+            pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+        } else {
+            pDest[i * 2] = pSrc[i * 2] * gain;
+            pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+        }
+    }
+}
+
+inline void sumAbsFrames(const CSAMPLE* pBuffer,
+        SINT first,
+        SINT last,
+        CSAMPLE* pAbsL,
+        CSAMPLE* pAbsR,
+        bool* pClippedL,
+        bool* pClippedR) {
+    for (SINT i = first; i < last; ++i) {
+        const CSAMPLE absl = fabs(pBuffer[i * 2]);
+        *pAbsL += absl;
+        *pClippedL |= absl > CSAMPLE_PEAK;
+        const CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
+        *pAbsR += absr;
+        *pClippedR |= absr > CSAMPLE_PEAK;
+    }
+}
+
+inline void clampSamples(CSAMPLE* pDest, const CSAMPLE* pSrc, SINT first, SINT last) {
+    for (SINT i = first; i < last; ++i) {
+        pDest[i] = SampleUtil::clampSample(pSrc[i]);
+    }
+}
+
+inline void interleaveFrames(CSAMPLE* pDest,
+        const CSAMPLE* pSrc1,
+        const CSAMPLE* pSrc2,
+        SINT first,
+        SINT last) {
+    for (SINT i = first; i < last; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+inline void deinterleaveFrames(CSAMPLE* pDest1,
+        CSAMPLE* pDest2,
+        const CSAMPLE* pSrc,
+        SINT first,
+        SINT last) {
+    for (SINT i = first; i < last; ++i) {
+        pDest1[i] = pSrc[i * 2];
+        pDest2[i] = pSrc[i * 2 + 1];
+    }
+}
+
+inline void sumBuffersTail(CSAMPLE* pDest,
+        const CSAMPLE* const* ppSrc,
+        int numSrc,
+        SINT first,
+        SINT last) {
+    for (SINT i = first; i < last; ++i) {
+        CSAMPLE sum = ppSrc[0][i];
+        for (int src = 1; src < numSrc; ++src) {
+            sum += ppSrc[src][i];
+        }
+        pDest[i] = sum;
+    }
+}
+
+// Generic kernels
+
+void applyRampingGainGeneric(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        // a loop counter i += 2 prevents vectorizing.
+        pBuffer[i * 2] *= gain;
+        pBuffer[i * 2 + 1] *= gain;
+    }
+}
+
+void copyWithRampingGainGeneric(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED only with "int i"
+    for (int i = 0; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void addWithRampingGainGeneric(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+SampleUtil::CLIP_STATUS sumAbsPerChannelGeneric(CSAMPLE* pfAbsL,
+        CSAMPLE* pfAbsR,
+        const CSAMPLE* pBuffer,
+        SINT numFrames) {
+    CSAMPLE fAbsL = CSAMPLE_ZERO;
+    CSAMPLE fAbsR = CSAMPLE_ZERO;
+    CSAMPLE clippedL = 0;
+    CSAMPLE clippedR = 0;
+
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        CSAMPLE absl = fabs(pBuffer[i * 2]);
+        fAbsL += absl;
+        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
+        CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
+        fAbsR += absr;
+        // Replacing the code with a bool clipped will prevent vetorizing
+        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
+    }
+
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    return clipStatus(clippedL > 0, clippedR > 0);
+}
+
+// pDest and pSrc may be aliases
+void copyClampBufferGeneric(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] = SampleUtil::clampSample(pSrc[i]);
+    }
+}
+
+void interleaveBufferGeneric(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+void deinterleaveBufferGeneric(CSAMPLE* M_RESTRICT pDest1,
+        CSAMPLE* M_RESTRICT pDest2,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 2];
+        pDest2[i] = pSrc[i * 2 + 1];
+    }
+}
+
+// Adds 1 to 4 sources to pDest in a single pass, or overwrites pDest with
+// their sum if accumulate is false.
+void sumPass(CSAMPLE* M_RESTRICT pDest, const CSAMPLE* const* ppSrc,
+        int numSrc, bool accumulate, SINT numSamples) {
+    const CSAMPLE* M_RESTRICT pSrc0 = ppSrc[0];
+    switch (numSrc) {
+    case 1:
+        if (accumulate) {
+            SampleUtil::add(pDest, pSrc0, numSamples);
+        } else {
+            SampleUtil::copy(pDest, pSrc0, numSamples);
+        }
+        return;
+    case 2: {
+        const CSAMPLE* M_RESTRICT pSrc1 = ppSrc[1];
+        if (accumulate) {
+            // note: LOOP VECTORIZED.
+            for (SINT i = 0; i < numSamples; ++i) {
+                pDest[i] = pDest[i] + pSrc0[i] + pSrc1[i];
+            }
+        } else {
+            // note: LOOP VECTORIZED.
+            for (SINT i = 0; i < numSamples; ++i) {
+                pDest[i] = pSrc0[i] + pSrc1[i];
+            }
+        }
+        return;
+    }
+    case 3: {
+        const CSAMPLE* M_RESTRICT pSrc1 = ppSrc[1];
+        const CSAMPLE* M_RESTRICT pSrc2 = ppSrc[2];
+        if (accumulate) {
+            // note: LOOP VECTORIZED.
+            for (SINT i = 0; i < numSamples; ++i) {
+                pDest[i] = pDest[i] + pSrc0[i] + pSrc1[i] + pSrc2[i];
+            }
+        } else {
+            // note: LOOP VECTORIZED.
+            for (SINT i = 0; i < numSamples; ++i) {
+                pDest[i] = pSrc0[i] + pSrc1[i] + pSrc2[i];
+            }
+        }
+        return;
+    }
+    default: {
+        const CSAMPLE* M_RESTRICT pSrc1 = ppSrc[1];
+        const CSAMPLE* M_RESTRICT pSrc2 = ppSrc[2];
+        const CSAMPLE* M_RESTRICT pSrc3 = ppSrc[3];
+        if (accumulate) {
+            // note: LOOP VECTORIZED.
+            for (SINT i = 0; i < numSamples; ++i) {
+                pDest[i] = pDest[i] + pSrc0[i] + pSrc1[i] + pSrc2[i] + pSrc3[i];
+            }
+        } else {
+            // note: LOOP VECTORIZED.
+            for (SINT i = 0; i < numSamples; ++i) {
+                pDest[i] = pSrc0[i] + pSrc1[i] + pSrc2[i] + pSrc3[i];
+            }
+        }
+        return;
+    }
+    }
+}
+
+// pDest is loaded and stored once for every 4 sources
+void sumBuffersGeneric(CSAMPLE* pDest, const CSAMPLE* const* ppSrc,
+        int numSrc, SINT numSamples) {
+    for (int src = 0; src < numSrc; src += 4) {
+        sumPass(pDest, ppSrc + src, math_min(numSrc - src, 4), src > 0,
+                numSamples);
+    }
+}
+
+const SampleKernels kGenericKernels = {
+        "generic",
+        applyRampingGainGeneric,
+        copyWithRampingGainGeneric,
+        addWithRampingGainGeneric,
+        sumAbsPerChannelGeneric,
+        copyClampBufferGeneric,
+        interleaveBufferGeneric,
+        deinterleaveBufferGeneric,
+        sumBuffersGeneric,
+};
+
+#ifdef MIXXX_CPU_SSE2
+// SSE2 kernels, 4 samples per register
+
+// Two stereo frames per register, so every gain is used for two lanes.
+// pDest and pSrc are aliases for applyRampingGain.
+template<bool kAdd>
+void rampSse2(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    const __m128 start = _mm_set1_ps(startGain);
+    const __m128 delta = _mm_set1_ps(gainDelta);
+    const __m128 step = _mm_set1_ps(4.0f);
+    __m128 frame0 = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+    __m128 frame1 = _mm_setr_ps(2.0f, 2.0f, 3.0f, 3.0f);
+    const int numVectorFrames = static_cast<int>(numFrames - numFrames % 4);
+    for (int i = 0; i < numVectorFrames; i += 4) {
+        const __m128 gain0 = _mm_add_ps(start, _mm_mul_ps(delta, frame0));
+        const __m128 gain1 = _mm_add_ps(start, _mm_mul_ps(delta, frame1));
+        __m128 out0 = _mm_mul_ps(_mm_loadu_ps(pSrc + i * 2), gain0);
+        __m128 out1 = _mm_mul_ps(_mm_loadu_ps(pSrc + i * 2 + 4), gain1);
+        if (kAdd) {
+            out0 = _mm_add_ps(_mm_loadu_ps(pDest + i * 2), out0);
+            out1 = _mm_add_ps(_mm_loadu_ps(pDest + i * 2 + 4), out1);
+        }
+        _mm_storeu_ps(pDest + i * 2, out0);
+        _mm_storeu_ps(pDest + i * 2 + 4, out1);
+        frame0 = _mm_add_ps(frame0, step);
+        frame1 = _mm_add_ps(frame1, step);
+    }
+    rampFrames<kAdd>(pDest, pSrc, startGain, gainDelta,
+            numVectorFrames, static_cast<int>(numFrames));
+}
+
+void applyRampingGainSse2(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    rampSse2<false>(pBuffer, pBuffer, startGain, gainDelta, numFrames);
+}
+
+void copyWithRampingGainSse2(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    rampSse2<false>(pDest, pSrc, startGain, gainDelta, numFrames);
+}
+
+void addWithRampingGainSse2(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    rampSse2<true>(pDest, pSrc, startGain, gainDelta, numFrames);
+}
+
+SampleUtil::CLIP_STATUS sumAbsPerChannelSse2(CSAMPLE* pfAbsL,
+        CSAMPLE* pfAbsR,
+        const CSAMPLE* pBuffer,
+        SINT numFrames) {
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 peak = _mm_set1_ps(CSAMPLE_PEAK);
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+    __m128 clipped = _mm_setzero_ps();
+    const SINT numVectorFrames = numFrames - numFrames % 4;
+    for (SINT i = 0; i < numVectorFrames; i += 4) {
+        const __m128 abs0 = _mm_and_ps(_mm_loadu_ps(pBuffer + i * 2), absMask);
+        const __m128 abs1 = _mm_and_ps(_mm_loadu_ps(pBuffer + i * 2 + 4), absMask);
+        sum0 = _mm_add_ps(sum0, abs0);
+        sum1 = _mm_add_ps(sum1, abs1);
+        clipped = _mm_or_ps(clipped,
+                _mm_or_ps(_mm_cmpgt_ps(abs0, peak), _mm_cmpgt_ps(abs1, peak)));
+    }
+    // The even lanes hold the left channel, the odd lanes the right channel
+    float sums[4];
+    _mm_storeu_ps(sums, _mm_add_ps(sum0, sum1));
+    const int clippedLanes = _mm_movemask_ps(clipped);
+    CSAMPLE absL = sums[0] + sums[2];
+    CSAMPLE absR = sums[1] + sums[3];
+    bool clippedL = (clippedLanes & 0x5) != 0;
+    bool clippedR = (clippedLanes & 0xA) != 0;
+    sumAbsFrames(pBuffer, numVectorFrames, numFrames,
+            &absL, &absR, &clippedL, &clippedR);
+    *pfAbsL = absL;
+    *pfAbsR = absR;
+    return clipStatus(clippedL, clippedR);
+}
+
+void copyClampBufferSse2(CSAMPLE* pDest, const CSAMPLE* pSrc, SINT numSamples) {
+    const __m128 peak = _mm_set1_ps(CSAMPLE_PEAK);
+    const __m128 minusPeak = _mm_set1_ps(-CSAMPLE_PEAK);
+    const SINT numVectorSamples = numSamples - numSamples % 8;
+    for (SINT i = 0; i < numVectorSamples; i += 8) {
+        const __m128 in0 = _mm_loadu_ps(pSrc + i);
+        const __m128 in1 = _mm_loadu_ps(pSrc + i + 4);
+        _mm_storeu_ps(pDest + i, _mm_max_ps(minusPeak, _mm_min_ps(peak, in0)));
+        _mm_storeu_ps(pDest + i + 4, _mm_max_ps(minusPeak, _mm_min_ps(peak, in1)));
+    }
+    clampSamples(pDest, pSrc, numVectorSamples, numSamples);
+}
+
+void interleaveBufferSse2(CSAMPLE* pDest,
+        const CSAMPLE* pSrc1,
+        const CSAMPLE* pSrc2,
+        SINT numFrames) {
+    const SINT numVectorFrames = numFrames - numFrames % 4;
+    for (SINT i = 0; i < numVectorFrames; i += 4) {
+        const __m128 src1 = _mm_loadu_ps(pSrc1 + i);
+        const __m128 src2 = _mm_loadu_ps(pSrc2 + i);
+        _mm_storeu_ps(pDest + i * 2, _mm_unpacklo_ps(src1, src2));
+        _mm_storeu_ps(pDest + i * 2 + 4, _mm_unpackhi_ps(src1, src2));
+    }
+    interleaveFrames(pDest, pSrc1, pSrc2, numVectorFrames, numFrames);
+}
+
+void deinterleaveBufferSse2(CSAMPLE* pDest1,
+        CSAMPLE* pDest2,
+        const CSAMPLE* pSrc,
+        SINT numFrames) {
+    const SINT numVectorFrames = numFrames - numFrames % 4;
+    for (SINT i = 0; i < numVectorFrames; i += 4) {
+        const __m128 in0 = _mm_loadu_ps(pSrc + i * 2);
+        const __m128 in1 = _mm_loadu_ps(pSrc + i * 2 + 4);
+        _mm_storeu_ps(pDest1 + i, _mm_shuffle_ps(in0, in1, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(pDest2 + i, _mm_shuffle_ps(in0, in1, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    deinterleaveFrames(pDest1, pDest2, pSrc, numVectorFrames, numFrames);
+}
+
+// Adds all sources in registers, so pDest is only stored once. Two
+// independent sums per iteration hide the latency of the additions.
+void sumBuffersSse2(CSAMPLE* pDest, const CSAMPLE* const* ppSrc,
+        int numSrc, SINT numSamples) {
+    const SINT numVectorSamples = numSamples - numSamples % 8;
+    for (SINT i = 0; i < numVectorSamples; i += 8) {
+        __m128 sum0 = _mm_loadu_ps(ppSrc[0] + i);
+        __m128 sum1 = _mm_loadu_ps(ppSrc[0] + i + 4);
+        for (int src = 1; src < numSrc; ++src) {
+            sum0 = _mm_add_ps(sum0, _mm_loadu_ps(ppSrc[src] + i));
+            sum1 = _mm_add_ps(sum1, _mm_loadu_ps(ppSrc[src] + i + 4));
+        }
+        _mm_storeu_ps(pDest + i, sum0);
+        _mm_storeu_ps(pDest + i + 4, sum1);
+    }
+    sumBuffersTail(pDest, ppSrc, numSrc, numVectorSamples, numSamples);
+}
+
+const SampleKernels kSse2Kernels = {
+        "sse2",
+        applyRampingGainSse2,
+        copyWithRampingGainSse2,
+        addWithRampingGainSse2,
+        sumAbsPerChannelSse2,
+        copyClampBufferSse2,
+        interleaveBufferSse2,
+        deinterleaveBufferSse2,
+        sumBuffersSse2,
+};
+#endif // MIXXX_CPU_SSE2
+
+#ifdef MIXXX_CPU_DISPATCH
+// AVX2 kernels, 8 samples per register. The intrinsics must not be moved
+// into helpers without MIXXX_TARGET_AVX2, because those cannot be inlined.
+
+template<bool kAdd>
+MIXXX_TARGET_AVX2 void rampAvx2(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    const __m256 start = _mm256_set1_ps(startGain);
+    const __m256 delta = _mm256_set1_ps(gainDelta);
+    const __m256 step = _mm256_set1_ps(8.0f);
+    __m256 frame0 = _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f);
+    __m256 frame1 = _mm256_setr_ps(4.0f, 4.0f, 5.0f, 5.0f, 6.0f, 6.0f, 7.0f, 7.0f);
+    const int numVectorFrames = static_cast<int>(numFrames - numFrames % 8);
+    for (int i = 0; i < numVectorFrames; i += 8) {
+        const __m256 gain0 = _mm256_fmadd_ps(delta, frame0, start);
+        const __m256 gain1 = _mm256_fmadd_ps(delta, frame1, start);
+        const __m256 src0 = _mm256_loadu_ps(pSrc + i * 2);
+        const __m256 src1 = _mm256_loadu_ps(pSrc + i * 2 + 8);
+        if (kAdd) {
+            _mm256_storeu_ps(pDest + i * 2,
+                    _mm256_fmadd_ps(src0, gain0, _mm256_loadu_ps(pDest + i * 2)));
+            _mm256_storeu_ps(pDest + i * 2 + 8,
+                    _mm256_fmadd_ps(src1, gain1, _mm256_loadu_ps(pDest + i * 2 + 8)));
+        } else {
+            _mm256_storeu_ps(pDest + i * 2, _mm256_mul_ps(src0, gain0));
+            _mm256_storeu_ps(pDest + i * 2 + 8, _mm256_mul_ps(src1, gain1));
+        }
+        frame0 = _mm256_add_ps(frame0, step);
+        frame1 = _mm256_add_ps(frame1, step);
+    }
+    rampFrames<kAdd>(pDest, pSrc, startGain, gainDelta,
+            numVectorFrames, static_cast<int>(numFrames));
+}
+
+MIXXX_TARGET_AVX2 void applyRampingGainAvx2(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    rampAvx2<false>(pBuffer, pBuffer, startGain, gainDelta, numFrames);
+}
+
+MIXXX_TARGET_AVX2 void copyWithRampingGainAvx2(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    rampAvx2<false>(pDest, pSrc, startGain, gainDelta, numFrames);
+}
+
+MIXXX_TARGET_AVX2 void addWithRampingGainAvx2(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    rampAvx2<true>(pDest, pSrc, startGain, gainDelta, numFrames);
+}
+
+MIXXX_TARGET_AVX2 SampleUtil::CLIP_STATUS sumAbsPerChannelAvx2(CSAMPLE* pfAbsL,
+        CSAMPLE* pfAbsR,
+        const CSAMPLE* pBuffer,
+        SINT numFrames) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const __m256 peak = _mm256_set1_ps(CSAMPLE_PEAK);
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    __m256 clipped = _mm256_setzero_ps();
+    const SINT numVectorFrames = numFrames - numFrames % 8;
+    for (SINT i = 0; i < numVectorFrames; i += 8) {
+        const __m256 abs0 = _mm256_and_ps(_mm256_loadu_ps(pBuffer + i * 2), absMask);
+        const __m256 abs1 = _mm256_and_ps(_mm256_loadu_ps(pBuffer + i * 2 + 8), absMask);
+        sum0 = _mm256_add_ps(sum0, abs0);
+        sum1 = _mm256_add_ps(sum1, abs1);
+        clipped = _mm256_or_ps(clipped,
+                _mm256_or_ps(_mm256_cmp_ps(abs0, peak, _CMP_GT_OQ),
+                        _mm256_cmp_ps(abs1, peak, _CMP_GT_OQ)));
+    }
+    // The even lanes hold the left channel, the odd lanes the right channel
+    float sums[8];
+    _mm256_storeu_ps(sums, _mm256_add_ps(sum0, sum1));
+    const int clippedLanes = _mm256_movemask_ps(clipped);
+    CSAMPLE absL = (sums[0] + sums[2]) + (sums[4] + sums[6]);
+    CSAMPLE absR = (sums[1] + sums[3]) + (sums[5] + sums[7]);
+    bool clippedL = (clippedLanes & 0x55) != 0;
+    bool clippedR = (clippedLanes & 0xAA) != 0;
+    sumAbsFrames(pBuffer, numVectorFrames, numFrames,
+            &absL, &absR, &clippedL, &clippedR);
+    *pfAbsL = absL;
+    *pfAbsR = absR;
+    return clipStatus(clippedL, clippedR);
+}
+
+MIXXX_TARGET_AVX2 void copyClampBufferAvx2(
+        CSAMPLE* pDest, const CSAMPLE* pSrc, SINT numSamples) {
+    const __m256 peak = _mm256_set1_ps(CSAMPLE_PEAK);
+    const __m256 minusPeak = _mm256_set1_ps(-CSAMPLE_PEAK);
+    const SINT numVectorSamples = numSamples - numSamples % 16;
+    for (SINT i = 0; i < numVectorSamples; i += 16) {
+        const __m256 in0 = _mm256_loadu_ps(pSrc + i);
+        const __m256 in1 = _mm256_loadu_ps(pSrc + i + 8);
+        _mm256_storeu_ps(pDest + i, _mm256_max_ps(minusPeak, _mm256_min_ps(peak, in0)));
+        _mm256_storeu_ps(pDest + i + 8, _mm256_max_ps(minusPeak, _mm256_min_ps(peak, in1)));
+    }
+    clampSamples(pDest, pSrc, numVectorSamples, numSamples);
+}
+
+MIXXX_TARGET_AVX2 void interleaveBufferAvx2(CSAMPLE* pDest,
+        const CSAMPLE* pSrc1,
+        const CSAMPLE* pSrc2,
+        SINT numFrames) {
+    const SINT numVectorFrames = numFrames - numFrames % 8;
+    for (SINT i = 0; i < numVectorFrames; i += 8) {
+        const __m256 src1 = _mm256_loadu_ps(pSrc1 + i);
+        const __m256 src2 = _mm256_loadu_ps(pSrc2 + i);
+        // The unpack instructions work within the 128 bit halves
+        const __m256 low = _mm256_unpacklo_ps(src1, src2);
+        const __m256 high = _mm256_unpackhi_ps(src1, src2);
+        _mm256_storeu_ps(pDest + i * 2, _mm256_permute2f128_ps(low, high, 0x20));
+        _mm256_storeu_ps(pDest + i * 2 + 8, _mm256_permute2f128_ps(low, high, 0x31));
+    }
+    interleaveFrames(pDest, pSrc1, pSrc2, numVectorFrames, numFrames);
+}
+
+MIXXX_TARGET_AVX2 void deinterleaveBufferAvx2(CSAMPLE* pDest1,
+        CSAMPLE* pDest2,
+        const CSAMPLE* pSrc,
+        SINT numFrames) {
+    const SINT numVectorFrames = numFrames - numFrames % 8;
+    for (SINT i = 0; i < numVectorFrames; i += 8) {
+        const __m256 in0 = _mm256_loadu_ps(pSrc + i * 2);
+        const __m256 in1 = _mm256_loadu_ps(pSrc + i * 2 + 8);
+        // The shuffles work within the 128 bit halves, which leaves the
+        // pairs of frames in the order 0, 2, 1, 3
+        const __m256d left = _mm256_castps_pd(
+                _mm256_shuffle_ps(in0, in1, _MM_SHUFFLE(2, 0, 2, 0)));
+        const __m256d right = _mm256_castps_pd(
+                _mm256_shuffle_ps(in0, in1, _MM_SHUFFLE(3, 1, 3, 1)));
+        _mm256_storeu_ps(pDest1 + i,
+                _mm256_castpd_ps(_mm256_permute4x64_pd(left, _MM_SHUFFLE(3, 1, 2, 0))));
+        _mm256_storeu_ps(pDest2 + i,
+                _mm256_castpd_ps(_mm256_permute4x64_pd(right, _MM_SHUFFLE(3, 1, 2, 0))));
+    }
+    deinterleaveFrames(pDest1, pDest2, pSrc, numVectorFrames, numFrames);
+}
+
+MIXXX_TARGET_AVX2 void sumBuffersAvx2(CSAMPLE* pDest,
+        const CSAMPLE* const* ppSrc,
+        int numSrc,
+        SINT numSamples) {
+    const SINT numVectorSamples = numSamples - numSamples % 16;
+    for (SINT i = 0; i < numVectorSamples; i += 16) {
+        __m256 sum0 = _mm256_loadu_ps(ppSrc[0] + i);
+        __m256 sum1 = _mm256_loadu_ps(ppSrc[0] + i + 8);
+        for (int src = 1; src < numSrc; ++src) {
+            sum0 = _mm256_add_ps(sum0, _mm256_loadu_ps(ppSrc[src] + i));
+            sum1 = _mm256_add_ps(sum1, _mm256_loadu_ps(ppSrc[src] + i + 8));
+        }
+        _mm256_storeu_ps(pDest + i, sum0);
+        _mm256_storeu_ps(pDest + i + 8, sum1);
+    }
+    sumBuffersTail(pDest, ppSrc, numSrc, numVectorSamples, numSamples);
+}
+
+const SampleKernels kAvx2Kernels = {
+        "avx2",
+        applyRampingGainAvx2,
+        copyWithRampingGainAvx2,
+        addWithRampingGainAvx2,
+        sumAbsPerChannelAvx2,
+        copyClampBufferAvx2,
+        interleaveBufferAvx2,
+        deinterleaveBufferAvx2,
+        sumBuffersAvx2,
+};
+
+// AVX-512 kernels, 16 samples per register
+
+template<bool kAdd>
+MIXXX_TARGET_AVX512 void rampAvx512(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    const __m512 start = _mm512_set1_ps(startGain);
+    const __m512 delta = _mm512_set1_ps(gainDelta);
+    const __m512 step = _mm512_set1_ps(16.0f);
+    __m512 frame0 = _mm512_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f,
+            4.0f, 4.0f, 5.0f, 5.0f, 6.0f, 6.0f, 7.0f, 7.0f);
+    __m512 frame1 = _mm512_add_ps(frame0, _mm512_set1_ps(8.0f));
+    const int numVectorFrames = static_cast<int>(numFrames - numFrames % 16);
+    for (int i = 0; i < numVectorFrames; i += 16) {
+        const __m512 gain0 = _mm512_fmadd_ps(delta, frame0, start);
+        const __m512 gain1 = _mm512_fmadd_ps(delta, frame1, start);
+        const __m512 src0 = _mm512_loadu_ps(pSrc + i * 2);
+        const __m512 src1 = _mm512_loadu_ps(pSrc + i * 2 + 16);
+        if (kAdd) {
+            _mm512_storeu_ps(pDest + i * 2,
+                    _mm512_fmadd_ps(src0, gain0, _mm512_loadu_ps(pDest + i * 2)));
+            _mm512_storeu_ps(pDest + i * 2 + 16,
+                    _mm512_fmadd_ps(src1, gain1, _mm512_loadu_ps(pDest + i * 2 + 16)));
+        } else {
+            _mm512_storeu_ps(pDest + i * 2, _mm512_mul_ps(src0, gain0));
+            _mm512_storeu_ps(pDest + i * 2 + 16, _mm512_mul_ps(src1, gain1));
+        }
+        frame0 = _mm512_add_ps(frame0, step);
+        frame1 = _mm512_add_ps(frame1, step);
+    }
+    rampFrames<kAdd>(pDest, pSrc, startGain, gainDelta,
+            numVectorFrames, static_cast<int>(numFrames));
+}
+
+MIXXX_TARGET_AVX512 void applyRampingGainAvx512(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    rampAvx512<false>(pBuffer, pBuffer, startGain, gainDelta, numFrames);
+}
+
+MIXXX_TARGET_AVX512 void copyWithRampingGainAvx512(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    rampAvx512<false>(pDest, pSrc, startGain, gainDelta, numFrames);
+}
+
+MIXXX_TARGET_AVX512 void addWithRampingGainAvx512(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    rampAvx512<true>(pDest, pSrc, startGain, gainDelta, numFrames);
+}
+
+MIXXX_TARGET_AVX512 SampleUtil::CLIP_STATUS sumAbsPerChannelAvx512(CSAMPLE* pfAbsL,
+        CSAMPLE* pfAbsR,
+        const CSAMPLE* pBuffer,
+        SINT numFrames) {
+    const __m512 peak = _mm512_set1_ps(CSAMPLE_PEAK);
+    __m512 sum0 = _mm512_setzero_ps();
+    __m512 sum1 = _mm512_setzero_ps();
+    __mmask16 clipped = 0;
+    const SINT numVectorFrames = numFrames - numFrames % 16;
+    for (SINT i = 0; i < numVectorFrames; i += 16) {
+        const __m512 abs0 = _mm512_abs_ps(_mm512_loadu_ps(pBuffer + i * 2));
+        const __m512 abs1 = _mm512_abs_ps(_mm512_loadu_ps(pBuffer + i * 2 + 16));
+        sum0 = _mm512_add_ps(sum0, abs0);
+        sum1 = _mm512_add_ps(sum1, abs1);
+        clipped |= _mm512_cmp_ps_mask(abs0, peak, _CMP_GT_OQ) |
+                _mm512_cmp_ps_mask(abs1, peak, _CMP_GT_OQ);
+    }
+    // The even lanes hold the left channel, the odd lanes the right channel
+    float sums[16];
+    _mm512_storeu_ps(sums, _mm512_add_ps(sum0, sum1));
+    CSAMPLE absL = CSAMPLE_ZERO;
+    CSAMPLE absR = CSAMPLE_ZERO;
+    for (int lane = 0; lane < 16; lane += 2) {
+        absL += sums[lane];
+        absR += sums[lane + 1];
+    }
+    bool clippedL = (clipped & 0x5555) != 0;
+    bool clippedR = (clipped & 0xAAAA) != 0;
+    sumAbsFrames(pBuffer, numVectorFrames, numFrames,
+            &absL, &absR, &clippedL, &clippedR);
+    *pfAbsL = absL;
+    *pfAbsR = absR;
+    return clipStatus(clippedL, clippedR);
+}
+
+MIXXX_TARGET_AVX512 void copyClampBufferAvx512(
+        CSAMPLE* pDest, const CSAMPLE* pSrc, SINT numSamples) {
+    const __m512 peak = _mm512_set1_ps(CSAMPLE_PEAK);
+    const __m512 minusPeak = _mm512_set1_ps(-CSAMPLE_PEAK);
+    // _mm512_min_ps() and _mm512_max_ps() pass _mm512_undefined_ps() as
+    // the source of their masked out lanes, which GCC 12 reports as
+    // maybe-uninitialized. The zero-masked variants with all lanes
+    // enabled compile to the same instructions.
+    const __mmask16 allLanes = 0xFFFF;
+    const SINT numVectorSamples = numSamples - numSamples % 32;
+    for (SINT i = 0; i < numVectorSamples; i += 32) {
+        const __m512 in0 = _mm512_loadu_ps(pSrc + i);
+        const __m512 in1 = _mm512_loadu_ps(pSrc + i + 16);
+        _mm512_storeu_ps(pDest + i,
+                _mm512_maskz_max_ps(allLanes, minusPeak,
+                        _mm512_maskz_min_ps(allLanes, peak, in0)));
+        _mm512_storeu_ps(pDest + i + 16,
+                _mm512_maskz_max_ps(allLanes, minusPeak,
+                        _mm512_maskz_min_ps(allLanes, peak, in1)));
+    }
+    clampSamples(pDest, pSrc, numVectorSamples, numSamples);
+}
+
+MIXXX_TARGET_AVX512 void interleaveBufferAvx512(CSAMPLE* pDest,
+        const CSAMPLE* pSrc1,
+        const CSAMPLE* pSrc2,
+        SINT numFrames) {
+    // Indices 16 to 31 select from the second register
+    const __m512i lowIndices = _mm512_setr_epi32(
+            0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+    const __m512i highIndices = _mm512_setr_epi32(
+            8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+    const SINT numVectorFrames = numFrames - numFrames % 16;
+    for (SINT i = 0; i < numVectorFrames; i += 16) {
+        const __m512 src1 = _mm512_loadu_ps(pSrc1 + i);
+        const __m512 src2 = _mm512_loadu_ps(pSrc2 + i);
+        _mm512_storeu_ps(pDest + i * 2, _mm512_permutex2var_ps(src1, lowIndices, src2));
+        _mm512_storeu_ps(pDest + i * 2 + 16, _mm512_permutex2var_ps(src1, highIndices, src2));
+    }
+    interleaveFrames(pDest, pSrc1, pSrc2, numVectorFrames, numFrames);
+}
+
+MIXXX_TARGET_AVX512 void deinterleaveBufferAvx512(CSAMPLE* pDest1,
+        CSAMPLE* pDest2,
+        const CSAMPLE* pSrc,
+        SINT numFrames) {
+    const __m512i evenIndices = _mm512_setr_epi32(
+            0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+    const __m512i oddIndices = _mm512_setr_epi32(
+            1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+    const SINT numVectorFrames = numFrames - numFrames % 16;
+    for (SINT i = 0; i < numVectorFrames; i += 16) {
+        const __m512 in0 = _mm512_loadu_ps(pSrc + i * 2);
+        const __m512 in1 = _mm512_loadu_ps(pSrc + i * 2 + 16);
+        _mm512_storeu_ps(pDest1 + i, _mm512_permutex2var_ps(in0, evenIndices, in1));
+        _mm512_storeu_ps(pDest2 + i, _mm512_permutex2var_ps(in0, oddIndices, in1));
+    }
+    deinterleaveFrames(pDest1, pDest2, pSrc, numVectorFrames, numFrames);
+}
+
+MIXXX_TARGET_AVX512 void sumBuffersAvx512(CSAMPLE* pDest,
+        const CSAMPLE* const* ppSrc,
+        int numSrc,
+        SINT numSamples) {
+    const SINT numVectorSamples = numSamples - numSamples % 32;
+    for (SINT i = 0; i < numVectorSamples; i += 32) {
+        __m512 sum0 = _mm512_loadu_ps(ppSrc[0] + i);
+        __m512 sum1 = _mm512_loadu_ps(ppSrc[0] + i + 16);
+        for (int src = 1; src < numSrc; ++src) {
+            sum0 = _mm512_add_ps(sum0, _mm512_loadu_ps(ppSrc[src] + i));
+            sum1 = _mm512_add_ps(sum1, _mm512_loadu_ps(ppSrc[src] + i + 16));
+        }
+        _mm512_storeu_ps(pDest + i, sum0);
+        _mm512_storeu_ps(pDest + i + 16, sum1);
+    }
+    sumBuffersTail(pDest, ppSrc, numSrc, numVectorSamples, numSamples);
+}
+
+const SampleKernels kAvx512Kernels = {
+        "avx512",
+        applyRampingGainAvx512,
+        copyWithRampingGainAvx512,
+        addWithRampingGainAvx512,
+        sumAbsPerChannelAvx512,
+        copyClampBufferAvx512,
+        interleaveBufferAvx512,
+        deinterleaveBufferAvx512,
+        sumBuffersAvx512,
+};
+#endif // MIXXX_CPU_DISPATCH
+
+} // anonymous namespace
+
+// static
+const SampleKernels& SampleKernels::generic() {
+    return kGenericKernels;
+}
+
+// static
+QVector<const SampleKernels*> SampleKernels::available() {
+    QVector<const SampleKernels*> kernels;
+    kernels.append(&kGenericKernels);
+#ifdef MIXXX_CPU_SSE2
+    kernels.append(&kSse2Kernels);
+#endif
+#ifdef MIXXX_CPU_DISPATCH
+    if (CpuFeatures::hasAvx2()) {
+        kernels.append(&kAvx2Kernels);
+    }
+    if (CpuFeatures::hasAvx2() && CpuFeatures::hasAvx512()) {
+        kernels.append(&kAvx512Kernels);
+    }
+#endif
+    return kernels;
+}
+
+// static
+const SampleKernels& SampleKernels::selected() {
+    static const SampleKernels* const s_pSelected = available().last();
+    return *s_pSelected;
+}
+
+} // namespace mixxx
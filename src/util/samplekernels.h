@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QVector>
+
+#include "util/sample.h"
+#include "util/types.h"
+
+namespace mixxx {
+
+// The SampleUtil functions that have hand-written SIMD implementations. One
+// set of kernels exists for each instruction set level. SampleUtil uses the
+// widest set that the CPU supports, so builds for the SSE2 baseline still use
+// AVX2 or AVX-512 when available.
+//
+// The kernels expect that SampleUtil has already handled the trivial cases,
+// e.g. a constant gain. The ramping gain kernels apply startGain + gainDelta * i
+// to both samples of stereo frame i.
+struct SampleKernels {
+    // Used for test and benchmark output
+    const char* name;
+
+    void (*applyRampingGain)(CSAMPLE* pBuffer,
+            CSAMPLE_GAIN startGain,
+            CSAMPLE_GAIN gainDelta,
+            SINT numFrames);
+    void (*copyWithRampingGain)(CSAMPLE* pDest,
+            const CSAMPLE* pSrc,
+            CSAMPLE_GAIN startGain,
+            CSAMPLE_GAIN gainDelta,
+            SINT numFrames);
+    void (*addWithRampingGain)(CSAMPLE* pDest,
+            const CSAMPLE* pSrc,
+            CSAMPLE_GAIN startGain,
+            CSAMPLE_GAIN gainDelta,
+            SINT numFrames);
+    SampleUtil::CLIP_STATUS (*sumAbsPerChannel)(CSAMPLE* pfAbsL,
+            CSAMPLE* pfAbsR,
+            const CSAMPLE* pBuffer,
+            SINT numFrames);
+    // pDest and pSrc may be aliases
+    void (*copyClampBuffer)(CSAMPLE* pDest, const CSAMPLE* pSrc, SINT numSamples);
+    void (*interleaveBuffer)(CSAMPLE* pDest,
+            const CSAMPLE* pSrc1,
+            const CSAMPLE* pSrc2,
+            SINT numFrames);
+    void (*deinterleaveBuffer)(CSAMPLE* pDest1,
+            CSAMPLE* pDest2,
+            const CSAMPLE* pSrc,
+            SINT numFrames);
+    // numSrc must be at least 1
+    void (*sumBuffers)(CSAMPLE* pDest,
+            const CSAMPLE* const* ppSrc,
+            int numSrc,
+            SINT numSamples);
+
+    // The portable kernels that rely on auto-vectorization
+    static const SampleKernels& generic();
+
+    // All kernel sets that run on this CPU, ordered from the generic set to
+    // the widest instruction set
+    static QVector<const SampleKernels*> available();
+
+    // The widest available set, selected once on the first call
+    static const SampleKernels& selected();
+};
+
+} // namespace mixxx
@@ -0,0 +1,174 @@
+#ifndef SPMCRING_H
+#define SPMCRING_H
+
+#include <algorithm>
+#include <atomic>
+
+#include <QtGlobal>
+
+#include "util/class.h"
+#include "util/math.h"
+
+// A single-producer, multi-consumer ring buffer. The producer writes every
+// sample once and each consumer reads it in place through its own Reader, so
+// fanning out one stream to several consumers needs no extra copies.
+//
+// The producer never waits for consumers: it overwrites the oldest data.
+// A consumer that falls behind is overrun. This is detected when acquiring
+// data: if the unread data has been overwritten already, or would be after
+// the producer has written another headroom items, the reader skips ahead to
+// the newest data before the consumer reads any of it. The headroom is the
+// amount of data the producer may write while a consumer is busy with the
+// data it acquired. If the consumer is slower than that, releasing the data
+// reports that it may have been overwritten while it was used. Each Reader
+// counts its own overruns and the items it skipped.
+//
+// Positions are 64 bit sample counters that never wrap in practice.
+template <class DataType>
+class SpmcRing {
+  public:
+    class Reader {
+      public:
+        Reader()
+                : m_pos(0),
+                  m_overruns(0),
+                  m_skipped(0) {
+        }
+        quint64 overrunCount() const {
+            return m_overruns;
+        }
+        // The number of items that have been dropped unread.
+        quint64 skippedCount() const {
+            return m_skipped;
+        }
+
+      private:
+        friend class SpmcRing<DataType>;
+        quint64 m_pos;
+        quint64 m_overruns;
+        quint64 m_skipped;
+    };
+
+    // headroom must be less than the capacity.
+    explicit SpmcRing(int capacity, int headroom = 0)
+            : m_capacity(roundUpToPowerOf2(capacity)),
+              m_headroom(headroom),
+              m_mask(m_capacity - 1),
+              m_data(new DataType[m_capacity]),
+              m_writeReserve(0),
+              m_writePos(0) {
+        DEBUG_ASSERT(m_headroom >= 0 && m_headroom < m_capacity);
+    }
+    ~SpmcRing() {
+        delete [] m_data;
+    }
+
+    int capacity() const {
+        return m_capacity;
+    }
+
+    // Producer only. Writes all count items, overwriting the oldest data if
+    // necessary. count must not exceed the capacity.
+    void write(const DataType* pData, int count) {
+        DataType* dataPtr1;
+        int size1;
+        DataType* dataPtr2;
+        int size2;
+        acquireWriteRegions(count, &dataPtr1, &size1, &dataPtr2, &size2);
+        std::copy(pData, pData + size1, dataPtr1);
+        std::copy(pData + size1, pData + count, dataPtr2);
+        commitWrite(count);
+    }
+
+    // Producer only. Returns the up to two regions where the next count
+    // items are stored, so the producer can render into the ring directly.
+    // They are published to the consumers with commitWrite(). count must not
+    // exceed the capacity.
+    void acquireWriteRegions(int count,
+            DataType** dataPtr1, int* sizePtr1,
+            DataType** dataPtr2, int* sizePtr2) {
+        DEBUG_ASSERT(count <= m_capacity);
+        const quint64 pos = m_writePos.load(std::memory_order_relaxed);
+        // Announce the range that is about to be overwritten before touching
+        // the data, so consumers can tell if they raced with us.
+        m_writeReserve.store(pos + count, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        const int start = static_cast<int>(pos & m_mask);
+        *dataPtr1 = m_data + start;
+        *sizePtr1 = math_min(count, m_capacity - start);
+        *dataPtr2 = m_data;
+        *sizePtr2 = count - *sizePtr1;
+    }
+
+    // Producer only. Publishes the count items written to the regions
+    // returned by acquireWriteRegions().
+    void commitWrite(int count) {
+        const quint64 pos = m_writePos.load(std::memory_order_relaxed);
+        DEBUG_ASSERT(pos + count == m_writeReserve.load(std::memory_order_relaxed));
+        m_writePos.store(pos + count, std::memory_order_release);
+    }
+
+    // Returns a reader that starts with the next item written. Thread-safe.
+    Reader createReader() const {
+        Reader reader;
+        reader.m_pos = m_writePos.load(std::memory_order_acquire);
+        return reader;
+    }
+
+    // Consumer only. Returns the number of items available to pReader, which
+    // are stored in up to two regions. The regions stay valid until
+    // releaseReadRegions() is called, unless the reader is overrun.
+    int acquireReadRegions(Reader* pReader,
+            const DataType** dataPtr1, int* sizePtr1,
+            const DataType** dataPtr2, int* sizePtr2) const {
+        const quint64 writePos = m_writePos.load(std::memory_order_acquire);
+        const quint64 reserve = m_writeReserve.load(std::memory_order_relaxed);
+        if (reserve - pReader->m_pos > static_cast<quint64>(m_capacity - m_headroom)) {
+            // The oldest unread data is already overwritten or would be
+            // while the consumer is using it. Drop all of it to resume with
+            // fresh data.
+            ++pReader->m_overruns;
+            pReader->m_skipped += writePos - pReader->m_pos;
+            pReader->m_pos = writePos;
+        }
+        const int count = static_cast<int>(writePos - pReader->m_pos);
+        const int start = static_cast<int>(pReader->m_pos & m_mask);
+        *dataPtr1 = m_data + start;
+        *sizePtr1 = math_min(count, m_capacity - start);
+        *dataPtr2 = m_data;
+        *sizePtr2 = count - *sizePtr1;
+        return count;
+    }
+
+    // Consumer only. Marks count items as read. Returns false if they may have
+    // been overwritten while pReader was using them.
+    bool releaseReadRegions(Reader* pReader, int count) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const quint64 reserve = m_writeReserve.load(std::memory_order_relaxed);
+        const bool intact = reserve <= pReader->m_pos + m_capacity;
+        pReader->m_pos += count;
+        if (!intact) {
+            ++pReader->m_overruns;
+        }
+        return intact;
+    }
+
+    // The number of items written but not yet released by pReader.
+    quint64 readAvailable(const Reader& reader) const {
+        return m_writePos.load(std::memory_order_acquire) - reader.m_pos;
+    }
+
+  private:
+    const int m_capacity;
+    const int m_headroom;
+    const quint64 m_mask;
+    DataType* const m_data;
+    // End of the range the producer is currently writing.
+    std::atomic<quint64> m_writeReserve;
+    // End of the completely written data.
+    std::atomic<quint64> m_writePos;
+
+    DISALLOW_COPY_AND_ASSIGN(SpmcRing<DataType>);
+};
+
+#endif /* SPMCRING_H */
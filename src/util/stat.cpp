@@ -1,5 +1,8 @@
 #include <limits>
 
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QStringList>
 #include <QtDebug>
 
@@ -7,6 +10,76 @@
 #include "util/time.h"
 #include "util/math.h"
 #include "util/statsmanager.h"
+#include "util/assert.h"
+
+namespace {
+
+// Tags are never removed, so their IDs are indices into the list of names.
+class StatTagRegistry {
+  public:
+    int intern(const QString& name) {
+        QMutexLocker locker(&m_mutex);
+        return internLocked(name);
+    }
+
+    int internLiteral(const char* name) {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_literalIds.constFind(name);
+        if (it != m_literalIds.constEnd()) {
+            return it.value();
+        }
+        const int id = internLocked(QString(name));
+        m_literalIds.insert(name, id);
+        return id;
+    }
+
+    QString name(int id) {
+        QMutexLocker locker(&m_mutex);
+        return m_names.value(id);
+    }
+
+  private:
+    int internLocked(const QString& name) {
+        auto it = m_ids.constFind(name);
+        if (it != m_ids.constEnd()) {
+            return it.value();
+        }
+        const int id = m_names.size();
+        m_names.append(name);
+        m_ids.insert(name, id);
+        return id;
+    }
+
+    QMutex m_mutex;
+    QHash<QString, int> m_ids;
+    QHash<const char*, int> m_literalIds;
+    QVector<QString> m_names;
+};
+
+StatTagRegistry& statTagRegistry() {
+    static StatTagRegistry s_registry;
+    return s_registry;
+}
+
+} // anonymous namespace
+
+constexpr int StatTag::kInvalidId;
+
+StatTag::StatTag(const QString& name)
+        : m_id(statTagRegistry().intern(name)) {
+}
+
+// static
+StatTag StatTag::fromLiteral(const char* name) {
+    StatTag tag;
+    tag.m_id = statTagRegistry().internLiteral(name);
+    return tag;
+}
+
+// static
+QString StatTag::name(int id) {
+    return statTagRegistry().name(id);
+}
 
 Stat::Stat()
         : m_type(UNSPECIFIED),
@@ -137,19 +210,22 @@ QDebug operator<<(QDebug dbg, const Stat &stat) {
 }
 
 // static
-bool Stat::track(QString tag,
+bool Stat::track(const StatTag& tag,
                  Stat::StatType type,
                  Stat::ComputeFlags compute,
                  double value) {
     if (!StatsManager::s_bStatsManagerEnabled) {
         return false;
     }
+    VERIFY_OR_DEBUG_ASSERT(tag.isValid()) {
+        return false;
+    }
     StatReport report;
-    report.tag = std::move(tag);
+    report.tagId = tag.id();
     report.type = type;
     report.compute = compute;
     report.time = mixxx::Time::elapsed().toIntegerNanos();
     report.value = value;
     StatsManager* pManager = StatsManager::instance();
-    return pManager && pManager->maybeWriteReport(std::move(report));
+    return pManager && pManager->maybeWriteReport(report);
 }
@@ -8,6 +8,38 @@
 
 struct StatReport;
 
+// The tag of a stat, interned to an integer ID when the tag is constructed.
+// Reporting a stat by its ID neither allocates nor copies strings, so tags
+// should be constructed once, e.g. as static locals or members, and not for
+// every report.
+class StatTag {
+  public:
+    StatTag()
+            : m_id(kInvalidId) {
+    }
+    explicit StatTag(const QString& name);
+
+    // Interns a string literal by its address, which only converts the
+    // literal to a QString on the first call.
+    static StatTag fromLiteral(const char* name);
+
+    bool isValid() const {
+        return m_id != kInvalidId;
+    }
+    int id() const {
+        return m_id;
+    }
+    QString name() const {
+        return name(m_id);
+    }
+    static QString name(int id);
+
+  private:
+    static constexpr int kInvalidId = -1;
+
+    int m_id;
+};
+
 class Stat {
   public:
     enum StatType {
@@ -117,15 +149,19 @@ class Stat {
     double m_variance_sk;
     QMap<double, double> m_histogram;
 
-    static bool track(QString tag,
+    static bool track(const StatTag& tag,
                       Stat::StatType type,
                       Stat::ComputeFlags compute,
                       double value);
 
-    // Disallow to use this class with implicit converted char strings.
-    // This should not be uses to avoid unicode encoding and memory
-    // allocation at every call. Use a static tag like this:
-    // static const QString tag("TAG TEXT");
+    // Disallow to use this class with implicit converted strings.
+    // This should not be uses to avoid unicode encoding, memory
+    // allocation and interning at every call. Use a static tag like this:
+    // static const StatTag tag("TAG TEXT");
+    static bool track(const QString&,
+                      Stat::StatType,
+                      Stat::ComputeFlags,
+                      double) = delete;
     static bool track(const char *,
                       Stat::StatType,
                       Stat::ComputeFlags,
@@ -134,10 +170,12 @@ class Stat {
 
 QDebug operator<<(QDebug dbg, const Stat &stat);
 
+// POD with trivial ctor/dtor/copy for passing through the lock-free
+// StatsPipe of each thread
 struct StatReport {
-    QString tag;
-    qint64 time;
+    int tagId;
     Stat::StatType type;
     Stat::ComputeFlags compute;
+    qint64 time;
     double value;
 };
@@ -1,4 +1,5 @@
 #include <QtDebug>
+#include <QCoreApplication>
 #include <QMutexLocker>
 #include <QTextStream>
 #include <QFile>
@@ -15,8 +16,9 @@ const int kProcessLength = kStatsPipeSize * 4 / 5;
 // static
 bool StatsManager::s_bStatsManagerEnabled = false;
 
-StatsPipe::StatsPipe(StatsManager* pManager)
+StatsPipe::StatsPipe(StatsManager* pManager, int threadId)
         : m_pManager(pManager),
+          m_threadId(threadId),
           m_queue(kStatsPipeSize) {
     qRegisterMetaType<Stat>("Stat");
 }
@@ -36,6 +38,21 @@ StatsManager::StatsManager()
     start(QThread::LowPriority);
 }
 
+namespace {
+
+void debugStats(const QHash<int, Stat>& stats) {
+    QList<Stat> sortedStats = stats.values();
+    std::sort(sortedStats.begin(), sortedStats.end(),
+            [](const Stat& stat1, const Stat& stat2) {
+                return stat1.m_tag < stat2.m_tag;
+            });
+    for (const auto& stat : sortedStats) {
+        qDebug() << stat;
+    }
+}
+
+} // anonymous namespace
+
 StatsManager::~StatsManager() {
     s_bStatsManagerEnabled = false;
     m_quit = 1;
@@ -45,29 +62,20 @@ StatsManager::~StatsManager() {
     qDebug() << "=====================================";
     qDebug() << "ALL STATS";
     qDebug() << "=====================================";
-    for (auto it = m_stats.constBegin();
-         it != m_stats.constEnd(); ++it) {
-        qDebug() << it.value();
-    }
+    debugStats(m_stats);
 
     if (!m_baseStats.isEmpty()) {
         qDebug() << "=====================================";
         qDebug() << "BASE STATS";
         qDebug() << "=====================================";
-        for (auto it = m_baseStats.constBegin();
-             it != m_baseStats.constEnd(); ++it) {
-            qDebug() << it.value();
-        }
+        debugStats(m_baseStats);
     }
 
     if (!m_experimentStats.isEmpty()) {
         qDebug() << "=====================================";
         qDebug() << "EXPERIMENT STATS";
         qDebug() << "=====================================";
-        for (auto it = m_experimentStats.constBegin();
-             it != m_experimentStats.constEnd(); ++it) {
-            qDebug() << it.value();
-        }
+        debugStats(m_experimentStats);
     }
     qDebug() << "=====================================";
 
@@ -83,25 +91,35 @@ class OrderByTime {
     }
 };
 
-QString humanizeNanos(qint64 nanos) {
-    double seconds = static_cast<double>(nanos) / 1e9;
-    if (seconds > 1) {
-        return QString("%1s").arg(QString::number(seconds));
-    }
-
-    double millis = static_cast<double>(nanos) / 1e6;
-    if (millis > 1) {
-        return QString("%1ms").arg(QString::number(millis));
-    }
-
-    double micros = static_cast<double>(nanos) / 1e3;
-    if (micros > 1) {
-        return QString("%1us").arg(QString::number(micros));
+namespace {
+
+QString escapeJsonString(const QString& string) {
+    QString result;
+    result.reserve(string.size());
+    for (const QChar c : string) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (c.unicode() < 0x20) {
+            result += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+        } else {
+            result += c;
+        }
     }
+    return result;
+}
 
-    return QString("%1ns").arg(QString::number(nanos));
+// Trace event timestamps are in microseconds
+QString traceTimestamp(mixxx::Duration time) {
+    return QString::number(time.toIntegerNanos() / 1000.0, 'f', 3);
 }
 
+} // anonymous namespace
+
+// Writes the events in the Trace Event Format of Chrome, which can be
+// opened with chrome://tracing or https://ui.perfetto.dev. Events of a
+// tag become begin/end pairs or instant events and timers become complete
+// events, on the track of the thread that reported them.
 void StatsManager::writeTimeline(const QString& filename) {
     QFile timeline(filename);
     if (!timeline.open(QIODevice::WriteOnly | QIODevice::Text)) {
@@ -115,48 +133,77 @@ void StatsManager::writeTimeline(const QString& filename) {
         return;
     }
 
-    // Sort by time.
-    std::sort(m_events.begin(), m_events.end(), OrderByTime());
-
-    mixxx::Duration last_time = m_events[0].m_time;
+    // Sort by time, but keep the order of events that were reported at the
+    // same time, e.g. an end and the next start.
+    std::stable_sort(m_events.begin(), m_events.end(), OrderByTime());
 
-    QMap<QString, qint64> startTimes;
-    QMap<QString, qint64> endTimes;
+    const qint64 pid = QCoreApplication::applicationPid();
+    QHash<int, QString> tagNames;
 
     QTextStream out(&timeline);
-    foreach (const Event& event, m_events) {
-        qint64 last_start = startTimes.value(event.m_tag, -1);
-        qint64 last_end = endTimes.value(event.m_tag, -1);
+    out.setCodec("UTF-8");
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    for (int threadId = 0; threadId < m_threadNames.size(); ++threadId) {
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\""
+            << ",\"pid\":" << pid
+            << ",\"tid\":" << threadId
+            << ",\"args\":{\"name\":\""
+            << escapeJsonString(m_threadNames[threadId]) << "\"}},\n";
+    }
 
-        qint64 duration_since_last_start = last_start == -1 ? 0 :
-                event.m_time.toIntegerNanos() - last_start;
-        qint64 duration_since_last_end = last_end == -1 ? 0 :
-                event.m_time.toIntegerNanos() - last_end;
+    QHash<int, qint64> startTimes;
+    QHash<int, qint64> endTimes;
+    bool first = true;
+    for (const Event& event : m_events) {
+        auto tagName = tagNames.constFind(event.m_tagId);
+        if (tagName == tagNames.constEnd()) {
+            tagName = tagNames.insert(event.m_tagId,
+                    escapeJsonString(StatTag::name(event.m_tagId)));
+        }
 
         if (event.m_type == Stat::EVENT_START) {
             // We last saw a start and we just saw another start.
-            if (last_start > last_end) {
-                qDebug() << "Mismatched start/end pair" << event.m_tag;
+            if (startTimes.value(event.m_tagId, -1) >
+                    endTimes.value(event.m_tagId, -1)) {
+                qDebug() << "Mismatched start/end pair" << StatTag::name(event.m_tagId);
             }
-            startTimes[event.m_tag] = event.m_time.toIntegerNanos();
+            startTimes[event.m_tagId] = event.m_time.toIntegerNanos();
         } else if (event.m_type == Stat::EVENT_END) {
             // We last saw an end and we just saw another end.
-            if (last_end > last_start) {
-                qDebug() << "Mismatched start/end pair" << event.m_tag;
+            if (endTimes.value(event.m_tagId, -1) >
+                    startTimes.value(event.m_tagId, -1)) {
+                qDebug() << "Mismatched start/end pair" << StatTag::name(event.m_tagId);
             }
-            endTimes[event.m_tag] = event.m_time.toIntegerNanos();
+            endTimes[event.m_tagId] = event.m_time.toIntegerNanos();
         }
 
-        // TODO(rryan): CSV escaping
-        qint64 elapsed = (event.m_time - last_time).toIntegerNanos();
-        out << event.m_time.toIntegerNanos() << ","
-            << "+" << humanizeNanos(elapsed) << ","
-            << "+" << humanizeNanos(duration_since_last_start) << ","
-            << "+" << humanizeNanos(duration_since_last_end) << ","
-            << Stat::statTypeToString(event.m_type) << ","
-            << event.m_tag << "\n";
-        last_time = event.m_time;
+        if (!first) {
+            out << ",\n";
+        }
+        first = false;
+        out << "{\"name\":\"" << tagName.value() << "\""
+            << ",\"pid\":" << pid
+            << ",\"tid\":" << event.m_threadId;
+        switch (event.m_type) {
+        case Stat::EVENT_START:
+            out << ",\"ph\":\"B\",\"ts\":" << traceTimestamp(event.m_time);
+            break;
+        case Stat::EVENT_END:
+            out << ",\"ph\":\"E\",\"ts\":" << traceTimestamp(event.m_time);
+            break;
+        case Stat::DURATION_NANOSEC:
+            out << ",\"ph\":\"X\",\"ts\":"
+                << traceTimestamp(event.m_time - event.m_duration)
+                << ",\"dur\":" << traceTimestamp(event.m_duration);
+            break;
+        default:
+            out << ",\"ph\":\"i\",\"s\":\"t\",\"ts\":"
+                << traceTimestamp(event.m_time);
+            break;
+        }
+        out << "}";
     }
+    out << "\n]}\n";
 
     timeline.close();
 }
@@ -171,19 +218,25 @@ StatsPipe* StatsManager::getStatsPipeForThread() {
     if (m_threadStatsPipes.hasLocalData()) {
         return m_threadStatsPipes.localData();
     }
-    StatsPipe* pResult = new StatsPipe(this);
-    m_threadStatsPipes.setLocalData(pResult);
+    QString threadName = QThread::currentThread()->objectName();
     QMutexLocker locker(&m_statsPipeLock);
+    const int threadId = m_threadNames.size();
+    if (threadName.isEmpty()) {
+        threadName = QString("Thread %1").arg(threadId);
+    }
+    m_threadNames.append(threadName);
+    StatsPipe* pResult = new StatsPipe(this, threadId);
+    m_threadStatsPipes.setLocalData(pResult);
     m_statsPipes.push_back(pResult);
     return pResult;
 }
 
-bool StatsManager::maybeWriteReport(StatReport report) {
+bool StatsManager::maybeWriteReport(const StatReport& report) {
     StatsPipe* pStatsPipe = getStatsPipeForThread();
     if (!pStatsPipe) {
         return false;
     }
-    bool success = pStatsPipe->enqueue(std::move(report));
+    bool success = pStatsPipe->enqueue(report);
     if (pStatsPipe->remainingCapacity() < kProcessLength) {
         m_statsPipeCondition.wakeAll();
     }
@@ -200,39 +253,51 @@ void StatsManager::processIncomingStatReports() {
     StatReport report;
     foreach (StatsPipe* pStatsPipe, m_statsPipes) {
         while (pStatsPipe->dequeue(&report)) {
-            QString tag = report.tag;
-            Stat& info = m_stats[tag];
-            info.m_tag = tag;
-            info.m_type = report.type;
-            info.m_compute = report.compute;
-            info.processReport(report);
-            emit(statUpdated(info));
-
-            if (report.compute & Stat::STATS_EXPERIMENT) {
-                Stat& experiment = m_experimentStats[tag];
-                experiment.m_tag = tag;
-                experiment.m_type = report.type;
-                experiment.m_compute = report.compute;
-                experiment.processReport(report);
-            } else if (report.compute & Stat::STATS_BASE) {
-                Stat& base = m_baseStats[tag];
-                base.m_tag = tag;
-                base.m_type = report.type;
-                base.m_compute = report.compute;
-                base.processReport(report);
-            }
+            processReport(report, pStatsPipe->threadId());
+        }
+    }
+}
 
-            if (CmdlineArgs::Instance().getTimelineEnabled() &&
-                    (report.type == Stat::EVENT ||
-                     report.type == Stat::EVENT_START ||
-                     report.type == Stat::EVENT_END)) {
-                Event event;
-                event.m_tag = tag;
-                event.m_type = report.type;
-                event.m_time = mixxx::Duration::fromNanos(report.time);
-                m_events.append(event);
-            }
+void StatsManager::processReport(const StatReport& report, int threadId) {
+    Stat& info = m_stats[report.tagId];
+    if (info.m_tag.isNull()) {
+        // The name is only looked up once for each tag
+        info.m_tag = StatTag::name(report.tagId);
+    }
+    info.m_type = report.type;
+    info.m_compute = report.compute;
+    info.processReport(report);
+    emit(statUpdated(info));
+
+    if (report.compute & Stat::STATS_EXPERIMENT) {
+        Stat& experiment = m_experimentStats[report.tagId];
+        experiment.m_tag = info.m_tag;
+        experiment.m_type = report.type;
+        experiment.m_compute = report.compute;
+        experiment.processReport(report);
+    } else if (report.compute & Stat::STATS_BASE) {
+        Stat& base = m_baseStats[report.tagId];
+        base.m_tag = info.m_tag;
+        base.m_type = report.type;
+        base.m_compute = report.compute;
+        base.processReport(report);
+    }
+
+    if (CmdlineArgs::Instance().getTimelineEnabled() &&
+            (report.type == Stat::EVENT ||
+             report.type == Stat::EVENT_START ||
+             report.type == Stat::EVENT_END ||
+             report.type == Stat::DURATION_NANOSEC)) {
+        Event event;
+        event.m_tagId = report.tagId;
+        event.m_threadId = threadId;
+        event.m_type = report.type;
+        event.m_time = mixxx::Duration::fromNanos(report.time);
+        if (report.type == Stat::DURATION_NANOSEC) {
+            event.m_duration = mixxx::Duration::fromNanos(
+                    static_cast<qint64>(report.value));
         }
+        m_events.append(event);
     }
 }
 
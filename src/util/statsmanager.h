@@ -1,6 +1,6 @@
 #pragma once
 
-#include <QMap>
+#include <QHash>
 #include <QObject>
 #include <QString>
 #include <QThread>
@@ -10,6 +10,7 @@
 #include <QWaitCondition>
 #include <QThreadStorage>
 #include <QList>
+#include <QVector>
 
 #include "rigtorp/SPSCQueue.h"
 
@@ -21,11 +22,17 @@ class StatsManager;
 
 class StatsPipe final {
   public:
-    explicit StatsPipe(StatsManager* pManager);
+    StatsPipe(StatsManager* pManager, int threadId);
     ~StatsPipe();
 
-    bool enqueue(StatReport report) {
-        return m_queue.try_emplace(std::move(report));
+    // The index of the thread that reports to this pipe, in the order in
+    // which the threads reported their first stat
+    int threadId() const {
+        return m_threadId;
+    }
+
+    bool enqueue(const StatReport& report) {
+        return m_queue.try_push(report);
     }
 
     bool dequeue(StatReport* pReport) {
@@ -44,6 +51,7 @@ class StatsPipe final {
 
   private:
     StatsManager* m_pManager;
+    const int m_threadId;
     rigtorp::SPSCQueue<StatReport> m_queue;
 };
 
@@ -54,7 +62,7 @@ class StatsManager : public QThread, public Singleton<StatsManager> {
     virtual ~StatsManager();
 
     // Returns true if write succeeds.
-    bool maybeWriteReport(StatReport report);
+    bool maybeWriteReport(const StatReport& report);
 
     static bool s_bStatsManagerEnabled;
 
@@ -77,14 +85,18 @@ class StatsManager : public QThread, public Singleton<StatsManager> {
     void processIncomingStatReports();
     StatsPipe* getStatsPipeForThread();
     void onStatsPipeDestroyed(StatsPipe* pPipe);
+    void processReport(const StatReport& report, int threadId);
     void writeTimeline(const QString& filename);
 
     QAtomicInt m_emitAllStats;
     QAtomicInt m_quit;
-    QMap<QString, Stat> m_stats;
-    QMap<QString, Stat> m_baseStats;
-    QMap<QString, Stat> m_experimentStats;
-    QList<Event> m_events;
+    // Keyed by the ID of the StatTag
+    QHash<int, Stat> m_stats;
+    QHash<int, Stat> m_baseStats;
+    QHash<int, Stat> m_experimentStats;
+    QVector<Event> m_events;
+    // Indexed by the thread ID of the StatsPipe
+    QVector<QString> m_threadNames;
 
     QWaitCondition m_statsPipeCondition;
     QMutex m_statsPipeLock;
@@ -5,7 +5,11 @@
 #include "waveform/guitick.h"
 
 Timer::Timer(const QString& key, Stat::ComputeFlags compute)
-        : m_key(key),
+        : Timer(StatTag(key), compute) {
+}
+
+Timer::Timer(const StatTag& tag, Stat::ComputeFlags compute)
+        : m_tag(tag),
           m_compute(Stat::experimentFlags(compute)),
           m_running(false) {
 }
@@ -22,7 +26,7 @@ mixxx::Duration Timer::restart(bool report) {
             // Ignore the report if it crosses the experiment boundary.
             Experiment::Mode oldMode = Stat::modeFromFlags(m_compute);
             if (oldMode == Experiment::mode()) {
-                Stat::track(m_key, Stat::DURATION_NANOSEC, m_compute,
+                Stat::track(m_tag, Stat::DURATION_NANOSEC, m_compute,
                             elapsed.toIntegerNanos());
             }
         }
@@ -39,7 +43,7 @@ mixxx::Duration Timer::elapsed(bool report) {
         // Ignore the report if it crosses the experiment boundary.
         Experiment::Mode oldMode = Stat::modeFromFlags(m_compute);
         if (oldMode == Experiment::mode()) {
-            Stat::track(m_key, Stat::DURATION_NANOSEC, m_compute,
+            Stat::track(m_tag, Stat::DURATION_NANOSEC, m_compute,
                         elapsedTime.toIntegerNanos());
         }
     }
@@ -52,6 +56,11 @@ SuspendableTimer::SuspendableTimer(const QString& key,
         : Timer(key, compute) {
 }
 
+SuspendableTimer::SuspendableTimer(const StatTag& tag,
+                                   Stat::ComputeFlags compute)
+        : Timer(tag, compute) {
+}
+
 void SuspendableTimer::start() {
     m_leapTime = mixxx::Duration::fromSeconds(0);
     Timer::start();
@@ -73,7 +82,7 @@ mixxx::Duration SuspendableTimer::elapsed(bool report) {
         // Ignore the report if it crosses the experiment boundary.
         Experiment::Mode oldMode = Stat::modeFromFlags(m_compute);
         if (oldMode == Experiment::mode()) {
-            Stat::track(m_key, Stat::DURATION_NANOSEC, m_compute,
+            Stat::track(m_tag, Stat::DURATION_NANOSEC, m_compute,
                         m_leapTime.toIntegerNanos());
         }
     }
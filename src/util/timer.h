@@ -20,6 +20,8 @@ class Timer {
   public:
     Timer(const QString& key,
           Stat::ComputeFlags compute = kDefaultComputeFlags);
+    Timer(const StatTag& tag,
+          Stat::ComputeFlags compute = kDefaultComputeFlags);
     void start();
 
     // Restart the timer returning the time duration since it was last
@@ -32,7 +34,7 @@ class Timer {
     mixxx::Duration elapsed(bool report);
 
   protected:
-    QString m_key;
+    StatTag m_tag;
     Stat::ComputeFlags m_compute;
     bool m_running;
     PerformanceTimer m_time;
@@ -42,6 +44,8 @@ class SuspendableTimer : public Timer {
   public:
     SuspendableTimer(const QString& key,
             Stat::ComputeFlags compute = kDefaultComputeFlags);
+    SuspendableTimer(const StatTag& tag,
+            Stat::ComputeFlags compute = kDefaultComputeFlags);
     void start();
     mixxx::Duration suspend();
     void go();
@@ -51,8 +55,20 @@ class SuspendableTimer : public Timer {
     mixxx::Duration m_leapTime;
 };
 
+// Only times in developer mode. Use the constructor with a StatTag that has
+// been interned up front in the audio callback. The others have to look up
+// or intern the key, which takes the lock of the tag registry.
 class ScopedTimer {
   public:
+    ScopedTimer(const StatTag& tag,
+                Stat::ComputeFlags compute = kDefaultComputeFlags)
+            : m_pTimer(NULL),
+              m_cancel(false) {
+        if (CmdlineArgs::Instance().getDeveloper()) {
+            initialize(tag, compute);
+        }
+    }
+
     ScopedTimer(const char* key, int i,
                 Stat::ComputeFlags compute = kDefaultComputeFlags)
             : m_pTimer(NULL),
@@ -67,7 +83,11 @@ class ScopedTimer {
             : m_pTimer(NULL),
               m_cancel(false) {
         if (CmdlineArgs::Instance().getDeveloper()) {
-            initialize(QString(key), arg ? QString(arg) : QString(), compute);
+            if (arg) {
+                initialize(QString(key), QString(arg), compute);
+            } else {
+                initialize(StatTag::fromLiteral(key), compute);
+            }
         }
     }
 
@@ -97,7 +117,12 @@ class ScopedTimer {
         } else {
             strKey = key.arg(arg);
         }
-        m_pTimer = new(m_timerMem) Timer(strKey, compute);
+        initialize(StatTag(strKey), compute);
+    }
+
+    inline void initialize(const StatTag& tag,
+                Stat::ComputeFlags compute = kDefaultComputeFlags) {
+        m_pTimer = new(m_timerMem) Timer(tag, compute);
         m_pTimer->start();
     }
 
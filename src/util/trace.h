@@ -10,8 +10,46 @@
 #include "util/performancetimer.h"
 #include "util/stat.h"
 
+// The tags of a Trace. Traces in the audio callback take tags that have been
+// interned up front, the other constructors of Trace intern their tags every
+// time.
+class TraceTag {
+  public:
+    TraceTag() {
+    }
+    explicit TraceTag(const QString& name)
+            : m_name(name),
+              m_tag(name),
+              m_durationTag(name + "_duration") {
+    }
+
+    const QString& name() const {
+        return m_name;
+    }
+    const StatTag& tag() const {
+        return m_tag;
+    }
+    const StatTag& durationTag() const {
+        return m_durationTag;
+    }
+
+  private:
+    QString m_name;
+    StatTag m_tag;
+    StatTag m_durationTag;
+};
+
 class Trace {
   public:
+    explicit Trace(const TraceTag& tag,
+          bool writeToStdout=false, bool time=true)
+            : m_writeToStdout(writeToStdout),
+              m_time(time) {
+        if (writeToStdout || CmdlineArgs::Instance().getDeveloper()) {
+            initialize(tag);
+        }
+    }
+
     Trace(const char* tag, const char* arg=NULL,
           bool writeToStdout=false, bool time=true)
             : m_writeToStdout(writeToStdout),
@@ -45,8 +83,6 @@ class Trace {
             return;
         }
 
-        Event::end(m_tag);
-
         if (m_time) {
             mixxx::Duration elapsed = m_timer.elapsed();
             if (m_writeToStdout) {
@@ -59,7 +95,7 @@ class Trace {
             // event for the same tag that has an EVENT_START/EVENT_END is a
             // duration instead of changing the tag.
             Stat::track(
-                m_tag + "_duration",
+                m_durationTag,
                 Stat::DURATION_NANOSEC,
                 Stat::COUNT | Stat::AVERAGE | Stat::SAMPLE_VARIANCE |
                 Stat::MAX | Stat::MIN,
@@ -67,17 +103,31 @@ class Trace {
         } else if (m_writeToStdout) {
             qDebug() << "END [" << m_tag << "]";
         }
+
+        // Ended after the duration, so the duration nests within the start
+        // and end event in the timeline.
+        Event::end(m_statTag);
     }
 
   private:
     void initialize(const QString& key, const QString& arg) {
         if (arg.isEmpty()) {
-            m_tag = key;
+            initialize(TraceTag(key));
         } else {
-            m_tag = key.arg(arg);
+            initialize(TraceTag(key.arg(arg)));
+        }
+    }
+
+    void initialize(const TraceTag& tag) {
+        if (!tag.tag().isValid()) {
+            return;
         }
+        // Shares the string without allocating
+        m_tag = tag.name();
+        m_statTag = tag.tag();
+        m_durationTag = tag.durationTag();
 
-        Event::start(m_tag);
+        Event::start(m_statTag);
         if (m_time) {
             m_timer.start();
         }
@@ -87,6 +137,8 @@ class Trace {
     }
 
     QString m_tag;
+    StatTag m_statTag;
+    StatTag m_durationTag;
     const bool m_writeToStdout, m_time;
     PerformanceTimer m_timer;
 
@@ -0,0 +1,123 @@
+#include "util/wakesemaphore.h"
+
+#if defined(Q_OS_LINUX)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(Q_OS_MAC)
+#include <dispatch/dispatch.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#include <climits>
+#else
+#include <errno.h>
+#endif
+
+#include "util/assert.h"
+
+#if defined(Q_OS_LINUX)
+
+namespace {
+
+// The futex operates on the value of the atomic
+static_assert(sizeof(std::atomic<int>) == sizeof(int),
+        "std::atomic<int> must have the size of int");
+
+int* futexAddress(std::atomic<int>* pCount) {
+    return reinterpret_cast<int*>(pCount);
+}
+
+} // anonymous namespace
+
+WakeSemaphore::WakeSemaphore()
+        : m_count(0) {
+}
+
+WakeSemaphore::~WakeSemaphore() {
+}
+
+void WakeSemaphore::release() {
+    m_count.fetch_add(1, std::memory_order_release);
+    syscall(SYS_futex, futexAddress(&m_count), FUTEX_WAKE_PRIVATE, 1,
+            nullptr, nullptr, 0);
+}
+
+void WakeSemaphore::acquire() {
+    int count = m_count.load(std::memory_order_relaxed);
+    while (true) {
+        if (count > 0) {
+            if (m_count.compare_exchange_weak(count, count - 1,
+                        std::memory_order_acquire, std::memory_order_relaxed)) {
+                return;
+            }
+            continue;
+        }
+        // Only sleeps if the count is still 0, so a release in between
+        // is not missed. Returns early on signals and spurious wakeups.
+        syscall(SYS_futex, futexAddress(&m_count), FUTEX_WAIT_PRIVATE, 0,
+                nullptr, nullptr, 0);
+        count = m_count.load(std::memory_order_relaxed);
+    }
+}
+
+#elif defined(Q_OS_MAC)
+
+WakeSemaphore::WakeSemaphore()
+        : m_pSemaphore(dispatch_semaphore_create(0)) {
+    DEBUG_ASSERT(m_pSemaphore);
+}
+
+WakeSemaphore::~WakeSemaphore() {
+    dispatch_release(static_cast<dispatch_semaphore_t>(m_pSemaphore));
+}
+
+void WakeSemaphore::release() {
+    dispatch_semaphore_signal(static_cast<dispatch_semaphore_t>(m_pSemaphore));
+}
+
+void WakeSemaphore::acquire() {
+    dispatch_semaphore_wait(static_cast<dispatch_semaphore_t>(m_pSemaphore),
+            DISPATCH_TIME_FOREVER);
+}
+
+#elif defined(Q_OS_WIN)
+
+WakeSemaphore::WakeSemaphore()
+        : m_pSemaphore(CreateSemaphore(nullptr, 0, LONG_MAX, nullptr)) {
+    DEBUG_ASSERT(m_pSemaphore);
+}
+
+WakeSemaphore::~WakeSemaphore() {
+    CloseHandle(m_pSemaphore);
+}
+
+void WakeSemaphore::release() {
+    ReleaseSemaphore(m_pSemaphore, 1, nullptr);
+}
+
+void WakeSemaphore::acquire() {
+    WaitForSingleObject(m_pSemaphore, INFINITE);
+}
+
+#else
+
+WakeSemaphore::WakeSemaphore() {
+    const int result = sem_init(&m_semaphore, 0, 0);
+    Q_UNUSED(result); // only used in DEBUG_ASSERT
+    DEBUG_ASSERT(result == 0);
+}
+
+WakeSemaphore::~WakeSemaphore() {
+    sem_destroy(&m_semaphore);
+}
+
+void WakeSemaphore::release() {
+    sem_post(&m_semaphore);
+}
+
+void WakeSemaphore::acquire() {
+    while (sem_wait(&m_semaphore) != 0 && errno == EINTR) {
+    }
+}
+
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QtGlobal>
+
+#if defined(Q_OS_LINUX)
+#include <atomic>
+#elif !defined(Q_OS_MAC) && !defined(Q_OS_WIN)
+#include <semaphore.h>
+#endif
+
+#include "util/class.h"
+
+// A counting semaphore that the engine thread may release. Unlike
+// QSemaphore, which locks a QMutex, release() never locks a mutex in user
+// space: It is a futex on Linux, a dispatch semaphore on macOS, a kernel
+// semaphore on Windows and a POSIX semaphore elsewhere. Releasing still
+// costs a system call on Linux and Windows, and on macOS if a thread is
+// waiting.
+class WakeSemaphore final {
+  public:
+    WakeSemaphore();
+    ~WakeSemaphore();
+
+    // Realtime safe
+    void release();
+    // Blocks until the semaphore has been released
+    void acquire();
+
+  private:
+#if defined(Q_OS_LINUX)
+    std::atomic<int> m_count;
+#elif defined(Q_OS_MAC) || defined(Q_OS_WIN)
+    // dispatch_semaphore_t or HANDLE
+    void* m_pSemaphore;
+#else
+    sem_t m_semaphore;
+#endif
+
+    DISALLOW_COPY_AND_ASSIGN(WakeSemaphore);
+};
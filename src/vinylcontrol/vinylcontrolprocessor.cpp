@@ -14,6 +14,13 @@
 #define SIGNAL_QUALITY_FIFO_SIZE 256
 #define SAMPLE_PIPE_FIFO_SIZE 65536
 
+namespace {
+
+// Interned up front, because buffers are received in the audio callback
+const StatTag kReceiveBufferTimerTag("VinylControlProcessor::receiveBuffer");
+
+} // anonymous namespace
+
 VinylControlProcessor::VinylControlProcessor(QObject* pParent, UserSettingsPointer pConfig)
         : QThread(pParent),
           m_pConfig(pConfig),
@@ -206,7 +213,7 @@ bool VinylControlProcessor::deckConfigured(int index) const {
 void VinylControlProcessor::receiveBuffer(AudioInput input,
                                           const CSAMPLE* pBuffer,
                                           unsigned int nFrames) {
-    ScopedTimer t("VinylControlProcessor::receiveBuffer");
+    ScopedTimer t(kReceiveBufferTimerTag);
     if (input.getType() != AudioInput::VINYLCONTROL) {
         qDebug() << "WARNING: AudioInput type is not VINYLCONTROL. Ignoring incoming buffer.";
         return;
@@ -2,6 +2,7 @@
 
 #include "waveform/guitick.h"
 #include "control/controlobject.h"
+#include "widget/controlwidgetupdatequeue.h"
 
 GuiTick::GuiTick() {
     m_pCOGuiTickTime = std::make_unique<ControlObject>(ConfigKey("[Master]", "guiTickTime"));
@@ -12,6 +13,10 @@ GuiTick::GuiTick() {
 // this is called from WaveformWidgetFactory::render in the main thread with the
 // configured waveform frame rate
 void GuiTick::process() {
+    // Push the latest values of controls that have been changed by other
+    // threads to the widgets
+    ControlWidgetUpdateQueue::instance()->drain();
+
     m_cpuTimeLastTick += m_cpuTimer.restart();
     double cpuTimeLastTickSeconds = m_cpuTimeLastTick.toDoubleSeconds();
     m_pCOGuiTickTime->set(cpuTimeLastTickSeconds);
@@ -1,6 +1,7 @@
 #include <QStyle>
 #include "widget/controlwidgetconnection.h"
 
+#include "widget/controlwidgetupdatequeue.h"
 #include "widget/wbasewidget.h"
 #include "control/controlproxy.h"
 #include "util/debug.h"
@@ -14,7 +15,26 @@ ControlWidgetConnection::ControlWidgetConnection(
         : m_pWidget(pBaseWidget),
           m_pValueTransformer(pTransformer) {
     m_pControl = new ControlProxy(key, this);
-    m_pControl->connectValueChanged(this, &ControlWidgetConnection::slotControlValueChanged);
+    ControlWidgetUpdateQueue* pQueue = ControlWidgetUpdateQueue::instance();
+    m_updateSlot = pQueue->registerConnection(this);
+    if (m_updateSlot == ControlWidgetUpdateQueue::kInvalidSlot) {
+        m_pControl->connectValueChanged(this, &ControlWidgetConnection::slotControlValueChanged);
+        return;
+    }
+    // Changes from other threads are coalesced and delivered with the next
+    // GUI tick. The functor must not touch this object, which might be
+    // deleted while another thread is delivering a change.
+    const int slot = m_updateSlot;
+    m_pControl->connectValueChangedUnqueued(this,
+            [pQueue, slot](double value) {
+                pQueue->valueChanged(slot, value);
+            });
+}
+
+ControlWidgetConnection::~ControlWidgetConnection() {
+    if (m_updateSlot != ControlWidgetUpdateQueue::kInvalidSlot) {
+        ControlWidgetUpdateQueue::instance()->unregisterConnection(m_updateSlot);
+    }
 }
 
 void ControlWidgetConnection::setControlParameter(double parameter) {
@@ -19,6 +19,7 @@ class ControlWidgetConnection : public QObject {
     ControlWidgetConnection(WBaseWidget* pBaseWidget,
                             const ConfigKey& key,
                             ValueTransformer* pTransformer);
+    ~ControlWidgetConnection() override;
 
     double getControlParameter() const;
     double getControlParameterForValue(double value) const;
@@ -34,6 +35,10 @@ class ControlWidgetConnection : public QObject {
 
   protected:
     void setControlParameter(double parameter);
+    // Pushes the current value of the control to the widget
+    void updateFromControl() {
+        slotControlValueChanged(m_pControl->get());
+    }
 
     WBaseWidget* m_pWidget;
 
@@ -43,7 +48,11 @@ class ControlWidgetConnection : public QObject {
     ControlProxy* m_pControl;
 
   private:
+    friend class ControlWidgetUpdateQueue;
+
     QScopedPointer<ValueTransformer> m_pValueTransformer;
+    // Slot in the ControlWidgetUpdateQueue
+    int m_updateSlot;
 };
 
 class ControlParameterWidgetConnection final : public ControlWidgetConnection {
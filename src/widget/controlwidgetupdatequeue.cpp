@@ -0,0 +1,103 @@
+#include "widget/controlwidgetupdatequeue.h"
+
+#include "util/assert.h"
+#include "util/counter.h"
+#include "widget/controlwidgetconnection.h"
+
+constexpr int ControlWidgetUpdateQueue::kInvalidSlot;
+constexpr int ControlWidgetUpdateQueue::kEndOfStack;
+constexpr int ControlWidgetUpdateQueue::kChunkSize;
+constexpr int ControlWidgetUpdateQueue::kMaxChunks;
+
+// static
+ControlWidgetUpdateQueue* ControlWidgetUpdateQueue::instance() {
+    static ControlWidgetUpdateQueue* s_pInstance = new ControlWidgetUpdateQueue();
+    return s_pInstance;
+}
+
+ControlWidgetUpdateQueue::ControlWidgetUpdateQueue()
+        : m_guiThreadId(QThread::currentThreadId()),
+          m_allocatedSlots(0),
+          m_dirtyStackTop(kEndOfStack) {
+    for (int i = 0; i < kMaxChunks; ++i) {
+        m_chunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+int ControlWidgetUpdateQueue::registerConnection(
+        ControlWidgetConnection* pConnection) {
+    DEBUG_ASSERT(QThread::currentThreadId() == m_guiThreadId);
+    int slot;
+    if (!m_freeSlots.isEmpty()) {
+        slot = m_freeSlots.takeLast();
+    } else {
+        if (m_allocatedSlots >= kMaxChunks * kChunkSize) {
+            return kInvalidSlot;
+        }
+        slot = m_allocatedSlots++;
+        const int chunk = slot / kChunkSize;
+        if (!m_chunks[chunk].load(std::memory_order_relaxed)) {
+            Slot* pSlots = new Slot[kChunkSize];
+            for (int i = 0; i < kChunkSize; ++i) {
+                pSlots[i].dirty.store(false, std::memory_order_relaxed);
+                pSlots[i].next.store(kEndOfStack, std::memory_order_relaxed);
+                pSlots[i].pConnection = nullptr;
+            }
+            m_chunks[chunk].store(pSlots, std::memory_order_release);
+        }
+    }
+    // A previous owner of this slot might still be on the dirty stack.
+    // This only causes a spurious update of the new owner.
+    slotAt(slot).pConnection = pConnection;
+    return slot;
+}
+
+void ControlWidgetUpdateQueue::unregisterConnection(int slot) {
+    DEBUG_ASSERT(QThread::currentThreadId() == m_guiThreadId);
+    VERIFY_OR_DEBUG_ASSERT(slot >= 0 && slot < m_allocatedSlots) {
+        return;
+    }
+    slotAt(slot).pConnection = nullptr;
+    m_freeSlots.append(slot);
+}
+
+void ControlWidgetUpdateQueue::valueChanged(int slot, double value) {
+    Slot& entry = slotAt(slot);
+    if (QThread::currentThreadId() == m_guiThreadId) {
+        if (entry.pConnection) {
+            entry.pConnection->slotControlValueChanged(value);
+        }
+        return;
+    }
+    if (entry.dirty.exchange(true, std::memory_order_acq_rel)) {
+        // Already on the stack, the GUI will pick up the latest value
+        return;
+    }
+    int top = m_dirtyStackTop.load(std::memory_order_relaxed);
+    do {
+        entry.next.store(top, std::memory_order_relaxed);
+    } while (!m_dirtyStackTop.compare_exchange_weak(
+            top, slot, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void ControlWidgetUpdateQueue::drain() {
+    DEBUG_ASSERT(QThread::currentThreadId() == m_guiThreadId);
+    // Taking the whole stack at once is not affected by the ABA problem
+    int slot = m_dirtyStackTop.exchange(kEndOfStack, std::memory_order_acquire);
+    int updates = 0;
+    while (slot != kEndOfStack) {
+        Slot& entry = slotAt(slot);
+        // Read the link before clearing the flag. Afterwards the slot
+        // may be pushed again by another thread.
+        const int next = entry.next.load(std::memory_order_relaxed);
+        entry.dirty.store(false, std::memory_order_release);
+        if (entry.pConnection) {
+            entry.pConnection->updateFromControl();
+            ++updates;
+        }
+        slot = next;
+    }
+    if (updates > 0) {
+        Counter("ControlWidgetUpdateQueue updates").increment(updates);
+    }
+}
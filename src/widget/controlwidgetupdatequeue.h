@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+
+#include <QThread>
+#include <QVector>
+
+class ControlWidgetConnection;
+
+// ControlWidgetUpdateQueue coalesces control changes from non-GUI threads
+// into at most one widget update per connection and GUI tick.
+//
+// Controls that are driven by the engine (playposition, VU meters, rate,
+// beat_active, ...) change with every audio callback. Delivering each change
+// through a queued signal posts one event per change and connection to the
+// GUI event loop. Instead, the thread that changes a control only marks the
+// connection as dirty by pushing it onto a lock-free stack. The GUI thread
+// drains the stack once per GUI tick and pushes the latest value of each
+// control to its widgets.
+//
+// Changes made on the GUI thread are delivered immediately as before.
+class ControlWidgetUpdateQueue final {
+  public:
+    static constexpr int kInvalidSlot = -1;
+
+    // Creates the queue on first use. Must be called from the GUI thread.
+    // The queue is never destroyed, because other threads may still mark
+    // connections while Mixxx shuts down.
+    static ControlWidgetUpdateQueue* instance();
+
+    // Returns a slot for pConnection, or kInvalidSlot if all slots are in
+    // use. GUI thread only.
+    int registerConnection(ControlWidgetConnection* pConnection);
+    void unregisterConnection(int slot);
+
+    // Called by the thread that changed the control. Realtime safe unless
+    // called from the GUI thread, which delivers the value immediately.
+    void valueChanged(int slot, double value);
+
+    // Updates all connections that have been marked since the last call.
+    // GUI thread only.
+    void drain();
+
+  private:
+    static constexpr int kEndOfStack = -1;
+    static constexpr int kChunkSize = 1024;
+    static constexpr int kMaxChunks = 64;
+
+    struct Slot {
+        std::atomic<bool> dirty;
+        std::atomic<int> next;
+        // Only accessed by the GUI thread
+        ControlWidgetConnection* pConnection;
+    };
+
+    ControlWidgetUpdateQueue();
+
+    Slot& slotAt(int slot) {
+        return m_chunks[slot / kChunkSize].load(std::memory_order_acquire)
+                [slot % kChunkSize];
+    }
+
+    const Qt::HANDLE m_guiThreadId;
+
+    // Chunks are allocated on demand and never freed
+    std::atomic<Slot*> m_chunks[kMaxChunks];
+    int m_allocatedSlots;
+    QVector<int> m_freeSlots;
+
+    // Top of the stack of dirty slots, linked through Slot::next
+    std::atomic<int> m_dirtyStackTop;
+};
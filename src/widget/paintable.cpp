@@ -10,6 +10,15 @@
 #include "util/math.h"
 #include "util/memory.h"
 #include "util/painterscope.h"
+#include "util/timer.h"
+#include "widget/svgrastercache.h"
+
+namespace {
+
+// Larger rasters are not worth caching, the SVG is rendered directly
+const int kMaxSvgRasterSize = 2048;
+
+} // anonymous namespace
 
 // static
 Paintable::DrawMode Paintable::DrawModeFromString(const QString& str) {
@@ -69,6 +78,7 @@ Paintable::Paintable(const PixmapSource& source, DrawMode mode, double scaleFact
             return;
         }
         m_pSvg.reset(pSvg.release());
+        m_svgId = source.getId();
 #ifdef __APPLE__
         // Apple does Retina scaling behind the scenes, so we also pass a
         // Paintable::FIXED image. On the other targets, it is better to
@@ -81,10 +91,19 @@ Paintable::Paintable(const PixmapSource& source, DrawMode mode, double scaleFact
 #endif
             // The SVG renderer doesn't directly support tiling, so we render
             // it to a pixmap which will then get tiled.
-            QImage copy_buffer(m_pSvg->defaultSize() * scaleFactor, QImage::Format_ARGB32);
-            copy_buffer.fill(0x00000000);  // Transparent black.
-            QPainter painter(&copy_buffer);
-            m_pSvg->render(&painter);
+            QSvgRenderer* pRenderer = m_pSvg.data();
+            const QRectF svgRect(QPointF(0, 0), pRenderer->defaultSize());
+            QImage copy_buffer = SvgRasterCache::get(
+                    SvgRasterCache::key(m_svgId, svgRect, svgRect, scaleFactor, 0, 1.0),
+                    [pRenderer, scaleFactor] {
+                        QImage image(pRenderer->defaultSize() * scaleFactor,
+                                QImage::Format_ARGB32);
+                        image.fill(0x00000000);  // Transparent black.
+                        QPainter painter(&image);
+                        pRenderer->render(&painter);
+                        return image;
+                    });
+            // Detaches from the cached raster, which is shared uncorrected
             WPixmapStore::correctImageColors(&copy_buffer);
 
             m_pPixmap.reset(new QPixmap(copy_buffer.size()));
@@ -238,9 +257,10 @@ void Paintable::drawInternal(const QRectF& targetRect, QPainter* pPainter,
                                  sourceRect.toRect());
         }
     } else if (m_pSvg) {
+        ScopedTimer t("Paintable::drawInternal SVG");
         if (m_drawMode == TILE) {
             qWarning() << "Tiled SVG should have been rendered to pixmap!";
-        } else {
+        } else if (!drawSvgRaster(targetRect, pPainter, sourceRect)) {
             // NOTE(rryan): QSvgRenderer render does not clip for us -- it
             // applies a world transformation using viewBox and renders the
             // entire SVG to the painter. We save/restore the QPainter in case
@@ -255,6 +275,67 @@ void Paintable::drawInternal(const QRectF& targetRect, QPainter* pPainter,
     }
 }
 
+bool Paintable::drawSvgRaster(const QRectF& targetRect, QPainter* pPainter,
+                              const QRectF& sourceRect) {
+    const QTransform world = pPainter->worldTransform();
+    // Only translation, rotation and uniform scaling can be cached
+    const double scaleSquared = world.m11() * world.m11() + world.m12() * world.m12();
+    if (world.type() > QTransform::TxShear ||
+            world.determinant() <= 0.0 ||
+            !qFuzzyCompare(scaleSquared,
+                    world.m21() * world.m21() + world.m22() * world.m22()) ||
+            !qFuzzyIsNull(world.m11() * world.m21() + world.m12() * world.m22())) {
+        return false;
+    }
+    const double scale = sqrt(scaleSquared);
+    const double angle = atan2(world.m12(), world.m11()) * 180.0 / M_PI;
+    const int rotationBucket = static_cast<int>(
+            round(angle / SvgRasterCache::kRotationStepDegrees));
+
+    // The raster is rendered without translation and drawn at the
+    // translation of the painter
+    const QTransform rotateAndScale = QTransform()
+            .rotate(rotationBucket * SvgRasterCache::kRotationStepDegrees)
+            .scale(scale, scale);
+    const QRectF bounds = rotateAndScale.mapRect(targetRect);
+    const double devicePixelRatio = pPainter->device()->devicePixelRatioF();
+    const QSize rasterSize(
+            static_cast<int>(ceil(bounds.width() * devicePixelRatio)),
+            static_cast<int>(ceil(bounds.height() * devicePixelRatio)));
+    if (rasterSize.isEmpty() ||
+            rasterSize.width() > kMaxSvgRasterSize ||
+            rasterSize.height() > kMaxSvgRasterSize) {
+        return false;
+    }
+
+    QSvgRenderer* pRenderer = m_pSvg.data();
+    const QImage raster = SvgRasterCache::get(
+            SvgRasterCache::key(m_svgId, sourceRect, targetRect,
+                    scale, rotationBucket, devicePixelRatio),
+            [&] {
+                QImage image(rasterSize, QImage::Format_ARGB32_Premultiplied);
+                image.setDevicePixelRatio(devicePixelRatio);
+                image.fill(Qt::transparent);
+                QPainter painter(&image);
+                painter.setRenderHints(QPainter::Antialiasing |
+                        QPainter::SmoothPixmapTransform);
+                painter.translate(-bounds.topLeft());
+                painter.setWorldTransform(rotateAndScale, true);
+                painter.setClipRect(targetRect);
+                pRenderer->setViewBox(sourceRect);
+                pRenderer->render(&painter, targetRect);
+                return image;
+            });
+    if (raster.isNull()) {
+        return false;
+    }
+
+    PainterScope PainterScope(pPainter);
+    pPainter->setWorldTransform(QTransform());
+    pPainter->drawImage(bounds.topLeft() + QPointF(world.dx(), world.dy()), raster);
+    return true;
+}
+
 // static
 QString Paintable::getAltFileName(const QString& fileName) {
     // Detect if the alternate image file exists and, if it does,
@@ -55,11 +55,17 @@ class Paintable {
   private:
     void drawInternal(const QRectF& targetRect, QPainter* pPainter,
                       const QRectF& sourceRect);
+    // Draws the SVG from the SvgRasterCache. Returns false if the painter
+    // transformation is not supported by the cache.
+    bool drawSvgRaster(const QRectF& targetRect, QPainter* pPainter,
+                       const QRectF& sourceRect);
 
     QScopedPointer<QPixmap> m_pPixmap;
     QScopedPointer<QSvgRenderer> m_pSvg;
     DrawMode m_drawMode;
     PixmapSource m_source;
+    // Identifies the SVG in the SvgRasterCache
+    QString m_svgId;
 };
 
 #endif // PAINTABLE
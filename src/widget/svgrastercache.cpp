@@ -0,0 +1,65 @@
+#include "widget/svgrastercache.h"
+
+#include "util/stat.h"
+#include "util/timer.h"
+
+constexpr double SvgRasterCache::kRotationStepDegrees;
+constexpr int SvgRasterCache::kMaxCostKiB;
+
+// static
+QCache<QString, QImage> SvgRasterCache::s_cache(SvgRasterCache::kMaxCostKiB);
+
+// static
+QString SvgRasterCache::key(const QString& sourceId,
+        const QRectF& sourceRect,
+        const QRectF& targetRect,
+        double scale,
+        int rotationBucket,
+        double devicePixelRatio) {
+    return QString("%1|%2,%3,%4,%5|%6,%7,%8,%9|")
+                   .arg(sourceId)
+                   .arg(sourceRect.x())
+                   .arg(sourceRect.y())
+                   .arg(sourceRect.width())
+                   .arg(sourceRect.height())
+                   .arg(targetRect.x())
+                   .arg(targetRect.y())
+                   .arg(targetRect.width())
+                   .arg(targetRect.height()) +
+            QString("%1|%2|%3")
+                    .arg(scale)
+                    .arg(rotationBucket)
+                    .arg(devicePixelRatio);
+}
+
+// static
+QImage SvgRasterCache::get(const QString& key, const std::function<QImage()>& render) {
+    // The average of this stat is the hit rate of the cache
+    const Stat::ComputeFlags flags = Stat::experimentFlags(
+            Stat::COUNT | Stat::AVERAGE);
+    static const StatTag hitTag(QStringLiteral("SvgRasterCache hit"));
+    const QImage* pCached = s_cache.object(key);
+    if (pCached) {
+        Stat::track(hitTag, Stat::UNSPECIFIED, flags, 1.0);
+        return *pCached;
+    }
+    Stat::track(hitTag, Stat::UNSPECIFIED, flags, 0.0);
+
+    QImage image;
+    {
+        ScopedTimer t("SvgRasterCache render");
+        image = render();
+    }
+    if (image.isNull()) {
+        return image;
+    }
+    const int costKiB = qMax(1, image.bytesPerLine() * image.height() / 1024);
+    // Rasters that are larger than the whole cache are dropped by QCache
+    s_cache.insert(key, new QImage(image), costKiB);
+    return image;
+}
+
+// static
+void SvgRasterCache::clear() {
+    s_cache.clear();
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <functional>
+
+#include <QCache>
+#include <QImage>
+#include <QRectF>
+#include <QString>
+
+// SvgRasterCache is a process-wide cache of rasterised SVG images, shared by
+// WPixmapStore (Paintable) and WImageStore.
+//
+// Rendering an SVG with QSvgRenderer tessellates all of its paths, which is
+// far too slow to be done for every knob and slider in every frame. Instead,
+// each SVG is rasterised once per target geometry and the raster is reused
+// until it is evicted. Entries are keyed by the source, the rendered part of
+// the SVG, the target rectangle, the scale and rotation of the painter and
+// the device pixel ratio. Rotations are quantised to kRotationStepDegrees so
+// that rotating knobs only produce a bounded number of entries.
+//
+// The cache is bounded by the total size of the rasters in bytes and evicts
+// the least recently used entries first. It must only be used from the GUI
+// thread.
+class SvgRasterCache final {
+  public:
+    static constexpr double kRotationStepDegrees = 1.0;
+    static constexpr int kMaxCostKiB = 64 * 1024;
+
+    static QString key(const QString& sourceId,
+            const QRectF& sourceRect,
+            const QRectF& targetRect,
+            double scale,
+            int rotationBucket,
+            double devicePixelRatio);
+
+    // Returns the raster for key, calling render() to create it if it is
+    // not cached. A null image returned by render() is not cached.
+    static QImage get(const QString& key, const std::function<QImage()>& render);
+
+    // Discards all rasters, e.g. after the color correction has changed.
+    static void clear();
+
+  private:
+    static QCache<QString, QImage> s_cache;
+
+    SvgRasterCache() = delete;
+};
@@ -6,6 +6,7 @@
 
 #include "skin/imgloader.h"
 #include "util/assert.h"
+#include "widget/svgrastercache.h"
 
 
 // static
@@ -75,12 +76,19 @@ QImage* WImageStore::getImageNoCache(const PixmapSource& source, double scaleFac
             return nullptr;
         }
 
-        auto pImage = new QImage(renderer.defaultSize() * scaleFactor,
+        // Shares the raster with Paintables of the same SVG
+        const QRectF svgRect(QPointF(0, 0), renderer.defaultSize());
+        const QImage image = SvgRasterCache::get(
+                SvgRasterCache::key(source.getId(), svgRect, svgRect, scaleFactor, 0, 1.0),
+                [&renderer, scaleFactor] {
+                    QImage image(renderer.defaultSize() * scaleFactor,
                             QImage::Format_ARGB32);
-        pImage->fill(0x00000000);  // Transparent black.
-        QPainter painter(pImage);
-        renderer.render(&painter);
-        return pImage;
+                    image.fill(0x00000000);  // Transparent black.
+                    QPainter painter(&image);
+                    renderer.render(&painter);
+                    return image;
+                });
+        return new QImage(image);
     } else {
         return m_loader->getImage(source.getPath(), scaleFactor);
     }
@@ -6,6 +6,7 @@
 
 #include "util/math.h"
 #include "skin/imgloader.h"
+#include "widget/svgrastercache.h"
 
 // static
 QHash<QString, WeakPaintablePointer> WPixmapStore::m_paintableCache;
@@ -63,4 +64,5 @@ void WPixmapStore::setLoader(QSharedPointer<ImgSource> ld) {
     // loader has changed. The pixmaps will get freed once all the widgets
     // referring to them are destroyed.
     m_paintableCache.clear();
+    SvgRasterCache::clear();
 }
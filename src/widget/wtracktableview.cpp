@@ -8,6 +8,7 @@
 #include <QCheckBox>
 #include <QLinkedList>
 #include <QScrollBar>
+#include <QSet>
 
 #include "widget/wtracktableview.h"
 
@@ -15,6 +16,7 @@
 #include "widget/wskincolor.h"
 #include "widget/wtracktableviewheader.h"
 #include "widget/wwidget.h"
+#include "analyzer/analyzerfingerprint.h"
 #include "library/coverartcache.h"
 #include "library/dlgtagfetcher.h"
 #include "library/dlgtrackinfo.h"
@@ -199,6 +201,7 @@ WTrackTableView::~WTrackTableView() {
     delete m_pClearAllMetadataAction;
     delete m_pPurgeAct;
     delete m_pFileBrowserAct;
+    delete m_pSelectDuplicatesAct;
 }
 
 void WTrackTableView::enableCachedOnly() {
@@ -466,6 +469,10 @@ void WTrackTableView::createActions() {
     connect(m_pFileBrowserAct, SIGNAL(triggered()),
             this, SLOT(slotOpenInFileBrowser()));
 
+    m_pSelectDuplicatesAct = new QAction(tr("Select Duplicates"), this);
+    connect(m_pSelectDuplicatesAct, SIGNAL(triggered()),
+            this, SLOT(slotSelectDuplicates()));
+
     m_pAutoDJBottomAct = new QAction(tr("Add to Auto DJ Queue (bottom)"), this);
     connect(m_pAutoDJBottomAct, SIGNAL(triggered()),
             this, SLOT(slotAddToAutoDJBottom()));
@@ -684,6 +691,31 @@ void WTrackTableView::slotOpenInFileBrowser() {
     mixxx::DesktopHelper::openInFileBrowser(locations);
 }
 
+void WTrackTableView::slotSelectDuplicates() {
+    TrackModel* trackModel = getTrackModel();
+    if (!trackModel) {
+        return;
+    }
+
+    const FingerprintDAO& fingerprintDao =
+            m_pTrackCollectionManager->internalCollection()->getFingerprintDAO();
+    // Duplicates that are not part of this view are ignored
+    QSet<int> duplicateRows;
+    for (const auto& trackId : getSelectedTrackIds()) {
+        for (const auto& duplicate : fingerprintDao.findDuplicatesOfTrack(trackId)) {
+            for (int row : trackModel->getTrackRows(duplicate.duplicateTrackId)) {
+                duplicateRows.insert(row);
+            }
+        }
+    }
+
+    QItemSelectionModel* pSelectionModel = selectionModel();
+    for (int row : duplicateRows) {
+        pSelectionModel->select(model()->index(row, 0),
+                QItemSelectionModel::Select | QItemSelectionModel::Rows);
+    }
+}
+
 void WTrackTableView::slotHide() {
     QModelIndexList indices = selectionModel()->selectedRows();
     if (indices.size() > 0) {
@@ -816,7 +848,8 @@ void WTrackTableView::showDlgTagFetcher(QModelIndex index) {
 
 void WTrackTableView::slotShowTrackInTagFetcher(TrackPointer pTrack) {
     if (m_pTagFetcher.isNull()) {
-        m_pTagFetcher.reset(new DlgTagFetcher(nullptr));
+        m_pTagFetcher.reset(new DlgTagFetcher(nullptr,
+                m_pTrackCollectionManager->internalCollection()->getFingerprintDAO()));
         connect(m_pTagFetcher.data(), SIGNAL(next()),
                 this, SLOT(slotNextDlgTagFetcher()));
         connect(m_pTagFetcher.data(), SIGNAL(previous()),
@@ -1112,6 +1145,10 @@ void WTrackTableView::contextMenuEvent(QContextMenuEvent* event) {
         m_pMenu->addAction(m_pPurgeAct);
     }
     m_pMenu->addAction(m_pFileBrowserAct);
+    // Duplicates are detected by the fingerprints from the analysis
+    if (AnalyzerFingerprint::isEnabled(m_pConfig)) {
+        m_pMenu->addAction(m_pSelectDuplicatesAct);
+    }
 
     if (modelHasCapabilities(TrackModel::TRACKMODELCAPS_EDITMETADATA)) {
         m_pMenu->addSeparator();
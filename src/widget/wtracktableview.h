@@ -58,6 +58,7 @@ class WTrackTableView : public WLibraryTableView {
     void slotRemove();
     void slotHide();
     void slotOpenInFileBrowser();
+    void slotSelectDuplicates();
     void slotShowTrackInfo();
     void slotShowDlgTagFetcher();
     void slotNextTrackInfo();
@@ -186,6 +187,7 @@ class WTrackTableView : public WLibraryTableView {
     // Show track-editor action
     QAction *m_pPropertiesAct;
     QAction *m_pFileBrowserAct;
+    QAction *m_pSelectDuplicatesAct;
 
     // BPM feature
     QAction *m_pBpmLockAction;